@@ -15,7 +15,9 @@
 #
 #  SPDX-License-Identifier: LGPL-2.1
 
-## @brief This file is a python script that permits to plot recorded data from an output txt file.
+## @brief This file is a python script that permits to plot recorded data from an output txt file,
+# or from a binary record of the telemetry_decode tool. Records are mapped in memory by record_view.py
+# rather than loaded, and zooming redraws the visible range.
 #
 # @author Régis Ruelland <regis.ruelland@laas.fr>
 
@@ -53,15 +55,13 @@ try:
     matplotlib.use('QtAgg')
 except ImportError:
     env.Execute("$PYTHONEXE -m pip install matplotlib")
-try:
-    import pandas as pd
-except ImportError:
-    env.Execute("$PYTHONEXE -m pip install pandas")
+
+import record_view
 
 
 def extract_timestamp(filename):
     # Extract the timestamp part from the filename
-    match = re.match(r'^(\d{4}-\d{2}-\d{2}_\d{2}-\d{2}-\d{2})-record\.txt$', filename)
+    match = re.match(r'^(\d{4}-\d{2}-\d{2}_\d{2}-\d{2}-\d{2})-record\.(txt|rec)$', filename)
     if match:
         timestamp_str = match.group(1)
         # Convert the timestamp string to a datetime object
@@ -70,71 +70,22 @@ def extract_timestamp(filename):
 
 def list_records():
     # Define the pattern to match the filenames
-    pattern = re.compile(r'^\d{4}-\d{2}-\d{2}_\d{2}-\d{2}-\d{2}-record\.txt$')
+    pattern = re.compile(r'^\d{4}-\d{2}-\d{2}_\d{2}-\d{2}-\d{2}-record\.(txt|rec)$')
     # List all files in the current directory
     try :
         data_records_path = os.path.join(".", "src", "Data_records")
         files = os.listdir(data_records_path)
         # Filter files that match the pattern
         record_files = [file for file in files if pattern.match(file)]
+        # Text records are converted next to them: list them once
+        record_files = [file for file in record_files
+                        if not (file.endswith(".rec") and file[:-4] + ".txt" in record_files)]
         record_files.sort(key=extract_timestamp)
         return record_files
     except :
         print(style.ERROR + 'No records found. Check your Data_records folder in src/.')
         return -1
 
-def to_dataFrame(filename):
-    """ filename is the name of file got datas dump from a ScopeMimicry object
-    the format is : two first line with # at beginning
-    in the first line there's a list of column names
-    in the second line a number: the index of the final data recorded
-    each other lines are 8 bytes in hex format and represent float datas.
-    """
-    with open(filename, "r") as f:
-        file = f.readlines()
-    line1 = file.pop(0)
-    if "#" in file[0] or file[0].startswith(" "):
-        line2 = file.pop(0)
-        idx = int(line2.replace("#", "").strip())
-    else:
-        idx = None
-    datas = np.fromiter(file, dtype=float)
-    names = line1.replace("#", "").split(",")
-    datas = datas.reshape(-1, len(names) - 1)
-    if idx:
-        datas = np.roll(datas, -(idx + 1), axis=0)
-    df = pd.DataFrame(datas, columns=names[:-1])
-    return df
-
-
-def plot_df(df):
-    """ plot dataframe in 3 different axes
-    first axes are voltages
-    second axe are currents
-    third are others...
-    by convention we begin column name with 'V' when it is voltage
-    we begin column name with 'I' when it is current
-    """
-    fig, axs = plt.subplots(3, 1)
-    tics = np.arange(len(df))
-    try:
-        df["V_Low_estim"] = df["duty_cycle"] * df["V_high"]
-    except:
-        pass
-    if "k_acquire" in df:
-        del df["k_acquire"]
-    for s in df:
-        if s.startswith("V"):
-            axs[0].step(tics, df[s], label=s)
-        elif s.startswith("I"):
-            axs[1].step(tics, df[s], label=s)
-        else:
-            axs[2].step(tics, df[s], label=s)
-    for ax in axs:
-        ax.legend()
-        ax.grid()
-    return fig
-
 #Dummy function to print a user friendly message using env.VerboseAction()
 #After successfully loading an example.
 def PrintSuccess(target, source, env):
@@ -161,12 +112,11 @@ if "plot-record" in COMMAND_LINE_TARGETS:
             print("The record number is:", record_number)
         except ValueError:
             print(style.ERROR + "Invalid input. Please enter a valid integer.")
-        df = to_dataFrame(os.path.join(".",                                     \
-                                        "src",                                  \
-                                        "Data_records",                         \
-                                        records[record_number]))
-        fig = plot_df(df)
-        fig.suptitle(records[record_number])
+        record = record_view.open_record(os.path.join(".",                      \
+                                                      "src",                    \
+                                                      "Data_records",           \
+                                                      records[record_number]))
+        fig = record_view.view(record, title=records[record_number])
         plt.show()
 
         exit(0)
@@ -0,0 +1,606 @@
+##  Copyright (c) 2024-present LAAS-CNRS
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 2.1 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+#  SPDX-License-Identifier: LGPL-2.1
+
+## @brief Views and exports binary records without loading them.
+#
+# Records are written by the telemetry_decode tool of the host build, given
+# an output name ending with ".rec": a header, then one fixed size row per
+# sample (see telemetry_decode.cpp). They are mapped in memory: only the
+# rows drawn or exported are read, so that records larger than the memory
+# can be used.
+#
+# Views draw the min/max envelope of each channel over as many bins as the
+# plot has pixels, from envelopes of blocks of rows computed in one pass
+# and cached next to the record. Zooming in redraws the visible range,
+# down to the samples themselves.
+#
+# Text records of ScopeMimicry (src/Data_records/*-record.txt) are
+# converted to a binary record first, one chunk of lines at a time.
+#
+# Derived channels, computed from recorded ones (see DERIVED_CHANNELS), are
+# drawn with them when the record has their inputs, e.g. V_Low_estim, the
+# low side voltage estimated from duty_cycle and V_high. They are not
+# exported.
+#
+# Usage:
+#   record_view.py info   <record>
+#   record_view.py view   <record> [--channels a,b,...] [--no-derived]
+#   record_view.py export <record> <output.parquet|.h5>
+#
+# Export needs pyarrow for Parquet files, h5py for HDF5 files.
+#
+# @author Jean Alinei <jean.alinei@owntech.org>
+
+import argparse
+import bisect
+import os
+import struct
+import sys
+
+import numpy as np
+
+
+RECORD_MAGIC = b"OTRECORD"
+RECORD_VERSION = 1
+RECORD_ALIGNMENT = 8
+RECORD_TRIGGERED = 1 << 0
+
+# magic, version, channels, data_offset, decimation, trigger_sample, flags
+RECORD_HEADER = struct.Struct("<8s6I")
+
+# Rows read at once when scanning or exporting
+CHUNK_ROWS = 1 << 20
+
+# Rows per block of the finest cached envelope, then blocks per block of
+# the next envelope
+ENVELOPE_BLOCK = 256
+ENVELOPE_FACTOR = 8
+
+ENVELOPE_CACHE_VERSION = 1
+
+# Channels computed from recorded ones: name: (inputs, function of the
+# input arrays)
+DERIVED_CHANNELS = {
+    # Low side voltage of a buck leg, estimated from the high side one
+    "V_Low_estim": (("duty_cycle", "V_high"),
+                    lambda duty_cycle, v_high: duty_cycle * v_high),
+}
+
+
+class Record:
+    """ A binary record, mapped in memory.
+
+    data is a structured array with a "sample" field holding the sample
+    indexes, then one float field per channel. Indexes jump over lost
+    samples: use rows for positions, samples for display.
+
+    channels are the recorded channels, names, then the derived channels
+    the record has the inputs of, derived.
+    """
+
+    def __init__(self, path):
+        self.path = path
+
+        with open(path, "rb") as f:
+            header = f.read(RECORD_HEADER.size)
+            if len(header) < RECORD_HEADER.size:
+                raise ValueError(f"{path}: not a record")
+
+            (magic, version, channels, data_offset, self.decimation,
+             trigger_sample, flags) = RECORD_HEADER.unpack(header)
+
+            if magic != RECORD_MAGIC or version != RECORD_VERSION:
+                raise ValueError(f"{path}: not a record, or unsupported version")
+
+            names = f.read(data_offset - RECORD_HEADER.size)
+
+        names = names.split(b"\0")[0].decode(errors="replace").split(",")
+        if len(names) != channels:
+            raise ValueError(f"{path}: {len(names)} names for {channels} channels")
+
+        self.names = _unique_names(names)
+        self.derived = [name for name, (inputs, _) in DERIVED_CHANNELS.items()
+                        if name not in self.names and
+                        all(channel in self.names for channel in inputs)]
+        self.channels = self.names + self.derived
+        self.trigger_sample = trigger_sample if flags & RECORD_TRIGGERED else None
+
+        self.dtype = np.dtype([("sample", "<u4")] +
+                              [(name, "<f4") for name in self.names])
+
+        # A row being written is ignored
+        rows = (os.path.getsize(path) - data_offset) // self.dtype.itemsize
+        if rows > 0:
+            self.data = np.memmap(path, dtype=self.dtype, mode="r",
+                                  offset=data_offset, shape=(rows,))
+        else:
+            self.data = np.zeros(0, dtype=self.dtype)
+
+        self._envelopes = None
+
+    def __len__(self):
+        return len(self.data)
+
+    def row_of(self, sample):
+        """ First row of a sample index at least equal to sample. """
+        return bisect.bisect_left(_Samples(self.data), sample)
+
+    def samples(self, rows):
+        """ Sample indexes of an array of rows. """
+        if len(self.data) == 0:
+            return np.zeros(0, dtype=np.uint32)
+        return self.data["sample"][np.minimum(rows, len(self.data) - 1)]
+
+    def values(self, name, start, stop):
+        """ Values of a recorded or derived channel over rows [start, stop[. """
+        if name in self.derived:
+            inputs, function = DERIVED_CHANNELS[name]
+            values = function(*(np.asarray(self.data[channel][start:stop])
+                                for channel in inputs))
+            return np.asarray(values, dtype=np.float32)
+
+        return np.asarray(self.data[name][start:stop])
+
+    def envelope(self, name, start, stop, bins):
+        """ Min/max envelope of a channel over rows [start, stop[, in at most
+        bins bins.
+
+        Returns the first row of each bin, then the mins and the maxes. When
+        there are fewer rows than bins, each row is a bin, and mins are
+        maxes.
+        """
+        start = max(0, start)
+        stop = min(len(self.data), stop)
+        count = stop - start
+
+        if count <= 0:
+            empty = np.zeros(0)
+            return empty.astype(np.int64), empty, empty
+
+        if count <= bins:
+            values = self.values(name, start, stop)
+            return np.arange(start, stop), values, values
+
+        step = count / bins
+
+        if step < ENVELOPE_BLOCK:
+            values = self.values(name, start, stop)
+            edges = np.linspace(0, count, bins + 1).astype(np.int64)[:-1]
+            edges = np.unique(edges)
+            return (start + edges,
+                    np.minimum.reduceat(values, edges),
+                    np.maximum.reduceat(values, edges))
+
+        # Coarsest envelope whose blocks are not larger than the bins
+        levels = self._get_envelopes()
+        block, mins, maxes = levels[0]
+        for level in levels[1:]:
+            if level[0] > step:
+                break
+            block, mins, maxes = level
+
+        channel = self.channels.index(name)
+        first = start // block
+        last = -(-stop // block)
+        mins = mins[first:last, channel]
+        maxes = maxes[first:last, channel]
+
+        edges = np.linspace(0, len(mins), bins + 1).astype(np.int64)[:-1]
+        edges = np.unique(edges)
+        return ((first + edges) * block,
+                np.minimum.reduceat(mins, edges),
+                np.maximum.reduceat(maxes, edges))
+
+    def _get_envelopes(self):
+        """ Envelopes of all channels, finest first: a list of (rows per
+        block, mins, maxes), mins and maxes having a row per block and a
+        column per channel. The finest one is read from the cache, or
+        computed in one pass over the record and cached.
+        """
+        if self._envelopes is not None:
+            return self._envelopes
+
+        cache_path = self.path + ".envelope.npz"
+        mins = maxes = None
+
+        try:
+            with np.load(cache_path) as cache:
+                if (int(cache["version"]) == ENVELOPE_CACHE_VERSION and
+                        int(cache["rows"]) == len(self.data) and
+                        list(cache["names"]) == self.channels):
+                    mins = cache["mins"]
+                    maxes = cache["maxes"]
+        except (OSError, KeyError, ValueError):
+            pass
+
+        if mins is None:
+            mins, maxes = self._scan()
+            try:
+                with open(cache_path, "wb") as f:
+                    np.savez(f, version=ENVELOPE_CACHE_VERSION,
+                             rows=len(self.data), names=self.channels,
+                             mins=mins, maxes=maxes)
+            except OSError:
+                pass
+
+        levels = [(ENVELOPE_BLOCK, mins, maxes)]
+        block = ENVELOPE_BLOCK
+        while len(mins) > ENVELOPE_FACTOR:
+            edges = np.arange(0, len(mins), ENVELOPE_FACTOR)
+            mins = np.minimum.reduceat(mins, edges, axis=0)
+            maxes = np.maximum.reduceat(maxes, edges, axis=0)
+            block *= ENVELOPE_FACTOR
+            levels.append((block, mins, maxes))
+
+        self._envelopes = levels
+        return levels
+
+    def _scan(self):
+        """ Envelope of blocks of ENVELOPE_BLOCK rows of all channels,
+        derived ones included. """
+        blocks = -(-len(self.data) // ENVELOPE_BLOCK)
+        channels = len(self.channels)
+        mins = np.empty((blocks, channels), dtype=np.float32)
+        maxes = np.empty((blocks, channels), dtype=np.float32)
+
+        # Chunks hold whole blocks
+        chunk_rows = CHUNK_ROWS - CHUNK_ROWS % ENVELOPE_BLOCK
+
+        for start in range(0, len(self.data), chunk_rows):
+            values = self._chunk_values(start, start + chunk_rows)
+            edges = np.arange(0, len(values), ENVELOPE_BLOCK)
+            block = start // ENVELOPE_BLOCK
+            mins[block:block + len(edges)] = np.minimum.reduceat(values, edges, axis=0)
+            maxes[block:block + len(edges)] = np.maximum.reduceat(values, edges, axis=0)
+
+        return mins, maxes
+
+    def _chunk_values(self, start, stop):
+        """ All channels over rows [start, stop[ as a rows x channels float
+        array. """
+        stop = min(len(self.data), stop)
+        values = np.empty((stop - start, len(self.channels)), dtype=np.float32)
+        for i, name in enumerate(self.channels):
+            values[:, i] = self.values(name, start, stop)
+        return values
+
+
+class _Samples:
+    """ Sample indexes of a record as a sequence, for bisect: reads only the
+    rows compared. """
+
+    def __init__(self, data):
+        self.data = data
+
+    def __len__(self):
+        return len(self.data)
+
+    def __getitem__(self, row):
+        return int(self.data[row]["sample"])
+
+
+def _unique_names(names):
+    unique = []
+    for name in names:
+        name = name.strip() or "channel"
+        candidate, suffix = name, 1
+        while candidate in unique or candidate == "sample":
+            suffix += 1
+            candidate = f"{name}_{suffix}"
+        unique.append(candidate)
+    return unique
+
+
+def _write_header(f, names, decimation=1, trigger_sample=None):
+    channels = len(names)
+    names = ",".join(names).encode() + b"\0"
+    data_offset = RECORD_HEADER.size + len(names)
+    data_offset += -data_offset % RECORD_ALIGNMENT
+
+    f.write(RECORD_HEADER.pack(RECORD_MAGIC, RECORD_VERSION, channels,
+                               data_offset, decimation,
+                               trigger_sample or 0,
+                               RECORD_TRIGGERED if trigger_sample is not None else 0))
+    f.write(names)
+    f.write(b"\0" * (data_offset - RECORD_HEADER.size - len(names)))
+    return data_offset
+
+
+def _text_value(line):
+    try:
+        return float(line)
+    except ValueError:
+        return np.nan
+
+
+def convert_text_record(text_path, record_path):
+    """ Converts a ScopeMimicry text record: a line of channel names, each
+    followed with a comma, an optional line with the index of the last row
+    written in its circular buffer, then one value per line. Rows are put
+    back in time order, as the former plot script did.
+    """
+    with open(text_path, "r") as f:
+        names = f.readline().replace("#", "").split(",")[:-1]
+        position = f.tell()
+        line = f.readline()
+        if "#" in line or line.startswith(" "):
+            last_row = int(line.replace("#", "").strip())
+            position = f.tell()
+        else:
+            last_row = None
+
+        values = sum(1 for _ in f)
+
+    channels = len(names)
+    if channels == 0:
+        raise ValueError(f"{text_path}: no channel names")
+
+    rows = values // channels
+    shift = (last_row + 1) % rows if (last_row and rows) else 0
+
+    with open(record_path, "wb") as f:
+        data_offset = _write_header(f, [name.strip() for name in names])
+
+    record_dtype = np.dtype([("sample", "<u4")] +
+                            [(f"c{i}", "<f4") for i in range(channels)])
+    if rows == 0:
+        return
+
+    data = np.memmap(record_path, dtype=record_dtype, mode="r+",
+                     offset=data_offset, shape=(rows,))
+    data["sample"] = np.arange(rows, dtype=np.uint32)
+
+    chunk_values = CHUNK_ROWS * channels
+
+    with open(text_path, "r") as f:
+        f.seek(position)
+        row = 0
+        while row < rows:
+            lines = [f.readline() for _ in range(min(chunk_values, (rows - row) * channels))]
+            chunk = np.array([_text_value(line) for line in lines],
+                             dtype=np.float32).reshape(-1, channels)
+            destination = (np.arange(row, row + len(chunk)) - shift) % rows
+            for i in range(channels):
+                data[f"c{i}"][destination] = chunk[:, i]
+            row += len(chunk)
+
+    data.flush()
+    del data
+
+
+def open_record(path):
+    """ Opens a binary record, or a text record converted next to it. """
+    if not path.endswith(".txt"):
+        return Record(path)
+
+    record_path = path[:-len(".txt")] + ".rec"
+    if (not os.path.exists(record_path) or
+            os.path.getmtime(record_path) < os.path.getmtime(path)):
+        convert_text_record(path, record_path)
+
+    return Record(record_path)
+
+
+def export(record, path):
+    """ Exports a record to a Parquet or HDF5 file, one chunk of rows at a
+    time. """
+    extension = os.path.splitext(path)[1].lower()
+
+    if extension == ".parquet":
+        import pyarrow as pa
+        import pyarrow.parquet as pq
+
+        schema = pa.schema([("sample", pa.uint32())] +
+                           [(name, pa.float32()) for name in record.names])
+        metadata = {"decimation": str(record.decimation)}
+        if record.trigger_sample is not None:
+            metadata["trigger_sample"] = str(record.trigger_sample)
+        schema = schema.with_metadata(metadata)
+
+        with pq.ParquetWriter(path, schema) as writer:
+            for start in range(0, len(record), CHUNK_ROWS):
+                rows = record.data[start:start + CHUNK_ROWS]
+                writer.write_table(pa.Table.from_arrays(
+                    [pa.array(np.asarray(rows[field])) for field in schema.names],
+                    schema=schema))
+
+    elif extension in (".h5", ".hdf5"):
+        import h5py
+
+        with h5py.File(path, "w") as f:
+            f.attrs["decimation"] = record.decimation
+            if record.trigger_sample is not None:
+                f.attrs["trigger_sample"] = record.trigger_sample
+
+            fields = ["sample"] + record.names
+            datasets = [f.create_dataset(field, shape=(len(record),),
+                                         dtype=record.dtype[field], chunks=True)
+                        for field in fields]
+
+            for start in range(0, len(record), CHUNK_ROWS):
+                rows = record.data[start:start + CHUNK_ROWS]
+                for field, dataset in zip(fields, datasets):
+                    dataset[start:start + len(rows)] = rows[field]
+
+    else:
+        raise ValueError(f"{path}: unknown format, use .parquet or .h5")
+
+
+def group_channels(names):
+    """ Channels of each plot: voltages, currents, others. By convention,
+    names of voltages begin with 'V', and names of currents with 'I'.
+    """
+    groups = [[], [], []]
+    for name in names:
+        if name == "k_acquire":
+            continue
+        if name.startswith("V"):
+            groups[0].append(name)
+        elif name.startswith("I"):
+            groups[1].append(name)
+        else:
+            groups[2].append(name)
+    return [group for group in groups if group]
+
+
+class _View:
+    """ Redraws the channels over the visible range when it changes. """
+
+    def __init__(self, record, axs, groups):
+        self.record = record
+        self.axs = axs
+        self.groups = groups
+        self.artists = []
+        self.drawn = None
+
+        names = [name for group in groups for name in group]
+        self.colors = {name: f"C{i % 10}" for i, name in enumerate(names)}
+
+    def draw(self, first_sample, last_sample):
+        start = self.record.row_of(first_sample)
+        stop = self.record.row_of(last_sample + 1)
+
+        if self.drawn == (start, stop):
+            return
+        self.drawn = (start, stop)
+
+        for artist in self.artists:
+            artist.remove()
+        self.artists = []
+
+        # A bin per pixel
+        width = self.axs[0].get_window_extent().width
+        bins = max(16, int(width))
+
+        for ax, group in zip(self.axs, self.groups):
+            for name in group:
+                rows, mins, maxes = self.record.envelope(name, start, stop, bins)
+                x = self.record.samples(rows)
+                color = self.colors[name]
+
+                if len(rows) == stop - start:
+                    self.artists += ax.step(x, mins, where="post", color=color)
+                else:
+                    # Extend the last bin up to the last row
+                    x = np.append(x, self.record.samples(stop - 1))
+                    mins = np.append(mins, mins[-1])
+                    maxes = np.append(maxes, maxes[-1])
+                    self.artists.append(ax.fill_between(
+                        x, mins, maxes, step="post", color=color,
+                        alpha=0.6, linewidth=0.5))
+
+    def on_xlim_changed(self, ax):
+        first, last = ax.get_xlim()
+        self.draw(int(np.floor(first)), int(np.ceil(last)))
+        ax.figure.canvas.draw_idle()
+
+
+def view(record, names=None, title=None, derived=True):
+    """ Plots channels of a record, by default the recorded and derived
+    ones: zooming or panning redraws the visible range. Returns the
+    figure, shown with plt.show(). """
+    import matplotlib.pyplot as plt
+    from matplotlib.lines import Line2D
+
+    groups = group_channels(names or
+                            (record.channels if derived else record.names))
+    if not groups or len(record) == 0:
+        raise ValueError(f"{record.path}: nothing to plot")
+
+    fig, axs = plt.subplots(len(groups), 1, sharex=True, squeeze=False)
+    axs = list(axs[:, 0])
+
+    first_sample = int(record.data[0]["sample"])
+    last_sample = int(record.data[-1]["sample"])
+
+    plot = _View(record, axs, groups)
+    plot.draw(first_sample, last_sample)
+
+    for ax, group in zip(axs, groups):
+        ax.legend([Line2D([], [], color=plot.colors[name]) for name in group],
+                  group, loc="upper right")
+        ax.grid()
+        if record.trigger_sample is not None:
+            ax.axvline(record.trigger_sample, color="red", linestyle="--")
+        ax.autoscale_view()
+
+    axs[0].set_xlim(first_sample, last_sample)
+    axs[-1].set_xlabel("sample")
+    fig.suptitle(title or os.path.basename(record.path))
+
+    # Keep a reference to the view with the figure
+    fig._record_view = plot
+    axs[0].callbacks.connect("xlim_changed", plot.on_xlim_changed)
+
+    return fig
+
+
+def main():
+    parser = argparse.ArgumentParser(description="View and export records")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    info_parser = commands.add_parser("info", help="print the record layout")
+    info_parser.add_argument("record")
+
+    view_parser = commands.add_parser("view", help="plot a record")
+    view_parser.add_argument("record")
+    view_parser.add_argument("--channels", help="channels to plot, e.g. V1_LOW,I1_LOW")
+    view_parser.add_argument("--no-derived", action="store_true",
+                             help="do not plot the derived channels")
+
+    export_parser = commands.add_parser("export", help="export to Parquet or HDF5")
+    export_parser.add_argument("record")
+    export_parser.add_argument("output")
+
+    args = parser.parse_args()
+
+    try:
+        record = open_record(args.record)
+
+        if args.command == "info":
+            print(f"{len(record)} rows of {len(record.names)} channels, "
+                  f"decimation {record.decimation}")
+            if len(record):
+                print(f"samples {record.data[0]['sample']} to {record.data[-1]['sample']}")
+            if record.trigger_sample is not None:
+                print(f"triggered at sample {record.trigger_sample}")
+            print(", ".join(record.names))
+            if record.derived:
+                print("derived: " + ", ".join(record.derived))
+
+        elif args.command == "view":
+            import matplotlib.pyplot as plt
+
+            names = args.channels.split(",") if args.channels else None
+            for name in names or []:
+                if name not in record.channels:
+                    raise ValueError(f"unknown channel {name}")
+            view(record, names, derived=not args.no_derived)
+            plt.show()
+
+        else:
+            export(record, args.output)
+
+    except (OSError, ValueError, ImportError) as error:
+        print(error, file=sys.stderr)
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
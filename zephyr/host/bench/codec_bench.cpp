@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Telemetry delta coding benchmark, on the host build.
+ *
+ *         Codes one second of samples at 20kHz of channels acquired as on
+ *         the Spin board: 12-bit ADC values with a few LSB of noise, slowly
+ *         changing, converted with a linear gain and offset. Prints the
+ *         coded size against raw floats, the bandwidth needed at 20kHz,
+ *         and the host time per value. Fails if a value is not decoded
+ *         exactly.
+ *
+ *         Usage: codec_bench [samples per frame]
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+/* Telemetry coding */
+#include "telemetry_codec.h"
+#include "telemetry_format.h"
+
+
+#define SAMPLE_RATE_HZ 20000
+#define ADC_NOISE_LSB  2
+
+
+static uint64_t now_ns()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Channel i: a sine of a few Hz around mid-scale, with noise, converted
+ * as a voltage or current sensor is.
+ */
+static void generate(std::vector<float>& values, uint8_t channels)
+{
+	srand(1);
+
+	for (uint32_t s = 0 ; s < SAMPLE_RATE_HZ ; s++)
+	{
+		double t = (double)s / SAMPLE_RATE_HZ;
+
+		for (uint8_t i = 0 ; i < channels ; i++)
+		{
+			double raw = 2048 + 1000 * sin(2 * M_PI * (1 + i) * t) +
+			             (rand() % (2 * ADC_NOISE_LSB + 1)) - ADC_NOISE_LSB;
+
+			float gain   = 0.045f + 0.001f * i;
+			float offset = -92.2f + i;
+
+			values[s * channels + i] = gain * (float)(uint16_t)raw + offset;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t samples_per_frame = 32;
+	if (argc > 1)
+	{
+		samples_per_frame = strtoul(argv[1], nullptr, 0);
+	}
+
+	if (samples_per_frame < 1)
+	{
+		fprintf(stderr, "At least one sample per frame\n");
+		return 2;
+	}
+
+	const uint8_t channel_counts[] = { 1, 4, 16, 32 };
+	bool failed = false;
+
+	printf("%u samples per frame, first sample of each frame raw\n\n",
+	       samples_per_frame);
+	printf("channels  bytes/value  ratio  Mbit/s at 20kHz  encode ns/value  decode ns/value\n");
+
+	for (uint8_t channels : channel_counts)
+	{
+		uint32_t values_count = SAMPLE_RATE_HZ * channels;
+
+		std::vector<float>   values(values_count);
+		std::vector<float>   decoded(values_count);
+		std::vector<uint8_t> coded(TELEMETRY_CODEC_MAX_BYTES(channels) *
+		                           SAMPLE_RATE_HZ);
+		std::vector<const uint8_t*> frames;
+
+		generate(values, channels);
+
+		uint32_t previous[TELEMETRY_MAX_CHANNELS];
+
+		/* Encode, as the frame writer does */
+		uint64_t start = now_ns();
+
+		uint8_t* output = coded.data();
+		for (uint32_t s = 0 ; s < SAMPLE_RATE_HZ ; s++)
+		{
+			const float* sample = &values[s * channels];
+
+			if (s % samples_per_frame == 0)
+			{
+				frames.push_back(output);
+				memcpy(output, sample, channels * sizeof(float));
+				memcpy(previous, sample, channels * sizeof(float));
+				output += channels * sizeof(float);
+			}
+			else
+			{
+				output = telemetry_codec_encode(output, sample, previous,
+				                                channels);
+			}
+		}
+
+		uint64_t encode_ns = now_ns() - start;
+		size_t   coded_size = output - coded.data();
+
+		/* Decode */
+		start = now_ns();
+
+		const uint8_t* input = coded.data();
+		const uint8_t* end   = output;
+		for (uint32_t s = 0 ; (s < SAMPLE_RATE_HZ) && (input != nullptr) ; s++)
+		{
+			float* sample = &decoded[s * channels];
+
+			if (s % samples_per_frame == 0)
+			{
+				memcpy(sample, input, channels * sizeof(float));
+				memcpy(previous, input, channels * sizeof(float));
+				input += channels * sizeof(float);
+			}
+			else
+			{
+				input = telemetry_codec_decode(input, end, sample, previous,
+				                               channels);
+			}
+		}
+
+		uint64_t decode_ns = now_ns() - start;
+
+		bool exact = (input == end) &&
+		             (memcmp(values.data(), decoded.data(),
+		                     values_count * sizeof(float)) == 0);
+		failed |= (exact == false);
+
+		double bytes_per_value = (double)coded_size / values_count;
+
+		printf("%8u  %11.2f  %5.2f  %15.2f  %15.2f  %15.2f%s\n",
+		       channels,
+		       bytes_per_value,
+		       bytes_per_value / sizeof(float),
+		       (double)coded_size * 8 * 1e-6,
+		       (double)encode_ns / values_count,
+		       (double)decode_ns / values_count,
+		       exact ? "" : "  DECODING ERROR");
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Critical task latency benchmark, on the host build.
+ *
+ *         Drives leg 1 through the Power API with one ADC trigger per
+ *         control period, and runs the same critical task from each
+ *         interrupt source: it reads V1_LOW and writes the duty cycle
+ *         compare. Prints the simulated time from the ADC trigger of the
+ *         measure the task used to its compare write, for each source.
+ *
+ *         Code takes no simulated time: the latencies are those of the
+ *         scheduling alone, conversion time included, to which the
+ *         execution time of the task adds on the Spin board.
+ *
+ *         Fails if the ADC source does not run the task at the end of the
+ *         conversion, or is not faster than the HRTIM source.
+ *
+ *         Usage: critical_latency_bench [control periods per source]
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* OwnTech Power API */
+#include "ShieldAPI.h"
+#include "SpinAPI.h"
+#include "TaskAPI.h"
+
+/* Simulator */
+#include "sim/sim_adc.h"
+#include "sim/sim_hrtim.h"
+#include "sim/sim_kernel.h"
+#include "sim/sim_plant.h"
+#include "sim/sim_time.h"
+
+
+/* 200kHz, the default frequency of the Twist devicetree */
+#define PERIOD_NS 5000
+
+/* Critical task at 20kHz, and one ADC trigger per control period */
+#define CONTROL_PERIOD_US 50
+#define ADC_DECIMATION    10
+
+/* Twist v1.4.1 V1_LOW pin, on ADC 1 */
+#define V1_LOW_PIN 29
+
+/* Samples are numbered modulo the 12-bit range */
+#define SAMPLE_SLOTS 4096
+
+static uint32_t periods = 10000;
+
+static uint32_t failures = 0;
+
+static void check(bool condition, const char* name)
+{
+	printf("%-52s %s\n", name, condition ? "ok" : "FAILED");
+
+	if (condition == false)
+	{
+		failures++;
+	}
+}
+
+
+/**
+ *  Plant numbering the V1_LOW samples, and recording their trigger time
+ */
+
+static uint64_t sample_times_ns[SAMPLE_SLOTS];
+static uint32_t sample_count = 0;
+
+static bool plant_sample(void* context,
+						 uint8_t adc_number,
+						 uint8_t channel,
+						 float* value)
+{
+	(void)context;
+	(void)channel;
+
+	if (adc_number != 1)
+		return false;
+
+	uint32_t slot = sample_count % SAMPLE_SLOTS;
+
+	sample_times_ns[slot] = sim_time_get_ns();
+	sample_count++;
+
+	*value = (float)slot;
+
+	return true;
+}
+
+static const sim_plant_t plant = { nullptr, plant_sample, nullptr, nullptr };
+
+
+/**
+ *  Critical task
+ */
+
+typedef struct
+{
+	uint32_t runs;
+	uint64_t min_ns;
+	uint64_t max_ns;
+	uint64_t total_ns;
+} latency_t;
+
+static latency_t latency;
+
+static void control_task()
+{
+	float32_t value = spin.data.getLatestValue(V1_LOW_PIN);
+
+	if (value == NO_VALUE)
+		return;
+
+	shield.power.setDutyCycle(LEG1, 0.5f);
+
+	/* Code takes no simulated time: now is the time of the write */
+	uint64_t elapsed_ns = sim_time_get_ns() - sample_times_ns[(uint32_t)value];
+
+	latency.runs++;
+	latency.total_ns += elapsed_ns;
+
+	if (elapsed_ns < latency.min_ns)
+		latency.min_ns = elapsed_ns;
+	if (elapsed_ns > latency.max_ns)
+		latency.max_ns = elapsed_ns;
+}
+
+/**
+ * Runs the critical task from a source, and returns its latencies.
+ */
+static latency_t measure(scheduling_interrupt_source_t source)
+{
+	latency = { 0, UINT64_MAX, 0, 0 };
+
+	task.createCritical(control_task, CONTROL_PERIOD_US, source, 1);
+	task.startCritical();
+
+	sim_kernel_run_for((uint64_t)periods * CONTROL_PERIOD_US * 1000);
+
+	task.stopCritical();
+
+	/* Let the last conversion end while the task is stopped */
+	sim_kernel_run_for(CONTROL_PERIOD_US * 1000);
+
+	return latency;
+}
+
+
+int main(int argc, char** argv)
+{
+	if (argc > 1)
+	{
+		periods = strtoul(argv[1], nullptr, 0);
+	}
+
+	sim_plant_set(&plant);
+
+	shield.power.initBuck(LEG1);
+	shield.power.setAdcDecim(LEG1, ADC_DECIMATION);
+	sim_hrtim_connect_leg(1, PWMA);
+
+	/* The task reads the raw sample number */
+	spin.data.enableAcquisition(V1_LOW_PIN);
+	spin.data.setConversionParametersLinear(V1_LOW_PIN, 1.0f, 0.0f);
+
+	shield.power.setDutyCycle(LEG1, 0.5f);
+	shield.power.start(LEG1);
+
+	static const scheduling_interrupt_source_t sources[] =
+	{
+		source_hrtim, source_tim6, source_adc
+	};
+	static const char* source_names[] = { "hrtim", "tim6", "adc" };
+
+	latency_t results[3];
+
+	printf("%u control periods of %uus per source, ADC trigger to compare "
+		   "write in ns\n", periods, CONTROL_PERIOD_US);
+	printf("source     runs      min     mean      max\n");
+
+	for (uint8_t i = 0 ; i < 3 ; i++)
+	{
+		results[i] = measure(sources[i]);
+
+		printf("%-6s %8u %8lu %8lu %8lu\n",
+			   source_names[i],
+			   results[i].runs,
+			   (unsigned long)results[i].min_ns,
+			   (unsigned long)(results[i].total_ns / (results[i].runs ? results[i].runs : 1)),
+			   (unsigned long)results[i].max_ns);
+	}
+
+	bool all_ran = true;
+	for (uint8_t i = 0 ; i < 3 ; i++)
+	{
+		all_ran = all_ran && (results[i].runs + 2 >= periods);
+	}
+	check(all_ran, "task run once per control period from each source");
+
+	/* One V1_LOW conversion in the sequence of ADC 1 */
+	check( (results[2].min_ns == SIM_ADC_CONVERSION_TIME_NS) &&
+		   (results[2].max_ns == SIM_ADC_CONVERSION_TIME_NS),
+		   "ADC source runs the task at the end of conversion");
+	check(results[2].max_ns < results[0].min_ns,
+		  "ADC source latency below the HRTIM source");
+
+	printf("%u checks failed\n", failures);
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Data acquisition pipeline microbenchmarks, on the host build.
+ *
+ *         Measures the host time spent dispatching and converting the
+ *         acquired values against the number of channels and the number
+ *         of acquisitions between two dispatches (buffer depth), for both
+ *         dispatch methods:
+ *         - task: dispatch called by the critical task, ADC in
+ *           discontinuous mode with one conversion per trigger,
+ *         - interrupt: dispatch called from the DMA interrupt at the end
+ *           of each sequence.
+ *
+ *         Each configuration runs in its own process, as the pipeline can
+ *         only be initialized once.
+ *
+ *         Usage: data_bench [cycles] [trigger frequency in Hz]
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/* OwnTech modules */
+#include "adc.h"
+#include "data_dispatch.h"
+#include "data_conversion.h"
+
+/* Simulator */
+#include "sim/sim_adc.h"
+#include "sim/sim_dma.h"
+
+
+/**
+ *  Local variables
+ */
+
+typedef struct
+{
+	uint64_t sum_ns;
+	uint64_t max_ns;
+	uint64_t count;
+} bench_timer_t;
+
+static uint32_t cycles = 20000;
+static uint32_t trigger_frequency = 200000;
+
+/* Sink preventing conversions from being optimized out */
+static volatile float32_t conversion_sink;
+
+
+/* Private functions */
+
+static uint64_t _now_ns()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void _timer_add(bench_timer_t* timer, uint64_t start_ns)
+{
+	uint64_t duration_ns = _now_ns() - start_ns;
+
+	timer->sum_ns += duration_ns;
+	timer->count++;
+	if (duration_ns > timer->max_ns)
+	{
+		timer->max_ns = duration_ns;
+	}
+}
+
+static double _timer_mean(const bench_timer_t* timer)
+{
+	return (timer->count > 0) ? (double)timer->sum_ns / timer->count : 0;
+}
+
+/**
+ * Configures ADC 1 with a distinct sine on each channel, then starts the
+ * pipeline in the same order as DataAPI::start().
+ */
+static void _pipeline_start(dispatch_t method,
+							uint8_t channels,
+							uint32_t depth)
+{
+	for (uint8_t channel = 1 ; channel <= channels ; channel++)
+	{
+		sim_waveform_t waveform =
+		{
+			.shape     = sim_waveform_sine,
+			.offset    = 2048,
+			.amplitude = 1500,
+			.frequency = 50.0f * channel,
+			.phase     = 0,
+			.noise     = 4
+		};
+		sim_adc_set_waveform(1, channel, &waveform);
+
+		adc_add_channel(1, channel);
+	}
+
+	adc_configure_use_dma(1, true);
+	adc_configure_trigger_source(1, hrtim_ev1);
+
+	if (method == task)
+	{
+		adc_configure_discontinuous_mode(1, 1);
+	}
+
+	data_conversion_init();
+	data_dispatch_init(method, depth);
+	adc_start();
+}
+
+/**
+ * Retrieves then converts the values of all channels, returns the number
+ * of values.
+ */
+static uint32_t _pipeline_consume(uint8_t channels, bench_timer_t* conversion)
+{
+	uint32_t total = 0;
+
+	for (uint8_t rank = 1 ; rank <= channels ; rank++)
+	{
+		uint32_t count;
+		uint16_t* values = data_dispatch_get_acquired_values(1, rank, count);
+
+		uint64_t start_ns = _now_ns();
+		for (uint32_t i = 0 ; i < count ; i++)
+		{
+			conversion_sink = data_conversion_convert_raw_value(1,
+																rank,
+																values[i]);
+		}
+		if (count > 0)
+		{
+			conversion->sum_ns += _now_ns() - start_ns;
+			conversion->count  += count;
+		}
+
+		total += count;
+	}
+
+	return total;
+}
+
+static void _bench_task(uint8_t channels, uint32_t depth)
+{
+	bench_timer_t dispatch   = {};
+	bench_timer_t conversion = {};
+	uint64_t samples  = 0;
+	uint64_t expected = 0;
+
+	_pipeline_start(task, channels, depth);
+
+	for (uint32_t cycle = 0 ; cycle < cycles ; cycle++)
+	{
+		sim_adc_run(1, trigger_frequency, depth);
+
+		uint64_t start_ns = _now_ns();
+		data_dispatch_do_full_dispatch();
+		_timer_add(&dispatch, start_ns);
+
+		samples  += _pipeline_consume(channels, &conversion);
+		expected += depth;
+	}
+
+	printf("task      %8u %6u %12.1f %10lu %12.2f %12.2f %8ld\n",
+		   channels,
+		   depth,
+		   _timer_mean(&dispatch),
+		   dispatch.max_ns,
+		   (double)dispatch.sum_ns / (samples ? samples : 1),
+		   (double)conversion.sum_ns / (conversion.count ? conversion.count : 1),
+		   (long)(expected - samples));
+}
+
+static void _bench_interrupt(uint8_t channels)
+{
+	bench_timer_t conversion = {};
+	uint64_t samples  = 0;
+	uint64_t expected = 0;
+
+	_pipeline_start(interrupt, channels, 0);
+	sim_dma_reset_stats();
+
+	for (uint32_t cycle = 0 ; cycle < cycles ; cycle++)
+	{
+		sim_adc_run(1, trigger_frequency, 1);
+
+		samples  += _pipeline_consume(channels, &conversion);
+		expected += channels;
+	}
+
+	/* Dispatch runs in the DMA callback */
+	sim_dma_stats_t stats;
+	sim_dma_get_stats(1, &stats);
+
+	printf("interrupt %8u %6u %12.1f %10lu %12.2f %12.2f %8ld\n",
+		   channels,
+		   1,
+		   (double)stats.callbacks_time_ns / (stats.callbacks ? stats.callbacks : 1),
+		   stats.callback_max_time_ns,
+		   (double)stats.callbacks_time_ns / (samples ? samples : 1),
+		   (double)conversion.sum_ns / (conversion.count ? conversion.count : 1),
+		   (long)(expected - samples));
+}
+
+/**
+ * Runs a benchmark in a child process, so that each one starts from a
+ * freshly initialized pipeline.
+ */
+static void _run_isolated(dispatch_t method, uint8_t channels, uint32_t depth)
+{
+	fflush(stdout);
+
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		if (method == task)
+		{
+			_bench_task(channels, depth);
+		}
+		else
+		{
+			_bench_interrupt(channels);
+		}
+
+		fflush(stdout);
+		_exit(0);
+	}
+
+	int status;
+	waitpid(pid, &status, 0);
+
+	if ( (WIFEXITED(status) == 0) || (WEXITSTATUS(status) != 0) )
+	{
+		printf("%-9s %8u %6u failed\n",
+			   (method == task) ? "task" : "interrupt", channels, depth);
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	if (argc > 1)
+	{
+		cycles = strtoul(argv[1], nullptr, 0);
+	}
+	if (argc > 2)
+	{
+		trigger_frequency = strtoul(argv[2], nullptr, 0);
+	}
+
+	sim_dma_enable_callback_timing(true);
+
+	static const uint8_t  channels_counts[] = {1, 2, 4, 8, 16};
+	static const uint32_t depths[]          = {1, 2, 4, 8, 16, 32};
+
+	printf("%u cycles, triggers at %u Hz, times in host ns\n",
+		   cycles, trigger_frequency);
+	printf("dispatch  channels  depth  dispatch/avg dispatch/max"
+		   "  dispatch/val   conv/value     lost\n");
+
+	for (uint8_t channels : channels_counts)
+	{
+		for (uint32_t depth : depths)
+		{
+			_run_isolated(task, channels, depth);
+		}
+	}
+
+	for (uint8_t channels : channels_counts)
+	{
+		_run_isolated(interrupt, channels, 1);
+	}
+
+	return 0;
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ *
+ * @brief  Three-phase modulation benchmark, on the host build.
+ *
+ *         Computes the duty cycles of each modulation over electrical
+ *         turns, from αβ references and from dq references through the
+ *         CORDIC inverse Park transform, and prints the host time per
+ *         call and its share of a 20kHz critical task period. The
+ *         CORDIC driver is its software implementation on the host: on
+ *         the Spin board, the same calls are timed with the DWT cycle
+ *         counter.
+ *
+ *         Fails if, in the linear range, a modulation changes the line to
+ *         line voltages, or does not clamp the phase it should.
+ *
+ *         Usage: threephase_bench [calls per modulation]
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+/* OwnTech modules */
+#include "ShieldAPI.h"
+#include "cordic_transforms.h"
+
+
+/* Critical task period of the budget */
+#define CONTROL_PERIOD_NS 50000
+
+/* Angle step per call, not a divisor of a turn */
+#define THETA_STEP 0.01F
+
+/* Per-unit amplitude, in the linear range of all modulations */
+#define AMPLITUDE 0.45F
+
+static uint32_t calls = 1000000;
+
+/* Sink preventing the duty cycles from being optimized out */
+static volatile float32_t duty_sink;
+
+static uint32_t failures = 0;
+
+static const char* modulation_names[] =
+{
+	"SPWM", "SPWM_THIRD_HARMONIC", "SVPWM", "DPWM_MIN", "DPWM_MAX", "DPWM1"
+};
+
+
+static uint64_t now_ns()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void check(bool condition, const char* name)
+{
+	printf("%-52s %s\n", name, condition ? "ok" : "FAILED");
+
+	if (condition == false)
+	{
+		failures++;
+	}
+}
+
+/**
+ * Returns true if the duty cycles of a reference keep its line to line
+ * voltages, and clamp the phase of a discontinuous modulation.
+ */
+static bool duty_cycles_valid(float32_t alpha,
+							  float32_t beta,
+							  three_phase_modulation_t modulation,
+							  const float32_t* duty)
+{
+	float32_t v[3];
+	cordic_clarke_inverse(alpha, beta, &v[0], &v[1], &v[2]);
+
+	float32_t duty_min = fminf(duty[0], fminf(duty[1], duty[2]));
+	float32_t duty_max = fmaxf(duty[0], fmaxf(duty[1], duty[2]));
+
+	for (uint8_t i = 0 ; i < 3 ; i++)
+	{
+		uint8_t next = (i + 1) % 3;
+
+		if (fabsf((duty[i] - duty[next]) - (v[i] - v[next])) > 1e-5F)
+			return false;
+	}
+
+	switch (modulation)
+	{
+		case DPWM_MIN:
+			return duty_min == 0.0F;
+		case DPWM_MAX:
+			return duty_max == 1.0F;
+		case DPWM1:
+			return (duty_min == 0.0F) || (duty_max == 1.0F);
+		default:
+			return (duty_min > 0.0F) && (duty_max < 1.0F);
+	}
+}
+
+/**
+ * Times the duty cycles computation from αβ references, and checks them
+ * on the first turn.
+ */
+static double bench_alpha_beta(three_phase_modulation_t modulation,
+							   bool* valid)
+{
+	float32_t duty[3];
+	float32_t theta = 0;
+
+	*valid = true;
+	for (float32_t angle = 0 ; angle < 2 * PI ; angle += THETA_STEP)
+	{
+		float32_t alpha = AMPLITUDE * cosf(angle);
+		float32_t beta  = AMPLITUDE * sinf(angle);
+
+		ThreePhaseAPI::computeDutyCycles(alpha, beta, modulation, duty);
+		*valid = *valid && duty_cycles_valid(alpha, beta, modulation, duty);
+	}
+
+	uint64_t start_ns = now_ns();
+	for (uint32_t i = 0 ; i < calls ; i++)
+	{
+		/* Stands for the reference of a current loop */
+		float32_t alpha = AMPLITUDE - theta * 0.1F;
+		float32_t beta  = theta * 0.1F;
+
+		ThreePhaseAPI::computeDutyCycles(alpha, beta, modulation, duty);
+		duty_sink = duty[0] + duty[1] + duty[2];
+
+		theta += THETA_STEP;
+		if (theta > 2 * PI)
+		{
+			theta -= 2 * PI;
+		}
+	}
+
+	return (double)(now_ns() - start_ns) / calls;
+}
+
+/**
+ * Times the duty cycles computation from dq references, inverse Park
+ * transform included.
+ */
+static double bench_dq(three_phase_modulation_t modulation)
+{
+	float32_t duty[3];
+	float32_t theta = 0;
+
+	uint64_t start_ns = now_ns();
+	for (uint32_t i = 0 ; i < calls ; i++)
+	{
+		float32_t alpha;
+		float32_t beta;
+
+		cordic_park_inverse(0.1F, AMPLITUDE, theta, &alpha, &beta);
+		ThreePhaseAPI::computeDutyCycles(alpha, beta, modulation, duty);
+		duty_sink = duty[0] + duty[1] + duty[2];
+
+		theta += THETA_STEP;
+		if (theta > 2 * PI)
+		{
+			theta -= 2 * PI;
+		}
+	}
+
+	return (double)(now_ns() - start_ns) / calls;
+}
+
+
+int main(int argc, char** argv)
+{
+	if (argc > 1)
+	{
+		calls = strtoul(argv[1], nullptr, 0);
+	}
+
+	printf("%u calls per modulation, times in host ns per call\n", calls);
+	printf("modulation            alpha-beta   budget         dq   budget\n");
+
+	bool valid[DPWM1 + 1];
+
+	for (uint8_t m = SPWM ; m <= DPWM1 ; m++)
+	{
+		three_phase_modulation_t modulation = (three_phase_modulation_t)m;
+
+		double alpha_beta_ns = bench_alpha_beta(modulation, &valid[m]);
+		double dq_ns         = bench_dq(modulation);
+
+		printf("%-20s %11.1f %7.3f%% %10.1f %7.3f%%\n",
+			   modulation_names[m],
+			   alpha_beta_ns,
+			   100 * alpha_beta_ns / CONTROL_PERIOD_NS,
+			   dq_ns,
+			   100 * dq_ns / CONTROL_PERIOD_NS);
+	}
+
+	char name[64];
+	for (uint8_t m = SPWM ; m <= DPWM1 ; m++)
+	{
+		snprintf(name, sizeof(name), "%s line voltages and clamping",
+				 modulation_names[m]);
+		check(valid[m], name);
+	}
+
+	printf("%u checks failed\n", failures);
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Drives the simulated HRTIM with the HRTIM driver, as the Power
+ *         API does on the Spin board, and checks the waveforms of its
+ *         outputs to the tick: phase shift, dead time, duty cycle limits,
+ *         center aligned modulation, output swap, burst mode and
+ *         repetition interrupt.
+ *
+ *         Usage: hrtim_waveforms
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <vector>
+
+/* HRTIM driver */
+#include "hrtim.h"
+
+/* Simulator */
+#include "sim/sim_hrtim.h"
+#include "sim/sim_kernel.h"
+#include "sim/sim_plant.h"
+
+
+/**
+ *  Edge recording
+ */
+
+/* 200kHz in HRTIM ticks, the default frequency of the driver */
+#define PERIOD_TICKS 27200
+#define PERIOD_NS    5000
+
+/* Default dead time of the driver: 100ns in 735ps steps, 4 ticks each */
+#define DEAD_TIME_TICKS (136 * 4)
+
+#define OUT_TA1 0
+#define OUT_TA2 1
+#define OUT_TC1 4
+#define OUT_TC2 5
+#define OUT_TD1 6
+#define OUT_TD2 7
+
+static std::vector<sim_hrtim_edge_t> edges;
+static bool     overlap = false;
+static uint32_t failures = 0;
+
+static void record_edge(const sim_hrtim_edge_t* edge, void* arg)
+{
+	(void)arg;
+
+	edges.push_back(*edge);
+
+	/* The two outputs of a timer must never be high together */
+	uint8_t other = edge->output ^ 1;
+	if ( (edge->level == true) && (sim_hrtim_get_output(other) == true) )
+	{
+		overlap = true;
+	}
+}
+
+static void check(bool condition, const char* name)
+{
+	printf("%-52s %s\n", name, condition ? "ok" : "FAILED");
+
+	if (condition == false)
+	{
+		failures++;
+	}
+}
+
+/**
+ * Returns the tick of the last edge of an output to a level, 0 if none.
+ */
+static uint64_t last_edge(uint8_t output, bool level)
+{
+	for (auto it = edges.rbegin() ; it != edges.rend() ; it++)
+	{
+		if ( (it->output == output) && (it->level == level) )
+			return it->tick;
+	}
+
+	return 0;
+}
+
+/**
+ * Returns the high time of an output over the last period, in ticks.
+ */
+static uint64_t high_ticks(uint8_t output)
+{
+	uint64_t end   = sim_hrtim_get_tick();
+	uint64_t start = end - PERIOD_TICKS;
+	uint64_t high  = 0;
+	bool     level = false;
+	uint64_t since = start;
+
+	/* Level at the start of the window */
+	for (const sim_hrtim_edge_t& edge : edges)
+	{
+		if (edge.output != output)
+			continue;
+
+		if (edge.tick <= start)
+		{
+			level = edge.level;
+			continue;
+		}
+
+		if ( (level == true) && (edge.level == false) )
+		{
+			high += edge.tick - since;
+		}
+		since = edge.tick;
+		level = edge.level;
+	}
+
+	if (level == true)
+	{
+		high += end - since;
+	}
+
+	return high;
+}
+
+static uint32_t edges_count(uint8_t output, bool level)
+{
+	uint32_t count = 0;
+
+	for (const sim_hrtim_edge_t& edge : edges)
+	{
+		if ( (edge.output == output) && (edge.level == level) )
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+
+/**
+ *  Plant receiving the duty cycle of leg 1
+ */
+
+static float leg1_duty_cycle = -1;
+
+static void plant_set_duty_cycle(void* context, uint8_t leg, float duty_cycle)
+{
+	(void)context;
+
+	if (leg == 1)
+	{
+		leg1_duty_cycle = duty_cycle;
+	}
+}
+
+static const sim_plant_t plant = { nullptr, nullptr, plant_set_duty_cycle, nullptr };
+
+
+/**
+ *  Repetition interrupt
+ */
+
+static uint32_t periodic_events = 0;
+
+static void periodic_event()
+{
+	periodic_events++;
+}
+
+
+int main()
+{
+	sim_hrtim_set_edge_handler(record_edge, nullptr);
+	sim_plant_set(&plant);
+
+	/* Left aligned legs A and C, C phase shifted by a quarter period,
+	 * center aligned leg D */
+	hrtim_set_modulation(PWMD, UpDwn);
+
+	check(hrtim_tu_init(PWMA) == PERIOD_TICKS, "timer A period");
+	hrtim_tu_init(PWMC);
+	check(hrtim_tu_init(PWMD) == PERIOD_TICKS / 2, "timer D up-down period");
+
+	hrtim_phase_shift_set(PWMC, PERIOD_TICKS / 4);
+	hrtim_duty_cycle_set(PWMA, PERIOD_TICKS / 2);
+	hrtim_duty_cycle_set(PWMC, PERIOD_TICKS / 2);
+	hrtim_duty_cycle_set(PWMD, PERIOD_TICKS / 8);
+
+	hrtim_out_en(PWMA);
+	hrtim_out_en(PWMC);
+	hrtim_out_en(PWMD);
+
+	sim_hrtim_connect_leg(1, PWMA);
+
+	sim_kernel_run_for(10 * PERIOD_NS);
+
+	/* Phase shift and dead time */
+	uint64_t ta1_rise = last_edge(OUT_TA1, true);
+	uint64_t ta1_fall = last_edge(OUT_TA1, false);
+	uint64_t ta2_rise = last_edge(OUT_TA2, true);
+	uint64_t tc1_rise = last_edge(OUT_TC1, true);
+
+	check((tc1_rise + PERIOD_TICKS - ta1_rise) % PERIOD_TICKS == PERIOD_TICKS / 4,
+		  "timer C shifted by a quarter period");
+	check((ta1_rise % PERIOD_TICKS) == DEAD_TIME_TICKS,
+		  "TA1 rises a dead time after the period");
+	check(ta2_rise - ta1_fall == DEAD_TIME_TICKS,
+		  "TA2 rises a dead time after TA1 falls");
+	check(high_ticks(OUT_TA1) == PERIOD_TICKS / 2 - DEAD_TIME_TICKS,
+		  "TA1 high time, 50% minus dead time");
+	check(high_ticks(OUT_TA2) == PERIOD_TICKS / 2 - DEAD_TIME_TICKS,
+		  "TA2 high time, 50% minus dead time");
+	check(high_ticks(OUT_TC1) == PERIOD_TICKS / 2 - DEAD_TIME_TICKS,
+		  "TC1 high time, 50% minus dead time");
+
+	/* Center aligned: TD1 high around the valley, 25% */
+	uint64_t td1_rise = last_edge(OUT_TD1, true);
+	uint64_t td1_fall = last_edge(OUT_TD1, false);
+	uint64_t td1_mid  = (td1_rise - DEAD_TIME_TICKS + td1_fall) / 2;
+	if (td1_fall < td1_rise)
+	{
+		td1_mid += PERIOD_TICKS / 2;
+	}
+
+	check(high_ticks(OUT_TD1) == PERIOD_TICKS / 4 - DEAD_TIME_TICKS,
+		  "TD1 high time, 25% minus dead time");
+	check(td1_mid % PERIOD_TICKS == 0, "TD1 centered on the valley");
+	check(high_ticks(OUT_TD2) == 3 * PERIOD_TICKS / 4 - DEAD_TIME_TICKS,
+		  "TD2 high time, 75% minus dead time");
+
+	/* Plant leg measured on the pin */
+	float expected = (float)(PERIOD_TICKS / 2 - DEAD_TIME_TICKS) / PERIOD_TICKS;
+	check( (leg1_duty_cycle > expected - 1e-4f) &&
+		   (leg1_duty_cycle < expected + 1e-4f),
+		   "leg 1 duty cycle from TA1");
+
+	/* Compare at the period: reset has priority, output stays low.
+	 * Compare beyond the period: output never reset. Compares are
+	 * preloaded, and the dead time spans the next period. */
+	hrtim_duty_cycle_set(PWMA, PERIOD_TICKS);
+	sim_kernel_run_for(4 * PERIOD_NS);
+	check(high_ticks(OUT_TA1) == 0, "TA1 low with compare at the period");
+	check(high_ticks(OUT_TA2) == PERIOD_TICKS, "TA2 high with compare at the period");
+
+	hrtim_duty_cycle_set(PWMA, PERIOD_TICKS + 100);
+	sim_kernel_run_for(4 * PERIOD_NS);
+	check(high_ticks(OUT_TA1) == PERIOD_TICKS, "TA1 high with compare beyond the period");
+	check(high_ticks(OUT_TA2) == 0, "TA2 low with compare beyond the period");
+
+	/* Output swap */
+	hrtim_duty_cycle_set(PWMA, PERIOD_TICKS / 4);
+	sim_kernel_run_for(3 * PERIOD_NS);
+	check(high_ticks(OUT_TA1) == PERIOD_TICKS / 4 - DEAD_TIME_TICKS,
+		  "TA1 high time, 25% minus dead time");
+
+	hrtim_output_hot_swap(PWMA);
+	sim_kernel_run_for(3 * PERIOD_NS);
+	check(high_ticks(OUT_TA1) == 3 * PERIOD_TICKS / 4 - DEAD_TIME_TICKS,
+		  "TA1 swapped, 75% minus dead time");
+	hrtim_output_hot_swap(PWMA);
+
+	/* Output disable */
+	hrtim_out_dis(PWMC);
+	sim_kernel_run_for(2 * PERIOD_NS);
+	check( (high_ticks(OUT_TC1) == 0) && (high_ticks(OUT_TC2) == 0),
+		   "timer C outputs disabled");
+
+	/* Burst mode: idle 2 master periods out of 4 */
+	hrtim_burst_mode_init();
+	hrtim_burst_set(1, 3);
+	sim_kernel_run_for(PERIOD_NS / 2);
+	uint32_t rises = edges_count(OUT_TA1, true);
+	hrtim_burst_start();
+	sim_kernel_run_for(8 * PERIOD_NS);
+	check(edges_count(OUT_TA1, true) - rises == 4, "burst mode, TA1 runs 4 periods of 8");
+	hrtim_burst_stop();
+	sim_kernel_run_for(4 * PERIOD_NS);
+	check(high_ticks(OUT_TA1) == PERIOD_TICKS / 4 - DEAD_TIME_TICKS,
+		  "burst mode stopped, TA1 runs");
+
+	/* Repetition interrupt every 2 master periods */
+	hrtim_PeriodicEvent_configure(MSTR, 2, periodic_event);
+	hrtim_PeriodicEvent_en(MSTR);
+	sim_kernel_run_for(20 * PERIOD_NS);
+	check( (periodic_events >= 9) && (periodic_events <= 11),
+		   "repetition interrupt every 2 periods");
+
+	check(overlap == false, "outputs of a timer never high together");
+
+	printf("%u edges in %.1f us, %u checks failed\n",
+		   (unsigned)edges.size(),
+		   (double)sim_hrtim_get_tick() / 5440.0,
+		   failures);
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Runs a 20kHz voltage control loop of a Twist leg in buck mode
+ *         against the Twist plant model, on the host build.
+ *
+ *         The leg is driven through the Power API, whose duty cycles
+ *         reach the plant through the simulated HRTIM, and measurements go
+ *         through the Data API with the devicetree calibration of the
+ *         Twist, as on the board. The HRTIM triggers the ADC once per
+ *         control period. The averaged plant uses the averaged HRTIM
+ *         model, the switched plant the tick level one.
+ *
+ *         With the averaged plant, the light-load burst controller of
+ *         the Power API is enabled once the output is at its reference.
+ *         The control loop holds its duty cycle and integrator while burst
+ *         mode is active, and restarts from the held duty cycle when burst
+ *         mode is left. The reference step is made with the burst
+ *         controller disabled. Neither plant has both switches of a leg
+ *         off, as during burst idle periods: the averaged HRTIM model does
+ *         not skip them, and the switched plant would turn the low switch
+ *         on, so it runs without the burst controller.
+ *
+ *         With a telemetry file, the voltage, current, duty cycle and
+ *         reference are streamed at 10kHz, as on the board, to the file
+ *         instead of the console, for telemetry_decode.
+ *
+ *         With a capture file, the V1_LOW and I1_LOW pins and the duty
+ *         cycle are captured around V1_LOW rising through 18V, then the
+ *         capture is downloaded to the file, for telemetry_decode.
+ *
+ *         Usage: twist_buck [simulated duration in s] [averaged|switched]
+ *                           [telemetry file|-] [capture file]
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+
+/* OwnTech Power API */
+#include "ShieldAPI.h"
+#include "SpinAPI.h"
+#include "TaskAPI.h"
+
+/* OwnTech telemetry */
+#include "telemetry.h"
+
+/* Simulator */
+#include "sim/sim_console.h"
+#include "sim/sim_hrtim.h"
+#include "sim/sim_kernel.h"
+#include "sim/sim_plant.h"
+#include "sim/sim_power_models.h"
+#include "sim/sim_time.h"
+
+
+/**
+ *  Application, as written for the Spin board
+ */
+
+/* Twist v1.4.1 sensors of leg 1 */
+#define V1_LOW_PIN 29
+#define I1_LOW_PIN 30
+
+#define CONTROL_PERIOD_US 50
+#define LOG_PERIOD_US     100000
+
+/* One ADC trigger per control period, out of 10 switching periods */
+#define ADC_DECIMATION 10
+
+/* 10kHz telemetry */
+#define TELEMETRY_DECIMATION 2
+
+/* Light-load burst mode, between 1.2A at 12V and 2.4A at 24V on 10 Ohm */
+#define BURST_ENTER_CURRENT 1.5f
+#define BURST_EXIT_CURRENT  2.0f
+
+/* Capture of the reference step */
+#define CAPTURE_LEVEL        18.0f
+#define CAPTURE_PRE_TRIGGER  200
+#define CAPTURE_POST_TRIGGER 800
+
+static const float KP = 0.002f;
+static const float KI = 10.0f;
+
+static float reference    = 12.0f;
+static float integral     = 0;
+static float duty_cycle   = 0;
+static float v1_low       = 0;
+static float i1_low       = 0;
+static uint32_t control_runs = 0;
+static uint32_t burst_runs   = 0;
+
+/* Called in the critical task when burst mode is entered or left */
+static void burst_callback(bool active)
+{
+	if (active == false)
+	{
+		/* Restart the loop from the duty cycle held during burst mode */
+		integral = duty_cycle;
+	}
+}
+
+static void control_task()
+{
+	float voltage = spin.data.getLatestValue(V1_LOW_PIN);
+	float current = spin.data.getLatestValue(I1_LOW_PIN);
+
+	if ( (voltage == NO_VALUE) || (current == NO_VALUE) )
+		return;
+
+	v1_low = voltage;
+	i1_low = current;
+
+	/* Outputs idle during part of the periods: hold the duty cycle */
+	if (shield.power.updateBurstController(current) == true)
+	{
+		burst_runs++;
+		telemetry_sample();
+		control_runs++;
+		return;
+	}
+
+	float error = reference - voltage;
+	integral += KI * error * (CONTROL_PERIOD_US * 1e-6f);
+	integral  = fminf(fmaxf(integral, 0.0f), 0.9f);
+
+	duty_cycle = fminf(fmaxf(KP * error + integral, 0.0f), 0.9f);
+
+	shield.power.setDutyCycle(LEG1, duty_cycle);
+
+	telemetry_sample();
+
+	control_runs++;
+}
+
+static void log_task()
+{
+	printf("%8.3f s  reference %5.1f V  V1_LOW %6.2f V  I1_LOW %6.2f A  duty %5.3f%s\n",
+		   (double)k_uptime_get() / 1000.0,
+		   (double)reference,
+		   (double)v1_low,
+		   (double)i1_low,
+		   (double)duty_cycle,
+		   shield.power.isBurstActive() ? "  burst" : "");
+}
+
+
+int main(int argc, char** argv)
+{
+	double duration_s = 1.0;
+	if (argc > 1)
+	{
+		duration_s = strtod(argv[1], nullptr);
+	}
+
+	sim_twist_parameters_t parameters;
+	sim_twist_get_default_parameters(&parameters);
+
+	if ( (argc > 2) && (strcmp(argv[2], "switched") == 0) )
+	{
+		parameters.model.type             = sim_power_model_switched;
+		parameters.model.steps_per_period = 20;
+	}
+	else
+	{
+		sim_hrtim_set_averaged(true);
+	}
+
+	sim_plant_set(sim_twist_init(&parameters));
+
+	/* Leg 1 of the Twist is timer A of the HRTIM */
+	shield.power.initBuck(LEG1);
+	shield.power.setAdcDecim(LEG1, ADC_DECIMATION);
+	sim_hrtim_connect_leg(1, PWMA);
+
+	/* Both measures converted on each trigger */
+	spin.data.configureDiscontinuousMode(ADC_1, 2);
+
+	spin.data.enableAcquisition(V1_LOW_PIN);
+	spin.data.enableAcquisition(I1_LOW_PIN);
+	spin.data.setConversionParametersLinear(V1_LOW_PIN, 0.045f, -92.2031f);
+	spin.data.setConversionParametersLinear(I1_LOW_PIN, 0.005f, -10.0f);
+
+	task.createCritical(control_task, CONTROL_PERIOD_US);
+	task.startCritical();
+
+	shield.power.start(LEG1);
+
+	uint8_t log_task_number = task.createBackgroundPeriodic(log_task,
+															LOG_PERIOD_US);
+	task.startBackground(log_task_number);
+
+	bool light_load = (parameters.model.type == sim_power_model_averaged);
+
+	if (light_load == true)
+	{
+		shield.power.setBurstCallback(burst_callback);
+	}
+
+	FILE* telemetry_file = nullptr;
+
+	if ( (argc > 3) && (strcmp(argv[3], "-") != 0) )
+	{
+		telemetry_file = fopen(argv[3], "wb");
+		if (telemetry_file == nullptr)
+		{
+			fprintf(stderr, "Cannot write %s\n", argv[3]);
+			return 1;
+		}
+
+		sim_console_set_output(telemetry_file);
+
+		telemetry_add_channel("V1_LOW", &v1_low);
+		telemetry_add_channel("I1_LOW", &i1_low);
+		telemetry_add_channel("duty_cycle", &duty_cycle);
+		telemetry_add_channel("reference", &reference);
+		telemetry_set_decimation(TELEMETRY_DECIMATION);
+		telemetry_start();
+	}
+
+	if (argc > 4)
+	{
+		spin.capture.addPin("V1_LOW", V1_LOW_PIN);
+		spin.capture.addPin("I1_LOW", I1_LOW_PIN);
+		spin.capture.addVariable("duty_cycle", &duty_cycle);
+		spin.capture.setTrigger(CAPTURE_TRIGGER_RISING_EDGE, 0, CAPTURE_LEVEL);
+		spin.capture.setLength(CAPTURE_PRE_TRIGGER, CAPTURE_POST_TRIGGER);
+
+		/* Pins are resolved once the Data API is started */
+		sim_kernel_run_for(CONTROL_PERIOD_US * 1000);
+
+		if (spin.capture.arm() != 0)
+		{
+			fprintf(stderr, "Cannot arm the capture\n");
+			return 1;
+		}
+	}
+
+	uint64_t duration_ns = (uint64_t)(duration_s * 1e9);
+
+	auto wall_start = std::chrono::steady_clock::now();
+
+	sim_kernel_run_for(duration_ns / 4);
+	if (light_load == true)
+	{
+		shield.power.initBurstController(BURST_ENTER_CURRENT,
+										 BURST_EXIT_CURRENT);
+	}
+	sim_kernel_run_for(duration_ns / 2 - duration_ns / 4);
+
+	shield.power.deInitBurstController();
+	reference = 24.0f;
+	sim_kernel_run_for(duration_ns / 4);
+	if (light_load == true)
+	{
+		shield.power.initBurstController(BURST_ENTER_CURRENT,
+										 BURST_EXIT_CURRENT);
+	}
+	sim_kernel_run_for(duration_ns - duration_ns / 2 - duration_ns / 4);
+
+	auto wall_end = std::chrono::steady_clock::now();
+	double wall_s = std::chrono::duration<double>(wall_end - wall_start).count();
+
+	if (telemetry_file != nullptr)
+	{
+		/* Let the telemetry thread send the last frames */
+		telemetry_stop();
+		sim_kernel_run_for(10 * 1000000);
+
+		printf("%u telemetry samples dropped\n",
+			   telemetry_get_dropped_samples());
+
+		sim_console_set_output(nullptr);
+		fclose(telemetry_file);
+	}
+
+	if (argc > 4)
+	{
+		FILE* capture_file = fopen(argv[4], "wb");
+
+		if ( (capture_file == nullptr) ||
+			 (spin.capture.getState() != CAPTURE_DONE) )
+		{
+			fprintf(stderr, "No capture written to %s\n", argv[4]);
+			return 1;
+		}
+
+		sim_console_set_output(capture_file);
+		spin.capture.download();
+		sim_console_set_output(nullptr);
+		fclose(capture_file);
+	}
+
+	printf("%u of them in burst mode\n", burst_runs);
+
+	printf("%u control periods, %.3f s simulated in %.3f s: %.1f times real time\n",
+		   control_runs,
+		   (double)sim_time_get_ns() * 1e-9,
+		   wall_s,
+		   ((double)sim_time_get_ns() * 1e-9) / wall_s);
+
+	return (fabsf(v1_low - reference) < 0.5f) ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Runs a voltage control loop against a simulated plant, faster
+ *         than real time, on the host build.
+ *
+ *         The critical task regulates the output voltage of an averaged
+ *         first-order buck converter model with a PI controller, using the
+ *         Task API and the Data API as on the Spin board. A periodic
+ *         background task logs the voltage, and a step of the reference is
+ *         applied halfway.
+ *
+ *         The event trace of the end of the run, critical task and
+ *         thread switches, can be written for trace_export.
+ *
+ *         Usage: voltage_loop [simulated duration in s] [trace dump file]
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+/* OwnTech Power API */
+#include "SpinAPI.h"
+#include "TaskAPI.h"
+
+/* Event trace */
+#include "event_trace.h"
+
+/* Simulator */
+#include "sim/sim_kernel.h"
+#include "sim/sim_plant.h"
+#include "sim/sim_time.h"
+
+
+/**
+ *  Plant: averaged buck converter with a first-order output
+ */
+
+#define INPUT_VOLTAGE    48.0f
+#define TIME_CONSTANT_S  1e-3
+#define SENSOR_LSB_PER_V 60.0f
+
+/* Shield pin of the output voltage sensor, on ADC 1 channel 1 */
+#define VOUT_PIN 29
+
+typedef struct
+{
+	float duty_cycle;
+	float output_voltage;
+} buck_t;
+
+static void buck_step(void* context, uint64_t duration_ns)
+{
+	buck_t* buck = (buck_t*)context;
+
+	float target = buck->duty_cycle * INPUT_VOLTAGE;
+	float alpha  = (float)(1.0 - exp(-((double)duration_ns * 1e-9) /
+									  TIME_CONSTANT_S));
+
+	buck->output_voltage += (target - buck->output_voltage) * alpha;
+}
+
+static bool buck_sample(void* context,
+						uint8_t adc_number,
+						uint8_t channel,
+						float* value)
+{
+	buck_t* buck = (buck_t*)context;
+
+	if ( (adc_number != 1) || (channel != 1) )
+		return false;
+
+	*value = buck->output_voltage * SENSOR_LSB_PER_V;
+
+	return true;
+}
+
+static void buck_set_duty_cycle(void* context, uint8_t leg, float duty_cycle)
+{
+	buck_t* buck = (buck_t*)context;
+
+	if (leg == 1)
+	{
+		buck->duty_cycle = duty_cycle;
+	}
+}
+
+static buck_t buck_state = {};
+
+static const sim_plant_t buck_plant =
+{
+	buck_step,
+	buck_sample,
+	buck_set_duty_cycle,
+	&buck_state
+};
+
+
+/**
+ *  Application, as written for the Spin board
+ */
+
+#define CONTROL_PERIOD_US 100
+#define LOG_PERIOD_US     250000
+
+static const float KP = 0.005f;
+static const float KI = 20.0f;
+
+static float reference      = 12.0f;
+static float integral       = 0;
+static float last_voltage   = 0;
+static uint32_t control_runs = 0;
+
+static void control_task()
+{
+	float voltage = spin.data.getLatestValue(VOUT_PIN);
+
+	if (voltage == NO_VALUE)
+		return;
+
+	last_voltage = voltage;
+
+	float error = reference - voltage;
+	integral += KI * error * (CONTROL_PERIOD_US * 1e-6f);
+
+	float duty_cycle = KP * error + integral;
+	if (duty_cycle < 0.0f)
+	{
+		duty_cycle = 0.0f;
+	}
+	else if (duty_cycle > 0.9f)
+	{
+		duty_cycle = 0.9f;
+	}
+
+	/* On the Spin board: spin.pwm.setDutyCycle() */
+	sim_plant_set_duty_cycle(1, duty_cycle);
+
+	control_runs++;
+}
+
+static void log_task()
+{
+	printf("%8.3f s  reference %5.1f V  output %6.2f V  duty %5.3f\n",
+		   (double)k_uptime_get() / 1000.0,
+		   (double)reference,
+		   (double)last_voltage,
+		   (double)buck_state.duty_cycle);
+}
+
+
+int main(int argc, char** argv)
+{
+	double duration_s = 2.0;
+	if (argc > 1)
+	{
+		duration_s = strtod(argv[1], nullptr);
+	}
+
+	sim_plant_set(&buck_plant);
+
+	/* As configured by the shield API: one conversion per PWM period */
+	spin.data.configureTriggerSource(ADC_1, TRIG_PWM);
+	spin.data.configureDiscontinuousMode(ADC_1, 1);
+
+	spin.data.enableAcquisition(VOUT_PIN);
+	spin.data.setConversionParametersLinear(VOUT_PIN,
+											1.0f / SENSOR_LSB_PER_V,
+											0.0f);
+
+	task.createCritical(control_task, CONTROL_PERIOD_US);
+	task.startCritical();
+
+	uint8_t log_task_number = task.createBackgroundPeriodic(log_task,
+															LOG_PERIOD_US);
+	task.startBackground(log_task_number);
+
+	uint64_t duration_ns = (uint64_t)(duration_s * 1e9);
+
+	auto wall_start = std::chrono::steady_clock::now();
+
+	sim_kernel_run_for(duration_ns / 2);
+	reference = 24.0f;
+	sim_kernel_run_for(duration_ns - duration_ns / 2);
+
+	auto wall_end = std::chrono::steady_clock::now();
+	double wall_s = std::chrono::duration<double>(wall_end - wall_start).count();
+
+	printf("%u control periods, %.3f s simulated in %.3f s: %.1f times real time\n",
+		   control_runs,
+		   (double)sim_time_get_ns() * 1e-9,
+		   wall_s,
+		   ((double)sim_time_get_ns() * 1e-9) / wall_s);
+
+	if (argc > 2)
+	{
+		FILE* dump = fopen(argv[2], "wb");
+
+		if ( (dump == nullptr) ||
+			 (fwrite(&trace_ring, sizeof(trace_ring), 1, dump) != 1) )
+		{
+			printf("Cannot write the trace to %s\n", argv[2]);
+			return 1;
+		}
+
+		fclose(dump);
+	}
+
+	return (fabsf(last_voltage - reference) < 0.5f) ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ *
+ * @brief  Host build replacement of the Shield API header. Only the power
+ *         part of the Shield API is built on the host, on the legs of the
+ *         Twist described in zephyr/devicetree.h. Sensors are read through
+ *         the Data API.
+ */
+
+#ifndef SHIELDAPI_H_
+#define SHIELDAPI_H_
+
+
+#include "Power.h"
+
+#ifdef CONFIG_OWNTECH_SHIELD_THREE_PHASE
+#include "ThreePhase.h"
+#endif
+
+
+class ShieldAPI
+{
+public:
+	/**
+	 * @brief Contains all the functions to drive shield power capabilities
+	 */
+	static PowerAPI power;
+
+#ifdef CONFIG_OWNTECH_SHIELD_THREE_PHASE
+	/**
+	 * @brief Contains all the functions to drive three legs as a
+	 * 		  three-phase inverter
+	 */
+	static ThreePhaseAPI threephase;
+#endif
+
+};
+
+
+/**
+ *  Public object to interact with the class
+ */
+
+extern ShieldAPI shield;
+
+
+#endif /* SHIELDAPI_H_ */
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the Spin API header. Only the data
+ *         acquisition, capture, PWM and GPIO parts of the Spin API are
+ *         built on the host, the spin object being defined by the
+ *         simulator. The DAC and comparator only take the calls of the
+ *         Power API: current mode is not simulated.
+ */
+
+#ifndef SPINAPI_H_
+#define SPINAPI_H_
+
+
+#include "CompHAL.h"
+#include "DacHAL.h"
+#include "DataAPI.h"
+#include "GpioHAL.h"
+#include "PwmHAL.h"
+
+#ifdef CONFIG_OWNTECH_CAPTURE_API
+#include "CaptureAPI.h"
+#endif
+
+
+class SpinAPI
+{
+public:
+	/**
+	 * @brief Contains all the functions for the GPIO
+	 */
+	static GpioHAL gpio;
+
+	/**
+	 * @brief Contains all the functions for the DAC, only those used by the
+	 *        Power API are available on the host
+	 */
+	static DacHAL dac;
+
+	/**
+	 * @brief Contains all the functions for the comparator, only those used
+	 *        by the Power API are available on the host
+	 */
+	static CompHAL comp;
+
+	/**
+	 * @brief Contains all the functions for the PWM, on the simulated HRTIM
+	 */
+	static PwmHAL pwm;
+
+	/**
+	 * @brief Data acquisition from SPIN ADCs
+	 */
+	static DataAPI data;
+
+#ifdef CONFIG_OWNTECH_CAPTURE_API
+	/**
+	 * @brief Triggered captures of the critical task variables and pins
+	 */
+	static CaptureAPI capture;
+#endif
+
+};
+
+
+/**
+ *  Public object to interact with the class
+ */
+
+extern SpinAPI spin;
+
+
+#endif /* SPINAPI_H_ */
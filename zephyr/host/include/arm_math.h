@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the CMSIS-DSP header, limited to
+ *         what the modules built on the host use.
+ */
+
+#ifndef ARM_MATH_H_
+#define ARM_MATH_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+#include <math.h>
+
+
+typedef float  float32_t;
+typedef double float64_t;
+
+#define PI 3.14159265358979f
+
+
+#endif /* ARM_MATH_H_ */
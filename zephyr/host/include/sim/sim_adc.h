@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Simulated ADCs of the host build.
+ *
+ *         The simulated ADC core replaces the register level part of the
+ *         ADC driver. Each channel samples a synthetic waveform at the
+ *         simulated time of its conversion, writes the result to the data
+ *         register and raises the DMA request at the time of the trigger.
+ *         The end of sequence interrupt is raised once the conversions of
+ *         the sequence are done, SIM_ADC_CONVERSION_TIME_NS each.
+ *
+ *         Hardware triggered ADCs convert when the simulation raises their
+ *         HRTIM trigger: either periodically from the simulated kernel,
+ *         see sim_adc_set_trigger_period_ns(), or explicitly, e.g. with
+ *         sim_adc_run() at a PWM frequency. Software triggered ADCs convert
+ *         as soon as they are started.
+ *
+ *         Channels driven by the plant, see sim/sim_plant.h, sample the
+ *         plant instead of their waveform, noise excepted.
+ */
+
+#ifndef SIM_ADC_H_
+#define SIM_ADC_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* 12-bit conversion with 2.5 sampling cycles at 42.5MHz */
+#define SIM_ADC_CONVERSION_TIME_NS 353
+
+typedef enum
+{
+	sim_waveform_constant,
+	sim_waveform_sine,
+	sim_waveform_square,
+	sim_waveform_triangle
+} sim_waveform_shape_t;
+
+/**
+ * @brief Synthetic waveform of a channel, in ADC LSB. Results are
+ *        clamped to the 12-bit range.
+ */
+typedef struct
+{
+	sim_waveform_shape_t shape;
+	float offset;
+	float amplitude; /* Peak amplitude, ignored for constant */
+	float frequency; /* In Hz, ignored for constant */
+	float phase;     /* In radians */
+	float noise;     /* Peak of a uniform noise added to each sample */
+} sim_waveform_t;
+
+
+/**
+ * @brief Sets the waveform sampled by an ADC channel.
+ *        Channels without waveform read 0.
+ *
+ * @param adc_number Number of the ADC, between 1 and 5.
+ * @param channel    Number of the channel, between 1 and 19.
+ * @param waveform   Waveform to sample.
+ */
+void sim_adc_set_waveform(uint8_t adc_number,
+                          uint8_t channel,
+                          const sim_waveform_t* waveform);
+
+/**
+ * @brief Sets the seed of the noise generator.
+ */
+void sim_adc_set_noise_seed(uint32_t seed);
+
+/**
+ * @brief Raises an HRTIM ADC trigger at the current simulated time.
+ *        Started ADCs using this trigger convert their next channels.
+ *
+ * @param trigger_number HRTIM ADC trigger, between 1 and 10.
+ */
+void sim_adc_hrtim_trigger(uint8_t trigger_number);
+
+/**
+ * @brief Raises all the HRTIM ADC triggers at each multiple of a period,
+ *        from the simulated kernel, as a running HRTIM does. Do not mix
+ *        with sim_adc_run(), which moves the simulated time itself.
+ *
+ * @param period_ns Trigger period in nanoseconds, 0 to stop triggering.
+ */
+void sim_adc_set_trigger_period_ns(uint64_t period_ns);
+
+/**
+ * @brief Returns the period set by sim_adc_set_trigger_period_ns().
+ */
+uint64_t sim_adc_get_trigger_period_ns();
+
+/**
+ * @brief Raises an HRTIM ADC trigger periodically: the simulated time is
+ *        advanced by one period before each trigger.
+ *
+ * @param trigger_number HRTIM ADC trigger, between 1 and 10.
+ * @param frequency      Trigger frequency in Hz.
+ * @param count          Number of triggers.
+ */
+void sim_adc_run(uint8_t trigger_number, uint32_t frequency, uint32_t count);
+
+/**
+ * @brief Returns the number of conversions done by an ADC.
+ *
+ * @param adc_number Number of the ADC, between 1 and 5.
+ */
+uint64_t sim_adc_get_conversions_count(uint8_t adc_number);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_ADC_H_ */
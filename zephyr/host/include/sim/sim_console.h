@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Simulated console output of the host build, written by
+ *         console_write(). Text printed with printk() goes to the standard
+ *         output instead.
+ */
+
+#ifndef SIM_CONSOLE_H_
+#define SIM_CONSOLE_H_
+
+
+/* Stdlib */
+#include <stdio.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Sets the file receiving the console output. By default, the
+ *        output is discarded.
+ *
+ * @param output Open file, NULL to discard the output.
+ */
+void sim_console_set_output(FILE* output);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_CONSOLE_H_ */
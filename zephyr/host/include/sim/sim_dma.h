@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Simulated DMA 1 and 2 of the host build.
+ *
+ *         DMA 1 channels are configured through the Zephyr DMA API and
+ *         transfer one data from their source address each time their
+ *         DMAMUX request is raised, in circular mode. Half and full
+ *         transfer callbacks are called synchronously, as from the DMA
+ *         interrupt.
+ *
+ *         DMA 2 channels are configured through their registers, see
+ *         stm32_ll_dma.h, and transfer 32-bit words from memory to the
+ *         peripheral reading them with sim_dma2_transfer(). Channel 1
+ *         raises its transfer complete interrupt.
+ */
+
+#ifndef SIM_DMA_H_
+#define SIM_DMA_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+#include <stdbool.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define SIM_DMA_CHANNELS_COUNT 8
+
+/** Activity of a DMA channel */
+typedef struct
+{
+	uint64_t transfers;
+	uint64_t callbacks;
+	uint64_t callbacks_time_ns; /* Host time spent in callbacks, if timed */
+	uint64_t callback_max_time_ns;
+} sim_dma_stats_t;
+
+
+/**
+ * @brief Raises a DMAMUX request, as a peripheral does. Enabled channels
+ *        attached to this request transfer one data.
+ *
+ * @param request DMAMUX request, e.g. LL_DMAMUX_REQ_ADC1.
+ */
+void sim_dma_request(uint32_t request);
+
+/**
+ * @brief Transfers one word from memory on the DMA 2 channel attached to
+ *        a DMAMUX request, as a peripheral reading its data does.
+ *
+ * @param request DMAMUX request, e.g. LL_DMAMUX_REQ_HRTIM1_M.
+ * @param data    Receives the word.
+ *
+ * @return true if an enabled channel transferred the word, false if no
+ *         channel serves the request.
+ */
+bool sim_dma2_transfer(uint32_t request, uint32_t* data);
+
+/**
+ * @brief Retrieves the activity of a channel since the last reset.
+ *
+ * @param channel Channel number, starting from 1 as in the Zephyr API.
+ * @param stats   Structure receiving the activity.
+ */
+void sim_dma_get_stats(uint32_t channel, sim_dma_stats_t* stats);
+
+/**
+ * @brief Resets the activity of all channels.
+ */
+void sim_dma_reset_stats();
+
+/**
+ * @brief Enables timing the callbacks with the host clock, for the
+ *        activity statistics. Disabled by default: reading the host clock
+ *        costs more than a simulated transfer.
+ *
+ * @param enable true to time the callbacks.
+ */
+void sim_dma_enable_callback_timing(bool enable);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_DMA_H_ */
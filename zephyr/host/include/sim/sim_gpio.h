@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ *
+ * @brief  Simulated GPIO ports A to D of the host build.
+ *
+ *         Pins are configured and driven through the Zephyr GPIO API.
+ *         Output pins read back the level they drive, input pins read the
+ *         level set by the simulation, low by default.
+ */
+
+#ifndef SIM_GPIO_H_
+#define SIM_GPIO_H_
+
+
+/* Zephyr */
+#include <zephyr/drivers/gpio.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Returns the level of a pin: driven by the application for
+ *        outputs, set by the simulation for inputs.
+ *
+ * @param port Simulated port, e.g. SIM_DEVICE(gpioa).
+ * @param pin  Pin number in the port, between 0 and 15.
+ *
+ * @return 1 if high, 0 if low, -EINVAL for an invalid port or pin.
+ */
+int sim_gpio_get(const struct device* port, gpio_pin_t pin);
+
+/**
+ * @brief Sets the level applied to an input pin, as an external circuit
+ *        does.
+ *
+ * @param port  Simulated port, e.g. SIM_DEVICE(gpioa).
+ * @param pin   Pin number in the port, between 0 and 15.
+ * @param value 0 for low, high otherwise.
+ */
+void sim_gpio_set_input(const struct device* port, gpio_pin_t pin, int value);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_GPIO_H_ */
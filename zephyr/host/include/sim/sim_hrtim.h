@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Simulated HRTIM1 of the host build.
+ *
+ *         The HRTIM driver runs unchanged on the registers of
+ *         stm32g4xx.h. The simulated HRTIM counts in ticks of the high
+ *         resolution clock, f_HRTIM x 32, and raises the events its
+ *         registers select, at the exact tick:
+ *
+ *         - master and timers A to F counters, continuous, up or up-down,
+ *           with their prescaler, period, compares and repetition counter.
+ *           Period, compares and repetition are transferred from their
+ *           preload registers on repetition update, or for timers on the
+ *           master update, unless the update is suspended, and when the
+ *           counter starts,
+ *         - timer resets from the master and the other timers,
+ *         - output set and reset crossbar, reset first when both occur.
+ *           When counting down, compare events swap set and reset,
+ *         - dead time: output 2 is the complement of output 1, each rising
+ *           edge delayed by its dead time. Pulses not longer than the dead
+ *           time are swallowed,
+ *         - output swap, output enable and burst mode idle state. Burst
+ *           mode idles BMCMPR + 1 clock periods out of BMPER + 1, clocked
+ *           by the master or a timer period,
+ *         - ADC triggers 1 to 4 with their post-scaler, raised to the
+ *           simulated ADCs. Triggers 2 and 4 only decode master sources,
+ *         - repetition interrupts, raised to the simulated interrupt
+ *           controller,
+ *         - burst DMA on repetition events: the words of the simulated DMA 2
+ *           channel attached to the HRTIM request are written to the
+ *           selected period, repetition and compare preload registers.
+ *
+ *         Registers written through the LL functions take effect at the
+ *         current simulated time; those written directly, such as
+ *         compares, at the next HRTIM event, which preload makes the same.
+ *         External events, faults and captures are not simulated.
+ *
+ *         The averaged mode, see sim_hrtim_set_averaged(), only raises the
+ *         events seen by code and plants, so that a control loop runs
+ *         faster than the switching frequency costs.
+ */
+
+#ifndef SIM_HRTIM_H_
+#define SIM_HRTIM_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+#include <stdbool.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* High resolution clock: 170MHz x 32, a tick is about 184ps */
+#define SIM_HRTIM_TICKS_PER_SECOND 5440000000ULL
+
+/* Outputs are numbered from 0 for TA1 to 11 for TF2 */
+#define SIM_HRTIM_OUTPUTS_COUNT 12
+
+typedef struct
+{
+	uint64_t tick;   /* HRTIM tick of the edge */
+	uint8_t  output; /* Output number, between 0 and 11 */
+	bool     level;  /* Output level after the edge */
+} sim_hrtim_edge_t;
+
+typedef void (*sim_hrtim_edge_handler_t)(const sim_hrtim_edge_t* edge,
+                                         void* arg);
+
+
+/**
+ * @brief Sets the function receiving each edge of the HRTIM outputs, as
+ *        seen on the pins: after dead time, swap, burst mode and output
+ *        enable.
+ *
+ * @param handler Edge handler, nullptr to remove it.
+ * @param arg     Passed to the handler.
+ */
+void sim_hrtim_set_edge_handler(sim_hrtim_edge_handler_t handler, void* arg);
+
+/**
+ * @brief Returns the current level of an HRTIM output pin.
+ *
+ * @param output Output number, between 0 and 11.
+ */
+bool sim_hrtim_get_output(uint8_t output);
+
+/**
+ * @brief Returns the HRTIM tick of the current simulated time.
+ */
+uint64_t sim_hrtim_get_tick();
+
+/**
+ * @brief Drives a power leg of the plant from a timing unit: at the end
+ *        of each timer period, the plant receives the share of the period
+ *        during which output 1 of the unit was high.
+ *
+ * @param leg         Power leg number, starting at 1. 0 disconnects the
+ *                    timing unit.
+ * @param timing_unit Timing unit, between 0 for timer A and 5 for timer F.
+ */
+void sim_hrtim_connect_leg(uint8_t leg, uint8_t timing_unit);
+
+/**
+ * @brief Selects the averaged mode, to call before configuring the HRTIM.
+ *
+ *        Counters then run period by period, and the simulated HRTIM only
+ *        wakes up for ADC triggers, repetition interrupts, and the first
+ *        repetition event after code ran, which transfers the registers
+ *        it may have written. Plant legs receive the duty cycle computed
+ *        from the active registers of their timer, each time they change:
+ *        own compare and period events through the crossbar, dead time,
+ *        output swap and output enable.
+ *
+ *        ADC triggers decode the master compares and period, and the
+ *        compares, period and rollover of the timers. Timer resets, master
+ *        and other timer events on the outputs, burst mode, master update
+ *        and burst DMA are not simulated, and the edge handler and output
+ *        pins are not updated.
+ *
+ * @param enable true for the averaged mode, false for the tick level model
+ *               (default).
+ */
+void sim_hrtim_set_averaged(bool enable);
+
+/**
+ * @brief Tells whether an ADC trigger of the HRTIM has a source selected,
+ *        e.g. once the Power API configured a leg. The HRTIM then triggers
+ *        the ADCs itself, and the simulated critical task does not set a
+ *        trigger period, see sim_adc_set_trigger_period_ns().
+ */
+bool sim_hrtim_is_triggering_adcs();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_HRTIM_H_ */
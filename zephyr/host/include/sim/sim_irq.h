@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Simulated interrupt controller of the host build.
+ *
+ *         Handlers connected with irq_connect_dynamic() run synchronously
+ *         when their line is raised, unless the line is disabled, the
+ *         interrupts are locked with irq_lock() or another handler is
+ *         running. The line then stays pending, and runs as soon as this
+ *         is no longer the case, highest priority first. Handlers never
+ *         preempt each other.
+ */
+
+#ifndef SIM_IRQ_H_
+#define SIM_IRQ_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+#include <stdbool.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define SIM_IRQ_LINES_COUNT 102
+
+
+/**
+ * @brief Raises an interrupt line, as a peripheral does.
+ *
+ * @param irq Interrupt line number.
+ */
+void sim_irq_raise(unsigned int irq);
+
+/**
+ * @brief Indicates whether an interrupt line is pending.
+ *
+ * @param irq Interrupt line number.
+ */
+bool sim_irq_is_pending(unsigned int irq);
+
+/**
+ * @brief Clears a pending interrupt line without running its handler.
+ *
+ * @param irq Interrupt line number.
+ */
+void sim_irq_clear_pending(unsigned int irq);
+
+/**
+ * @brief Disconnects all handlers and clears all lines.
+ */
+void sim_irq_reset();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_IRQ_H_ */
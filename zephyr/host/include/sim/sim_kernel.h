@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Simulated kernel of the host build: runs Zephyr threads, timers,
+ *         semaphores and simulated peripheral events in simulated time.
+ *
+ *         Code takes no simulated time to run. Threads run one at a time
+ *         until they block (sleep, semaphore, timer) or yield, then the
+ *         simulated time jumps to the next event, so that simulations run
+ *         as fast as the host allows and always give the same result.
+ *
+ *         Peripheral events, such as the critical task interrupt, run
+ *         between two thread executions: they never preempt a thread in
+ *         the middle of its code. A thread that yields without blocking
+ *         runs again after the next event.
+ */
+
+#ifndef SIM_KERNEL_H_
+#define SIM_KERNEL_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+#include <stdbool.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef void (*sim_event_handler_t)(void* arg);
+
+/**
+ * @brief Event raised at a given simulated time, e.g. by a peripheral.
+ *        Handlers run as interrupts do, outside of any thread. Events due
+ *        at the same time run by increasing priority.
+ */
+typedef struct
+{
+	sim_event_handler_t handler;
+	void*    arg;
+	int      priority;
+	uint64_t time_ns;
+	bool     scheduled;
+} sim_event_t;
+
+/* Priorities of the built-in events at a same time */
+#define SIM_EVENT_PRIORITY_CRITICAL_TASK 0
+#define SIM_EVENT_PRIORITY_ADC_TRIGGER   1
+#define SIM_EVENT_PRIORITY_HRTIM         2
+
+
+/**
+ * @brief Schedules an event, replacing its previous schedule if any.
+ *
+ * @param event   Event, must stay valid until raised or cancelled.
+ * @param time_ns Simulated time at which to raise the event. Events in
+ *                the past are raised at the next step.
+ */
+void sim_event_schedule(sim_event_t* event, uint64_t time_ns);
+
+/**
+ * @brief Cancels a scheduled event.
+ */
+void sim_event_cancel(sim_event_t* event);
+
+/**
+ * @brief Tells whether nothing but the caller has to run until a simulated
+ *        time: no ready or yielded thread, no timer, wake-up or event due
+ *        until then included, and the time is not past the end of the
+ *        current run.
+ *
+ *        An event handler that repeats at a fixed period can then process
+ *        its next periods right away, advancing the simulated time itself,
+ *        instead of going through the kernel for each of them.
+ *
+ * @param time_ns Simulated time.
+ */
+bool sim_kernel_is_idle_until(uint64_t time_ns);
+
+/**
+ * @brief Returns the simulated time at which something else than the
+ *        caller may run next: the current time if a thread is ready or
+ *        yielded, else the next timer, wake-up or event, or the end of the
+ *        current run.
+ *
+ *        A peripheral whose registers are only written by code can then
+ *        wait until this time before looking at them again.
+ */
+uint64_t sim_kernel_get_idle_end();
+
+/**
+ * @brief Runs the simulation until a simulated time.
+ *
+ * @param end_ns Simulated time at which to stop.
+ */
+void sim_kernel_run_until(uint64_t end_ns);
+
+/**
+ * @brief Runs the simulation for a duration from the current simulated
+ *        time. Calling k_sleep() outside of a thread does the same.
+ *
+ * @param duration_ns Duration in nanoseconds.
+ */
+void sim_kernel_run_for(uint64_t duration_ns);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_KERNEL_H_ */
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Physical system connected to the simulated board.
+ *
+ *         The plant is stepped each time the simulated time moves, is
+ *         sampled by the simulated ADCs, and receives the duty cycles
+ *         applied to the power legs. Channels the plant does not drive
+ *         sample their synthetic waveform, see sim/sim_adc.h.
+ */
+
+#ifndef SIM_PLANT_H_
+#define SIM_PLANT_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+#include <stdbool.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct
+{
+	/**
+	 * @brief Moves the plant state forward. Time steps follow the
+	 *        simulation events, so they are not constant: plants with
+	 *        fast dynamics subdivide them.
+	 */
+	void (*step)(void* context, uint64_t duration_ns);
+
+	/**
+	 * @brief Gives the value sampled by an ADC channel, in ADC LSB.
+	 *
+	 * @return false if the plant does not drive this channel.
+	 */
+	bool (*sample)(void* context,
+				   uint8_t adc_number,
+				   uint8_t channel,
+				   float* value);
+
+	/**
+	 * @brief Receives the duty cycle, between 0 and 1, of a power leg.
+	 */
+	void (*set_duty_cycle)(void* context, uint8_t leg, float duty_cycle);
+
+	/* Passed to all functions */
+	void* context;
+} sim_plant_t;
+
+
+/**
+ * @brief Connects a plant to the simulated board, replacing the previous
+ *        one if any.
+ *
+ * @param plant Plant, must stay valid while connected. nullptr
+ *              disconnects the plant.
+ */
+void sim_plant_set(const sim_plant_t* plant);
+
+/**
+ * @brief Steps the plant, called when the simulated time moves.
+ *
+ * @param duration_ns Duration in nanoseconds.
+ */
+void sim_plant_step(uint64_t duration_ns);
+
+/**
+ * @brief Samples the plant for an ADC channel.
+ *
+ * @param adc_number Number of the ADC, between 1 and 5.
+ * @param channel    Number of the channel, between 1 and 19.
+ * @param value      Sampled value in ADC LSB, only set if the plant drives
+ *                   the channel.
+ *
+ * @return true if a plant is connected and drives the channel.
+ */
+bool sim_plant_sample(uint8_t adc_number, uint8_t channel, float* value);
+
+/**
+ * @brief Applies a duty cycle to a power leg of the plant.
+ *
+ * @param leg        Power leg number, starting at 1.
+ * @param duty_cycle Duty cycle between 0 and 1.
+ */
+void sim_plant_set_duty_cycle(uint8_t leg, float duty_cycle);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_PLANT_H_ */
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Plant models of the OwnTech power shields, to close the loop of
+ *         a control application on the host build.
+ *
+ *         - Twist: two legs sharing the high side bus, each one feeding a
+ *           low side LC filter. A source or a load can be connected on
+ *           each side, so that the legs work as buck (source on the high
+ *           side) or boost (source on a low side) converters.
+ *         - Ownverter: three-phase bridge on a DC bus, feeding a balanced
+ *           star-connected RL load with an optional back-EMF (motor or
+ *           grid).
+ *
+ *         Both come as an averaged model, or a switched model which
+ *         reproduces the ripple of a centered PWM. Models run with a fixed
+ *         step, a fraction of the switching period: one step per period
+ *         is enough for the averaged model, unless a source or a load
+ *         reacts faster than the period. The switched model needs enough
+ *         steps per period to show the ripple shape; duty cycles are not
+ *         rounded to the step. Dead times are not modelled.
+ *
+ *         Duty cycles are received as on the board: see
+ *         sim_plant_set_duty_cycle(). Each model drives the ADC channels of
+ *         its shield sensors, using the calibration gains and offsets of
+ *         the shield devicetree, so that the default conversion parameters
+ *         of the Data API give back the simulated quantities.
+ */
+
+#ifndef SIM_POWER_MODELS_H_
+#define SIM_POWER_MODELS_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+/* Simulator */
+#include "sim/sim_plant.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef enum
+{
+	sim_power_model_averaged,
+	sim_power_model_switched
+} sim_power_model_type_t;
+
+typedef struct
+{
+	sim_power_model_type_t type;
+	uint64_t switching_period_ns; /* 5000 for the default 200kHz PWM */
+	uint32_t steps_per_period;    /* 1 or more, e.g. 50 when switched */
+} sim_power_model_config_t;
+
+
+/* Twist */
+
+/**
+ * @brief Twist circuit. Resistances set to 0 mean the source or the load
+ *        is not connected.
+ */
+typedef struct
+{
+	sim_power_model_config_t model;
+
+	/* Legs, same for both */
+	float inductance;             /* H */
+	float inductor_resistance;    /* Ohm */
+	float low_capacitance;        /* F */
+
+	/* High side */
+	float high_capacitance;       /* F */
+	float high_source_voltage;    /* V */
+	float high_source_resistance; /* Ohm */
+	float high_load_resistance;   /* Ohm */
+
+	/* Low sides, one per leg */
+	float low_source_voltage[2];
+	float low_source_resistance[2];
+	float low_load_resistance[2];
+} sim_twist_parameters_t;
+
+typedef struct
+{
+	float v1_low;
+	float v2_low;
+	float v_high;
+	float i1_low; /* Inductor current, from the leg to the low side */
+	float i2_low;
+	float i_high; /* Current drawn from the high side by the legs */
+} sim_twist_measures_t;
+
+/**
+ * @brief Gives typical Twist values, in buck mode: 48V source on the high
+ *        side, 10 Ohm loads on both low sides, averaged model at 200kHz.
+ */
+void sim_twist_get_default_parameters(sim_twist_parameters_t* parameters);
+
+/**
+ * @brief Initializes the Twist model, with all voltages and currents at 0.
+ *        Sensors are those of the Twist v1.4.1 devicetree.
+ *
+ * @return Plant to connect with sim_plant_set(), or nullptr if the
+ *         parameters are invalid.
+ */
+const sim_plant_t* sim_twist_init(const sim_twist_parameters_t* parameters);
+
+/**
+ * @brief Reads the simulated quantities, as measured by the shield sensors.
+ */
+void sim_twist_get_measures(sim_twist_measures_t* measures);
+
+
+/* Ownverter */
+
+typedef struct
+{
+	sim_power_model_config_t model;
+
+	/* DC bus */
+	float dc_capacitance;       /* F */
+	float dc_source_voltage;    /* V */
+	float dc_source_resistance; /* Ohm, 0 means no source */
+
+	/* Balanced load, per phase */
+	float phase_inductance;     /* H */
+	float phase_resistance;     /* Ohm */
+	float emf_amplitude;        /* Peak phase back-EMF, V */
+	float emf_frequency;        /* Hz */
+} sim_ownverter_parameters_t;
+
+typedef struct
+{
+	float v1_low; /* Leg output voltage, from the DC bus negative side */
+	float v2_low;
+	float v3_low;
+	float v_high;
+	float i1_low; /* Phase current, from the leg to the load */
+	float i2_low;
+	float i3_low;
+	float i_high; /* Current drawn from the DC bus by the legs */
+} sim_ownverter_measures_t;
+
+/**
+ * @brief Gives typical Ownverter values: 48V DC source, 1mH and 1 Ohm per
+ *        phase without back-EMF, averaged model at 200kHz.
+ */
+void sim_ownverter_get_default_parameters(sim_ownverter_parameters_t* parameters);
+
+/**
+ * @brief Initializes the Ownverter model, with all voltages and currents
+ *        at 0. Sensors are those of the Ownverter v1.1.0 devicetree.
+ *
+ * @return Plant to connect with sim_plant_set(), or nullptr if the
+ *         parameters are invalid.
+ */
+const sim_plant_t* sim_ownverter_init(const sim_ownverter_parameters_t* parameters);
+
+/**
+ * @brief Reads the simulated quantities, as measured by the shield sensors.
+ */
+void sim_ownverter_get_measures(sim_ownverter_measures_t* measures);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_POWER_MODELS_H_ */
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Simulated scheduling of the critical task in the host build.
+ *
+ *         The Task API is built from the module sources, except for the
+ *         critical task, whose interrupt sources are replaced by simulated
+ *         kernel events. As on the target, HRTIM and ADC sources run the
+ *         task every given number of HRTIM periods, and the ADC source runs
+ *         it once the conversions of its ADC are done. The HRTIM triggers
+ *         the ADCs at each of its periods while the critical task runs,
+ *         unless the simulated HRTIM triggers them, see sim/sim_hrtim.h.
+ */
+
+#ifndef SIM_TASK_H_
+#define SIM_TASK_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* 200kHz, default PWM frequency of the Spin board */
+#define SIM_TASK_DEFAULT_HRTIM_PERIOD_NS 5000
+
+
+/**
+ * @brief Sets the period of the simulated HRTIM, which paces the critical
+ *        task and the ADC triggers. Must be called before the critical
+ *        task is defined.
+ *
+ * @param period_ns HRTIM period in nanoseconds, multiple of 1000.
+ */
+void sim_task_set_hrtim_period_ns(uint64_t period_ns);
+
+/**
+ * @brief Returns the period of the simulated HRTIM.
+ */
+uint64_t sim_task_get_hrtim_period_ns();
+
+/**
+ * @brief Gives a simulated execution time to the code of the critical task
+ *        calling it, as code takes no simulated time to run. The time adds
+ *        up until the end of the execution, which overruns the period if
+ *        the next period started by then.
+ *
+ * @param duration_ns Execution time in nanoseconds.
+ */
+void sim_task_consume_ns(uint64_t duration_ns);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_TASK_H_ */
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Simulated time of the host build. Time only moves when the
+ *         simulation advances it, so that runs are reproducible and
+ *         independent of the host speed.
+ */
+
+#ifndef SIM_TIME_H_
+#define SIM_TIME_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Returns the simulated time in nanoseconds.
+ */
+uint64_t sim_time_get_ns();
+
+/**
+ * @brief Moves the simulated time forward, stepping the plant if any.
+ *
+ * @param duration_ns Duration in nanoseconds.
+ */
+void sim_time_advance_ns(uint64_t duration_ns);
+
+/**
+ * @brief Sets the simulated time back to 0.
+ */
+void sim_time_reset();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_TIME_H_ */
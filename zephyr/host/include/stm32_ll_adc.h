@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the STM32 LL ADC header, limited to
+ *         what the ADC driver public API uses.
+ *
+ *         Trigger constants do not have their hardware values: an HRTIM
+ *         trigger is its trigger number, which is what the simulated ADC
+ *         core expects.
+ */
+
+#ifndef STM32_LL_ADC_H_
+#define STM32_LL_ADC_H_
+
+
+#include "stm32g4xx.h"
+
+
+#define LL_ADC_REG_TRIG_SOFTWARE       0U
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG1 1U
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG2 2U
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG3 3U
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG4 4U
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG5 5U
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG6 6U
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG7 7U
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG8 8U
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG9 9U
+
+#define LL_ADC_REG_TRIG_EXT_RISING     1U
+
+
+__STATIC_INLINE uint32_t LL_ADC_IsActiveFlag_EOS(ADC_TypeDef* ADCx)
+{
+	return ((ADCx->ISR & ADC_ISR_EOS) == ADC_ISR_EOS) ? 1U : 0U;
+}
+
+__STATIC_INLINE void LL_ADC_ClearFlag_EOS(ADC_TypeDef* ADCx)
+{
+	ADCx->ISR = ADCx->ISR & ~ADC_ISR_EOS;
+}
+
+__STATIC_INLINE void LL_ADC_EnableIT_EOS(ADC_TypeDef* ADCx)
+{
+	ADCx->IER = ADCx->IER | ADC_IER_EOSIE;
+}
+
+__STATIC_INLINE void LL_ADC_DisableIT_EOS(ADC_TypeDef* ADCx)
+{
+	ADCx->IER = ADCx->IER & ~ADC_IER_EOSIE;
+}
+
+
+#endif /* STM32_LL_ADC_H_ */
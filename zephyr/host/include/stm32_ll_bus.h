@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the STM32 LL bus header, limited to
+ *         what the HRTIM driver uses. Clocks are always running on the
+ *         host: enabling one only sets its bit.
+ */
+
+#ifndef STM32_LL_BUS_H_
+#define STM32_LL_BUS_H_
+
+
+#include "stm32g4xx.h"
+
+
+#define LL_AHB1_GRP1_PERIPH_DMA2     (1U << 1)
+#define LL_AHB1_GRP1_PERIPH_DMAMUX1  (1U << 2)
+
+#define LL_AHB2_GRP1_PERIPH_GPIOA    (1U << 0)
+#define LL_AHB2_GRP1_PERIPH_GPIOB    (1U << 1)
+#define LL_AHB2_GRP1_PERIPH_GPIOC    (1U << 2)
+
+#define LL_APB2_GRP1_PERIPH_HRTIM1   (1U << 26)
+
+
+__STATIC_INLINE void LL_AHB1_GRP1_EnableClock(uint32_t Periphs)
+{
+	RCC->AHB1ENR = RCC->AHB1ENR | Periphs;
+}
+
+__STATIC_INLINE void LL_AHB2_GRP1_EnableClock(uint32_t Periphs)
+{
+	RCC->AHB2ENR = RCC->AHB2ENR | Periphs;
+}
+
+__STATIC_INLINE void LL_APB2_GRP1_EnableClock(uint32_t Periphs)
+{
+	RCC->APB2ENR = RCC->APB2ENR | Periphs;
+}
+
+
+#endif /* STM32_LL_BUS_H_ */
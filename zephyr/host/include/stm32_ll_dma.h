@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the STM32 LL DMA header, limited to
+ *         what the data acquisition pipeline and the HRTIM driver use.
+ *
+ *         The data acquisition pipeline drives DMA 1 through the Zephyr
+ *         DMA API, see sim/sim_dma.h. The functions below only access the
+ *         registers, except that enabling a DMA 2 channel latches its
+ *         address and count, as the target does, for the transfers of
+ *         sim_dma2_transfer().
+ */
+
+#ifndef STM32_LL_DMA_H_
+#define STM32_LL_DMA_H_
+
+
+#include "stm32g4xx.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Latches the memory address and count of a DMA 2 channel. Called
+ *        by LL_DMA_EnableChannel().
+ */
+void sim_dma2_channel_enabled(uint32_t channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+/* DMAMUX requests, same values as on the target */
+#define LL_DMAMUX_REQ_ADC1 5U
+#define LL_DMAMUX_REQ_ADC2 36U
+#define LL_DMAMUX_REQ_ADC3 37U
+#define LL_DMAMUX_REQ_ADC4 38U
+#define LL_DMAMUX_REQ_ADC5 39U
+
+#define LL_DMAMUX_REQ_HRTIM1_M 95U
+#define LL_DMAMUX_REQ_HRTIM1_A 96U
+#define LL_DMAMUX_REQ_HRTIM1_B 97U
+#define LL_DMAMUX_REQ_HRTIM1_C 98U
+#define LL_DMAMUX_REQ_HRTIM1_D 99U
+#define LL_DMAMUX_REQ_HRTIM1_E 100U
+#define LL_DMAMUX_REQ_HRTIM1_F 101U
+
+#define LL_DMA_CHANNEL_1 0U
+
+/* Transfer configuration, same values as on the target */
+#define LL_DMA_DIRECTION_MEMORY_TO_PERIPH (1U << 4)
+#define LL_DMA_MODE_CIRCULAR              (1U << 5)
+#define LL_DMA_PERIPH_NOINCREMENT         0U
+#define LL_DMA_MEMORY_INCREMENT           (1U << 7)
+#define LL_DMA_PDATAALIGN_WORD            (2U << 8)
+#define LL_DMA_MDATAALIGN_WORD            (2U << 10)
+#define LL_DMA_PRIORITY_VERYHIGH          (3U << 12)
+
+#define LL_DMA_CCR_CONFIGURATION (0x7FF0U)
+
+
+__STATIC_INLINE uint32_t LL_DMA_GetDataLength(DMA_TypeDef* DMAx,
+											  uint32_t Channel)
+{
+	return DMAx->channels[Channel].CNDTR;
+}
+
+__STATIC_INLINE void LL_DMA_DisableIT_HT(DMA_TypeDef* DMAx, uint32_t Channel)
+{
+	DMAx->channels[Channel].CCR = DMAx->channels[Channel].CCR & ~DMA_CCR_HTIE;
+}
+
+__STATIC_INLINE void LL_DMA_EnableIT_TC(DMA_TypeDef* DMAx, uint32_t Channel)
+{
+	DMAx->channels[Channel].CCR = DMAx->channels[Channel].CCR | DMA_CCR_TCIE;
+}
+
+__STATIC_INLINE void LL_DMA_DisableIT_TC(DMA_TypeDef* DMAx, uint32_t Channel)
+{
+	DMAx->channels[Channel].CCR = DMAx->channels[Channel].CCR & ~DMA_CCR_TCIE;
+}
+
+__STATIC_INLINE void LL_DMA_ConfigTransfer(DMA_TypeDef* DMAx,
+                                           uint32_t Channel,
+                                           uint32_t Configuration)
+{
+	DMAx->channels[Channel].CCR =
+		(DMAx->channels[Channel].CCR & ~LL_DMA_CCR_CONFIGURATION) | Configuration;
+}
+
+/* Addresses are host addresses, given as uintptr_t as on the target */
+__STATIC_INLINE void LL_DMA_ConfigAddresses(DMA_TypeDef* DMAx,
+                                            uint32_t Channel,
+                                            uintptr_t SrcAddress,
+                                            uintptr_t DstAddress,
+                                            uint32_t Direction)
+{
+	if (Direction == LL_DMA_DIRECTION_MEMORY_TO_PERIPH)
+	{
+		DMAx->channels[Channel].CMAR = SrcAddress;
+		DMAx->channels[Channel].CPAR = DstAddress;
+	}
+	else
+	{
+		DMAx->channels[Channel].CPAR = SrcAddress;
+		DMAx->channels[Channel].CMAR = DstAddress;
+	}
+}
+
+__STATIC_INLINE void LL_DMA_SetMemoryAddress(DMA_TypeDef* DMAx,
+                                             uint32_t Channel,
+                                             uintptr_t MemoryAddress)
+{
+	DMAx->channels[Channel].CMAR = MemoryAddress;
+}
+
+__STATIC_INLINE void LL_DMA_SetDataLength(DMA_TypeDef* DMAx,
+                                          uint32_t Channel,
+                                          uint32_t NbData)
+{
+	DMAx->channels[Channel].CNDTR = NbData;
+}
+
+__STATIC_INLINE void LL_DMA_SetPeriphRequest(DMA_TypeDef* DMAx,
+                                             uint32_t Channel,
+                                             uint32_t Request)
+{
+	uint32_t dmamux_channel = (DMAx == DMA2) ? Channel + 8 : Channel;
+
+	sim_dmamux1_channels[dmamux_channel].CCR =
+		(sim_dmamux1_channels[dmamux_channel].CCR & ~DMAMUX_CxCR_DMAREQ_ID) |
+		Request;
+}
+
+__STATIC_INLINE void LL_DMA_EnableChannel(DMA_TypeDef* DMAx, uint32_t Channel)
+{
+	DMAx->channels[Channel].CCR = DMAx->channels[Channel].CCR | DMA_CCR_EN;
+
+	if (DMAx == DMA2)
+	{
+		sim_dma2_channel_enabled(Channel);
+	}
+}
+
+__STATIC_INLINE void LL_DMA_DisableChannel(DMA_TypeDef* DMAx, uint32_t Channel)
+{
+	DMAx->channels[Channel].CCR = DMAx->channels[Channel].CCR & ~DMA_CCR_EN;
+}
+
+
+__STATIC_INLINE uint32_t LL_DMA_IsActiveFlag_TC1(DMA_TypeDef* DMAx)
+{
+	return (DMAx->ISR & DMA_ISR_TCIF1) != 0;
+}
+
+/* The write to IFCR clears the flag at once */
+__STATIC_INLINE void LL_DMA_ClearFlag_TC1(DMA_TypeDef* DMAx)
+{
+	DMAx->IFCR = DMA_ISR_TCIF1;
+	DMAx->ISR  = DMAx->ISR & ~DMA_ISR_TCIF1;
+}
+
+
+#endif /* STM32_LL_DMA_H_ */
@@ -0,0 +1,902 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the STM32 LL HRTIM header, limited to
+ *         what the HRTIM driver uses.
+ *
+ *         Constants have their hardware values, so that the registers hold
+ *         what they would hold on target. Functions write the registers of
+ *         the simulated HRTIM, then let it react at once, see
+ *         sim/sim_hrtim.h.
+ */
+
+#ifndef STM32_LL_HRTIM_H_
+#define STM32_LL_HRTIM_H_
+
+
+#include "stm32g4xx.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Applies the registers written at the current simulated time.
+ *        Called by all the functions below that write a register.
+ */
+void sim_hrtim_registers_written();
+
+
+/* Timers */
+#define LL_HRTIM_TIMER_MASTER HRTIM_MCR_MCEN
+#define LL_HRTIM_TIMER_A      HRTIM_MCR_TACEN
+#define LL_HRTIM_TIMER_B      HRTIM_MCR_TBCEN
+#define LL_HRTIM_TIMER_C      HRTIM_MCR_TCCEN
+#define LL_HRTIM_TIMER_D      HRTIM_MCR_TDCEN
+#define LL_HRTIM_TIMER_E      HRTIM_MCR_TECEN
+#define LL_HRTIM_TIMER_F      HRTIM_MCR_TFCEN
+
+/* Outputs */
+#define LL_HRTIM_OUTPUT_TA1 (1U << 0)
+#define LL_HRTIM_OUTPUT_TA2 (1U << 1)
+#define LL_HRTIM_OUTPUT_TB1 (1U << 2)
+#define LL_HRTIM_OUTPUT_TB2 (1U << 3)
+#define LL_HRTIM_OUTPUT_TC1 (1U << 4)
+#define LL_HRTIM_OUTPUT_TC2 (1U << 5)
+#define LL_HRTIM_OUTPUT_TD1 (1U << 6)
+#define LL_HRTIM_OUTPUT_TD2 (1U << 7)
+#define LL_HRTIM_OUTPUT_TE1 (1U << 8)
+#define LL_HRTIM_OUTPUT_TE2 (1U << 9)
+#define LL_HRTIM_OUTPUT_TF1 (1U << 10)
+#define LL_HRTIM_OUTPUT_TF2 (1U << 11)
+
+/* Counter */
+#define LL_HRTIM_MODE_CONTINUOUS       HRTIM_MCR_CONT
+#define LL_HRTIM_COUNTING_MODE_UP      0U
+#define LL_HRTIM_COUNTING_MODE_UP_DOWN HRTIM_TIMCR2_UDM
+#define LL_HRTIM_UPDATETRIG_REPETITION HRTIM_TIMCR_TREPU
+#define LL_HRTIM_UPDATETRIG_MASTER     HRTIM_TIMCR_MSTU
+
+#define LL_HRTIM_ROLLOVER_MODE_BOTH 0U
+#define LL_HRTIM_ROLLOVER_MODE_PER  (1U << 6)
+#define LL_HRTIM_ROLLOVER_MODE_RST  (1U << 7)
+
+/* Timer reset triggers */
+#define LL_HRTIM_RESETTRIG_MASTER_PER  HRTIM_RSTR_MSTPER
+#define LL_HRTIM_RESETTRIG_MASTER_CMP1 (HRTIM_RSTR_MSTCMP1 << 0)
+#define LL_HRTIM_RESETTRIG_MASTER_CMP2 (HRTIM_RSTR_MSTCMP1 << 1)
+#define LL_HRTIM_RESETTRIG_MASTER_CMP3 (HRTIM_RSTR_MSTCMP1 << 2)
+#define LL_HRTIM_RESETTRIG_MASTER_CMP4 (HRTIM_RSTR_MSTCMP1 << 3)
+#define LL_HRTIM_RESETTRIG_OTHER1_CMP1 (HRTIM_RSTR_OTHER1_CMP1 << 0)
+#define LL_HRTIM_RESETTRIG_OTHER1_CMP2 (HRTIM_RSTR_OTHER1_CMP1 << 1)
+#define LL_HRTIM_RESETTRIG_OTHER1_CMP4 (HRTIM_RSTR_OTHER1_CMP1 << 2)
+
+/* Output set and reset sources */
+#define LL_HRTIM_OUTPUTSET_NONE     0U
+#define LL_HRTIM_OUTPUTSET_TIMPER   HRTIM_SET1R_PER
+#define LL_HRTIM_OUTPUTSET_TIMCMP1  (HRTIM_SET1R_CMP1 << 0)
+#define LL_HRTIM_OUTPUTSET_TIMCMP2  (HRTIM_SET1R_CMP1 << 1)
+#define LL_HRTIM_OUTPUTSET_TIMCMP3  (HRTIM_SET1R_CMP1 << 2)
+#define LL_HRTIM_OUTPUTSET_TIMCMP4  (HRTIM_SET1R_CMP1 << 3)
+
+#define LL_HRTIM_OUTPUTRESET_NONE    0U
+#define LL_HRTIM_OUTPUTRESET_TIMPER  HRTIM_SET1R_PER
+#define LL_HRTIM_OUTPUTRESET_TIMCMP1 (HRTIM_SET1R_CMP1 << 0)
+#define LL_HRTIM_OUTPUTRESET_TIMCMP2 (HRTIM_SET1R_CMP1 << 1)
+#define LL_HRTIM_OUTPUTRESET_TIMCMP3 (HRTIM_SET1R_CMP1 << 2)
+#define LL_HRTIM_OUTPUTRESET_TIMCMP4 (HRTIM_SET1R_CMP1 << 3)
+#define LL_HRTIM_OUTPUTRESET_EEV_1   (1U << 21)
+#define LL_HRTIM_OUTPUTRESET_EEV_2   (1U << 22)
+#define LL_HRTIM_OUTPUTRESET_EEV_3   (1U << 23)
+#define LL_HRTIM_OUTPUTRESET_EEV_4   (1U << 24)
+#define LL_HRTIM_OUTPUTRESET_EEV_5   (1U << 25)
+#define LL_HRTIM_OUTPUTRESET_EEV_6   (1U << 26)
+#define LL_HRTIM_OUTPUTRESET_EEV_7   (1U << 27)
+#define LL_HRTIM_OUTPUTRESET_EEV_8   (1U << 28)
+#define LL_HRTIM_OUTPUTRESET_EEV_9   (1U << 29)
+
+/* Output idle state */
+#define LL_HRTIM_OUT_IDLE_WHEN_BURST    HRTIM_OUTR_IDLM1
+#define LL_HRTIM_OUT_IDLELEVEL_INACTIVE 0U
+
+/* ADC triggers */
+#define LL_HRTIM_ADCTRIG_1  0U
+#define LL_HRTIM_ADCTRIG_2  1U
+#define LL_HRTIM_ADCTRIG_3  2U
+#define LL_HRTIM_ADCTRIG_4  3U
+#define LL_HRTIM_ADCTRIG_5  4U
+#define LL_HRTIM_ADCTRIG_6  5U
+#define LL_HRTIM_ADCTRIG_7  6U
+#define LL_HRTIM_ADCTRIG_8  7U
+#define LL_HRTIM_ADCTRIG_9  8U
+#define LL_HRTIM_ADCTRIG_10 9U
+
+#define LL_HRTIM_ADCTRIG_SRC13_TIMACMP3 (1U << 11)
+#define LL_HRTIM_ADCTRIG_SRC13_TIMBCMP3 (1U << 16)
+#define LL_HRTIM_ADCTRIG_SRC13_TIMCCMP3 (1U << 21)
+#define LL_HRTIM_ADCTRIG_SRC13_TIMDCMP3 (1U << 25)
+#define LL_HRTIM_ADCTRIG_SRC13_TIMECMP3 (1U << 29)
+#define LL_HRTIM_ADCTRIG_SRC13_TIMFCMP3 (1U << 15)
+
+#define LL_HRTIM_ADCTRIG_UPDATE_TIMER_A (1U << 16)
+#define LL_HRTIM_ADCTRIG_UPDATE_TIMER_B (2U << 16)
+#define LL_HRTIM_ADCTRIG_UPDATE_TIMER_C (3U << 16)
+#define LL_HRTIM_ADCTRIG_UPDATE_TIMER_D (4U << 16)
+#define LL_HRTIM_ADCTRIG_UPDATE_TIMER_E (5U << 16)
+#define LL_HRTIM_ADCTRIG_UPDATE_TIMER_F (6U << 16)
+
+/* Burst mode */
+#define LL_HRTIM_BM_PRESCALER_DIV1  0U
+#define LL_HRTIM_BM_TRIG_NONE       0U
+#define LL_HRTIM_BM_MODE_CONTINOUS  HRTIM_BMCR_BMOM
+#define LL_HRTIM_BM_CLKSRC_MASTER   (0x0U << 2)
+#define LL_HRTIM_BM_CLKSRC_TIMER_A  (0x1U << 2)
+#define LL_HRTIM_BM_CLKSRC_TIMER_B  (0x2U << 2)
+#define LL_HRTIM_BM_CLKSRC_TIMER_C  (0x3U << 2)
+#define LL_HRTIM_BM_CLKSRC_TIMER_D  (0x4U << 2)
+#define LL_HRTIM_BM_CLKSRC_TIMER_E  (0x5U << 2)
+#define LL_HRTIM_BM_CLKSRC_TIMER_F  (0xBU << 2)
+
+/* Burst DMA, same bits for the master and the timers */
+#define LL_HRTIM_BURSTDMA_TIMPER  (1U << 4)
+#define LL_HRTIM_BURSTDMA_TIMREP  (1U << 5)
+#define LL_HRTIM_BURSTDMA_TIMCMP1 (1U << 6)
+#define LL_HRTIM_BURSTDMA_TIMCMP2 (1U << 7)
+#define LL_HRTIM_BURSTDMA_TIMCMP3 (1U << 8)
+#define LL_HRTIM_BURSTDMA_TIMCMP4 (1U << 9)
+
+/* Synchronization */
+#define LL_HRTIM_SYNCIN_SRC_NONE           0U
+#define LL_HRTIM_SYNCIN_SRC_EXTERNAL_EVENT (0x3U << 8)
+#define LL_HRTIM_SYNCOUT_POSITIVE_PULSE    (0x2U << 12)
+
+/* External events */
+#define LL_HRTIM_EVENT_4              (1U << 3)
+#define LL_HRTIM_EVENT_5              (1U << 4)
+#define LL_HRTIM_EEV4SRC_COMP1_OUT    1U
+#define LL_HRTIM_EEV5SRC_COMP3_OUT    1U
+#define LL_HRTIM_EE_POLARITY_HIGH     0U
+#define LL_HRTIM_EE_SENSITIVITY_LEVEL 0U
+#define LL_HRTIM_EE_FASTMODE_DISABLE  0U
+
+/* Dual channel DAC triggers */
+#define LL_HRTIM_DCDR_COUNTER 0U
+#define LL_HRTIM_DCDS_CMP2    0U
+
+/* DLL calibration */
+#define LL_HRTIM_DLLCALIBRATION_MODE_CONTINUOUS HRTIM_DLLCR_CALEN
+#define LL_HRTIM_DLLCALIBRATION_RATE_3          (0x3U << 2)
+
+
+/* Register access helpers, not part of the LL API */
+
+__STATIC_INLINE HRTIM_Timerx_TypeDef* sim_ll_hrtim_timer(HRTIM_TypeDef* HRTIMx,
+                                                         uint32_t Timer)
+{
+	return &HRTIMx->sTimerxRegs[__builtin_ctz(Timer) - 17];
+}
+
+__STATIC_INLINE HRTIM_Timerx_TypeDef* sim_ll_hrtim_output_timer(HRTIM_TypeDef* HRTIMx,
+                                                                uint32_t Output)
+{
+	return &HRTIMx->sTimerxRegs[__builtin_ctz(Output) / 2];
+}
+
+/* Output 2 fields are output 1 fields shifted by 16 */
+__STATIC_INLINE uint32_t sim_ll_hrtim_output_shift(uint32_t Output)
+{
+	return (__builtin_ctz(Output) % 2) * 16;
+}
+
+__STATIC_INLINE void sim_ll_hrtim_modify(__IO uint32_t* reg,
+                                         uint32_t clear,
+                                         uint32_t set)
+{
+	*reg = (*reg & ~clear) | set;
+	sim_hrtim_registers_written();
+}
+
+
+/* Timers */
+
+__STATIC_INLINE void LL_HRTIM_TIM_CounterEnable(HRTIM_TypeDef* HRTIMx,
+                                                uint32_t Timers)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sMasterRegs.MCR, 0, Timers);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_CounterDisable(HRTIM_TypeDef* HRTIMx,
+                                                 uint32_t Timers)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sMasterRegs.MCR, Timers, 0);
+}
+
+/* Master MCR and timer TIMxCR share the fields below */
+__STATIC_INLINE __IO uint32_t* sim_ll_hrtim_cr(HRTIM_TypeDef* HRTIMx,
+                                               uint32_t Timer)
+{
+	if (Timer == LL_HRTIM_TIMER_MASTER)
+		return &HRTIMx->sMasterRegs.MCR;
+
+	return &sim_ll_hrtim_timer(HRTIMx, Timer)->TIMxCR;
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetPrescaler(HRTIM_TypeDef* HRTIMx,
+                                               uint32_t Timer,
+                                               uint32_t Prescaler)
+{
+	sim_ll_hrtim_modify(sim_ll_hrtim_cr(HRTIMx, Timer), HRTIM_MCR_CK_PSC, Prescaler);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetCounterMode(HRTIM_TypeDef* HRTIMx,
+                                                 uint32_t Timer,
+                                                 uint32_t Mode)
+{
+	sim_ll_hrtim_modify(sim_ll_hrtim_cr(HRTIMx, Timer),
+	                    HRTIM_MCR_CONT | HRTIM_MCR_RETRIG,
+	                    Mode);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_EnablePreload(HRTIM_TypeDef* HRTIMx,
+                                                uint32_t Timer)
+{
+	sim_ll_hrtim_modify(sim_ll_hrtim_cr(HRTIMx, Timer), 0, HRTIM_MCR_PREEN);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetUpdateTrig(HRTIM_TypeDef* HRTIMx,
+                                                uint32_t Timer,
+                                                uint32_t UpdateTrig)
+{
+	if (Timer == LL_HRTIM_TIMER_MASTER)
+	{
+		uint32_t mrepu = (UpdateTrig & LL_HRTIM_UPDATETRIG_REPETITION) ?
+		                 HRTIM_MCR_MREPU : 0;
+		sim_ll_hrtim_modify(&HRTIMx->sMasterRegs.MCR, HRTIM_MCR_MREPU, mrepu);
+		return;
+	}
+
+	sim_ll_hrtim_modify(&sim_ll_hrtim_timer(HRTIMx, Timer)->TIMxCR,
+	                    HRTIM_TIMCR_TREPU | HRTIM_TIMCR_TRSTU | HRTIM_TIMCR_MSTU,
+	                    UpdateTrig);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetCountingMode(HRTIM_TypeDef* HRTIMx,
+                                                  uint32_t Timer,
+                                                  uint32_t Mode)
+{
+	if (Timer == LL_HRTIM_TIMER_MASTER)
+		return;
+
+	sim_ll_hrtim_modify(&sim_ll_hrtim_timer(HRTIMx, Timer)->TIMxCR2,
+	                    HRTIM_TIMCR2_UDM,
+	                    Mode);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetADCRollOverMode(HRTIM_TypeDef* HRTIMx,
+                                                     uint32_t Timer,
+                                                     uint32_t Mode)
+{
+	sim_ll_hrtim_modify(&sim_ll_hrtim_timer(HRTIMx, Timer)->TIMxCR2,
+	                    HRTIM_TIMCR2_ADROM,
+	                    Mode << 4);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetPeriod(HRTIM_TypeDef* HRTIMx,
+                                            uint32_t Timer,
+                                            uint32_t Period)
+{
+	if (Timer == LL_HRTIM_TIMER_MASTER)
+		HRTIMx->sMasterRegs.MPER = Period;
+	else
+		sim_ll_hrtim_timer(HRTIMx, Timer)->PERxR = Period;
+
+	sim_hrtim_registers_written();
+}
+
+__STATIC_INLINE uint32_t LL_HRTIM_TIM_GetPeriod(HRTIM_TypeDef* HRTIMx,
+                                                uint32_t Timer)
+{
+	if (Timer == LL_HRTIM_TIMER_MASTER)
+		return HRTIMx->sMasterRegs.MPER;
+
+	return sim_ll_hrtim_timer(HRTIMx, Timer)->PERxR;
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetRepetition(HRTIM_TypeDef* HRTIMx,
+                                                uint32_t Timer,
+                                                uint32_t Repetition)
+{
+	if (Timer == LL_HRTIM_TIMER_MASTER)
+		HRTIMx->sMasterRegs.MREP = Repetition;
+	else
+		sim_ll_hrtim_timer(HRTIMx, Timer)->REPxR = Repetition;
+
+	sim_hrtim_registers_written();
+}
+
+__STATIC_INLINE uint32_t LL_HRTIM_TIM_GetRepetition(HRTIM_TypeDef* HRTIMx,
+                                                    uint32_t Timer)
+{
+	if (Timer == LL_HRTIM_TIMER_MASTER)
+		return HRTIMx->sMasterRegs.MREP;
+
+	return sim_ll_hrtim_timer(HRTIMx, Timer)->REPxR;
+}
+
+/* Compare registers, numbered from 1 */
+__STATIC_INLINE void sim_ll_hrtim_set_compare(HRTIM_TypeDef* HRTIMx,
+                                              uint32_t Timer,
+                                              uint8_t compare,
+                                              uint32_t CompareValue)
+{
+	if (Timer == LL_HRTIM_TIMER_MASTER)
+	{
+		__IO uint32_t* mcmp[4] = { &HRTIMx->sMasterRegs.MCMP1R,
+		                           &HRTIMx->sMasterRegs.MCMP2R,
+		                           &HRTIMx->sMasterRegs.MCMP3R,
+		                           &HRTIMx->sMasterRegs.MCMP4R };
+		*mcmp[compare - 1] = CompareValue;
+	}
+	else
+	{
+		HRTIM_Timerx_TypeDef* timer = sim_ll_hrtim_timer(HRTIMx, Timer);
+		__IO uint32_t* cmp[4] = { &timer->CMP1xR, &timer->CMP2xR,
+		                          &timer->CMP3xR, &timer->CMP4xR };
+		*cmp[compare - 1] = CompareValue;
+	}
+
+	sim_hrtim_registers_written();
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetCompare1(HRTIM_TypeDef* HRTIMx,
+                                              uint32_t Timer,
+                                              uint32_t CompareValue)
+{
+	sim_ll_hrtim_set_compare(HRTIMx, Timer, 1, CompareValue);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetCompare2(HRTIM_TypeDef* HRTIMx,
+                                              uint32_t Timer,
+                                              uint32_t CompareValue)
+{
+	sim_ll_hrtim_set_compare(HRTIMx, Timer, 2, CompareValue);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetCompare3(HRTIM_TypeDef* HRTIMx,
+                                              uint32_t Timer,
+                                              uint32_t CompareValue)
+{
+	sim_ll_hrtim_set_compare(HRTIMx, Timer, 3, CompareValue);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetCompare4(HRTIM_TypeDef* HRTIMx,
+                                              uint32_t Timer,
+                                              uint32_t CompareValue)
+{
+	sim_ll_hrtim_set_compare(HRTIMx, Timer, 4, CompareValue);
+}
+
+__STATIC_INLINE uint32_t sim_ll_hrtim_get_compare(HRTIM_TypeDef* HRTIMx,
+                                                  uint32_t Timer,
+                                                  uint8_t compare)
+{
+	if (Timer == LL_HRTIM_TIMER_MASTER)
+	{
+		__IO uint32_t* mcmp[4] = { &HRTIMx->sMasterRegs.MCMP1R,
+		                           &HRTIMx->sMasterRegs.MCMP2R,
+		                           &HRTIMx->sMasterRegs.MCMP3R,
+		                           &HRTIMx->sMasterRegs.MCMP4R };
+		return *mcmp[compare - 1];
+	}
+
+	HRTIM_Timerx_TypeDef* timer = sim_ll_hrtim_timer(HRTIMx, Timer);
+	__IO uint32_t* cmp[4] = { &timer->CMP1xR, &timer->CMP2xR,
+	                          &timer->CMP3xR, &timer->CMP4xR };
+	return *cmp[compare - 1];
+}
+
+__STATIC_INLINE uint32_t LL_HRTIM_TIM_GetCompare1(HRTIM_TypeDef* HRTIMx,
+                                                  uint32_t Timer)
+{
+	return sim_ll_hrtim_get_compare(HRTIMx, Timer, 1);
+}
+
+__STATIC_INLINE uint32_t LL_HRTIM_TIM_GetCompare2(HRTIM_TypeDef* HRTIMx,
+                                                  uint32_t Timer)
+{
+	return sim_ll_hrtim_get_compare(HRTIMx, Timer, 2);
+}
+
+__STATIC_INLINE uint32_t LL_HRTIM_TIM_GetCompare3(HRTIM_TypeDef* HRTIMx,
+                                                  uint32_t Timer)
+{
+	return sim_ll_hrtim_get_compare(HRTIMx, Timer, 3);
+}
+
+__STATIC_INLINE uint32_t LL_HRTIM_TIM_GetCompare4(HRTIM_TypeDef* HRTIMx,
+                                                  uint32_t Timer)
+{
+	return sim_ll_hrtim_get_compare(HRTIMx, Timer, 4);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetResetTrig(HRTIM_TypeDef* HRTIMx,
+                                               uint32_t Timer,
+                                               uint32_t ResetTrig)
+{
+	sim_ll_hrtim_timer(HRTIMx, Timer)->RSTxR = ResetTrig;
+	sim_hrtim_registers_written();
+}
+
+__STATIC_INLINE uint32_t LL_HRTIM_TIM_GetResetTrig(HRTIM_TypeDef* HRTIMx,
+                                                   uint32_t Timer)
+{
+	return sim_ll_hrtim_timer(HRTIMx, Timer)->RSTxR;
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_EnableDeadTime(HRTIM_TypeDef* HRTIMx,
+                                                 uint32_t Timer)
+{
+	sim_ll_hrtim_modify(&sim_ll_hrtim_timer(HRTIMx, Timer)->OUTxR,
+	                    0,
+	                    HRTIM_OUTR_DTEN);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetBurstDMARegs(HRTIM_TypeDef* HRTIMx,
+                                                  uint32_t Timer,
+                                                  uint32_t Registers)
+{
+	__IO uint32_t* bdupr[7] = { &HRTIMx->sCommonRegs.BDMUPR,
+	                            &HRTIMx->sCommonRegs.BDTAUPR,
+	                            &HRTIMx->sCommonRegs.BDTBUPR,
+	                            &HRTIMx->sCommonRegs.BDTCUPR,
+	                            &HRTIMx->sCommonRegs.BDTDUPR,
+	                            &HRTIMx->sCommonRegs.BDTEUPR,
+	                            &HRTIMx->sCommonRegs.BDTFUPR };
+	*bdupr[__builtin_ctz(Timer) - 16] = Registers;
+	sim_hrtim_registers_written();
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetDualDacResetTrigger(HRTIM_TypeDef* HRTIMx,
+                                                         uint32_t Timer,
+                                                         uint32_t ResetTrigger)
+{
+	sim_ll_hrtim_modify(&sim_ll_hrtim_timer(HRTIMx, Timer)->TIMxCR2,
+	                    HRTIM_TIMCR2_DCDR,
+	                    ResetTrigger);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_SetDualDacStepTrigger(HRTIM_TypeDef* HRTIMx,
+                                                        uint32_t Timer,
+                                                        uint32_t StepTrigger)
+{
+	sim_ll_hrtim_modify(&sim_ll_hrtim_timer(HRTIMx, Timer)->TIMxCR2,
+	                    HRTIM_TIMCR2_DCDS,
+	                    StepTrigger);
+}
+
+__STATIC_INLINE void LL_HRTIM_TIM_EnableDualDacTrigger(HRTIM_TypeDef* HRTIMx,
+                                                       uint32_t Timer)
+{
+	sim_ll_hrtim_modify(&sim_ll_hrtim_timer(HRTIMx, Timer)->TIMxCR2,
+	                    0,
+	                    HRTIM_TIMCR2_DCDE);
+}
+
+__STATIC_INLINE void LL_HRTIM_SuspendUpdate(HRTIM_TypeDef* HRTIMx,
+                                            uint32_t Timers)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.CR1, 0, (Timers >> 16) & 0x7FU);
+}
+
+__STATIC_INLINE void LL_HRTIM_ResumeUpdate(HRTIM_TypeDef* HRTIMx,
+                                           uint32_t Timers)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.CR1, (Timers >> 16) & 0x7FU, 0);
+}
+
+
+/* Outputs */
+
+/* OENR holds the enable state of the outputs */
+__STATIC_INLINE void LL_HRTIM_EnableOutput(HRTIM_TypeDef* HRTIMx,
+                                           uint32_t Outputs)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.OENR, 0, Outputs);
+}
+
+__STATIC_INLINE void LL_HRTIM_DisableOutput(HRTIM_TypeDef* HRTIMx,
+                                            uint32_t Outputs)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.OENR, Outputs, 0);
+}
+
+__STATIC_INLINE void LL_HRTIM_EnableSwapOutputs(HRTIM_TypeDef* HRTIMx,
+                                                uint32_t Timer)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.CR2, 0, Timer >> 1);
+}
+
+__STATIC_INLINE void LL_HRTIM_DisableSwapOutputs(HRTIM_TypeDef* HRTIMx,
+                                                 uint32_t Timer)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.CR2, Timer >> 1, 0);
+}
+
+__STATIC_INLINE void LL_HRTIM_OUT_SetOutputSetSrc(HRTIM_TypeDef* HRTIMx,
+                                                  uint32_t Output,
+                                                  uint32_t SetSrc)
+{
+	HRTIM_Timerx_TypeDef* timer = sim_ll_hrtim_output_timer(HRTIMx, Output);
+
+	if (sim_ll_hrtim_output_shift(Output) == 0)
+		timer->SETx1R = SetSrc;
+	else
+		timer->SETx2R = SetSrc;
+
+	sim_hrtim_registers_written();
+}
+
+__STATIC_INLINE void LL_HRTIM_OUT_SetOutputResetSrc(HRTIM_TypeDef* HRTIMx,
+                                                    uint32_t Output,
+                                                    uint32_t ResetSrc)
+{
+	HRTIM_Timerx_TypeDef* timer = sim_ll_hrtim_output_timer(HRTIMx, Output);
+
+	if (sim_ll_hrtim_output_shift(Output) == 0)
+		timer->RSTx1R = ResetSrc;
+	else
+		timer->RSTx2R = ResetSrc;
+
+	sim_hrtim_registers_written();
+}
+
+__STATIC_INLINE void LL_HRTIM_OUT_SetIdleMode(HRTIM_TypeDef* HRTIMx,
+                                              uint32_t Output,
+                                              uint32_t IdleMode)
+{
+	uint32_t shift = sim_ll_hrtim_output_shift(Output);
+
+	sim_ll_hrtim_modify(&sim_ll_hrtim_output_timer(HRTIMx, Output)->OUTxR,
+	                    HRTIM_OUTR_IDLM1 << shift,
+	                    IdleMode << shift);
+}
+
+/* Outputs beyond TF2 are ignored, as passing a timer instead of an output */
+__STATIC_INLINE void LL_HRTIM_OUT_SetIdleLevel(HRTIM_TypeDef* HRTIMx,
+                                               uint32_t Output,
+                                               uint32_t IdleLevel)
+{
+	if (__builtin_ctz(Output) > 11)
+		return;
+
+	uint32_t shift = sim_ll_hrtim_output_shift(Output);
+
+	sim_ll_hrtim_modify(&sim_ll_hrtim_output_timer(HRTIMx, Output)->OUTxR,
+	                    HRTIM_OUTR_IDLES1 << shift,
+	                    IdleLevel << shift);
+}
+
+
+/* Dead time */
+
+__STATIC_INLINE void LL_HRTIM_DT_SetPrescaler(HRTIM_TypeDef* HRTIMx,
+                                              uint32_t Timer,
+                                              uint32_t Prescaler)
+{
+	sim_ll_hrtim_modify(&sim_ll_hrtim_timer(HRTIMx, Timer)->DTxR,
+	                    HRTIM_DTR_DTPRSC,
+	                    Prescaler);
+}
+
+__STATIC_INLINE void LL_HRTIM_DT_SetRisingValue(HRTIM_TypeDef* HRTIMx,
+                                                uint32_t Timer,
+                                                uint32_t RisingValue)
+{
+	sim_ll_hrtim_modify(&sim_ll_hrtim_timer(HRTIMx, Timer)->DTxR,
+	                    HRTIM_DTR_DTR,
+	                    RisingValue);
+}
+
+__STATIC_INLINE void LL_HRTIM_DT_SetFallingValue(HRTIM_TypeDef* HRTIMx,
+                                                 uint32_t Timer,
+                                                 uint32_t FallingValue)
+{
+	sim_ll_hrtim_modify(&sim_ll_hrtim_timer(HRTIMx, Timer)->DTxR,
+	                    HRTIM_DTR_DTF,
+	                    FallingValue << 16);
+}
+
+
+/* ADC triggers */
+
+/* Triggers 1 to 4 have a source register each, 5 to 10 a field of ADCER */
+__STATIC_INLINE void LL_HRTIM_SetADCTrigSrc(HRTIM_TypeDef* HRTIMx,
+                                            uint32_t ADCTrig,
+                                            uint32_t Src)
+{
+	__IO uint32_t* adcr[4] = { &HRTIMx->sCommonRegs.ADC1R,
+	                           &HRTIMx->sCommonRegs.ADC2R,
+	                           &HRTIMx->sCommonRegs.ADC3R,
+	                           &HRTIMx->sCommonRegs.ADC4R };
+	static const uint8_t adcer_shift[6] = { 0, 5, 10, 16, 21, 26 };
+
+	if (ADCTrig <= LL_HRTIM_ADCTRIG_4)
+	{
+		*adcr[ADCTrig] = Src;
+		sim_hrtim_registers_written();
+		return;
+	}
+
+	uint32_t shift = adcer_shift[ADCTrig - LL_HRTIM_ADCTRIG_5];
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.ADCER,
+	                    0x1FU << shift,
+	                    (Src & 0x1FU) << shift);
+}
+
+__STATIC_INLINE uint32_t LL_HRTIM_GetADCTrigSrc(HRTIM_TypeDef* HRTIMx,
+                                                uint32_t ADCTrig)
+{
+	__IO uint32_t* adcr[4] = { &HRTIMx->sCommonRegs.ADC1R,
+	                           &HRTIMx->sCommonRegs.ADC2R,
+	                           &HRTIMx->sCommonRegs.ADC3R,
+	                           &HRTIMx->sCommonRegs.ADC4R };
+	static const uint8_t adcer_shift[6] = { 0, 5, 10, 16, 21, 26 };
+
+	if (ADCTrig <= LL_HRTIM_ADCTRIG_4)
+		return *adcr[ADCTrig];
+
+	uint32_t shift = adcer_shift[ADCTrig - LL_HRTIM_ADCTRIG_5];
+	return (HRTIMx->sCommonRegs.ADCER >> shift) & 0x1FU;
+}
+
+__STATIC_INLINE void LL_HRTIM_SetADCTrigUpdate(HRTIM_TypeDef* HRTIMx,
+                                               uint32_t ADCTrig,
+                                               uint32_t Update)
+{
+	if (ADCTrig <= LL_HRTIM_ADCTRIG_4)
+	{
+		uint32_t shift = 3 * ADCTrig;
+		sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.CR1,
+		                    HRTIM_CR1_ADC1USRC << shift,
+		                    Update << shift);
+		return;
+	}
+
+	uint32_t shift = 4 * (ADCTrig - LL_HRTIM_ADCTRIG_5);
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.ADCUR,
+	                    0x7U << shift,
+	                    (Update >> 16) << shift);
+}
+
+__STATIC_INLINE void LL_HRTIM_SetADCPostScaler(HRTIM_TypeDef* HRTIMx,
+                                               uint32_t ADCTrig,
+                                               uint32_t PostScaler)
+{
+	__IO uint32_t* adcps = (ADCTrig < LL_HRTIM_ADCTRIG_6) ?
+	                       &HRTIMx->sCommonRegs.ADCPS1 :
+	                       &HRTIMx->sCommonRegs.ADCPS2;
+	uint32_t shift = 6 * (ADCTrig % 5);
+
+	sim_ll_hrtim_modify(adcps, 0x1FU << shift, (PostScaler & 0x1FU) << shift);
+}
+
+
+/* Interrupts, flags and DMA requests */
+
+__STATIC_INLINE __IO uint32_t* sim_ll_hrtim_dier(HRTIM_TypeDef* HRTIMx,
+                                                 uint32_t Timer)
+{
+	if (Timer == LL_HRTIM_TIMER_MASTER)
+		return &HRTIMx->sMasterRegs.MDIER;
+
+	return &sim_ll_hrtim_timer(HRTIMx, Timer)->TIMxDIER;
+}
+
+__STATIC_INLINE void LL_HRTIM_EnableIT_REP(HRTIM_TypeDef* HRTIMx,
+                                           uint32_t Timer)
+{
+	sim_ll_hrtim_modify(sim_ll_hrtim_dier(HRTIMx, Timer), 0, HRTIM_MDIER_MREPIE);
+}
+
+__STATIC_INLINE void LL_HRTIM_DisableIT_REP(HRTIM_TypeDef* HRTIMx,
+                                            uint32_t Timer)
+{
+	sim_ll_hrtim_modify(sim_ll_hrtim_dier(HRTIMx, Timer), HRTIM_MDIER_MREPIE, 0);
+}
+
+__STATIC_INLINE void LL_HRTIM_EnableIT_SYNC(HRTIM_TypeDef* HRTIMx)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sMasterRegs.MDIER, 0, HRTIM_MDIER_SYNCIE);
+}
+
+__STATIC_INLINE void LL_HRTIM_EnableDMAReq_REP(HRTIM_TypeDef* HRTIMx,
+                                               uint32_t Timer)
+{
+	sim_ll_hrtim_modify(sim_ll_hrtim_dier(HRTIMx, Timer), 0, HRTIM_MDIER_MREPDE);
+}
+
+__STATIC_INLINE void LL_HRTIM_DisableDMAReq_REP(HRTIM_TypeDef* HRTIMx,
+                                                uint32_t Timer)
+{
+	sim_ll_hrtim_modify(sim_ll_hrtim_dier(HRTIMx, Timer), HRTIM_MDIER_MREPDE, 0);
+}
+
+/* Flags are cleared in the status registers directly */
+__STATIC_INLINE void LL_HRTIM_ClearFlag_REP(HRTIM_TypeDef* HRTIMx,
+                                            uint32_t Timer)
+{
+	if (Timer == LL_HRTIM_TIMER_MASTER)
+		HRTIMx->sMasterRegs.MISR = HRTIMx->sMasterRegs.MISR & ~HRTIM_MISR_MREP;
+	else
+		sim_ll_hrtim_timer(HRTIMx, Timer)->TIMxISR =
+			sim_ll_hrtim_timer(HRTIMx, Timer)->TIMxISR & ~HRTIM_MISR_MREP;
+}
+
+__STATIC_INLINE void LL_HRTIM_ClearFlag_SYNC(HRTIM_TypeDef* HRTIMx)
+{
+	HRTIMx->sMasterRegs.MISR = HRTIMx->sMasterRegs.MISR & ~HRTIM_MISR_SYNC;
+}
+
+__STATIC_INLINE uint32_t LL_HRTIM_GetSyncInSrc(HRTIM_TypeDef* HRTIMx)
+{
+	return HRTIMx->sMasterRegs.MCR & HRTIM_MCR_SYNC_IN;
+}
+
+__STATIC_INLINE uint32_t LL_HRTIM_GetSyncOutConfig(HRTIM_TypeDef* HRTIMx)
+{
+	return HRTIMx->sMasterRegs.MCR & HRTIM_MCR_SYNC_OUT;
+}
+
+
+/* Burst mode */
+
+__STATIC_INLINE void LL_HRTIM_BM_SetPrescaler(HRTIM_TypeDef* HRTIMx,
+                                              uint32_t Prescaler)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.BMCR, HRTIM_BMCR_BMPRSC, Prescaler);
+}
+
+__STATIC_INLINE void LL_HRTIM_BM_SetTrig(HRTIM_TypeDef* HRTIMx,
+                                         uint32_t Trig)
+{
+	HRTIMx->sCommonRegs.BMTRGR = Trig;
+	sim_hrtim_registers_written();
+}
+
+__STATIC_INLINE void LL_HRTIM_BM_SetMode(HRTIM_TypeDef* HRTIMx,
+                                         uint32_t Mode)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.BMCR, HRTIM_BMCR_BMOM, Mode);
+}
+
+__STATIC_INLINE void LL_HRTIM_BM_SetClockSrc(HRTIM_TypeDef* HRTIMx,
+                                             uint32_t ClockSrc)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.BMCR, HRTIM_BMCR_BMCLK, ClockSrc);
+}
+
+__STATIC_INLINE void LL_HRTIM_BM_SetCompare(HRTIM_TypeDef* HRTIMx,
+                                            uint32_t CompareValue)
+{
+	HRTIMx->sCommonRegs.BMCMPR = CompareValue;
+	sim_hrtim_registers_written();
+}
+
+__STATIC_INLINE void LL_HRTIM_BM_SetPeriod(HRTIM_TypeDef* HRTIMx,
+                                           uint32_t Period)
+{
+	HRTIMx->sCommonRegs.BMPER = Period;
+	sim_hrtim_registers_written();
+}
+
+__STATIC_INLINE void LL_HRTIM_BM_Enable(HRTIM_TypeDef* HRTIMx)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.BMCR, 0, HRTIM_BMCR_BME);
+}
+
+__STATIC_INLINE void LL_HRTIM_BM_Disable(HRTIM_TypeDef* HRTIMx)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.BMCR, HRTIM_BMCR_BME, 0);
+}
+
+__STATIC_INLINE void LL_HRTIM_BM_Start(HRTIM_TypeDef* HRTIMx)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.BMTRGR, 0, HRTIM_BMTRGR_SW);
+}
+
+__STATIC_INLINE void LL_HRTIM_BM_Stop(HRTIM_TypeDef* HRTIMx)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.BMCR, HRTIM_BMCR_BMSTAT, 0);
+}
+
+
+/* External events, not simulated */
+
+/* Events 1 to 5 in EECR1, 6 to 10 in EECR2, 6 bits each */
+__STATIC_INLINE void sim_ll_hrtim_ee_modify(HRTIM_TypeDef* HRTIMx,
+                                            uint32_t Event,
+                                            uint32_t field,
+                                            uint32_t value)
+{
+	uint32_t index = __builtin_ctz(Event);
+	__IO uint32_t* eecr = (index < 5) ? &HRTIMx->sCommonRegs.EECR1 :
+	                                    &HRTIMx->sCommonRegs.EECR2;
+	uint32_t shift = 6 * (index % 5);
+
+	sim_ll_hrtim_modify(eecr, field << shift, value << shift);
+}
+
+__STATIC_INLINE void LL_HRTIM_EE_SetSrc(HRTIM_TypeDef* HRTIMx,
+                                        uint32_t Event,
+                                        uint32_t Src)
+{
+	sim_ll_hrtim_ee_modify(HRTIMx, Event, 0x3U << 0, Src);
+}
+
+__STATIC_INLINE void LL_HRTIM_EE_SetPolarity(HRTIM_TypeDef* HRTIMx,
+                                             uint32_t Event,
+                                             uint32_t Polarity)
+{
+	sim_ll_hrtim_ee_modify(HRTIMx, Event, 0x1U << 2, Polarity);
+}
+
+__STATIC_INLINE void LL_HRTIM_EE_SetSensitivity(HRTIM_TypeDef* HRTIMx,
+                                                uint32_t Event,
+                                                uint32_t Sensitivity)
+{
+	sim_ll_hrtim_ee_modify(HRTIMx, Event, 0x3U << 3, Sensitivity);
+}
+
+__STATIC_INLINE void LL_HRTIM_EE_SetFastMode(HRTIM_TypeDef* HRTIMx,
+                                             uint32_t Event,
+                                             uint32_t FastMode)
+{
+	sim_ll_hrtim_ee_modify(HRTIMx, Event, 0x1U << 5, FastMode);
+}
+
+
+/* DLL calibration */
+
+__STATIC_INLINE void LL_HRTIM_ConfigDLLCalibration(HRTIM_TypeDef* HRTIMx,
+                                                   uint32_t Mode,
+                                                   uint32_t Period)
+{
+	sim_ll_hrtim_modify(&HRTIMx->sCommonRegs.DLLCR,
+	                    HRTIM_DLLCR_CALEN | HRTIM_DLLCR_CALRTE,
+	                    Mode | Period);
+}
+
+__STATIC_INLINE uint32_t LL_HRTIM_IsActiveFlag_DLLRDY(HRTIM_TypeDef* HRTIMx)
+{
+	return ((HRTIMx->sCommonRegs.ISR & HRTIM_ISR_DLLRDY) == HRTIM_ISR_DLLRDY) ?
+	       1U : 0U;
+}
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_LL_HRTIM_H_ */
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the STM32 LL RCC header, limited to
+ *         what the HRTIM driver uses.
+ */
+
+#ifndef STM32_LL_RCC_H_
+#define STM32_LL_RCC_H_
+
+
+#include "stm32g4xx.h"
+
+
+__STATIC_INLINE uint32_t LL_RCC_GetAPB2Prescaler()
+{
+	return RCC->CFGR & RCC_CFGR_PPRE2;
+}
+
+
+#endif /* STM32_LL_RCC_H_ */
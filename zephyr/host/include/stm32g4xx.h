@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the STM32G4 device header.
+ *
+ *         Only the peripherals used by the host build are described, and
+ *         only the registers the drivers access. Peripheral instances are
+ *         plain variables owned by the simulator, which reacts to their
+ *         content when stepped.
+ */
+
+#ifndef STM32G4XX_H_
+#define STM32G4XX_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* CMSIS compiler abstraction */
+
+#ifndef __STATIC_INLINE
+#define __STATIC_INLINE static inline
+#endif
+
+#ifndef __IO
+#define __IO volatile
+#endif
+
+#define UNUSED(X) (void)X
+
+/* Accesses to simulated registers are not reordered */
+#define __DSB()
+
+/* The compiler must still not reorder accesses shared with the critical
+ * task across a barrier */
+#define __DMB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+typedef enum
+{
+	RESET = 0,
+	SET   = !RESET
+} FlagStatus;
+
+
+/* Interrupt numbers, same values as on the target */
+
+typedef enum
+{
+	DMA1_Channel7_IRQn = 17,
+	ADC1_2_IRQn        = 18,
+	ADC3_IRQn          = 47,
+	TIM6_DAC_IRQn      = 54,
+	DMA2_Channel1_IRQn = 56,
+	ADC4_IRQn          = 61,
+	ADC5_IRQn          = 62,
+	HRTIM1_Master_IRQn = 67,
+	HRTIM1_TIMA_IRQn   = 68,
+	HRTIM1_TIMB_IRQn   = 69,
+	HRTIM1_TIMC_IRQn   = 70,
+	HRTIM1_TIMD_IRQn   = 71,
+	HRTIM1_TIME_IRQn   = 72,
+	HRTIM1_TIMF_IRQn   = 74,
+	CORDIC_IRQn        = 100,
+	FMAC_IRQn          = 101
+} IRQn_Type;
+
+/* Raises the line on the simulated interrupt controller */
+void NVIC_SetPendingIRQ(IRQn_Type irq);
+
+
+/* ADC */
+
+typedef struct
+{
+	__IO uint32_t ISR;
+	__IO uint32_t IER;
+	__IO uint32_t DR;
+} ADC_TypeDef;
+
+#define ADC_ISR_EOC   (1U << 2)
+#define ADC_ISR_EOS   (1U << 3)
+#define ADC_ISR_OVR   (1U << 4)
+
+#define ADC_IER_EOCIE (1U << 2)
+#define ADC_IER_EOSIE (1U << 3)
+
+extern ADC_TypeDef sim_adc_registers[5];
+
+#define ADC1 (&sim_adc_registers[0])
+#define ADC2 (&sim_adc_registers[1])
+#define ADC3 (&sim_adc_registers[2])
+#define ADC4 (&sim_adc_registers[3])
+#define ADC5 (&sim_adc_registers[4])
+
+
+/* DMA */
+
+/* Address registers hold host addresses */
+typedef struct
+{
+	__IO uint32_t  CCR;
+	__IO uint32_t  CNDTR;
+	__IO uintptr_t CPAR;
+	__IO uintptr_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t ISR;
+	__IO uint32_t IFCR;
+	DMA_Channel_TypeDef channels[8];
+} DMA_TypeDef;
+
+#define DMA_CCR_EN   (1U << 0)
+#define DMA_CCR_TCIE (1U << 1)
+#define DMA_CCR_HTIE (1U << 2)
+#define DMA_CCR_CIRC (1U << 5)
+
+#define DMA_ISR_TCIF1 (1U << 1)
+
+extern DMA_TypeDef sim_dma1_registers;
+extern DMA_TypeDef sim_dma2_registers;
+
+#define DMA1 (&sim_dma1_registers)
+#define DMA2 (&sim_dma2_registers)
+
+
+/* DMAMUX, channels 0 to 7 serve DMA 1, 8 to 15 DMA 2 */
+
+typedef struct
+{
+	__IO uint32_t CCR;
+} DMAMUX_Channel_TypeDef;
+
+#define DMAMUX_CxCR_DMAREQ_ID (0x7FU << 0)
+
+extern DMAMUX_Channel_TypeDef sim_dmamux1_channels[16];
+
+
+/* RCC */
+
+typedef struct
+{
+	__IO uint32_t CFGR;
+	__IO uint32_t AHB1ENR;
+	__IO uint32_t AHB2ENR;
+	__IO uint32_t APB2ENR;
+} RCC_TypeDef;
+
+#define RCC_CFGR_PPRE2       (0x7U << 11)
+#define RCC_CFGR_PPRE2_DIV1  (0x0U << 11)
+#define RCC_CFGR_PPRE2_DIV2  (0x4U << 11)
+#define RCC_CFGR_PPRE2_DIV4  (0x5U << 11)
+#define RCC_CFGR_PPRE2_DIV8  (0x6U << 11)
+#define RCC_CFGR_PPRE2_DIV16 (0x7U << 11)
+
+extern RCC_TypeDef sim_rcc_registers;
+
+#define RCC (&sim_rcc_registers)
+
+
+/* GPIO */
+
+typedef struct
+{
+	__IO uint32_t MODER;
+	__IO uint32_t OTYPER;
+	__IO uint32_t OSPEEDR;
+	__IO uint32_t PUPDR;
+	__IO uint32_t AFR[2];
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef sim_gpio_registers[3];
+
+#define GPIOA (&sim_gpio_registers[0])
+#define GPIOB (&sim_gpio_registers[1])
+#define GPIOC (&sim_gpio_registers[2])
+
+
+/* HRTIM, register fields follow RM0440 */
+
+typedef struct
+{
+	__IO uint32_t MCR;
+	__IO uint32_t MISR;
+	__IO uint32_t MICR;
+	__IO uint32_t MDIER;
+	__IO uint32_t MCNTR;
+	__IO uint32_t MPER;
+	__IO uint32_t MREP;
+	__IO uint32_t MCMP1R;
+	__IO uint32_t MCMP2R;
+	__IO uint32_t MCMP3R;
+	__IO uint32_t MCMP4R;
+} HRTIM_Master_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t TIMxCR;
+	__IO uint32_t TIMxISR;
+	__IO uint32_t TIMxICR;
+	__IO uint32_t TIMxDIER;
+	__IO uint32_t CNTxR;
+	__IO uint32_t PERxR;
+	__IO uint32_t REPxR;
+	__IO uint32_t CMP1xR;
+	__IO uint32_t CMP2xR;
+	__IO uint32_t CMP3xR;
+	__IO uint32_t CMP4xR;
+	__IO uint32_t DTxR;
+	__IO uint32_t SETx1R;
+	__IO uint32_t RSTx1R;
+	__IO uint32_t SETx2R;
+	__IO uint32_t RSTx2R;
+	__IO uint32_t RSTxR;
+	__IO uint32_t OUTxR;
+	__IO uint32_t TIMxCR2;
+} HRTIM_Timerx_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t CR1;
+	__IO uint32_t CR2;
+	__IO uint32_t ISR;
+	__IO uint32_t ICR;
+	__IO uint32_t OENR;
+	__IO uint32_t BMCR;
+	__IO uint32_t BMTRGR;
+	__IO uint32_t BMCMPR;
+	__IO uint32_t BMPER;
+	__IO uint32_t EECR1;
+	__IO uint32_t EECR2;
+	__IO uint32_t EECR3;
+	__IO uint32_t ADC1R;
+	__IO uint32_t ADC2R;
+	__IO uint32_t ADC3R;
+	__IO uint32_t ADC4R;
+	__IO uint32_t DLLCR;
+	__IO uint32_t BDMUPR;
+	__IO uint32_t BDTAUPR;
+	__IO uint32_t BDTBUPR;
+	__IO uint32_t BDTCUPR;
+	__IO uint32_t BDTDUPR;
+	__IO uint32_t BDTEUPR;
+	__IO uint32_t BDMADR;
+	__IO uint32_t BDTFUPR;
+	__IO uint32_t ADCER;
+	__IO uint32_t ADCUR;
+	__IO uint32_t ADCPS1;
+	__IO uint32_t ADCPS2;
+} HRTIM_Common_TypeDef;
+
+typedef struct
+{
+	HRTIM_Master_TypeDef sMasterRegs;
+	HRTIM_Timerx_TypeDef sTimerxRegs[6];
+	HRTIM_Common_TypeDef sCommonRegs;
+} HRTIM_TypeDef;
+
+/* Master and timer control registers */
+#define HRTIM_MCR_CK_PSC      (0x7U << 0)
+#define HRTIM_MCR_CONT        (1U << 3)
+#define HRTIM_MCR_RETRIG      (1U << 4)
+#define HRTIM_MCR_SYNC_IN     (0x3U << 8)
+#define HRTIM_MCR_SYNC_OUT    (0x3U << 12)
+#define HRTIM_MCR_MCEN        (1U << 16)
+#define HRTIM_MCR_TACEN       (1U << 17)
+#define HRTIM_MCR_TBCEN       (1U << 18)
+#define HRTIM_MCR_TCCEN       (1U << 19)
+#define HRTIM_MCR_TDCEN       (1U << 20)
+#define HRTIM_MCR_TECEN       (1U << 21)
+#define HRTIM_MCR_TFCEN       (1U << 22)
+#define HRTIM_MCR_PREEN       (1U << 27)
+#define HRTIM_MCR_MREPU       (1U << 29)
+
+#define HRTIM_TIMCR_TREPU     (1U << 17)
+#define HRTIM_TIMCR_TRSTU     (1U << 18)
+#define HRTIM_TIMCR_MSTU      (1U << 24)
+
+#define HRTIM_TIMCR2_DCDE     (1U << 0)
+#define HRTIM_TIMCR2_DCDS     (1U << 1)
+#define HRTIM_TIMCR2_DCDR     (1U << 2)
+#define HRTIM_TIMCR2_UDM      (1U << 4)
+#define HRTIM_TIMCR2_ROM      (0x3U << 6)
+#define HRTIM_TIMCR2_ADROM    (0x3U << 10)
+
+/* Interrupt, flag and DMA request bits, same for master and timers */
+#define HRTIM_MISR_MREP       (1U << 4)
+#define HRTIM_MISR_SYNC       (1U << 6)
+#define HRTIM_MDIER_MREPIE    (1U << 4)
+#define HRTIM_MDIER_SYNCIE    (1U << 6)
+#define HRTIM_MDIER_MREPDE    (1U << 20)
+
+/* Timer reset sources, OTHERn are the other timers in order */
+#define HRTIM_RSTR_UPDATE     (1U << 1)
+#define HRTIM_RSTR_CMP2       (1U << 2)
+#define HRTIM_RSTR_CMP4       (1U << 3)
+#define HRTIM_RSTR_MSTPER     (1U << 4)
+#define HRTIM_RSTR_MSTCMP1    (1U << 5)
+#define HRTIM_RSTR_OTHER1_CMP1 (1U << 19)
+
+/* Output set and reset sources */
+#define HRTIM_SET1R_PER       (1U << 2)
+#define HRTIM_SET1R_CMP1      (1U << 3)
+#define HRTIM_SET1R_MSTPER    (1U << 7)
+#define HRTIM_SET1R_MSTCMP1   (1U << 8)
+
+/* Dead time and output registers */
+#define HRTIM_DTR_DTR         (0x1FFU << 0)
+#define HRTIM_DTR_DTPRSC      (0x7U << 10)
+#define HRTIM_DTR_DTF         (0x1FFU << 16)
+#define HRTIM_OUTR_IDLM1      (1U << 2)
+#define HRTIM_OUTR_IDLES1     (1U << 3)
+#define HRTIM_OUTR_DTEN       (1U << 8)
+
+/* Common registers */
+#define HRTIM_CR1_MUDIS       (1U << 0)
+#define HRTIM_CR1_ADC1USRC    (0x7U << 16)
+#define HRTIM_CR2_SWPA        (1U << 16)
+#define HRTIM_ISR_DLLRDY      (1U << 16)
+#define HRTIM_BMCR_BME        (1U << 0)
+#define HRTIM_BMCR_BMOM       (1U << 1)
+#define HRTIM_BMCR_BMCLK      (0xFU << 2)
+#define HRTIM_BMCR_BMPRSC     (0xFU << 6)
+#define HRTIM_BMCR_BMSTAT     (1U << 31)
+#define HRTIM_BMTRGR_SW       (1U << 0)
+#define HRTIM_DLLCR_CAL       (1U << 0)
+#define HRTIM_DLLCR_CALEN     (1U << 1)
+#define HRTIM_DLLCR_CALRTE    (0x3U << 2)
+
+extern HRTIM_TypeDef sim_hrtim1_registers;
+
+#define HRTIM1 (&sim_hrtim1_registers)
+
+
+/* Core debug and DWT cycle counter. The cycle counter always runs, at
+ * 170MHz of simulated time, and is updated on each access. */
+
+typedef struct
+{
+	__IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+	__IO uint32_t CTRL;
+	__IO uint32_t CYCCNT;
+} DWT_Type;
+
+#define CoreDebug_DEMCR_TRCENA_Msk (1U << 24)
+#define DWT_CTRL_CYCCNTENA_Msk     (1U << 0)
+
+extern CoreDebug_Type sim_core_debug_registers;
+
+DWT_Type* sim_dwt_get();
+
+#define CoreDebug (&sim_core_debug_registers)
+#define DWT       (sim_dwt_get())
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32G4XX_H_ */
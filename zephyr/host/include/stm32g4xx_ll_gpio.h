@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the STM32G4 LL GPIO header, limited
+ *         to what the HRTIM driver uses. Pins only hold their
+ *         configuration: the simulated HRTIM gives the levels of its
+ *         outputs itself, see sim/sim_hrtim.h.
+ */
+
+#ifndef STM32G4XX_LL_GPIO_H_
+#define STM32G4XX_LL_GPIO_H_
+
+
+#include "stm32g4xx.h"
+
+
+#define LL_GPIO_PIN_1  (1U << 1)
+#define LL_GPIO_PIN_6  (1U << 6)
+#define LL_GPIO_PIN_7  (1U << 7)
+#define LL_GPIO_PIN_8  (1U << 8)
+#define LL_GPIO_PIN_9  (1U << 9)
+#define LL_GPIO_PIN_10 (1U << 10)
+#define LL_GPIO_PIN_11 (1U << 11)
+#define LL_GPIO_PIN_12 (1U << 12)
+#define LL_GPIO_PIN_13 (1U << 13)
+#define LL_GPIO_PIN_14 (1U << 14)
+#define LL_GPIO_PIN_15 (1U << 15)
+
+#define LL_GPIO_MODE_INPUT     0U
+#define LL_GPIO_MODE_OUTPUT    1U
+#define LL_GPIO_MODE_ALTERNATE 2U
+#define LL_GPIO_MODE_ANALOG    3U
+
+#define LL_GPIO_OUTPUT_PUSHPULL      0U
+#define LL_GPIO_SPEED_FREQ_VERY_HIGH 3U
+#define LL_GPIO_PULL_NO              0U
+
+#define LL_GPIO_AF_3  3U
+#define LL_GPIO_AF_13 13U
+
+typedef struct
+{
+	uint32_t Pin;
+	uint32_t Mode;
+	uint32_t Speed;
+	uint32_t OutputType;
+	uint32_t Pull;
+	uint32_t Alternate;
+} LL_GPIO_InitTypeDef;
+
+
+/* Pin is a single pin mask */
+__STATIC_INLINE void LL_GPIO_SetPinMode(GPIO_TypeDef* GPIOx,
+                                        uint32_t Pin,
+                                        uint32_t Mode)
+{
+	uint32_t position = __builtin_ctz(Pin);
+
+	GPIOx->MODER = (GPIOx->MODER & ~(0x3U << (2 * position))) |
+	               (Mode << (2 * position));
+}
+
+__STATIC_INLINE int LL_GPIO_Init(GPIO_TypeDef* GPIOx,
+                                 LL_GPIO_InitTypeDef* GPIO_InitStruct)
+{
+	for (uint32_t position = 0 ; position < 16 ; position++)
+	{
+		if ( (GPIO_InitStruct->Pin & (1U << position)) == 0 )
+			continue;
+
+		uint32_t afr   = position / 8;
+		uint32_t shift = 4 * (position % 8);
+
+		GPIOx->AFR[afr] = (GPIOx->AFR[afr] & ~(0xFU << shift)) |
+		                  (GPIO_InitStruct->Alternate << shift);
+		GPIOx->OSPEEDR = (GPIOx->OSPEEDR & ~(0x3U << (2 * position))) |
+		                 (GPIO_InitStruct->Speed << (2 * position));
+		GPIOx->OTYPER = (GPIOx->OTYPER & ~(1U << position)) |
+		                (GPIO_InitStruct->OutputType << position);
+		GPIOx->PUPDR = (GPIOx->PUPDR & ~(0x3U << (2 * position))) |
+		               (GPIO_InitStruct->Pull << (2 * position));
+
+		LL_GPIO_SetPinMode(GPIOx, 1U << position, GPIO_InitStruct->Mode);
+	}
+
+	return 0;
+}
+
+
+#endif /* STM32G4XX_LL_GPIO_H_ */
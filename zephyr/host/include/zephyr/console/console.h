@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the Zephyr console header, limited to
+ *         the output. Data written goes to the file set with
+ *         sim_console_set_output(), see sim/sim_console.h.
+ */
+
+#ifndef ZEPHYR_CONSOLE_CONSOLE_H_
+#define ZEPHYR_CONSOLE_CONSOLE_H_
+
+
+/* Stdlib */
+#include <stddef.h>
+#include <sys/types.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+ssize_t console_write(void* dummy, const void* buf, size_t size);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_CONSOLE_CONSOLE_H_ */
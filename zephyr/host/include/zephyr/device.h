@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the Zephyr device model. Devices
+ *         taken from the devicetree are simulated ones.
+ */
+
+#ifndef ZEPHYR_DEVICE_H_
+#define ZEPHYR_DEVICE_H_
+
+
+/* Stdlib */
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <zephyr/devicetree.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+struct device
+{
+	const char* name;
+};
+
+#define DEVICE_DT_GET(node_id) SIM_DEVICE(node_id)
+#define SIM_DEVICE(label) (&sim_device_##label)
+
+extern const struct device sim_device_dma1;
+
+static inline bool device_is_ready(const struct device* dev)
+{
+	return dev != NULL;
+}
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_DEVICE_H_ */
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ *
+ * @brief  Host build replacement of the Zephyr devicetree API, limited to
+ *         the macros the modules built on the host use.
+ *
+ *         Nodes are identified by their label, and their properties are
+ *         macros named <label>_P_<property>, as generated from the
+ *         devicetree on target. The host build simulates a Spin board
+ *         with a Twist v1.4.1 shield, whose power legs are copied below
+ *         from boards/shields/twist/twist_v1_4_1.overlay.
+ */
+
+#ifndef ZEPHYR_DEVICETREE_H_
+#define ZEPHYR_DEVICETREE_H_
+
+
+#define DT_NODELABEL(label) label
+
+#define DT_CAT(a, b)        DT_PRIMITIVE_CAT(a, b)
+#define DT_PRIMITIVE_CAT(a, b) a##b
+#define DT_CAT3(a, b, c)    DT_PRIMITIVE_CAT3(a, b, c)
+#define DT_PRIMITIVE_CAT3(a, b, c) a##b##c
+#define DT_CAT4(a, b, c, d) DT_PRIMITIVE_CAT4(a, b, c, d)
+#define DT_PRIMITIVE_CAT4(a, b, c, d) a##b##c##d
+
+#define DT_PROP(node_id, prop) DT_CAT3(node_id, _P_, prop)
+
+#define DT_PROP_BY_IDX(node_id, prop, idx) \
+	DT_CAT4(node_id, _P_, prop, _IDX_##idx)
+
+#define DT_STRING_TOKEN(node_id, prop) \
+	DT_CAT4(node_id, _P_, prop, _STRING_TOKEN)
+
+/* All the optional properties of the nodes below are defined */
+#define DT_PROP_OR(node_id, prop, default_value) DT_PROP(node_id, prop)
+
+#define DT_NODE_HAS_PROP(node_id, prop) 1
+
+#define DT_FOREACH_CHILD_STATUS_OKAY(node_id, fn) \
+	DT_CAT(node_id, _FOREACH_CHILD_STATUS_OKAY)(fn)
+
+
+/**
+ *  Twist v1.4.1 power legs
+ */
+
+#define powershield_P_default_frequency 200000
+#define powershield_P_min_frequency     50000
+
+#define powershield_FOREACH_CHILD_STATUS_OKAY(fn) fn(leg1) fn(leg2)
+
+#define leg1_P_leg_name_STRING_TOKEN              LEG1
+#define leg1_P_pwm_pin_num_IDX_0                  12
+#define leg1_P_pwm_pin_num_IDX_1                  14
+#define leg1_P_pwm_x1_high                        1
+#define leg1_P_capa_pin_num                       7
+#define leg1_P_driver_pin_num                     19
+#define leg1_P_current_pin_num                    30
+#define leg1_P_default_adc_STRING_TOKEN           ADC_1
+#define leg1_P_default_adc_decim                  1
+#define leg1_P_default_edge_trigger_STRING_TOKEN  EdgeTrigger_up
+#define leg1_P_default_dead_time_IDX_0            100
+#define leg1_P_default_dead_time_IDX_1            100
+#define leg1_P_default_modulation_STRING_TOKEN    UpDwn
+#define leg1_P_default_phase_shift                0
+#define leg1_P_output1_inactive                   0
+#define leg1_P_output2_inactive                   0
+
+#define leg2_P_leg_name_STRING_TOKEN              LEG2
+#define leg2_P_pwm_pin_num_IDX_0                  2
+#define leg2_P_pwm_pin_num_IDX_1                  4
+#define leg2_P_pwm_x1_high                        1
+#define leg2_P_capa_pin_num                       56
+#define leg2_P_driver_pin_num                     22
+#define leg2_P_current_pin_num                    25
+#define leg2_P_default_adc_STRING_TOKEN           ADC_2
+#define leg2_P_default_adc_decim                  1
+#define leg2_P_default_edge_trigger_STRING_TOKEN  EdgeTrigger_up
+#define leg2_P_default_dead_time_IDX_0            100
+#define leg2_P_default_dead_time_IDX_1            100
+#define leg2_P_default_modulation_STRING_TOKEN    UpDwn
+#define leg2_P_default_phase_shift                0
+#define leg2_P_output1_inactive                   0
+#define leg2_P_output2_inactive                   0
+
+
+#endif /* ZEPHYR_DEVICETREE_H_ */
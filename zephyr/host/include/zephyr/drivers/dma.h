@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the Zephyr DMA API, limited to what
+ *         the data acquisition pipeline uses. Addresses are 64-bit wide as
+ *         with CONFIG_DMA_64BIT. Transfers are done by the simulated DMA,
+ *         see sim/sim_dma.h.
+ */
+
+#ifndef ZEPHYR_DRIVERS_DMA_H_
+#define ZEPHYR_DRIVERS_DMA_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+#include <zephyr/device.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+enum dma_channel_direction
+{
+	MEMORY_TO_MEMORY     = 0x0,
+	MEMORY_TO_PERIPHERAL = 0x1,
+	PERIPHERAL_TO_MEMORY = 0x2
+};
+
+enum dma_addr_adj
+{
+	DMA_ADDR_ADJ_INCREMENT = 0,
+	DMA_ADDR_ADJ_DECREMENT = 1,
+	DMA_ADDR_ADJ_NO_CHANGE = 2
+};
+
+#define DMA_STATUS_COMPLETE 0
+#define DMA_STATUS_BLOCK    1
+
+typedef void (*dma_callback_t)(const struct device* dev,
+							   void* user_data,
+							   uint32_t channel,
+							   int status);
+
+struct dma_block_config
+{
+	uint64_t source_address;
+	uint64_t dest_address;
+	uint32_t block_size;
+	uint16_t source_addr_adj  : 2;
+	uint16_t dest_addr_adj    : 2;
+	uint16_t source_reload_en : 1;
+	uint16_t dest_reload_en   : 1;
+};
+
+struct dma_config
+{
+	uint32_t dma_slot;
+	uint32_t channel_direction;
+	uint32_t source_data_size;
+	uint32_t dest_data_size;
+	uint32_t source_burst_length;
+	uint32_t dest_burst_length;
+	uint32_t block_count;
+	struct dma_block_config* head_block;
+	void* user_data;
+	dma_callback_t dma_callback;
+};
+
+int dma_config(const struct device* dev,
+			   uint32_t channel,
+			   struct dma_config* config);
+
+int dma_reload(const struct device* dev,
+			   uint32_t channel,
+			   uint64_t src,
+			   uint64_t dst,
+			   size_t size);
+
+int dma_start(const struct device* dev, uint32_t channel);
+int dma_stop(const struct device* dev, uint32_t channel);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_DRIVERS_DMA_H_ */
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ *
+ * @brief  Host build replacement of the Zephyr GPIO API, limited to what
+ *         the GPIO HAL uses. Ports A to D are simulated, see
+ *         sim/sim_gpio.h.
+ */
+
+#ifndef ZEPHYR_DRIVERS_GPIO_H_
+#define ZEPHYR_DRIVERS_GPIO_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+#include <zephyr/device.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef uint8_t  gpio_pin_t;
+typedef uint32_t gpio_flags_t;
+
+#define GPIO_PULL_UP (1U << 4)
+#define GPIO_INPUT   (1U << 16)
+#define GPIO_OUTPUT  (1U << 17)
+
+extern const struct device sim_device_gpioa;
+extern const struct device sim_device_gpiob;
+extern const struct device sim_device_gpioc;
+extern const struct device sim_device_gpiod;
+
+int gpio_pin_configure(const struct device* port,
+					   gpio_pin_t pin,
+					   gpio_flags_t flags);
+
+int gpio_pin_set(const struct device* port, gpio_pin_t pin, int value);
+int gpio_pin_get(const struct device* port, gpio_pin_t pin);
+int gpio_pin_toggle(const struct device* port, gpio_pin_t pin);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_DRIVERS_GPIO_H_ */
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the Zephyr interrupt API. Interrupt
+ *         lines are handled by the simulated interrupt controller, see
+ *         sim/sim_irq.h.
+ */
+
+#ifndef ZEPHYR_IRQ_H_
+#define ZEPHYR_IRQ_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define IRQ_ZERO_LATENCY (1U << 2)
+
+/* Connected at run time on the host */
+#define IRQ_CONNECT(irq, priority, isr, parameter, flags) \
+	irq_connect_dynamic(irq, priority, (void (*)(const void*))(isr), parameter, flags)
+
+int irq_connect_dynamic(unsigned int irq,
+						unsigned int priority,
+						void (*routine)(const void* parameter),
+						const void* parameter,
+						uint32_t flags);
+
+void irq_enable(unsigned int irq);
+void irq_disable(unsigned int irq);
+int  irq_is_enabled(unsigned int irq);
+
+unsigned int irq_lock();
+void irq_unlock(unsigned int key);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_IRQ_H_ */
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the Zephyr kernel header, limited to
+ *         what the modules built on the host use. Memory allocation and
+ *         console output map to the C library. Threads, timers and
+ *         semaphores are run in simulated time by the simulated kernel,
+ *         see sim/sim_kernel.h.
+ */
+
+#ifndef ZEPHYR_KERNEL_H_
+#define ZEPHYR_KERNEL_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+/* On target, the SoC header comes with the kernel header */
+#include <stm32g4xx.h>
+
+#include <zephyr/devicetree.h>
+#include <zephyr/irq.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define ARG_UNUSED(x) (void)(x)
+
+#define printk   printf
+#define snprintk snprintf
+
+#ifdef __cplusplus
+#define BUILD_ASSERT(expr, msg) static_assert(expr, msg)
+#else
+#define BUILD_ASSERT(expr, msg) _Static_assert(expr, msg)
+#endif
+
+/* Init functions run before main(), levels and priorities are ignored */
+#define SYS_INIT(init_fn, level, prio) \
+	__attribute__((constructor)) static void init_fn##_sys_init(void) \
+	{ \
+		init_fn(); \
+	}
+
+
+static inline void* k_malloc(size_t size)
+{
+	return malloc(size);
+}
+
+static inline void* k_calloc(size_t nmemb, size_t size)
+{
+	return calloc(nmemb, size);
+}
+
+static inline void k_free(void* ptr)
+{
+	free(ptr);
+}
+
+
+/* Timeouts */
+
+typedef struct
+{
+	int64_t ns; /* Negative for K_FOREVER */
+} k_timeout_t;
+
+static inline k_timeout_t sim_timeout_ns(int64_t ns)
+{
+	k_timeout_t timeout;
+	timeout.ns = ns;
+	return timeout;
+}
+
+#define K_NSEC(t)    sim_timeout_ns((int64_t)(t))
+#define K_USEC(t)    sim_timeout_ns((int64_t)(t) * 1000)
+#define K_MSEC(t)    sim_timeout_ns((int64_t)(t) * 1000000)
+#define K_SECONDS(t) sim_timeout_ns((int64_t)(t) * 1000000000)
+#define K_NO_WAIT    sim_timeout_ns(0)
+#define K_FOREVER    sim_timeout_ns(-1)
+
+
+/* Threads */
+
+typedef char k_thread_stack_t;
+typedef void (*k_thread_entry_t)(void* p1, void* p2, void* p3);
+
+struct k_thread
+{
+	int sim_id;
+};
+
+typedef struct k_thread* k_tid_t;
+
+/* Simulated threads run on their own host stack, sized for host code */
+#define K_THREAD_STACK_ARRAY_DEFINE(sym, nmemb, size) \
+	k_thread_stack_t sym[nmemb][size]
+#define K_THREAD_STACK_DEFINE(sym, size) k_thread_stack_t sym[size]
+#define K_THREAD_STACK_SIZEOF(sym) sizeof(sym)
+
+#define K_FP_REGS (1U << 1)
+
+k_tid_t k_thread_create(struct k_thread* new_thread,
+						k_thread_stack_t* stack,
+						size_t stack_size,
+						k_thread_entry_t entry,
+						void* p1, void* p2, void* p3,
+						int prio,
+						uint32_t options,
+						k_timeout_t delay);
+
+void    k_thread_suspend(k_tid_t thread);
+void    k_thread_resume(k_tid_t thread);
+k_tid_t k_current_get();
+void    k_yield();
+int32_t k_sleep(k_timeout_t timeout);
+
+static inline int32_t k_msleep(int32_t ms)
+{
+	return k_sleep(K_MSEC(ms));
+}
+
+static inline int32_t k_usleep(int32_t us)
+{
+	return k_sleep(K_USEC(us));
+}
+
+
+/* Timers */
+
+struct k_timer
+{
+	uint64_t expiry_ns;
+	uint64_t period_ns;
+	uint32_t status;
+	bool     running;
+	void (*expiry_fn)(struct k_timer* timer);
+	void (*stop_fn)(struct k_timer* timer);
+};
+
+void     k_timer_init(struct k_timer* timer,
+					  void (*expiry_fn)(struct k_timer* timer),
+					  void (*stop_fn)(struct k_timer* timer));
+void     k_timer_start(struct k_timer* timer,
+					   k_timeout_t duration,
+					   k_timeout_t period);
+void     k_timer_stop(struct k_timer* timer);
+uint32_t k_timer_status_get(struct k_timer* timer);
+uint32_t k_timer_status_sync(struct k_timer* timer);
+
+
+/* Semaphores */
+
+struct k_sem
+{
+	unsigned int count;
+	unsigned int limit;
+};
+
+#define K_SEM_MAX_LIMIT UINT32_MAX
+#define K_SEM_DEFINE(name, initial_count, count_limit) \
+	struct k_sem name = { initial_count, count_limit }
+
+int          k_sem_init(struct k_sem* sem,
+						unsigned int initial_count,
+						unsigned int limit);
+void         k_sem_give(struct k_sem* sem);
+int          k_sem_take(struct k_sem* sem, k_timeout_t timeout);
+void         k_sem_reset(struct k_sem* sem);
+unsigned int k_sem_count_get(struct k_sem* sem);
+
+
+/* Mutexes, recursive for their owner, without priority inheritance */
+
+struct k_mutex
+{
+	struct k_sem sem;
+	k_tid_t      owner;
+	uint32_t     lock_count;
+};
+
+#define K_MUTEX_DEFINE(name) \
+	struct k_mutex name = { { 1, 1 }, NULL, 0 }
+
+int k_mutex_init(struct k_mutex* mutex);
+int k_mutex_lock(struct k_mutex* mutex, k_timeout_t timeout);
+int k_mutex_unlock(struct k_mutex* mutex);
+
+
+/* Atomic variables */
+
+typedef long atomic_t;
+typedef long atomic_val_t;
+
+#define ATOMIC_INIT(i) (i)
+
+static inline atomic_val_t atomic_or(atomic_t* target, atomic_val_t value)
+{
+	return __atomic_fetch_or(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_clear(atomic_t* target)
+{
+	return __atomic_exchange_n(target, 0, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_get(const atomic_t* target)
+{
+	return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_set(atomic_t* target, atomic_val_t value)
+{
+	return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_inc(atomic_t* target)
+{
+	return __atomic_fetch_add(target, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline bool atomic_cas(atomic_t* target,
+							  atomic_val_t old_value,
+							  atomic_val_t new_value)
+{
+	return __atomic_compare_exchange_n(target, &old_value, new_value, false,
+									   __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+
+/* Time */
+
+int64_t  k_uptime_get();
+uint32_t k_uptime_get_32();
+uint32_t k_cycle_get_32();
+
+/* Code takes no simulated time, busy waits included */
+static inline void k_busy_wait(uint32_t usec_to_wait)
+{
+	(void)usec_to_wait;
+}
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_KERNEL_H_ */
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of the Zephyr CRC header, limited to the
+ *         functions used by the modules built on the host, with the same
+ *         algorithm as the Zephyr one.
+ */
+
+#ifndef ZEPHYR_SYS_CRC_H_
+#define ZEPHYR_SYS_CRC_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+#include <stddef.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief CRC-16-ITU-T, polynomial 0x1021, not reflected. A 0xFFFF seed
+ *        gives CRC-16/CCITT-FALSE, a 0x0000 seed CRC-16/XMODEM.
+ */
+static inline uint16_t crc16_itu_t(uint16_t seed, const uint8_t* src, size_t len)
+{
+	for ( ; len > 0 ; len--)
+	{
+		seed  = (seed >> 8U) | (seed << 8U);
+		seed ^= *src++;
+		seed ^= (seed & 0xffU) >> 4U;
+		seed ^= seed << 12U;
+		seed ^= (seed & 0xffU) << 5U;
+	}
+
+	return seed;
+}
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_SYS_CRC_H_ */
@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Simulated ADC core: replaces the register level part of the
+ *         ADC driver (adc_core.c) in the host build.
+ */
+
+
+/* Stdlib */
+#include <math.h>
+
+/* STM32 LL */
+#include <stm32_ll_adc.h>
+#include <stm32_ll_dma.h>
+
+/* ADC driver private functions */
+#include "adc_core.h"
+
+/* Simulator */
+#include "sim/sim_dma.h"
+#include "sim/sim_irq.h"
+#include "sim/sim_kernel.h"
+#include "sim/sim_plant.h"
+#include "sim/sim_time.h"
+
+/* Current file header */
+#include "sim/sim_adc.h"
+
+
+/**
+ *  Simulated peripherals
+ */
+
+ADC_TypeDef sim_adc_registers[5] = {};
+
+
+/**
+ *  Local variables
+ */
+
+#define SIM_ADC_COUNT          5
+#define SIM_ADC_CHANNELS_COUNT 19
+#define SIM_ADC_RANKS_COUNT    16
+#define SIM_ADC_MAX_VALUE      4095.0f
+#define SIM_ADC_HRTIM_TRIGGERS 10
+
+typedef struct
+{
+	bool     enabled;
+	bool     started;
+	bool     use_dma;
+	uint32_t trigger;
+	uint32_t discontinuous_count;
+	uint8_t  sequence_length;
+	uint8_t  next_rank;
+	uint8_t  ranks[SIM_ADC_RANKS_COUNT];
+	bool     differential[SIM_ADC_CHANNELS_COUNT];
+	uint64_t conversions_count;
+} sim_adc_t;
+
+static sim_adc_t adcs[SIM_ADC_COUNT] = {};
+
+static sim_waveform_t waveforms[SIM_ADC_COUNT][SIM_ADC_CHANNELS_COUNT] = {};
+
+static const uint32_t dma_requests[SIM_ADC_COUNT] =
+{
+	LL_DMAMUX_REQ_ADC1,
+	LL_DMAMUX_REQ_ADC2,
+	LL_DMAMUX_REQ_ADC3,
+	LL_DMAMUX_REQ_ADC4,
+	LL_DMAMUX_REQ_ADC5
+};
+
+static const unsigned int irq_lines[SIM_ADC_COUNT] =
+{
+	ADC1_2_IRQn, ADC1_2_IRQn, ADC3_IRQn, ADC4_IRQn, ADC5_IRQn
+};
+
+static uint32_t noise_state = 0x12345678;
+
+static void _sim_adc_trigger_event_handler(void* arg);
+
+static uint64_t    trigger_period_ns = 0;
+static sim_event_t trigger_event     = { _sim_adc_trigger_event_handler,
+										 nullptr,
+										 SIM_EVENT_PRIORITY_ADC_TRIGGER,
+										 0,
+										 false };
+
+static void _sim_adc_eos_event_handler(void* arg);
+
+/* End of sequence interrupts, raised at the end of the conversions */
+static sim_event_t eos_events[SIM_ADC_COUNT] =
+{
+	{ _sim_adc_eos_event_handler, (void*)0, SIM_EVENT_PRIORITY_ADC_TRIGGER, 0, false },
+	{ _sim_adc_eos_event_handler, (void*)1, SIM_EVENT_PRIORITY_ADC_TRIGGER, 0, false },
+	{ _sim_adc_eos_event_handler, (void*)2, SIM_EVENT_PRIORITY_ADC_TRIGGER, 0, false },
+	{ _sim_adc_eos_event_handler, (void*)3, SIM_EVENT_PRIORITY_ADC_TRIGGER, 0, false },
+	{ _sim_adc_eos_event_handler, (void*)4, SIM_EVENT_PRIORITY_ADC_TRIGGER, 0, false }
+};
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Returns a uniform random number in [-1, 1].
+ */
+static float _sim_adc_noise()
+{
+	/* xorshift32 */
+	noise_state ^= noise_state << 13;
+	noise_state ^= noise_state >> 17;
+	noise_state ^= noise_state << 5;
+
+	return ((float)noise_state / (float)UINT32_MAX) * 2.0f - 1.0f;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the noiseless value of a waveform.
+ */
+static float _sim_adc_waveform(const sim_waveform_t* waveform,
+							   uint64_t time_ns)
+{
+	double angle = 2.0 * M_PI * waveform->frequency * ((double)time_ns * 1e-9)
+				 + waveform->phase;
+
+	float shape;
+	switch (waveform->shape)
+	{
+		case sim_waveform_sine:
+			shape = (float)sin(angle);
+			break;
+		case sim_waveform_square:
+			shape = (sin(angle) >= 0) ? 1.0f : -1.0f;
+			break;
+		case sim_waveform_triangle:
+			shape = (float)(asin(sin(angle)) * 2.0 / M_PI);
+			break;
+		case sim_waveform_constant:
+		default:
+			shape = 0;
+			break;
+	}
+
+	return waveform->offset + waveform->amplitude * shape;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Samples a channel: the plant if it drives
+ *        the channel, its waveform otherwise.
+ */
+static uint16_t _sim_adc_sample(uint8_t adc_index,
+								uint8_t channel,
+								uint64_t time_ns)
+{
+	if ( (channel == 0) || (channel > SIM_ADC_CHANNELS_COUNT) )
+		return 0;
+
+	const sim_waveform_t* waveform = &waveforms[adc_index][channel - 1];
+
+	float value;
+	if (sim_plant_sample(adc_index + 1, channel, &value) == false)
+	{
+		value = _sim_adc_waveform(waveform, time_ns);
+	}
+
+	if (waveform->noise != 0)
+	{
+		value += waveform->noise * _sim_adc_noise();
+	}
+
+	if (value < 0)
+	{
+		value = 0;
+	}
+	else if (value > SIM_ADC_MAX_VALUE)
+	{
+		value = SIM_ADC_MAX_VALUE;
+	}
+
+	return (uint16_t)lrintf(value);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Converts the channels of an ADC for one trigger
+ *        event: the whole sequence, or the next channels in discontinuous
+ *        mode.
+ */
+static void _sim_adc_convert(uint8_t adc_index)
+{
+	sim_adc_t*   adc       = &adcs[adc_index];
+	ADC_TypeDef* registers = &sim_adc_registers[adc_index];
+
+	if (adc->sequence_length == 0)
+		return;
+
+	uint32_t conversions = adc->sequence_length - adc->next_rank;
+	if ( (adc->discontinuous_count != 0) &&
+		 (adc->discontinuous_count < conversions) )
+	{
+		conversions = adc->discontinuous_count;
+	}
+
+	uint64_t time_ns = sim_time_get_ns();
+
+	for (uint32_t i = 0 ; i < conversions ; i++)
+	{
+		time_ns += SIM_ADC_CONVERSION_TIME_NS;
+
+		uint8_t channel = adc->ranks[adc->next_rank];
+
+		registers->DR   = _sim_adc_sample(adc_index, channel, time_ns);
+		registers->ISR = registers->ISR | ADC_ISR_EOC;
+		adc->conversions_count++;
+
+		if (adc->use_dma == true)
+		{
+			sim_dma_request(dma_requests[adc_index]);
+		}
+
+		adc->next_rank++;
+		if (adc->next_rank == adc->sequence_length)
+		{
+			adc->next_rank = 0;
+			registers->ISR = registers->ISR | ADC_ISR_EOS;
+
+			if (registers->IER & ADC_IER_EOSIE)
+			{
+				sim_event_schedule(&eos_events[adc_index], time_ns);
+			}
+		}
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Raises the end of sequence interrupt of an ADC
+ *        once its conversions are done.
+ */
+static void _sim_adc_eos_event_handler(void* arg)
+{
+	sim_irq_raise(irq_lines[(uintptr_t)arg]);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Raises all the HRTIM triggers at each period.
+ *        Following periods are processed right away while nothing else is
+ *        due, which avoids going through the kernel at each period.
+ */
+static void _sim_adc_trigger_event_handler(void* arg)
+{
+	(void)arg;
+
+	uint64_t time_ns = trigger_event.time_ns;
+
+	while (true)
+	{
+		for (uint8_t adc_index = 0 ; adc_index < SIM_ADC_COUNT ; adc_index++)
+		{
+			uint32_t trigger = adcs[adc_index].trigger;
+
+			if ( (adcs[adc_index].started == true) &&
+				 (trigger >= 1) && (trigger <= SIM_ADC_HRTIM_TRIGGERS) )
+			{
+				_sim_adc_convert(adc_index);
+			}
+		}
+
+		time_ns += trigger_period_ns;
+
+		if (sim_kernel_is_idle_until(time_ns) == false)
+			break;
+
+		uint64_t now_ns = sim_time_get_ns();
+		if (time_ns > now_ns)
+		{
+			sim_time_advance_ns(time_ns - now_ns);
+		}
+	}
+
+	sim_event_schedule(&trigger_event, time_ns);
+}
+
+
+/* ADC core API */
+
+void adc_core_init()
+{
+}
+
+void adc_core_enable(uint8_t adc_num)
+{
+	adcs[adc_num - 1].enabled = true;
+}
+
+void adc_core_start(uint8_t adc_num, uint8_t sequence_length)
+{
+	sim_adc_t* adc = &adcs[adc_num - 1];
+
+	if (adc->enabled == false)
+		return;
+
+	adc->sequence_length = sequence_length;
+	adc->next_rank       = 0;
+
+	if (adc->trigger == LL_ADC_REG_TRIG_SOFTWARE)
+	{
+		_sim_adc_convert(adc_num - 1);
+	}
+	else
+	{
+		adc->started = true;
+	}
+}
+
+void adc_core_stop(uint8_t adc_num)
+{
+	adcs[adc_num - 1].started = false;
+}
+
+void adc_core_configure_dma_mode(uint8_t adc_num, bool use_dma)
+{
+	adcs[adc_num - 1].use_dma = use_dma;
+}
+
+void adc_core_configure_trigger_source(uint8_t adc_num,
+									   uint32_t external_trigger_edge,
+									   uint32_t trigger_source)
+{
+	(void)external_trigger_edge;
+
+	adcs[adc_num - 1].trigger = trigger_source;
+}
+
+void adc_core_configure_discontinuous_mode(uint8_t adc_num,
+										   uint32_t discontinuous_count)
+{
+	adcs[adc_num - 1].discontinuous_count = discontinuous_count;
+}
+
+void adc_core_set_channel_differential(uint8_t adc_num,
+									   uint8_t channel,
+									   bool enable_differential)
+{
+	if ( (channel == 0) || (channel > SIM_ADC_CHANNELS_COUNT) )
+		return;
+
+	adcs[adc_num - 1].differential[channel - 1] = enable_differential;
+}
+
+void adc_core_configure_channel(uint8_t adc_num, uint8_t channel, uint8_t rank)
+{
+	if ( (rank == 0) || (rank > SIM_ADC_RANKS_COUNT) )
+		return;
+
+	adcs[adc_num - 1].ranks[rank - 1] = channel;
+}
+
+
+/* Public API */
+
+void sim_adc_set_waveform(uint8_t adc_number,
+						  uint8_t channel,
+						  const sim_waveform_t* waveform)
+{
+	if ( (adc_number == 0) || (adc_number > SIM_ADC_COUNT) ||
+		 (channel == 0) || (channel > SIM_ADC_CHANNELS_COUNT) ||
+		 (waveform == nullptr) )
+		return;
+
+	waveforms[adc_number - 1][channel - 1] = *waveform;
+}
+
+void sim_adc_set_noise_seed(uint32_t seed)
+{
+	/* xorshift state must not be 0 */
+	noise_state = (seed != 0) ? seed : 1;
+}
+
+void sim_adc_hrtim_trigger(uint8_t trigger_number)
+{
+	for (uint8_t adc_index = 0 ; adc_index < SIM_ADC_COUNT ; adc_index++)
+	{
+		if ( (adcs[adc_index].started == true) &&
+			 (adcs[adc_index].trigger == trigger_number) )
+		{
+			_sim_adc_convert(adc_index);
+		}
+	}
+}
+
+void sim_adc_set_trigger_period_ns(uint64_t period_ns)
+{
+	trigger_period_ns = period_ns;
+
+	if (period_ns == 0)
+	{
+		sim_event_cancel(&trigger_event);
+		return;
+	}
+
+	uint64_t now_ns = sim_time_get_ns();
+	sim_event_schedule(&trigger_event, (now_ns / period_ns + 1) * period_ns);
+}
+
+uint64_t sim_adc_get_trigger_period_ns()
+{
+	return trigger_period_ns;
+}
+
+void sim_adc_run(uint8_t trigger_number, uint32_t frequency, uint32_t count)
+{
+	if (frequency == 0)
+		return;
+
+	uint64_t period_ns = 1000000000ULL / frequency;
+
+	for (uint32_t i = 0 ; i < count ; i++)
+	{
+		sim_time_advance_ns(period_ns);
+		sim_adc_hrtim_trigger(trigger_number);
+	}
+}
+
+uint64_t sim_adc_get_conversions_count(uint8_t adc_number)
+{
+	if ( (adc_number == 0) || (adc_number > SIM_ADC_COUNT) )
+		return 0;
+
+	return adcs[adc_number - 1].conversions_count;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Simulated console output of the host build. Writing takes no
+ *         simulated time.
+ */
+
+
+/* Zephyr */
+#include <zephyr/console/console.h>
+
+/* Current file header */
+#include "sim/sim_console.h"
+
+
+/**
+ *  Local variables
+ */
+
+static FILE* console_output = nullptr;
+
+
+/* Public API */
+
+void sim_console_set_output(FILE* output)
+{
+	console_output = output;
+}
+
+ssize_t console_write(void* dummy, const void* buf, size_t size)
+{
+	(void)dummy;
+
+	if (console_output != nullptr)
+	{
+		fwrite(buf, 1, size, console_output);
+	}
+
+	return size;
+}
@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Host build replacement of uninterruptible_synchronous_task.cpp:
+ *         the HRTIM and TIM6 interrupts are replaced by a simulated kernel
+ *         event. Data management is the same as on the target.
+ */
+
+
+/* Task API private functions */
+#include "scheduling_common.h"
+#include "uninterruptible_synchronous_task.h"
+
+/* OwnTech Power API */
+#include "adc.h"
+#include "SpinAPI.h"
+
+/* Event trace */
+#include "event_trace.h"
+
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+#include "task_overrun.h"
+#endif
+
+/* Simulator */
+#include "sim/sim_adc.h"
+#include "sim/sim_hrtim.h"
+#include "sim/sim_kernel.h"
+#include "sim/sim_time.h"
+
+/* Current file header */
+#include "sim/sim_task.h"
+
+
+/**
+ *  Local variables
+ */
+
+static void _critical_task_event_handler(void* arg);
+
+/* Task status */
+static task_status_t uninterruptibleTaskStatus = task_status_t::inexistent;
+
+/* Interrupt source */
+static scheduling_interrupt_source_t interrupt_source = source_uninitialized;
+static uint8_t trigger_adc_number = 1;
+
+/* Task */
+static task_function_t user_periodic_task = NULL;
+static uint32_t task_period = 0;
+static bool do_data_dispatch = false;
+
+/* Simulated HRTIM */
+static uint64_t hrtim_period_ns = SIM_TASK_DEFAULT_HRTIM_PERIOD_NS;
+
+/* Start of the next period, the event may run later after an overrun */
+static uint64_t next_period_ns = 0;
+
+/* Simulated execution time of the current run */
+static uint64_t execution_ns = 0;
+
+static sim_event_t critical_task_event = { _critical_task_event_handler,
+										   nullptr,
+										   SIM_EVENT_PRIORITY_CRITICAL_TASK,
+										   0,
+										   false };
+
+
+/* Private API */
+
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+/**
+ * @brief PRIVATE FUNCTION - Checks if the next period started before the
+ *        end of the simulated execution.
+ */
+static bool _overrun_pending()
+{
+	return sim_time_get_ns() + execution_ns >= next_period_ns;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Applies the overrun policy. The pending event
+ *        runs the task at the end of the execution, or is dropped so that
+ *        the task runs on the first period starting after the execution.
+ */
+static void _overrun_handle()
+{
+	uint64_t end_ns = sim_time_get_ns() + execution_ns;
+
+	switch (task_overrun_record())
+	{
+		case overrun_action_drop_event:
+			while (next_period_ns <= end_ns)
+			{
+				next_period_ns += (uint64_t)task_period * 1000;
+			}
+			sim_event_schedule(&critical_task_event, next_period_ns);
+			break;
+		case overrun_action_stop:
+			scheduling_stop_uninterruptible_synchronous_task();
+			break;
+		case overrun_action_none:
+		default:
+			sim_event_schedule(&critical_task_event, end_ns);
+			break;
+	}
+}
+#endif
+
+void user_task_proxy()
+{
+	OWNTECH_TRACE(TRACE_EVENT_CRITICAL_BEGIN, 0);
+
+	execution_ns = 0;
+
+	if (user_periodic_task == NULL)
+	{
+		OWNTECH_TRACE(TRACE_EVENT_CRITICAL_END, 0);
+		return;
+	}
+
+	if (do_data_dispatch == true)
+	{
+		spin.data.doFullDispatch();
+	}
+
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+	bool run_user_code = (task_overrun_degraded_skip() == false);
+#else
+	bool run_user_code = true;
+#endif
+
+	if (run_user_code == true)
+	{
+		user_periodic_task();
+	}
+
+#ifdef CONFIG_OWNTECH_CAPTURE_API
+	spin.capture.sample();
+#endif
+
+	OWNTECH_TRACE(TRACE_EVENT_CRITICAL_END, 0);
+
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+	if (_overrun_pending() == true)
+	{
+		_overrun_handle();
+	}
+#endif
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Critical task interrupt: runs the task, or
+ *        with the ADC source, arms the end of sequence interrupt that
+ *        runs it once the conversions triggered now are done.
+ */
+static void _critical_task_event_handler(void* arg)
+{
+	(void)arg;
+
+	/* Periods missed during a late run raise a single event */
+	uint64_t now_ns = sim_time_get_ns();
+	do
+	{
+		next_period_ns += (uint64_t)task_period * 1000;
+	} while (next_period_ns <= now_ns);
+
+	sim_event_schedule(&critical_task_event, next_period_ns);
+
+	if (interrupt_source != source_tim6)
+	{
+		OWNTECH_TRACE(TRACE_EVENT_HRTIM_REP, 0);
+	}
+
+	if (interrupt_source == source_adc)
+	{
+		adc_eos_event_arm();
+	}
+	else
+	{
+		/* Interrupts raised by the task run once it returns, as it
+		   preempts them on the target */
+		unsigned int key = irq_lock();
+		user_task_proxy();
+		irq_unlock(key);
+	}
+}
+
+
+/* Public API */
+
+void scheduling_set_uninterruptible_synchronous_task_interrupt_source(
+									scheduling_interrupt_source_t int_source)
+{
+	interrupt_source = int_source;
+}
+
+void scheduling_set_uninterruptible_synchronous_task_adc(uint8_t adc_number)
+{
+	trigger_adc_number = adc_number;
+}
+
+int8_t scheduling_define_uninterruptible_synchronous_task(
+									task_function_t periodic_task,
+									uint32_t task_period_us)
+{
+	if ( (uninterruptibleTaskStatus != task_status_t::inexistent) &&
+		 (uninterruptibleTaskStatus != task_status_t::suspended))
+		return -1;
+
+	if (periodic_task == NULL)
+		return -1;
+
+	if (task_period_us == 0)
+		return -1;
+
+	if (interrupt_source == source_tim6)
+	{
+		task_period = task_period_us;
+		user_periodic_task = periodic_task;
+
+		uninterruptibleTaskStatus = task_status_t::defined;
+
+		return 0;
+	}
+	else if ( (interrupt_source == source_hrtim) ||
+			  (interrupt_source == source_adc) )
+	{
+		if (((uint64_t)task_period_us * 1000) % hrtim_period_ns != 0)
+			return -1;
+
+		task_period = task_period_us;
+		user_periodic_task = periodic_task;
+
+		if (interrupt_source == source_adc)
+		{
+			adc_eos_event_configure(trigger_adc_number, user_task_proxy);
+		}
+
+		uninterruptibleTaskStatus = task_status_t::defined;
+
+		return 0;
+	}
+
+	return -1;
+}
+
+void scheduling_start_uninterruptible_synchronous_task(
+									bool manage_data_acquisition)
+{
+	if ( (uninterruptibleTaskStatus != task_status_t::defined) &&
+		 (uninterruptibleTaskStatus != task_status_t::suspended) )
+		return;
+
+	if (interrupt_source == scheduling_interrupt_source_t::source_uninitialized)
+		return;
+
+	if ( (manage_data_acquisition == true) && (spin.data.started() == false) )
+	{
+		/**
+		 * If Data Acquisition has not been started yet,
+		 * then Scheduling will be in charge of data dispatch
+		 */
+		do_data_dispatch = true;
+
+		/* Configure Data Acquisition module */
+		spin.data.setDispatchMethod(DispatchMethod_t::externally_triggered);
+
+		uint32_t repetition = ((uint64_t)task_period * 1000) / hrtim_period_ns;
+		if (repetition == 0)
+			return;
+
+		spin.data.setRepetitionsBetweenDispatches(repetition);
+
+		/* Then start it */
+		spin.data.start();
+	}
+
+	/* The HRTIM triggers the ADCs at each of its periods, unless the
+	 * simulated HRTIM was configured to trigger them, e.g. by the Power API */
+	if (sim_hrtim_is_triggering_adcs() == true)
+	{
+		sim_adc_set_trigger_period_ns(0);
+	}
+	else if (sim_adc_get_trigger_period_ns() != hrtim_period_ns)
+	{
+		sim_adc_set_trigger_period_ns(hrtim_period_ns);
+	}
+
+	uint64_t now_ns = sim_time_get_ns();
+	uint64_t first_run_ns;
+
+	if (interrupt_source == source_tim6)
+	{
+		first_run_ns = now_ns + (uint64_t)task_period * 1000;
+	}
+	else
+	{
+		/* HRTIM repetition events fall on HRTIM periods */
+		first_run_ns = (now_ns / hrtim_period_ns + 1) * hrtim_period_ns
+					 + ((uint64_t)task_period * 1000) - hrtim_period_ns;
+	}
+
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+	scheduling_clear_overrun();
+#endif
+
+	if (interrupt_source == source_adc)
+	{
+		adc_eos_event_enable();
+	}
+
+	next_period_ns = first_run_ns;
+	sim_event_schedule(&critical_task_event, first_run_ns);
+
+	uninterruptibleTaskStatus = task_status_t::running;
+}
+
+void scheduling_stop_uninterruptible_synchronous_task()
+{
+	if (uninterruptibleTaskStatus != task_status_t::running)
+		return;
+
+	sim_event_cancel(&critical_task_event);
+
+	if (interrupt_source == source_adc)
+	{
+		adc_eos_event_disable();
+	}
+
+	uninterruptibleTaskStatus = task_status_t::suspended;
+}
+
+
+/* Simulator API */
+
+void sim_task_set_hrtim_period_ns(uint64_t period_ns)
+{
+	if (period_ns != 0)
+	{
+		hrtim_period_ns = period_ns;
+	}
+}
+
+uint64_t sim_task_get_hrtim_period_ns()
+{
+	return hrtim_period_ns;
+}
+
+void sim_task_consume_ns(uint64_t duration_ns)
+{
+	execution_ns += duration_ns;
+}
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+
+/* Stdlib */
+#include <chrono>
+
+/* Zephyr */
+#include <zephyr/drivers/dma.h>
+
+/* STM32 LL */
+#include <stm32_ll_dma.h>
+
+/* Current file header */
+#include "sim/sim_dma.h"
+
+/* Simulator */
+#include "sim/sim_irq.h"
+
+
+/**
+ *  Simulated peripherals
+ */
+
+DMA_TypeDef sim_dma1_registers = {};
+
+/* DMA 2 runs from its registers, the DMAMUX only holds them */
+DMA_TypeDef sim_dma2_registers = {};
+DMAMUX_Channel_TypeDef sim_dmamux1_channels[16] = {};
+
+extern "C" const struct device sim_device_dma1 = { "dma1" };
+
+
+/**
+ *  Local variables
+ */
+
+typedef struct
+{
+	bool           configured;
+	uint32_t       request;
+	uintptr_t      source;
+	uintptr_t      destination;
+	uint32_t       data_size;
+	uint32_t       length; /* In data */
+	dma_callback_t callback;
+	void*          user_data;
+	sim_dma_stats_t stats;
+} sim_dma_channel_t;
+
+static sim_dma_channel_t channels[SIM_DMA_CHANNELS_COUNT] = {};
+static bool              callback_timing = false;
+
+/* DMA 2 channel state latched on enable, as the target does */
+typedef struct
+{
+	uintptr_t address; /* Next memory address */
+	uint32_t  reload;  /* Count reloaded in circular mode */
+} sim_dma2_channel_t;
+
+static sim_dma2_channel_t dma2_channels[SIM_DMA_CHANNELS_COUNT] = {};
+
+/* Interrupt lines of DMA 2 channels, only channel 1 is simulated */
+static const unsigned int dma2_irq_lines[SIM_DMA_CHANNELS_COUNT] =
+{
+	DMA2_Channel1_IRQn, 0, 0, 0, 0, 0, 0, 0
+};
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the state of a channel numbered as in
+ *        the Zephyr API, or nullptr if out of range.
+ */
+static sim_dma_channel_t* _sim_dma_get_channel(uint32_t channel)
+{
+	if ( (channel == 0) || (channel > SIM_DMA_CHANNELS_COUNT) )
+		return nullptr;
+
+	return &channels[channel - 1];
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Calls the user callback of a channel and
+ *        accounts for the host time spent in it if enabled.
+ */
+static void _sim_dma_callback(uint32_t channel, int status)
+{
+	sim_dma_channel_t* state = &channels[channel - 1];
+
+	if (state->callback == nullptr)
+		return;
+
+	state->stats.callbacks++;
+
+	if (callback_timing == false)
+	{
+		state->callback(&sim_device_dma1, state->user_data, channel, status);
+		return;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	state->callback(&sim_device_dma1, state->user_data, channel, status);
+
+	auto end = std::chrono::steady_clock::now();
+	uint64_t duration_ns =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+	state->stats.callbacks_time_ns += duration_ns;
+	if (duration_ns > state->stats.callback_max_time_ns)
+	{
+		state->stats.callback_max_time_ns = duration_ns;
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Transfers one data on a channel, in circular
+ *        mode, and calls the callback on half and full transfer.
+ */
+static void _sim_dma_transfer(uint32_t channel)
+{
+	sim_dma_channel_t*   state     = &channels[channel - 1];
+	DMA_Channel_TypeDef* registers = &sim_dma1_registers.channels[channel - 1];
+
+	uint32_t index = state->length - registers->CNDTR;
+	uint32_t value = *(volatile uint32_t*)state->source;
+
+	if (state->data_size == 2)
+	{
+		((uint16_t*)state->destination)[index] = (uint16_t)value;
+	}
+	else
+	{
+		((uint32_t*)state->destination)[index] = value;
+	}
+
+	state->stats.transfers++;
+	registers->CNDTR = registers->CNDTR - 1;
+
+	if ( (registers->CNDTR == state->length / 2) &&
+		 (registers->CCR & DMA_CCR_HTIE) )
+	{
+		_sim_dma_callback(channel, DMA_STATUS_BLOCK);
+	}
+
+	if (registers->CNDTR == 0)
+	{
+		registers->CNDTR = state->length;
+
+		if (registers->CCR & DMA_CCR_TCIE)
+		{
+			_sim_dma_callback(channel, DMA_STATUS_COMPLETE);
+		}
+	}
+}
+
+
+/* Zephyr API */
+
+int dma_config(const struct device* dev,
+			   uint32_t channel,
+			   struct dma_config* config)
+{
+	sim_dma_channel_t* state = _sim_dma_get_channel(channel);
+
+	if ( (dev != &sim_device_dma1) || (state == nullptr) ||
+		 (config->head_block == nullptr) || (config->dest_data_size == 0) )
+		return -1;
+
+	DMA_Channel_TypeDef* registers = &sim_dma1_registers.channels[channel - 1];
+
+	state->configured  = true;
+	state->request     = config->dma_slot;
+	state->source      = (uintptr_t)config->head_block->source_address;
+	state->destination = (uintptr_t)config->head_block->dest_address;
+	state->data_size   = config->dest_data_size;
+	state->length      = config->head_block->block_size / config->dest_data_size;
+	state->callback    = config->dma_callback;
+	state->user_data   = config->user_data;
+
+	/* The driver enables both interrupts in circular mode */
+	registers->CCR   = DMA_CCR_HTIE | DMA_CCR_TCIE;
+	registers->CNDTR = state->length;
+
+	return 0;
+}
+
+int dma_reload(const struct device* dev,
+			   uint32_t channel,
+			   uint64_t src,
+			   uint64_t dst,
+			   size_t size)
+{
+	sim_dma_channel_t* state = _sim_dma_get_channel(channel);
+
+	if ( (dev != &sim_device_dma1) || (state == nullptr) ||
+		 (state->configured == false) )
+		return -1;
+
+	state->source      = (uintptr_t)src;
+	state->destination = (uintptr_t)dst;
+	state->length      = size / state->data_size;
+
+	sim_dma1_registers.channels[channel - 1].CNDTR = state->length;
+
+	return 0;
+}
+
+int dma_start(const struct device* dev, uint32_t channel)
+{
+	sim_dma_channel_t* state = _sim_dma_get_channel(channel);
+
+	if ( (dev != &sim_device_dma1) || (state == nullptr) ||
+		 (state->configured == false) )
+		return -1;
+
+	DMA_Channel_TypeDef* registers = &sim_dma1_registers.channels[channel - 1];
+	registers->CCR = registers->CCR | DMA_CCR_EN;
+
+	return 0;
+}
+
+int dma_stop(const struct device* dev, uint32_t channel)
+{
+	sim_dma_channel_t* state = _sim_dma_get_channel(channel);
+
+	if ( (dev != &sim_device_dma1) || (state == nullptr) )
+		return -1;
+
+	DMA_Channel_TypeDef* registers = &sim_dma1_registers.channels[channel - 1];
+	registers->CCR = registers->CCR & ~DMA_CCR_EN;
+
+	return 0;
+}
+
+
+/* LL API */
+
+void sim_dma2_channel_enabled(uint32_t channel)
+{
+	if (channel >= SIM_DMA_CHANNELS_COUNT)
+		return;
+
+	DMA_Channel_TypeDef* registers = &sim_dma2_registers.channels[channel];
+
+	dma2_channels[channel].address = registers->CMAR;
+	dma2_channels[channel].reload  = registers->CNDTR;
+}
+
+
+/* Public API */
+
+void sim_dma_request(uint32_t request)
+{
+	for (uint32_t channel = 1 ; channel <= SIM_DMA_CHANNELS_COUNT ; channel++)
+	{
+		sim_dma_channel_t* state = &channels[channel - 1];
+
+		if ( (state->configured == false) || (state->request != request) )
+			continue;
+
+		if ( (sim_dma1_registers.channels[channel - 1].CCR & DMA_CCR_EN) == 0 )
+			continue;
+
+		_sim_dma_transfer(channel);
+	}
+}
+
+bool sim_dma2_transfer(uint32_t request, uint32_t* data)
+{
+	for (uint32_t channel = 0 ; channel < SIM_DMA_CHANNELS_COUNT ; channel++)
+	{
+		DMA_Channel_TypeDef* registers = &sim_dma2_registers.channels[channel];
+		sim_dma2_channel_t*  state     = &dma2_channels[channel];
+
+		if ( ((registers->CCR & DMA_CCR_EN) == 0) || (registers->CNDTR == 0) ||
+			 ((sim_dmamux1_channels[channel + 8].CCR & DMAMUX_CxCR_DMAREQ_ID) !=
+			  request) )
+			continue;
+
+		*data = *(const uint32_t*)state->address;
+
+		state->address   += sizeof(uint32_t);
+		registers->CNDTR  = registers->CNDTR - 1;
+
+		if (registers->CNDTR == 0)
+		{
+			if (registers->CCR & DMA_CCR_CIRC)
+			{
+				state->address   = registers->CMAR;
+				registers->CNDTR = state->reload;
+			}
+
+			sim_dma2_registers.ISR = sim_dma2_registers.ISR |
+									 (DMA_ISR_TCIF1 << (4 * channel));
+
+			if ( (registers->CCR & DMA_CCR_TCIE) &&
+				 (dma2_irq_lines[channel] != 0) )
+			{
+				sim_irq_raise(dma2_irq_lines[channel]);
+			}
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+void sim_dma_get_stats(uint32_t channel, sim_dma_stats_t* stats)
+{
+	sim_dma_channel_t* state = _sim_dma_get_channel(channel);
+
+	if ( (state == nullptr) || (stats == nullptr) )
+		return;
+
+	*stats = state->stats;
+}
+
+void sim_dma_reset_stats()
+{
+	for (uint32_t channel = 0 ; channel < SIM_DMA_CHANNELS_COUNT ; channel++)
+	{
+		channels[channel].stats = {};
+	}
+}
+
+void sim_dma_enable_callback_timing(bool enable)
+{
+	callback_timing = enable;
+}
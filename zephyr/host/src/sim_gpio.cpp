@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ */
+
+
+/* Stdlib */
+#include <errno.h>
+
+/* Current file header */
+#include "sim/sim_gpio.h"
+
+
+/**
+ *  Simulated peripherals
+ */
+
+extern "C" const struct device sim_device_gpioa = { "gpioa" };
+extern "C" const struct device sim_device_gpiob = { "gpiob" };
+extern "C" const struct device sim_device_gpioc = { "gpioc" };
+extern "C" const struct device sim_device_gpiod = { "gpiod" };
+
+
+/**
+ *  Local variables
+ */
+
+#define SIM_GPIO_PORTS_COUNT 4
+#define SIM_GPIO_PINS_COUNT  16
+
+typedef struct
+{
+	gpio_flags_t flags[SIM_GPIO_PINS_COUNT];
+	uint16_t     output;  /* Levels driven by the application */
+	uint16_t     input;   /* Levels set by the simulation */
+} sim_gpio_port_t;
+
+static const struct device* const devices[SIM_GPIO_PORTS_COUNT] =
+{
+	&sim_device_gpioa, &sim_device_gpiob, &sim_device_gpioc, &sim_device_gpiod
+};
+
+static sim_gpio_port_t ports[SIM_GPIO_PORTS_COUNT] = {};
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the simulated port of a device,
+ *        nullptr for an invalid device or pin.
+ */
+static sim_gpio_port_t* _sim_gpio_port(const struct device* port,
+									   gpio_pin_t pin)
+{
+	if (pin >= SIM_GPIO_PINS_COUNT)
+		return nullptr;
+
+	for (uint8_t i = 0 ; i < SIM_GPIO_PORTS_COUNT ; i++)
+	{
+		if (devices[i] == port)
+			return &ports[i];
+	}
+
+	return nullptr;
+}
+
+
+/* Zephyr API */
+
+int gpio_pin_configure(const struct device* port,
+					   gpio_pin_t pin,
+					   gpio_flags_t flags)
+{
+	sim_gpio_port_t* state = _sim_gpio_port(port, pin);
+
+	if (state == nullptr)
+		return -EINVAL;
+
+	state->flags[pin] = flags;
+
+	return 0;
+}
+
+int gpio_pin_set(const struct device* port, gpio_pin_t pin, int value)
+{
+	sim_gpio_port_t* state = _sim_gpio_port(port, pin);
+
+	if (state == nullptr)
+		return -EINVAL;
+
+	if (value != 0)
+	{
+		state->output |= (1U << pin);
+	}
+	else
+	{
+		state->output &= ~(1U << pin);
+	}
+
+	return 0;
+}
+
+int gpio_pin_get(const struct device* port, gpio_pin_t pin)
+{
+	return sim_gpio_get(port, pin);
+}
+
+int gpio_pin_toggle(const struct device* port, gpio_pin_t pin)
+{
+	sim_gpio_port_t* state = _sim_gpio_port(port, pin);
+
+	if (state == nullptr)
+		return -EINVAL;
+
+	state->output ^= (1U << pin);
+
+	return 0;
+}
+
+
+/* Public API */
+
+int sim_gpio_get(const struct device* port, gpio_pin_t pin)
+{
+	sim_gpio_port_t* state = _sim_gpio_port(port, pin);
+
+	if (state == nullptr)
+		return -EINVAL;
+
+	if (state->flags[pin] & GPIO_OUTPUT)
+		return (state->output >> pin) & 1U;
+
+	return (state->input >> pin) & 1U;
+}
+
+void sim_gpio_set_input(const struct device* port, gpio_pin_t pin, int value)
+{
+	sim_gpio_port_t* state = _sim_gpio_port(port, pin);
+
+	if (state == nullptr)
+		return;
+
+	if (value != 0)
+	{
+		state->input |= (1U << pin);
+	}
+	else
+	{
+		state->input &= ~(1U << pin);
+	}
+}
@@ -0,0 +1,2356 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Simulated HRTIM1: counters, output crossbar, dead time, burst
+ *         mode, ADC triggers, repetition interrupts and burst DMA, at the
+ *         tick of the high resolution clock.
+ */
+
+
+/* Stdlib */
+#include <string.h>
+
+/* STM32 LL */
+#include <stm32_ll_dma.h>
+#include <stm32_ll_hrtim.h>
+
+/* Simulator */
+#include "sim/sim_adc.h"
+#include "sim/sim_dma.h"
+#include "sim/sim_irq.h"
+#include "sim/sim_kernel.h"
+#include "sim/sim_plant.h"
+#include "sim/sim_time.h"
+
+/* Current file header */
+#include "sim/sim_hrtim.h"
+
+
+/**
+ *  Simulated peripherals
+ */
+
+HRTIM_TypeDef sim_hrtim1_registers = {};
+
+/* Clock and pins only hold what the HRTIM driver writes */
+RCC_TypeDef  sim_rcc_registers     = {};
+GPIO_TypeDef sim_gpio_registers[3] = {};
+
+
+/**
+ *  Local variables
+ */
+
+/* Counter 0 is the master, 1 to 6 are timers A to F */
+#define SIM_HRTIM_COUNTERS_COUNT 7
+#define SIM_HRTIM_UNITS_COUNT    6
+#define SIM_HRTIM_ADC_TRIGGERS   4
+#define SIM_HRTIM_NEVER          UINT64_MAX
+
+/* Tick conversions: a tick is 25/136 ns */
+#define SIM_HRTIM_TICKS_PER_NS_NUM 136
+#define SIM_HRTIM_TICKS_PER_NS_DEN 25
+
+/* Burst mode clock sources of BMCLK for each counter */
+static const uint32_t burst_clock_sources[SIM_HRTIM_COUNTERS_COUNT] =
+{
+	0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0xB
+};
+
+static const unsigned int irq_lines[SIM_HRTIM_COUNTERS_COUNT] =
+{
+	HRTIM1_Master_IRQn,
+	HRTIM1_TIMA_IRQn, HRTIM1_TIMB_IRQn, HRTIM1_TIMC_IRQn,
+	HRTIM1_TIMD_IRQn, HRTIM1_TIME_IRQn, HRTIM1_TIMF_IRQn
+};
+
+/* ADC trigger 1 and 3 sources of each timer, 0 when not available:
+ * compare 2, compare 3, compare 4, period, reset */
+#define SIM_HRTIM_ADC_SOURCES_COUNT 5
+
+static const uint32_t adc_unit_sources[SIM_HRTIM_UNITS_COUNT]
+									  [SIM_HRTIM_ADC_SOURCES_COUNT] =
+{
+	{ 0,       1U << 11, 1U << 12, 1U << 13, 1U << 14 },
+	{ 0,       1U << 16, 1U << 17, 1U << 18, 1U << 19 },
+	{ 0,       1U << 21, 1U << 22, 1U << 23, 0        },
+	{ 0,       1U << 25, 1U << 26, 1U << 27, 0        },
+	{ 0,       1U << 29, 1U << 30, 1U << 31, 0        },
+	{ 1U << 10, 1U << 15, 1U << 20, 1U << 24, 1U << 28 }
+};
+
+/* Events of a counter at a tick */
+typedef struct
+{
+	uint8_t cmp_up;     /* Compares 1 to 4 matched counting up */
+	uint8_t cmp_down;   /* Compares 1 to 4 matched counting down */
+	bool    period;     /* Period event: rollover in up mode, crest in up-down */
+	bool    period_end; /* Counter back to 0, by rollover or reset */
+	bool    reset;      /* Counter reset by another event */
+} sim_hrtim_events_t;
+
+typedef struct
+{
+	bool     running;
+	uint32_t ckpsc;
+	bool     up_down;
+	uint64_t origin;        /* Tick at which the counter was at 0 */
+	uint32_t position;      /* Position of the last event */
+	uint32_t next_position;
+	uint64_t next_tick;
+	uint32_t period;        /* Active registers */
+	uint32_t compare[4];
+	uint32_t repetition;
+	uint32_t repetition_counter;
+} sim_hrtim_counter_t;
+
+typedef struct
+{
+	bool     out1;          /* Crossbar outputs */
+	bool     out2;
+	bool     dt_out1;       /* Outputs after dead time */
+	bool     dt_out2;
+	bool     pending;       /* Edge delayed by the dead time */
+	uint64_t pending_tick;
+	bool     pending_out1;  /* Rising edge of output 1, else of output 2 */
+	uint8_t  leg;           /* Plant leg, 0 if none */
+	bool     duty_started;
+	uint64_t duty_start_tick;
+	uint64_t high_since_tick;
+	uint64_t high_ticks;
+	bool     duty_changed;  /* Averaged mode: registers written since the
+							 * last duty cycle given to the plant */
+	float    duty;
+} sim_hrtim_unit_t;
+
+/* Averaged mode: positions of some events of a counter in its period,
+ * between 1 and the length of the period, sorted */
+#define SIM_HRTIM_POSITIONS_MAX 12
+
+typedef struct
+{
+	uint8_t  count;
+	uint32_t position[SIM_HRTIM_POSITIONS_MAX];
+} sim_hrtim_positions_t;
+
+/* Averaged mode: events of a timer in its period changing its outputs */
+typedef struct
+{
+	uint32_t position;
+	uint32_t up;
+	uint32_t down;
+} sim_hrtim_output_event_t;
+
+static sim_hrtim_counter_t counters[SIM_HRTIM_COUNTERS_COUNT] = {};
+static sim_hrtim_unit_t    units[SIM_HRTIM_UNITS_COUNT]       = {};
+static bool                pins[SIM_HRTIM_OUTPUTS_COUNT]      = {};
+
+static uint32_t burst_count           = 0;
+static uint32_t burst_prescaler_count = 0;
+static bool     burst_idle            = false;
+
+static uint32_t adc_postscaler_counts[SIM_HRTIM_ADC_TRIGGERS] = {};
+
+/* Counters with a repetition event at the current tick, and whether the
+ * master update took place */
+static uint32_t repetition_events = 0;
+static bool     master_updated    = false;
+
+/* Averaged mode: positions of the ADC trigger sources and of the rollovers
+ * of each counter, computed again when the registers change */
+static sim_hrtim_positions_t adc_positions[SIM_HRTIM_ADC_TRIGGERS]
+										  [SIM_HRTIM_COUNTERS_COUNT] = {};
+static sim_hrtim_positions_t rollover_positions[SIM_HRTIM_COUNTERS_COUNT] = {};
+static uint8_t adc_source_counters[SIM_HRTIM_ADC_TRIGGERS] = {};
+
+/* Averaged mode: ticks of the next repetition event of each counter and of
+ * the next output of each ADC trigger. The state in between, repetition
+ * counters and postscaler counts, is only computed when the registers
+ * change: postscaler counts are those at their count tick. */
+static uint64_t repetition_ticks[SIM_HRTIM_COUNTERS_COUNT] = {};
+static uint64_t adc_trigger_ticks[SIM_HRTIM_ADC_TRIGGERS] = {};
+static uint64_t adc_count_ticks[SIM_HRTIM_ADC_TRIGGERS]   = {};
+
+/* Averaged mode: registers as last applied */
+static HRTIM_TypeDef applied_registers = {};
+
+static uint64_t current_tick = 0;
+static bool     in_run       = false;
+static bool     averaged     = false;
+
+static sim_hrtim_edge_handler_t edge_handler     = nullptr;
+static void*                    edge_handler_arg = nullptr;
+
+static void _sim_hrtim_event_handler(void* arg);
+
+static sim_event_t hrtim_event = { _sim_hrtim_event_handler,
+								   nullptr,
+								   SIM_EVENT_PRIORITY_HRTIM,
+								   0,
+								   false };
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the control register of a counter,
+ *        master MCR or timer TIMxCR, which share their fields.
+ */
+static uint32_t _sim_hrtim_cr(uint8_t counter)
+{
+	if (counter == 0)
+		return HRTIM1->sMasterRegs.MCR;
+
+	return HRTIM1->sTimerxRegs[counter - 1].TIMxCR;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Transfers the preload registers of a counter
+ *        to its active registers.
+ */
+static void _sim_hrtim_load(uint8_t counter)
+{
+	sim_hrtim_counter_t* cnt = &counters[counter];
+
+	if (counter == 0)
+	{
+		HRTIM_Master_TypeDef* regs = &HRTIM1->sMasterRegs;
+		cnt->period     = regs->MPER & 0xFFFFU;
+		cnt->compare[0] = regs->MCMP1R & 0xFFFFU;
+		cnt->compare[1] = regs->MCMP2R & 0xFFFFU;
+		cnt->compare[2] = regs->MCMP3R & 0xFFFFU;
+		cnt->compare[3] = regs->MCMP4R & 0xFFFFU;
+		cnt->repetition = regs->MREP & 0xFFU;
+	}
+	else
+	{
+		HRTIM_Timerx_TypeDef* regs = &HRTIM1->sTimerxRegs[counter - 1];
+		cnt->period     = regs->PERxR & 0xFFFFU;
+		cnt->compare[0] = regs->CMP1xR & 0xFFFFU;
+		cnt->compare[1] = regs->CMP2xR & 0xFFFFU;
+		cnt->compare[2] = regs->CMP3xR & 0xFFFFU;
+		cnt->compare[3] = regs->CMP4xR & 0xFFFFU;
+		cnt->repetition = regs->REPxR & 0xFFU;
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the number of positions of a counter
+ *        period: the period in up mode, twice the period in up-down mode.
+ */
+static uint32_t _sim_hrtim_length(const sim_hrtim_counter_t* cnt)
+{
+	return (cnt->up_down == true) ? 2 * cnt->period : cnt->period;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Finds the next position at which a counter
+ *        raises an event, after its current position. In up-down mode,
+ *        positions beyond the period count down: position p is the counter
+ *        value 2 x period - p.
+ */
+static void _sim_hrtim_compute_next(uint8_t counter)
+{
+	sim_hrtim_counter_t* cnt = &counters[counter];
+
+	if ( (cnt->running == false) || (cnt->period == 0) )
+	{
+		cnt->next_tick = SIM_HRTIM_NEVER;
+		return;
+	}
+
+	uint32_t position = cnt->position;
+	if (current_tick > cnt->origin)
+	{
+		uint64_t elapsed = (current_tick - cnt->origin) >> cnt->ckpsc;
+		if (elapsed > position)
+		{
+			position = (uint32_t)elapsed;
+		}
+	}
+
+	uint32_t length = _sim_hrtim_length(cnt);
+	uint32_t next   = length;
+
+	if ( (cnt->up_down == true) && (cnt->period > position) )
+	{
+		next = cnt->period;
+	}
+
+	for (uint8_t i = 0 ; i < 4 ; i++)
+	{
+		uint32_t cmp = cnt->compare[i];
+
+		if ( (cmp > position) && (cmp <= cnt->period) && (cmp < next) )
+		{
+			next = cmp;
+		}
+
+		if ( (cnt->up_down == true) && (cmp > 0) && (cmp < cnt->period) )
+		{
+			uint32_t down = length - cmp;
+			if ( (down > position) && (down < next) )
+			{
+				next = down;
+			}
+		}
+	}
+
+	/* Period shortened below the counter: roll over at once */
+	if (next <= position)
+	{
+		next = position + 1;
+	}
+
+	cnt->next_position = next;
+	cnt->next_tick     = cnt->origin + ((uint64_t)next << cnt->ckpsc);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Clocks the burst mode controller.
+ */
+static void _sim_hrtim_burst_clock()
+{
+	HRTIM_Common_TypeDef* common = &HRTIM1->sCommonRegs;
+
+	if ( ((common->BMCR & HRTIM_BMCR_BME) == 0) ||
+		 ((common->BMCR & HRTIM_BMCR_BMSTAT) == 0) )
+		return;
+
+	uint32_t prescaler = (common->BMCR & HRTIM_BMCR_BMPRSC) >> 6;
+	burst_prescaler_count++;
+	if (burst_prescaler_count < (1U << prescaler))
+		return;
+	burst_prescaler_count = 0;
+
+	burst_count++;
+	if (burst_count > common->BMPER)
+	{
+		burst_count = 0;
+
+		if ((common->BMCR & HRTIM_BMCR_BMOM) == 0)
+		{
+			common->BMCR = common->BMCR & ~HRTIM_BMCR_BMSTAT;
+			burst_idle   = false;
+			return;
+		}
+	}
+
+	burst_idle = (burst_count <= common->BMCMPR);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Raises the repetition flag of a counter.
+ *
+ * @return true if the repetition interrupt is enabled.
+ */
+static bool _sim_hrtim_repetition_flag(uint8_t counter)
+{
+	if (counter == 0)
+	{
+		HRTIM1->sMasterRegs.MISR = HRTIM1->sMasterRegs.MISR | HRTIM_MISR_MREP;
+		return (HRTIM1->sMasterRegs.MDIER & HRTIM_MDIER_MREPIE) != 0;
+	}
+
+	HRTIM_Timerx_TypeDef* regs = &HRTIM1->sTimerxRegs[counter - 1];
+	regs->TIMxISR = regs->TIMxISR | HRTIM_MISR_MREP;
+
+	return (regs->TIMxDIER & HRTIM_MDIER_MREPIE) != 0;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Handles a rollover of a counter: burst mode
+ *        clock, repetition counter, repetition event and update.
+ *
+ * @return true if a repetition interrupt is requested.
+ */
+static bool _sim_hrtim_rollover(uint8_t counter, bool crest)
+{
+	sim_hrtim_counter_t* cnt = &counters[counter];
+
+	if ( (counter != 0) && (cnt->up_down == true) )
+	{
+		uint32_t rom = (HRTIM1->sTimerxRegs[counter - 1].TIMxCR2 &
+						HRTIM_TIMCR2_ROM) >> 6;
+
+		if ( ((rom == 1) && (crest == false)) ||
+			 ((rom == 2) && (crest == true)) )
+			return false;
+	}
+
+	uint32_t clock_source = (HRTIM1->sCommonRegs.BMCR & HRTIM_BMCR_BMCLK) >> 2;
+	if (clock_source == burst_clock_sources[counter])
+	{
+		_sim_hrtim_burst_clock();
+	}
+
+	if (cnt->repetition_counter > 0)
+	{
+		cnt->repetition_counter--;
+		return false;
+	}
+
+	bool irq = _sim_hrtim_repetition_flag(counter);
+	repetition_events |= (1U << counter);
+
+	uint32_t cr     = _sim_hrtim_cr(counter);
+	uint32_t update = (counter == 0) ? HRTIM_MCR_MREPU : HRTIM_TIMCR_TREPU;
+	bool suspended  = (HRTIM1->sCommonRegs.CR1 & (1U << counter)) != 0;
+	if ( (cr & update) && (suspended == false) )
+	{
+		_sim_hrtim_load(counter);
+		master_updated = master_updated || (counter == 0);
+	}
+
+	cnt->repetition_counter = cnt->repetition;
+
+	return irq;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Raises the events of a counter at its next
+ *        position, then moves it there.
+ *
+ * @return true if a repetition interrupt is requested.
+ */
+static bool _sim_hrtim_counter_event(uint8_t counter, sim_hrtim_events_t* ev)
+{
+	sim_hrtim_counter_t* cnt = &counters[counter];
+	uint64_t tick = cnt->next_tick;
+
+	if ((_sim_hrtim_cr(counter) & HRTIM_MCR_PREEN) == 0)
+	{
+		_sim_hrtim_load(counter);
+	}
+
+	uint32_t position = cnt->next_position;
+	uint32_t length   = _sim_hrtim_length(cnt);
+	bool     end      = (position >= length);
+
+	for (uint8_t i = 0 ; i < 4 ; i++)
+	{
+		uint32_t cmp = cnt->compare[i];
+
+		if ( ( (cmp == position) && (cmp > 0) && (cmp <= cnt->period) ) ||
+			 ( (cmp == 0) && (end == true) ) )
+		{
+			ev->cmp_up |= (1U << i);
+		}
+		else if ( (cnt->up_down == true) && (cmp > 0) &&
+				  (cmp < cnt->period) && (position == length - cmp) )
+		{
+			ev->cmp_down |= (1U << i);
+		}
+	}
+
+	bool irq = false;
+
+	if (end == true)
+	{
+		ev->period     = ev->period || (cnt->up_down == false);
+		ev->period_end = true;
+
+		cnt->origin   = tick;
+		cnt->position = 0;
+
+		irq = _sim_hrtim_rollover(counter, false);
+	}
+	else if ( (cnt->up_down == true) && (position == cnt->period) )
+	{
+		ev->period    = true;
+		cnt->position = position;
+
+		irq = _sim_hrtim_rollover(counter, true);
+	}
+	else
+	{
+		cnt->position = position;
+	}
+
+	_sim_hrtim_compute_next(counter);
+
+	return irq;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the reset sources of a timer raised
+ *        at the current tick, as TIMxRSTR bits.
+ */
+static uint32_t _sim_hrtim_reset_sources(uint8_t unit,
+										 const sim_hrtim_events_t* ev)
+{
+	const sim_hrtim_events_t* own    = &ev[unit + 1];
+	const sim_hrtim_events_t* master = &ev[0];
+	uint32_t sources = 0;
+
+	uint8_t own_cmp = own->cmp_up | own->cmp_down;
+	if (own_cmp & (1U << 1)) sources |= HRTIM_RSTR_CMP2;
+	if (own_cmp & (1U << 3)) sources |= HRTIM_RSTR_CMP4;
+
+	if (master->period == true)
+	{
+		sources |= HRTIM_RSTR_MSTPER;
+	}
+	sources |= (uint32_t)master->cmp_up << 5;
+
+	/* Other timers come in order, skipping this one */
+	uint8_t other = 0;
+	for (uint8_t i = 0 ; (i < SIM_HRTIM_UNITS_COUNT) && (other < 4) ; i++)
+	{
+		if (i == unit)
+			continue;
+
+		uint8_t cmp   = ev[i + 1].cmp_up | ev[i + 1].cmp_down;
+		uint32_t base = HRTIM_RSTR_OTHER1_CMP1 << (3 * other);
+
+		if (cmp & (1U << 0)) sources |= base;
+		if (cmp & (1U << 1)) sources |= base << 1;
+		if (cmp & (1U << 3)) sources |= base << 2;
+
+		other++;
+	}
+
+	return sources;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Sets or resets a crossbar output from its set
+ *        and reset sources. Reset has priority over set.
+ */
+static bool _sim_hrtim_crossbar(bool level, uint32_t set, uint32_t reset,
+								uint32_t up, uint32_t down)
+{
+	uint32_t set_events   = (set & up)   | (reset & down);
+	uint32_t reset_events = (reset & up) | (set & down);
+
+	if (reset_events != 0)
+		return false;
+
+	if (set_events != 0)
+		return true;
+
+	return level;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Updates the crossbar outputs of a timer, and
+ *        its outputs after the dead time.
+ */
+static void _sim_hrtim_outputs(uint8_t unit, uint64_t tick,
+							   const sim_hrtim_events_t* ev)
+{
+	HRTIM_Timerx_TypeDef* regs = &HRTIM1->sTimerxRegs[unit];
+	sim_hrtim_unit_t*     tu   = &units[unit];
+	const sim_hrtim_events_t* own    = &ev[unit + 1];
+	const sim_hrtim_events_t* master = &ev[0];
+
+	/* Compares counting down swap set and reset */
+	uint32_t up   = ((uint32_t)own->cmp_up << 3) |
+					((uint32_t)master->cmp_up << 8);
+	uint32_t down = ((uint32_t)own->cmp_down << 3);
+
+	if (own->period == true)    up |= HRTIM_SET1R_PER;
+	if (master->period == true) up |= HRTIM_SET1R_MSTPER;
+
+	if ( (up == 0) && (down == 0) )
+		return;
+
+	bool out1 = _sim_hrtim_crossbar(tu->out1, regs->SETx1R, regs->RSTx1R,
+									up, down);
+	bool out2 = _sim_hrtim_crossbar(tu->out2, regs->SETx2R, regs->RSTx2R,
+									up, down);
+
+	if ((regs->OUTxR & HRTIM_OUTR_DTEN) == 0)
+	{
+		tu->out1    = out1;
+		tu->out2    = out2;
+		tu->dt_out1 = out1;
+		tu->dt_out2 = out2;
+		return;
+	}
+
+	/* Dead time: output 2 is the complement of output 1, and each rising
+	 * edge is delayed. A new edge replaces the pending one. */
+	if (out1 == tu->out1)
+		return;
+
+	tu->out1 = out1;
+	tu->out2 = !out1;
+
+	uint32_t prescaler = (regs->DTxR & HRTIM_DTR_DTPRSC) >> 10;
+	uint32_t value     = (out1 == true) ? (regs->DTxR & HRTIM_DTR_DTR) :
+										  ((regs->DTxR & HRTIM_DTR_DTF) >> 16);
+	uint64_t delay     = (uint64_t)value * (4U << prescaler);
+
+	if (out1 == true)
+	{
+		tu->dt_out2 = false;
+	}
+	else
+	{
+		tu->dt_out1 = false;
+	}
+
+	if (delay == 0)
+	{
+		tu->dt_out1      = out1;
+		tu->dt_out2      = !out1;
+		tu->pending      = false;
+	}
+	else
+	{
+		tu->pending      = true;
+		tu->pending_tick = tick + delay;
+		tu->pending_out1 = out1;
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Measures the high time of the pin of output 1
+ *        of a timer driving a plant leg.
+ */
+static void _sim_hrtim_pin_edge(uint8_t output, bool level, uint64_t tick)
+{
+	sim_hrtim_unit_t* tu = &units[output / 2];
+
+	if ( ((output % 2) != 0) || (tu->leg == 0) )
+		return;
+
+	if (level == true)
+	{
+		tu->high_since_tick = tick;
+	}
+	else
+	{
+		tu->high_ticks += tick - tu->high_since_tick;
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Sets the pins from the timer outputs, through
+ *        output swap, burst mode idle state and output enable, and emits
+ *        their edges.
+ */
+static void _sim_hrtim_update_pins(uint64_t tick)
+{
+	HRTIM_Common_TypeDef* common = &HRTIM1->sCommonRegs;
+
+	for (uint8_t unit = 0 ; unit < SIM_HRTIM_UNITS_COUNT ; unit++)
+	{
+		HRTIM_Timerx_TypeDef* regs = &HRTIM1->sTimerxRegs[unit];
+		bool levels[2] = { units[unit].dt_out1, units[unit].dt_out2 };
+
+		if (common->CR2 & (HRTIM_CR2_SWPA << unit))
+		{
+			bool swap = levels[0];
+			levels[0] = levels[1];
+			levels[1] = swap;
+		}
+
+		for (uint8_t i = 0 ; i < 2 ; i++)
+		{
+			uint8_t  output = 2 * unit + i;
+			uint32_t shift  = 16 * i;
+
+			if ( (burst_idle == true) &&
+				 (regs->OUTxR & (HRTIM_OUTR_IDLM1 << shift)) )
+			{
+				levels[i] = (regs->OUTxR & (HRTIM_OUTR_IDLES1 << shift)) != 0;
+			}
+
+			if ((common->OENR & (1U << output)) == 0)
+			{
+				levels[i] = false;
+			}
+
+			if (pins[output] == levels[i])
+				continue;
+
+			pins[output] = levels[i];
+			_sim_hrtim_pin_edge(output, levels[i], tick);
+
+			if (edge_handler != nullptr)
+			{
+				sim_hrtim_edge_t edge = { tick, output, levels[i] };
+				edge_handler(&edge, edge_handler_arg);
+			}
+		}
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Gives the plant the duty cycle of the period
+ *        of a timer that just ended. The first period only starts the
+ *        measurement.
+ */
+static void _sim_hrtim_measure_duty(uint8_t unit, uint64_t tick)
+{
+	sim_hrtim_unit_t* tu = &units[unit];
+
+	if (tu->leg == 0)
+		return;
+
+	bool high = pins[2 * unit];
+
+	if (high == true)
+	{
+		tu->high_ticks     += tick - tu->high_since_tick;
+		tu->high_since_tick = tick;
+	}
+
+	if ( (tu->duty_started == true) && (tick > tu->duty_start_tick) )
+	{
+		float duty = (float)tu->high_ticks / (float)(tick - tu->duty_start_tick);
+		sim_plant_set_duty_cycle(tu->leg, duty);
+	}
+
+	tu->duty_started    = true;
+	tu->duty_start_tick = tick;
+	tu->high_ticks      = 0;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the ADC trigger sources raised at the
+ *        current tick, as ADC1R to ADC4R bits.
+ *
+ * @param src13 true for ADC triggers 1 and 3, which also decode timers.
+ */
+static uint32_t _sim_hrtim_adc_sources(const sim_hrtim_events_t* ev, bool src13)
+{
+	uint32_t sources = ev[0].cmp_up;
+
+	if (ev[0].period == true)
+	{
+		sources |= (1U << 4);
+	}
+
+	if (src13 == false)
+		return sources;
+
+	for (uint8_t unit = 0 ; unit < SIM_HRTIM_UNITS_COUNT ; unit++)
+	{
+		const sim_hrtim_events_t* own = &ev[unit + 1];
+		const uint32_t* table = adc_unit_sources[unit];
+
+		/* Up-down mode: ADROM selects the counting direction of compares */
+		uint8_t cmp = own->cmp_up | own->cmp_down;
+		if (counters[unit + 1].up_down == true)
+		{
+			uint32_t adrom = (HRTIM1->sTimerxRegs[unit].TIMxCR2 &
+							  HRTIM_TIMCR2_ADROM) >> 10;
+
+			if (adrom == 1)      cmp = own->cmp_up;
+			else if (adrom == 2) cmp = own->cmp_down;
+		}
+
+		if (cmp & (1U << 1)) sources |= table[0];
+		if (cmp & (1U << 2)) sources |= table[1];
+		if (cmp & (1U << 3)) sources |= table[2];
+		if (own->period == true) sources |= table[3];
+		if ( (own->period_end == true) || (own->reset == true) )
+		{
+			sources |= table[4];
+		}
+	}
+
+	return sources;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Transfers the preload registers of the timers
+ *        updated with the master, on the master update.
+ */
+static void _sim_hrtim_master_update()
+{
+	for (uint8_t counter = 1 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		bool suspended = (HRTIM1->sCommonRegs.CR1 & (1U << counter)) != 0;
+
+		if ( (counters[counter].running == false) || (suspended == true) ||
+			 ((HRTIM1->sTimerxRegs[counter - 1].TIMxCR & HRTIM_TIMCR_MSTU) == 0) )
+			continue;
+
+		_sim_hrtim_load(counter);
+		_sim_hrtim_compute_next(counter);
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Runs the burst DMA requested by the repetition
+ *        event of a counter: one word from DMA 2 for each register selected
+ *        in BDMUPR and BDTxUPR, master first, in register order. PER, REP
+ *        and CMP1 to CMP4 are written to their preload registers, other
+ *        registers are not simulated and their word is discarded.
+ */
+static void _sim_hrtim_burst_dma(uint8_t counter)
+{
+	HRTIM_Common_TypeDef* common = &HRTIM1->sCommonRegs;
+	const uint32_t selections[SIM_HRTIM_COUNTERS_COUNT] =
+	{
+		common->BDMUPR,  common->BDTAUPR, common->BDTBUPR, common->BDTCUPR,
+		common->BDTDUPR, common->BDTEUPR, common->BDTFUPR
+	};
+	uint32_t request = LL_DMAMUX_REQ_HRTIM1_M + counter;
+
+	for (uint8_t unit = 0 ; unit < SIM_HRTIM_COUNTERS_COUNT ; unit++)
+	{
+		__IO uint32_t* registers[6];
+
+		if (unit == 0)
+		{
+			HRTIM_Master_TypeDef* regs = &HRTIM1->sMasterRegs;
+			__IO uint32_t* master[6] = { &regs->MPER,   &regs->MREP,
+										 &regs->MCMP1R, &regs->MCMP2R,
+										 &regs->MCMP3R, &regs->MCMP4R };
+			memcpy(registers, master, sizeof(registers));
+		}
+		else
+		{
+			HRTIM_Timerx_TypeDef* regs = &HRTIM1->sTimerxRegs[unit - 1];
+			__IO uint32_t* timer[6] = { &regs->PERxR,  &regs->REPxR,
+										&regs->CMP1xR, &regs->CMP2xR,
+										&regs->CMP3xR, &regs->CMP4xR };
+			memcpy(registers, timer, sizeof(registers));
+		}
+
+		uint32_t selection = selections[unit];
+
+		while (selection != 0)
+		{
+			uint8_t  bit = __builtin_ctz(selection);
+			uint32_t word;
+
+			selection &= selection - 1;
+
+			if (sim_dma2_transfer(request, &word) == false)
+				return;
+
+			if ( (bit >= 4) && (bit <= 9) )
+			{
+				*registers[bit - 4] = word;
+			}
+		}
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Processes the HRTIM events due at a tick.
+ */
+static void _sim_hrtim_process_tick(uint64_t tick)
+{
+	sim_hrtim_events_t ev[SIM_HRTIM_COUNTERS_COUNT] = {};
+	bool irqs[SIM_HRTIM_COUNTERS_COUNT] = {};
+
+	current_tick      = tick;
+	repetition_events = 0;
+	master_updated    = false;
+
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		if ( (counters[counter].running == true) &&
+			 (counters[counter].next_tick == tick) )
+		{
+			irqs[counter] = _sim_hrtim_counter_event(counter, &ev[counter]);
+		}
+	}
+
+	for (uint8_t unit = 0 ; unit < SIM_HRTIM_UNITS_COUNT ; unit++)
+	{
+		_sim_hrtim_outputs(unit, tick, ev);
+	}
+
+	/* Timer resets, unless the timer just rolled over by itself */
+	for (uint8_t unit = 0 ; unit < SIM_HRTIM_UNITS_COUNT ; unit++)
+	{
+		sim_hrtim_counter_t* cnt = &counters[unit + 1];
+		uint32_t rstr = HRTIM1->sTimerxRegs[unit].RSTxR;
+
+		if ( (cnt->running == false) || (cnt->origin == tick) ||
+			 ((rstr & _sim_hrtim_reset_sources(unit, ev)) == 0) )
+			continue;
+
+		cnt->origin   = tick;
+		cnt->position = 0;
+		ev[unit + 1].reset      = true;
+		ev[unit + 1].period_end = true;
+
+		irqs[unit + 1] = _sim_hrtim_rollover(unit + 1, false) || irqs[unit + 1];
+
+		if (HRTIM1->sTimerxRegs[unit].TIMxCR & HRTIM_TIMCR_TRSTU)
+		{
+			_sim_hrtim_load(unit + 1);
+		}
+
+		_sim_hrtim_compute_next(unit + 1);
+	}
+
+	/* Update with the master, then burst DMA writes the preload registers
+	 * of the next update */
+	if (master_updated == true)
+	{
+		_sim_hrtim_master_update();
+	}
+
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		uint32_t dier = (counter == 0) ? HRTIM1->sMasterRegs.MDIER :
+										 HRTIM1->sTimerxRegs[counter - 1].TIMxDIER;
+
+		if ( (repetition_events & (1U << counter)) &&
+			 (dier & HRTIM_MDIER_MREPDE) )
+		{
+			_sim_hrtim_burst_dma(counter);
+		}
+	}
+
+	for (uint8_t unit = 0 ; unit < SIM_HRTIM_UNITS_COUNT ; unit++)
+	{
+		sim_hrtim_unit_t* tu = &units[unit];
+
+		if ( (tu->pending == false) || (tu->pending_tick != tick) )
+			continue;
+
+		if (tu->pending_out1 == true)
+		{
+			tu->dt_out1 = true;
+		}
+		else
+		{
+			tu->dt_out2 = true;
+		}
+
+		tu->pending = false;
+	}
+
+	_sim_hrtim_update_pins(tick);
+
+	for (uint8_t unit = 0 ; unit < SIM_HRTIM_UNITS_COUNT ; unit++)
+	{
+		if (ev[unit + 1].period_end == true)
+		{
+			_sim_hrtim_measure_duty(unit, tick);
+		}
+	}
+
+	/* ADC triggers and interrupts come last, their handlers may write the
+	 * registers */
+	HRTIM_Common_TypeDef* common = &HRTIM1->sCommonRegs;
+	const uint32_t adcr[SIM_HRTIM_ADC_TRIGGERS] =
+	{
+		common->ADC1R, common->ADC2R, common->ADC3R, common->ADC4R
+	};
+	bool adc_triggers[SIM_HRTIM_ADC_TRIGGERS] = {};
+
+	uint32_t sources13 = _sim_hrtim_adc_sources(ev, true);
+	uint32_t sources24 = _sim_hrtim_adc_sources(ev, false);
+
+	for (uint8_t trigger = 0 ; trigger < SIM_HRTIM_ADC_TRIGGERS ; trigger++)
+	{
+		uint32_t sources = (trigger % 2 == 0) ? sources13 : sources24;
+
+		if ((adcr[trigger] & sources) == 0)
+			continue;
+
+		uint32_t postscaler = (common->ADCPS1 >> (6 * trigger)) & 0x1FU;
+		if (adc_postscaler_counts[trigger] < postscaler)
+		{
+			adc_postscaler_counts[trigger]++;
+			continue;
+		}
+
+		adc_postscaler_counts[trigger] = 0;
+		adc_triggers[trigger] = true;
+	}
+
+	for (uint8_t trigger = 0 ; trigger < SIM_HRTIM_ADC_TRIGGERS ; trigger++)
+	{
+		if (adc_triggers[trigger] == true)
+		{
+			sim_adc_hrtim_trigger(trigger + 1);
+		}
+	}
+
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		if (irqs[counter] == true)
+		{
+			sim_irq_raise(irq_lines[counter]);
+		}
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the tick of the next HRTIM event.
+ */
+static uint64_t _sim_hrtim_next_tick()
+{
+	uint64_t next = SIM_HRTIM_NEVER;
+
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		if ( (counters[counter].running == true) &&
+			 (counters[counter].next_tick < next) )
+		{
+			next = counters[counter].next_tick;
+		}
+	}
+
+	for (uint8_t unit = 0 ; unit < SIM_HRTIM_UNITS_COUNT ; unit++)
+	{
+		if ( (units[unit].pending == true) && (units[unit].pending_tick < next) )
+		{
+			next = units[unit].pending_tick;
+		}
+	}
+
+	return next;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Processes the HRTIM events up to a tick.
+ */
+static void _sim_hrtim_run_until(uint64_t tick)
+{
+	in_run = true;
+
+	uint64_t next;
+	while ( (next = _sim_hrtim_next_tick()) <= tick )
+	{
+		_sim_hrtim_process_tick(next);
+	}
+
+	in_run = false;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the HRTIM tick of a simulated time.
+ */
+static uint64_t _sim_hrtim_ns_to_tick(uint64_t time_ns)
+{
+	return time_ns * SIM_HRTIM_TICKS_PER_NS_NUM / SIM_HRTIM_TICKS_PER_NS_DEN;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the first simulated time at or after
+ *        an HRTIM tick.
+ */
+static uint64_t _sim_hrtim_tick_to_ns(uint64_t tick)
+{
+	return (tick * SIM_HRTIM_TICKS_PER_NS_DEN + SIM_HRTIM_TICKS_PER_NS_NUM - 1)
+		   / SIM_HRTIM_TICKS_PER_NS_NUM;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: adds a position to a sorted
+ *        list of positions, once.
+ */
+static void _sim_hrtim_add_position(sim_hrtim_positions_t* positions,
+									uint32_t position)
+{
+	uint8_t i = 0;
+	while ( (i < positions->count) && (positions->position[i] < position) )
+	{
+		i++;
+	}
+
+	if ( ( (i < positions->count) && (positions->position[i] == position) ) ||
+		 (positions->count == SIM_HRTIM_POSITIONS_MAX) )
+		return;
+
+	for (uint8_t j = positions->count ; j > i ; j--)
+	{
+		positions->position[j] = positions->position[j - 1];
+	}
+
+	positions->position[i] = position;
+	positions->count++;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: returns the position of the
+ *        event of a compare counting up, 0 if it never matches. A null
+ *        compare matches at the end of the period.
+ */
+static uint32_t _sim_hrtim_compare_up(const sim_hrtim_counter_t* cnt,
+									  uint32_t cmp)
+{
+	if (cmp == 0)
+		return _sim_hrtim_length(cnt);
+
+	return (cmp <= cnt->period) ? cmp : 0;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: tells whether a counter counts,
+ *        on a period that is not null.
+ */
+static bool _sim_hrtim_is_counting(const sim_hrtim_counter_t* cnt)
+{
+	return (cnt->running == true) && (cnt->period != 0);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: floor division of a tick
+ *        difference, with a rest between 0 and the divisor excluded. The
+ *        difference mostly is within the current period of a counter, so
+ *        that the 64 bits division is avoided on the usual path.
+ */
+static int64_t _sim_hrtim_divide(int64_t value, int64_t divisor, int64_t* rest)
+{
+	if ( (value >= 0) && (value < divisor) )
+	{
+		*rest = value;
+		return 0;
+	}
+
+	/* Events at a single position of their period */
+	if (divisor == 1)
+	{
+		*rest = 0;
+		return value;
+	}
+
+	int64_t quotient;
+	if ( (value >= 0) && (value <= (int64_t)UINT32_MAX) )
+	{
+		quotient = (uint32_t)value / (uint32_t)divisor;
+	}
+	else
+	{
+		quotient = value / divisor;
+	}
+
+	*rest = value - quotient * divisor;
+	if (*rest < 0)
+	{
+		quotient--;
+		*rest += divisor;
+	}
+
+	return quotient;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: returns the number of events of
+ *        a counter at some positions of its period, from its origin up to
+ *        a tick included, negative before the origin. The counter keeps
+ *        its active registers until the next averaged event, so that its
+ *        periods all are the same.
+ */
+static int64_t _sim_hrtim_count(const sim_hrtim_counter_t* cnt,
+								const sim_hrtim_positions_t* positions,
+								uint64_t tick)
+{
+	int64_t period_ticks = (int64_t)_sim_hrtim_length(cnt) << cnt->ckpsc;
+	int64_t rest;
+	int64_t periods      = _sim_hrtim_divide((int64_t)(tick - cnt->origin),
+											 period_ticks,
+											 &rest);
+
+	int64_t count = periods * positions->count;
+	for (uint8_t i = 0 ; i < positions->count ; i++)
+	{
+		if (((int64_t)positions->position[i] << cnt->ckpsc) <= rest)
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: returns the tick of the n-th
+ *        event, from 1, of a counter at some positions of its period after
+ *        a tick.
+ */
+static uint64_t _sim_hrtim_nth(const sim_hrtim_counter_t* cnt,
+							   const sim_hrtim_positions_t* positions,
+							   uint64_t tick,
+							   uint64_t n)
+{
+	if (positions->count == 0)
+		return SIM_HRTIM_NEVER;
+
+	int64_t period_ticks = (int64_t)_sim_hrtim_length(cnt) << cnt->ckpsc;
+	int64_t index   = _sim_hrtim_count(cnt, positions, tick) + (int64_t)n - 1;
+	int64_t rest;
+	int64_t periods = _sim_hrtim_divide(index, positions->count, &rest);
+
+	return cnt->origin + (uint64_t)(periods * period_ticks) +
+		   ((uint64_t)positions->position[rest] << cnt->ckpsc);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: returns the positions of the
+ *        rollovers of a counter that count for its repetition, as
+ *        selected by its roll-over mode in up-down mode.
+ */
+static void _sim_hrtim_rollover_positions(uint8_t counter,
+										  sim_hrtim_positions_t* positions)
+{
+	const sim_hrtim_counter_t* cnt = &counters[counter];
+
+	positions->count = 0;
+
+	if (_sim_hrtim_is_counting(cnt) == false)
+		return;
+
+	uint32_t rom = 0;
+	if ( (counter != 0) && (cnt->up_down == true) )
+	{
+		rom = (HRTIM1->sTimerxRegs[counter - 1].TIMxCR2 & HRTIM_TIMCR2_ROM) >> 6;
+	}
+
+	if ( (cnt->up_down == true) && (rom != 2) )
+	{
+		_sim_hrtim_add_position(positions, cnt->period);
+	}
+
+	if ( (cnt->up_down == false) || (rom != 1) )
+	{
+		_sim_hrtim_add_position(positions, _sim_hrtim_length(cnt));
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the sources register of an ADC
+ *        trigger, ADC1R to ADC4R.
+ */
+static uint32_t _sim_hrtim_adcr(uint8_t trigger)
+{
+	HRTIM_Common_TypeDef* common = &HRTIM1->sCommonRegs;
+
+	switch (trigger)
+	{
+		case 0:  return common->ADC1R;
+		case 1:  return common->ADC2R;
+		case 2:  return common->ADC3R;
+		default: return common->ADC4R;
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: returns the positions of the
+ *        sources of an ADC trigger raised by a counter: compares and
+ *        period of the master, compares 2 to 4, period and reset of the
+ *        timers.
+ */
+static void _sim_hrtim_adc_positions(uint8_t trigger,
+									 uint8_t counter,
+									 sim_hrtim_positions_t* positions)
+{
+	const sim_hrtim_counter_t* cnt = &counters[counter];
+	uint32_t sources = _sim_hrtim_adcr(trigger);
+	uint32_t length  = _sim_hrtim_length(cnt);
+
+	positions->count = 0;
+
+	if (_sim_hrtim_is_counting(cnt) == false)
+		return;
+
+	if (counter == 0)
+	{
+		for (uint8_t i = 0 ; i < 4 ; i++)
+		{
+			uint32_t position = _sim_hrtim_compare_up(cnt, cnt->compare[i]);
+			if ( (sources & (1U << i)) && (position != 0) )
+			{
+				_sim_hrtim_add_position(positions, position);
+			}
+		}
+
+		if (sources & (1U << 4))
+		{
+			_sim_hrtim_add_position(positions, length);
+		}
+
+		return;
+	}
+
+	/* Only ADC triggers 1 and 3 decode timers */
+	if ((trigger % 2) != 0)
+		return;
+
+	const uint32_t* table = adc_unit_sources[counter - 1];
+	uint32_t adrom = 0;
+	if (cnt->up_down == true)
+	{
+		adrom = (HRTIM1->sTimerxRegs[counter - 1].TIMxCR2 &
+				 HRTIM_TIMCR2_ADROM) >> 10;
+	}
+
+	for (uint8_t i = 0 ; i < 3 ; i++)
+	{
+		if ((sources & table[i]) == 0)
+			continue;
+
+		uint32_t cmp      = cnt->compare[i + 1];
+		uint32_t position = _sim_hrtim_compare_up(cnt, cmp);
+
+		if ( (adrom != 2) && (position != 0) )
+		{
+			_sim_hrtim_add_position(positions, position);
+		}
+
+		if ( (cnt->up_down == true) && (adrom != 1) &&
+			 (cmp > 0) && (cmp < cnt->period) )
+		{
+			_sim_hrtim_add_position(positions, length - cmp);
+		}
+	}
+
+	if (sources & table[3])
+	{
+		_sim_hrtim_add_position(positions,
+								(cnt->up_down == true) ? cnt->period : length);
+	}
+
+	if (sources & table[4])
+	{
+		_sim_hrtim_add_position(positions, length);
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: computes the positions of the
+ *        sources of an ADC trigger again.
+ */
+static void _sim_hrtim_update_adc_positions(uint8_t trigger)
+{
+	adc_source_counters[trigger] = 0;
+
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		sim_hrtim_positions_t* positions = &adc_positions[trigger][counter];
+
+		_sim_hrtim_adc_positions(trigger, counter, positions);
+		if (positions->count != 0)
+		{
+			adc_source_counters[trigger] |= (1U << counter);
+		}
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: returns the number of sources
+ *        of an ADC trigger raised after a tick, up to another tick
+ *        included.
+ */
+static int64_t _sim_hrtim_adc_count(uint8_t trigger, uint64_t from, uint64_t to)
+{
+	int64_t count = 0;
+
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		if ((adc_source_counters[trigger] & (1U << counter)) == 0)
+			continue;
+
+		const sim_hrtim_counter_t*   cnt       = &counters[counter];
+		const sim_hrtim_positions_t* positions = &adc_positions[trigger][counter];
+
+		count += _sim_hrtim_count(cnt, positions, to) -
+				 _sim_hrtim_count(cnt, positions, from);
+	}
+
+	return count;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: returns the tick of the n-th
+ *        source, from 1, of an ADC trigger after a tick.
+ */
+static uint64_t _sim_hrtim_adc_nth(uint8_t trigger, uint64_t tick, uint64_t n)
+{
+	uint8_t sources = adc_source_counters[trigger];
+
+	if (sources == 0)
+		return SIM_HRTIM_NEVER;
+
+	/* Sources of a single counter */
+	if ((sources & (sources - 1)) == 0)
+	{
+		uint8_t counter = (uint8_t)__builtin_ctz(sources);
+		return _sim_hrtim_nth(&counters[counter],
+							  &adc_positions[trigger][counter], tick, n);
+	}
+
+	/* Sources of several counters: one event at a time */
+	for (uint64_t i = 0 ; i < n ; i++)
+	{
+		uint64_t next = SIM_HRTIM_NEVER;
+
+		for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+		{
+			uint64_t event = _sim_hrtim_nth(&counters[counter],
+											&adc_positions[trigger][counter],
+											tick, 1);
+			if (event < next)
+			{
+				next = event;
+			}
+		}
+
+		tick = next;
+	}
+
+	return tick;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: moves the origin of a counter to
+ *        the start of the period holding a tick.
+ */
+static void _sim_hrtim_move_origin(sim_hrtim_counter_t* cnt, uint64_t tick)
+{
+	int64_t period_ticks = (int64_t)_sim_hrtim_length(cnt) << cnt->ckpsc;
+
+	if (tick >= cnt->origin)
+	{
+		int64_t rest;
+		cnt->origin += _sim_hrtim_divide((int64_t)(tick - cnt->origin),
+										 period_ticks,
+										 &rest) * period_ticks;
+	}
+
+	uint64_t position = (tick - cnt->origin) >> cnt->ckpsc;
+	cnt->position = (position > cnt->period) ? cnt->period : 0;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: tells whether the preload
+ *        registers of a counter differ from its active ones.
+ */
+static bool _sim_hrtim_preload_differs(uint8_t counter)
+{
+	const sim_hrtim_counter_t* cnt = &counters[counter];
+
+	if (counter == 0)
+	{
+		HRTIM_Master_TypeDef* regs = &HRTIM1->sMasterRegs;
+		return ((regs->MPER   & 0xFFFFU) != cnt->period)     ||
+			   ((regs->MCMP1R & 0xFFFFU) != cnt->compare[0]) ||
+			   ((regs->MCMP2R & 0xFFFFU) != cnt->compare[1]) ||
+			   ((regs->MCMP3R & 0xFFFFU) != cnt->compare[2]) ||
+			   ((regs->MCMP4R & 0xFFFFU) != cnt->compare[3]) ||
+			   ((regs->MREP   & 0xFFU)   != cnt->repetition);
+	}
+
+	HRTIM_Timerx_TypeDef* regs = &HRTIM1->sTimerxRegs[counter - 1];
+	return ((regs->PERxR  & 0xFFFFU) != cnt->period)     ||
+		   ((regs->CMP1xR & 0xFFFFU) != cnt->compare[0]) ||
+		   ((regs->CMP2xR & 0xFFFFU) != cnt->compare[1]) ||
+		   ((regs->CMP3xR & 0xFFFFU) != cnt->compare[2]) ||
+		   ((regs->CMP4xR & 0xFFFFU) != cnt->compare[3]) ||
+		   ((regs->REPxR  & 0xFFU)   != cnt->repetition);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: tells whether the next
+ *        repetition event of a counter transfers preload registers that
+ *        differ from its active ones.
+ */
+static bool _sim_hrtim_transfer_pending(uint8_t counter)
+{
+	uint32_t update = (counter == 0) ? HRTIM_MCR_MREPU : HRTIM_TIMCR_TREPU;
+
+	if ( ((_sim_hrtim_cr(counter) & update) == 0) ||
+		 (HRTIM1->sCommonRegs.CR1 & (1U << counter)) )
+		return false;
+
+	return _sim_hrtim_preload_differs(counter);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: counts the sources of an ADC
+ *        trigger in its postscaler up to a tick.
+ */
+static void _sim_hrtim_adc_sync(uint8_t trigger, uint64_t tick)
+{
+	if (adc_count_ticks[trigger] >= tick)
+		return;
+
+	uint32_t postscaler = (HRTIM1->sCommonRegs.ADCPS1 >> (6 * trigger)) & 0x1FU;
+	int64_t  sources    = _sim_hrtim_adc_count(trigger, adc_count_ticks[trigger], tick);
+
+	adc_postscaler_counts[trigger] = (uint32_t)
+		((adc_postscaler_counts[trigger] + (uint64_t)sources) % (postscaler + 1));
+	adc_count_ticks[trigger] = tick;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: computes the tick of the next
+ *        output of an ADC trigger, from its postscaler count.
+ */
+static void _sim_hrtim_adc_next(uint8_t trigger)
+{
+	uint32_t postscaler = (HRTIM1->sCommonRegs.ADCPS1 >> (6 * trigger)) & 0x1FU;
+	uint32_t count      = adc_postscaler_counts[trigger];
+	uint64_t sources    = (count > postscaler) ? 1 : (postscaler + 1 - count);
+
+	adc_trigger_ticks[trigger] = _sim_hrtim_adc_nth(trigger,
+													adc_count_ticks[trigger],
+													sources);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: computes the repetition
+ *        counters and postscaler counts at the current tick, from the
+ *        ticks of the next events. To call before the registers change.
+ */
+static void _sim_hrtim_averaged_sync()
+{
+	for (uint8_t trigger = 0 ; trigger < SIM_HRTIM_ADC_TRIGGERS ; trigger++)
+	{
+		_sim_hrtim_adc_sync(trigger, current_tick);
+	}
+
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		sim_hrtim_counter_t* cnt = &counters[counter];
+		const sim_hrtim_positions_t* rollovers = &rollover_positions[counter];
+
+		if (_sim_hrtim_is_counting(cnt) == false)
+			continue;
+
+		if (repetition_ticks[counter] != SIM_HRTIM_NEVER)
+		{
+			cnt->repetition_counter = (uint32_t)
+				(_sim_hrtim_count(cnt, rollovers, repetition_ticks[counter] - 1) -
+				 _sim_hrtim_count(cnt, rollovers, current_tick));
+		}
+
+		_sim_hrtim_move_origin(cnt, current_tick);
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: computes the positions of the
+ *        events once the registers changed, then the ticks of the next
+ *        events from the state at the current tick.
+ */
+static void _sim_hrtim_averaged_rebase()
+{
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		const sim_hrtim_counter_t* cnt = &counters[counter];
+		sim_hrtim_positions_t* rollovers = &rollover_positions[counter];
+
+		_sim_hrtim_rollover_positions(counter, rollovers);
+		repetition_ticks[counter] = _sim_hrtim_nth(cnt, rollovers, current_tick,
+												   cnt->repetition_counter + 1);
+	}
+
+	for (uint8_t trigger = 0 ; trigger < SIM_HRTIM_ADC_TRIGGERS ; trigger++)
+	{
+		adc_count_ticks[trigger] = current_tick;
+
+		_sim_hrtim_update_adc_positions(trigger);
+		_sim_hrtim_adc_next(trigger);
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: moves a counter up to a tick,
+ *        through its repetition events. Only the first one may transfer
+ *        new preload registers: registers are only written by code, which
+ *        the averaged events wait for. The following ones are counted.
+ *
+ * @return true if a repetition interrupt is requested.
+ */
+static bool _sim_hrtim_averaged_counter(uint8_t counter, uint64_t tick)
+{
+	sim_hrtim_counter_t* cnt = &counters[counter];
+	sim_hrtim_positions_t* rollovers = &rollover_positions[counter];
+	uint64_t repetition_tick = repetition_ticks[counter];
+
+	if (repetition_tick > tick)
+		return false;
+
+	/* Sources of the ADC triggers counted with the registers they had */
+	bool transfer = _sim_hrtim_transfer_pending(counter);
+	if (transfer == true)
+	{
+		for (uint8_t trigger = 0 ; trigger < SIM_HRTIM_ADC_TRIGGERS ; trigger++)
+		{
+			if (adc_source_counters[trigger] & (1U << counter))
+			{
+				_sim_hrtim_adc_sync(trigger, tick);
+			}
+		}
+	}
+
+	/* Woken at the event, a single rollover per period and the same
+	 * registers: the following repetition events are evenly spaced */
+	if ( (transfer == false) && (tick == repetition_tick) &&
+		 (rollovers->count == 1) )
+	{
+		uint64_t period_ticks = (uint64_t)_sim_hrtim_length(cnt) << cnt->ckpsc;
+		uint64_t offset       = (uint64_t)rollovers->position[0] << cnt->ckpsc;
+
+		if (offset >= period_ticks)
+		{
+			offset = 0;
+		}
+
+		cnt->origin             = repetition_tick - offset;
+		cnt->position           = ((offset >> cnt->ckpsc) > cnt->period) ? cnt->period : 0;
+		cnt->repetition_counter = 0;
+
+		bool irq = _sim_hrtim_rollover(counter, (offset != 0));
+
+		repetition_ticks[counter] = repetition_tick +
+									period_ticks * (cnt->repetition_counter + 1);
+		return irq;
+	}
+
+	_sim_hrtim_move_origin(cnt, repetition_tick);
+
+	cnt->repetition_counter = 0;
+	bool irq = _sim_hrtim_rollover(counter, (cnt->origin != repetition_tick));
+
+	if (transfer == true)
+	{
+		if (counter != 0)
+		{
+			units[counter - 1].duty_changed = true;
+		}
+
+		_sim_hrtim_rollover_positions(counter, rollovers);
+
+		for (uint8_t trigger = 0 ; trigger < SIM_HRTIM_ADC_TRIGGERS ; trigger++)
+		{
+			sim_hrtim_positions_t positions;
+			_sim_hrtim_adc_positions(trigger, counter, &positions);
+
+			sim_hrtim_positions_t* previous = &adc_positions[trigger][counter];
+			if ( (positions.count == previous->count) &&
+				 (memcmp(positions.position, previous->position,
+						 positions.count * sizeof(uint32_t)) == 0) )
+				continue;
+
+			_sim_hrtim_update_adc_positions(trigger);
+			_sim_hrtim_adc_next(trigger);
+		}
+	}
+
+	/* Woken at the repetition event itself, the usual case */
+	int64_t events = 0;
+	if (tick != repetition_tick)
+	{
+		events = _sim_hrtim_count(cnt, rollovers, tick) -
+				 _sim_hrtim_count(cnt, rollovers, repetition_tick);
+	}
+
+	if (events > (int64_t)cnt->repetition_counter)
+	{
+		int64_t after = events - cnt->repetition_counter - 1;
+
+		irq = _sim_hrtim_repetition_flag(counter) || irq;
+		cnt->repetition_counter = cnt->repetition -
+								  (uint32_t)(after % (cnt->repetition + 1));
+	}
+	else
+	{
+		cnt->repetition_counter -= (uint32_t)events;
+	}
+
+	repetition_ticks[counter] = _sim_hrtim_nth(cnt, rollovers, tick,
+											   cnt->repetition_counter + 1);
+
+	return irq;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: tells whether the registers
+ *        changed since they were last applied. Preload registers of the
+ *        counters with preload enabled, update disable bits and flags are
+ *        left out: they only matter from the next repetition event.
+ */
+static bool _sim_hrtim_averaged_registers_changed()
+{
+	HRTIM_TypeDef registers;
+	memcpy(&registers, (const void*)HRTIM1, sizeof(HRTIM_TypeDef));
+
+	HRTIM_Master_TypeDef* master  = &registers.sMasterRegs;
+	HRTIM_Master_TypeDef* applied = &applied_registers.sMasterRegs;
+
+	master->MISR = applied->MISR;
+	if (master->MCR & applied->MCR & HRTIM_MCR_PREEN)
+	{
+		master->MPER   = applied->MPER;
+		master->MREP   = applied->MREP;
+		master->MCMP1R = applied->MCMP1R;
+		master->MCMP2R = applied->MCMP2R;
+		master->MCMP3R = applied->MCMP3R;
+		master->MCMP4R = applied->MCMP4R;
+	}
+
+	for (uint8_t unit = 0 ; unit < SIM_HRTIM_UNITS_COUNT ; unit++)
+	{
+		HRTIM_Timerx_TypeDef* timer      = &registers.sTimerxRegs[unit];
+		HRTIM_Timerx_TypeDef* applied_tu = &applied_registers.sTimerxRegs[unit];
+
+		timer->TIMxISR = applied_tu->TIMxISR;
+		if (timer->TIMxCR & applied_tu->TIMxCR & HRTIM_MCR_PREEN)
+		{
+			timer->PERxR  = applied_tu->PERxR;
+			timer->REPxR  = applied_tu->REPxR;
+			timer->CMP1xR = applied_tu->CMP1xR;
+			timer->CMP2xR = applied_tu->CMP2xR;
+			timer->CMP3xR = applied_tu->CMP3xR;
+			timer->CMP4xR = applied_tu->CMP4xR;
+		}
+	}
+
+	HRTIM_Common_TypeDef* common = &registers.sCommonRegs;
+	common->CR1 = (common->CR1 & ~0x7FU) | (applied_registers.sCommonRegs.CR1 & 0x7FU);
+
+	return memcmp(&registers, &applied_registers, sizeof(HRTIM_TypeDef)) != 0;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: returns the share of its period
+ *        during which the pin of output 1 of a timer is high, from its
+ *        active registers and its own compare and period events, through
+ *        the crossbar, dead time, output swap and output enable.
+ */
+static float _sim_hrtim_averaged_duty(uint8_t unit)
+{
+	HRTIM_Common_TypeDef* common = &HRTIM1->sCommonRegs;
+	HRTIM_Timerx_TypeDef* regs   = &HRTIM1->sTimerxRegs[unit];
+	const sim_hrtim_counter_t* cnt = &counters[unit + 1];
+
+	if ( (_sim_hrtim_is_counting(cnt) == false) ||
+		 ((common->OENR & (1U << (2 * unit))) == 0) )
+		return 0;
+
+	/* Events of the period, sorted, those at a same position merged */
+	sim_hrtim_output_event_t events[2 * 4 + 1] = {};
+	uint8_t  events_count = 0;
+	uint32_t length       = _sim_hrtim_length(cnt);
+
+	for (uint8_t i = 0 ; i < 2 * 4 + 1 ; i++)
+	{
+		uint32_t position = 0;
+		uint32_t up       = 0;
+		uint32_t down     = 0;
+
+		if (i == 2 * 4)
+		{
+			position = (cnt->up_down == true) ? cnt->period : length;
+			up       = HRTIM_SET1R_PER;
+		}
+		else if (i < 4)
+		{
+			position = _sim_hrtim_compare_up(cnt, cnt->compare[i]);
+			up       = 1U << (3 + i);
+		}
+		else
+		{
+			uint32_t cmp = cnt->compare[i - 4];
+			if ( (cnt->up_down == true) && (cmp > 0) && (cmp < cnt->period) )
+			{
+				position = length - cmp;
+				down     = 1U << (3 + i - 4);
+			}
+		}
+
+		if (position == 0)
+			continue;
+
+		uint8_t j = 0;
+		while ( (j < events_count) && (events[j].position < position) )
+		{
+			j++;
+		}
+
+		if ( (j == events_count) || (events[j].position != position) )
+		{
+			for (uint8_t k = events_count ; k > j ; k--)
+			{
+				events[k] = events[k - 1];
+			}
+
+			events[j] = { position, 0, 0 };
+			events_count++;
+		}
+
+		events[j].up   |= up;
+		events[j].down |= down;
+	}
+
+	/* With dead time, output 2 is the complement of output 1, and each
+	 * rising edge is delayed */
+	bool     dead_time = (regs->OUTxR & HRTIM_OUTR_DTEN) != 0;
+	bool     swapped   = (common->CR2 & (HRTIM_CR2_SWPA << unit)) != 0;
+	bool     inverted  = (swapped == true) && (dead_time == true);
+	uint32_t set       = regs->SETx1R;
+	uint32_t reset     = regs->RSTx1R;
+	uint64_t delay     = 0;
+
+	if ( (swapped == true) && (dead_time == false) )
+	{
+		set   = regs->SETx2R;
+		reset = regs->RSTx2R;
+	}
+
+	if (dead_time == true)
+	{
+		uint32_t prescaler = (regs->DTxR & HRTIM_DTR_DTPRSC) >> 10;
+		uint32_t value     = (inverted == false) ? (regs->DTxR & HRTIM_DTR_DTR) :
+												   ((regs->DTxR & HRTIM_DTR_DTF) >> 16);
+		delay = (uint64_t)value * (4U << prescaler);
+	}
+
+	/* Level at the start of a period, once the waveform repeats */
+	bool level = false;
+	for (uint8_t i = 0 ; i < events_count ; i++)
+	{
+		level = _sim_hrtim_crossbar(level, set, reset, events[i].up, events[i].down);
+	}
+
+	/* Pulses rising in a period, falling in this one or the next */
+	bool     edges      = false;
+	bool     rising     = false;
+	uint32_t rise       = 0;
+	uint64_t high_ticks = 0;
+
+	for (uint8_t copy = 0 ; copy < 2 ; copy++)
+	{
+		for (uint8_t i = 0 ; i < events_count ; i++)
+		{
+			bool next = _sim_hrtim_crossbar(level, set, reset,
+											events[i].up, events[i].down);
+			if (next == level)
+				continue;
+
+			level = next;
+			edges = true;
+
+			uint32_t position = events[i].position + copy * length;
+
+			if (level != inverted)
+			{
+				if (copy == 0)
+				{
+					rise   = position;
+					rising = true;
+				}
+			}
+			else if (rising == true)
+			{
+				uint64_t pulse = (uint64_t)(position - rise) << cnt->ckpsc;
+				if (pulse > delay)
+				{
+					high_ticks += pulse - delay;
+				}
+
+				rising = false;
+			}
+		}
+	}
+
+	if (edges == false)
+		return (level != inverted) ? 1 : 0;
+
+	return (float)high_ticks / (float)((uint64_t)length << cnt->ckpsc);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: gives the plant the duty cycle
+ *        of the timers driving a leg whose registers changed.
+ */
+static void _sim_hrtim_averaged_update_legs()
+{
+	for (uint8_t unit = 0 ; unit < SIM_HRTIM_UNITS_COUNT ; unit++)
+	{
+		sim_hrtim_unit_t* tu = &units[unit];
+
+		if ( (tu->duty_changed == false) || (tu->leg == 0) )
+			continue;
+
+		tu->duty_changed = false;
+
+		float duty = _sim_hrtim_averaged_duty(unit);
+		if (duty != tu->duty)
+		{
+			tu->duty = duty;
+			sim_plant_set_duty_cycle(tu->leg, duty);
+		}
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: processes the HRTIM up to a
+ *        tick: ADC trigger outputs and repetition events since the last
+ *        processed tick, then the duty cycles of the legs. ADC triggers and
+ *        interrupts come last, their handlers may write the registers.
+ */
+static void _sim_hrtim_averaged_run_until(uint64_t tick)
+{
+	if (tick < current_tick)
+	{
+		tick = current_tick;
+	}
+
+	in_run = true;
+
+	bool adc_triggers[SIM_HRTIM_ADC_TRIGGERS] = {};
+	bool irqs[SIM_HRTIM_COUNTERS_COUNT]       = {};
+
+	/* Without preload, registers written since apply from the last tick */
+	bool synced = false;
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		if ( (_sim_hrtim_is_counting(&counters[counter]) == false) ||
+			 (_sim_hrtim_cr(counter) & HRTIM_MCR_PREEN) ||
+			 (_sim_hrtim_preload_differs(counter) == false) )
+			continue;
+
+		if (synced == false)
+		{
+			_sim_hrtim_averaged_sync();
+			synced = true;
+		}
+
+		_sim_hrtim_load(counter);
+		if (counter != 0)
+		{
+			units[counter - 1].duty_changed = true;
+		}
+	}
+
+	if (synced == true)
+	{
+		_sim_hrtim_averaged_rebase();
+	}
+
+	/* Sources are counted before the repetition events transfer new
+	 * registers, as they are raised before */
+	for (uint8_t trigger = 0 ; trigger < SIM_HRTIM_ADC_TRIGGERS ; trigger++)
+	{
+		if (adc_trigger_ticks[trigger] > tick)
+			continue;
+
+		uint32_t postscaler = (HRTIM1->sCommonRegs.ADCPS1 >> (6 * trigger)) & 0x1FU;
+		int64_t  sources    = 0;
+		if (tick != adc_trigger_ticks[trigger])
+		{
+			sources = _sim_hrtim_adc_count(trigger, adc_trigger_ticks[trigger], tick);
+		}
+
+		adc_triggers[trigger]          = true;
+		adc_postscaler_counts[trigger] = (uint32_t)(sources % (postscaler + 1));
+		adc_count_ticks[trigger]       = tick;
+
+		_sim_hrtim_adc_next(trigger);
+	}
+
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		irqs[counter] = _sim_hrtim_averaged_counter(counter, tick);
+	}
+
+	current_tick = tick;
+
+	_sim_hrtim_averaged_update_legs();
+
+	for (uint8_t trigger = 0 ; trigger < SIM_HRTIM_ADC_TRIGGERS ; trigger++)
+	{
+		if (adc_triggers[trigger] == true)
+		{
+			sim_adc_hrtim_trigger(trigger + 1);
+		}
+	}
+
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		if (irqs[counter] == true)
+		{
+			sim_irq_raise(irq_lines[counter]);
+		}
+	}
+
+	in_run = false;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Averaged mode: returns the tick of the next
+ *        averaged event: ADC trigger output, repetition interrupt, or
+ *        repetition event transferring the preload registers. Registers
+ *        may be written without the LL API once other code runs, so that
+ *        the first repetition event from then transfers them.
+ */
+static uint64_t _sim_hrtim_averaged_next_tick()
+{
+	uint64_t next = SIM_HRTIM_NEVER;
+
+	for (uint8_t trigger = 0 ; trigger < SIM_HRTIM_ADC_TRIGGERS ; trigger++)
+	{
+		if (adc_trigger_ticks[trigger] < next)
+		{
+			next = adc_trigger_ticks[trigger];
+		}
+	}
+
+	uint64_t idle_tick = SIM_HRTIM_NEVER;
+	bool     idle_read = false;
+
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		const sim_hrtim_counter_t* cnt = &counters[counter];
+		const sim_hrtim_positions_t* rollovers = &rollover_positions[counter];
+		uint64_t repetition_tick = repetition_ticks[counter];
+
+		if (repetition_tick >= next)
+			continue;
+
+		bool irq_enabled = (counter == 0) ?
+			((HRTIM1->sMasterRegs.MDIER & HRTIM_MDIER_MREPIE) != 0) :
+			((HRTIM1->sTimerxRegs[counter - 1].TIMxDIER & HRTIM_MDIER_MREPIE) != 0);
+
+		uint32_t update = (counter == 0) ? HRTIM_MCR_MREPU : HRTIM_TIMCR_TREPU;
+
+		if ( (irq_enabled == false) &&
+			 (_sim_hrtim_transfer_pending(counter) == false) )
+		{
+			if ((_sim_hrtim_cr(counter) & update) == 0)
+				continue;
+
+			if (idle_read == false)
+			{
+				uint64_t idle_end_ns = sim_kernel_get_idle_end();
+				if (idle_end_ns < SIM_HRTIM_NEVER / SIM_HRTIM_TICKS_PER_NS_NUM)
+				{
+					idle_tick = _sim_hrtim_ns_to_tick(idle_end_ns);
+				}
+				idle_read = true;
+			}
+
+			if (idle_tick == SIM_HRTIM_NEVER)
+				continue;
+
+			/* First repetition event at or after the idle end */
+			if ( (repetition_tick < idle_tick) && (rollovers->count == 1) )
+			{
+				/* Repetition events evenly spaced */
+				int64_t spacing = ((int64_t)_sim_hrtim_length(cnt) << cnt->ckpsc) *
+								  (cnt->repetition + 1);
+				int64_t rest;
+				int64_t events = _sim_hrtim_divide((int64_t)(idle_tick - repetition_tick) - 1,
+												   spacing, &rest) + 1;
+
+				repetition_tick += (uint64_t)(events * spacing);
+			}
+			else if (repetition_tick < idle_tick)
+			{
+				int64_t  first  = _sim_hrtim_count(cnt, rollovers, repetition_tick);
+				int64_t  target = _sim_hrtim_count(cnt, rollovers, idle_tick - 1) + 1;
+				uint64_t period = cnt->repetition + 1;
+				uint64_t events = ((uint64_t)(target - first) + period - 1) / period * period;
+
+				repetition_tick = _sim_hrtim_nth(cnt, rollovers, repetition_tick, events);
+			}
+		}
+
+		if (repetition_tick < next)
+		{
+			next = repetition_tick;
+		}
+	}
+
+	return next;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Schedules the kernel event at the next HRTIM
+ *        event.
+ */
+static void _sim_hrtim_schedule()
+{
+	uint64_t next;
+
+	if (averaged == true)
+	{
+		/* The event must not be seen as something else to run */
+		sim_event_cancel(&hrtim_event);
+		next = _sim_hrtim_averaged_next_tick();
+	}
+	else
+	{
+		next = _sim_hrtim_next_tick();
+	}
+
+	if (next == SIM_HRTIM_NEVER)
+	{
+		sim_event_cancel(&hrtim_event);
+		return;
+	}
+
+	sim_event_schedule(&hrtim_event, _sim_hrtim_tick_to_ns(next));
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Runs the HRTIM up to the current simulated
+ *        time. Following events are processed right away while nothing
+ *        else is due, which avoids going through the kernel at each event.
+ */
+static void _sim_hrtim_event_handler(void* arg)
+{
+	(void)arg;
+
+	if (averaged == true)
+	{
+		_sim_hrtim_averaged_run_until(_sim_hrtim_ns_to_tick(sim_time_get_ns()));
+		_sim_hrtim_schedule();
+		return;
+	}
+
+	while (true)
+	{
+		_sim_hrtim_run_until(_sim_hrtim_ns_to_tick(sim_time_get_ns()));
+
+		uint64_t next = _sim_hrtim_next_tick();
+		if (next == SIM_HRTIM_NEVER)
+			break;
+
+		uint64_t next_ns = _sim_hrtim_tick_to_ns(next);
+		if (sim_kernel_is_idle_until(next_ns) == false)
+			break;
+
+		uint64_t now_ns = sim_time_get_ns();
+		if (next_ns > now_ns)
+		{
+			sim_time_advance_ns(next_ns - now_ns);
+		}
+	}
+
+	_sim_hrtim_schedule();
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Applies the registers to the simulated HRTIM
+ *        at the current tick.
+ */
+static void _sim_hrtim_apply_registers()
+{
+	HRTIM_Common_TypeDef* common = &HRTIM1->sCommonRegs;
+
+	/* Calibration completes at once */
+	if (common->DLLCR & (HRTIM_DLLCR_CAL | HRTIM_DLLCR_CALEN))
+	{
+		common->ISR = common->ISR | HRTIM_ISR_DLLRDY;
+	}
+
+	for (uint8_t counter = 0 ; counter < SIM_HRTIM_COUNTERS_COUNT ; counter++)
+	{
+		sim_hrtim_counter_t* cnt = &counters[counter];
+		uint32_t cr      = _sim_hrtim_cr(counter);
+		bool     enabled = (HRTIM1->sMasterRegs.MCR & (HRTIM_MCR_MCEN << counter)) != 0;
+
+		if ( (enabled == true) && (cnt->running == false) )
+		{
+			cnt->running = true;
+			cnt->ckpsc   = cr & HRTIM_MCR_CK_PSC;
+			cnt->up_down = (counter != 0) &&
+						   (HRTIM1->sTimerxRegs[counter - 1].TIMxCR2 &
+							HRTIM_TIMCR2_UDM);
+			cnt->origin  = current_tick - ((uint64_t)cnt->position << cnt->ckpsc);
+
+			_sim_hrtim_load(counter);
+			cnt->repetition_counter = cnt->repetition;
+		}
+		else if ( (enabled == false) && (cnt->running == true) )
+		{
+			cnt->position = (uint32_t)((current_tick - cnt->origin) >> cnt->ckpsc);
+			cnt->running  = false;
+		}
+		else if ( (cnt->running == true) && ((cr & HRTIM_MCR_PREEN) == 0) )
+		{
+			_sim_hrtim_load(counter);
+		}
+
+		if (averaged == false)
+		{
+			_sim_hrtim_compute_next(counter);
+		}
+	}
+
+	/* Burst mode: software trigger starts it, BMSTAT cleared stops it */
+	if (common->BMTRGR & HRTIM_BMTRGR_SW)
+	{
+		common->BMTRGR = common->BMTRGR & ~HRTIM_BMTRGR_SW;
+
+		if (common->BMCR & HRTIM_BMCR_BME)
+		{
+			common->BMCR          = common->BMCR | HRTIM_BMCR_BMSTAT;
+			burst_count           = 0;
+			burst_prescaler_count = 0;
+			burst_idle            = true;
+		}
+	}
+
+	if ( ((common->BMCR & HRTIM_BMCR_BME) == 0) ||
+		 ((common->BMCR & HRTIM_BMCR_BMSTAT) == 0) )
+	{
+		burst_idle = false;
+	}
+
+	if (averaged == true)
+	{
+		_sim_hrtim_averaged_rebase();
+
+		for (uint8_t unit = 0 ; unit < SIM_HRTIM_UNITS_COUNT ; unit++)
+		{
+			units[unit].duty_changed = true;
+		}
+
+		_sim_hrtim_averaged_update_legs();
+
+		memcpy(&applied_registers, (const void*)HRTIM1, sizeof(HRTIM_TypeDef));
+		return;
+	}
+
+	_sim_hrtim_update_pins(current_tick);
+}
+
+
+/* LL API */
+
+void sim_hrtim_registers_written()
+{
+	/* Written from an interrupt or ADC handler raised by an event: the
+	 * registers apply at the tick of that event */
+	if (in_run == true)
+	{
+		if (averaged == true)
+		{
+			if (_sim_hrtim_averaged_registers_changed() == false)
+				return;
+
+			_sim_hrtim_averaged_sync();
+		}
+
+		_sim_hrtim_apply_registers();
+		return;
+	}
+
+	uint64_t now_tick = _sim_hrtim_ns_to_tick(sim_time_get_ns());
+
+	if (averaged == true)
+	{
+		_sim_hrtim_averaged_run_until(now_tick);
+	}
+	else
+	{
+		_sim_hrtim_run_until(now_tick);
+	}
+
+	if (now_tick > current_tick)
+	{
+		current_tick = now_tick;
+	}
+
+	/* Averaged mode: preload registers only matter from the next
+	 * repetition event, which the schedule takes into account */
+	if (averaged == true)
+	{
+		if (_sim_hrtim_averaged_registers_changed() == true)
+		{
+			_sim_hrtim_averaged_sync();
+			_sim_hrtim_apply_registers();
+		}
+	}
+	else
+	{
+		_sim_hrtim_apply_registers();
+	}
+
+	_sim_hrtim_schedule();
+}
+
+
+/* Public API */
+
+void sim_hrtim_set_edge_handler(sim_hrtim_edge_handler_t handler, void* arg)
+{
+	edge_handler     = handler;
+	edge_handler_arg = arg;
+}
+
+bool sim_hrtim_get_output(uint8_t output)
+{
+	if (output >= SIM_HRTIM_OUTPUTS_COUNT)
+		return false;
+
+	return pins[output];
+}
+
+uint64_t sim_hrtim_get_tick()
+{
+	uint64_t now_tick = _sim_hrtim_ns_to_tick(sim_time_get_ns());
+
+	return (now_tick > current_tick) ? now_tick : current_tick;
+}
+
+void sim_hrtim_connect_leg(uint8_t leg, uint8_t timing_unit)
+{
+	if (timing_unit >= SIM_HRTIM_UNITS_COUNT)
+		return;
+
+	sim_hrtim_unit_t* tu = &units[timing_unit];
+
+	tu->leg             = leg;
+	tu->duty_started    = false;
+	tu->high_ticks      = 0;
+	tu->high_since_tick = sim_hrtim_get_tick();
+	tu->duty_changed    = true;
+	tu->duty            = -1;
+
+	if (averaged == true)
+	{
+		_sim_hrtim_averaged_update_legs();
+	}
+}
+
+void sim_hrtim_set_averaged(bool enable)
+{
+	averaged = enable;
+
+	if (averaged == true)
+	{
+		_sim_hrtim_averaged_rebase();
+		memcpy(&applied_registers, (const void*)HRTIM1, sizeof(HRTIM_TypeDef));
+	}
+
+	_sim_hrtim_schedule();
+}
+
+bool sim_hrtim_is_triggering_adcs()
+{
+	HRTIM_Common_TypeDef* common = &HRTIM1->sCommonRegs;
+
+	return (common->ADC1R | common->ADC2R | common->ADC3R | common->ADC4R) != 0;
+}
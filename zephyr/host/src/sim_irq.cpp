@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+
+/* Zephyr */
+#include <zephyr/irq.h>
+
+/* STM32 device */
+#include <stm32g4xx.h>
+
+/* Current file header */
+#include "sim/sim_irq.h"
+
+
+/**
+ *  Local variables
+ */
+
+typedef struct
+{
+	void (*routine)(const void* parameter);
+	const void* parameter;
+	int  priority; /* Lower is more urgent, zero-latency is -1 */
+	bool enabled;
+	bool pending;
+} sim_irq_line_t;
+
+static sim_irq_line_t lines[SIM_IRQ_LINES_COUNT] = {};
+
+static unsigned int lock_depth = 0;
+static bool handler_running = false;
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the most urgent line ready to run, or
+ *        -1 if there is none.
+ */
+static int _sim_irq_next_line()
+{
+	int next = -1;
+
+	for (int irq = 0 ; irq < SIM_IRQ_LINES_COUNT ; irq++)
+	{
+		sim_irq_line_t* line = &lines[irq];
+
+		if ( (line->pending == false) || (line->enabled == false) ||
+			 (line->routine == nullptr) )
+			continue;
+
+		if ( (next == -1) || (line->priority < lines[next].priority) )
+		{
+			next = irq;
+		}
+	}
+
+	return next;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Runs pending handlers until none is left,
+ *        when allowed.
+ */
+static void _sim_irq_service()
+{
+	if ( (lock_depth > 0) || (handler_running == true) )
+		return;
+
+	int irq;
+	while ( (irq = _sim_irq_next_line()) != -1 )
+	{
+		lines[irq].pending = false;
+
+		handler_running = true;
+		lines[irq].routine(lines[irq].parameter);
+		handler_running = false;
+	}
+}
+
+
+/* Zephyr API */
+
+int irq_connect_dynamic(unsigned int irq,
+						unsigned int priority,
+						void (*routine)(const void* parameter),
+						const void* parameter,
+						uint32_t flags)
+{
+	if (irq >= SIM_IRQ_LINES_COUNT)
+		return -1;
+
+	lines[irq].routine   = routine;
+	lines[irq].parameter = parameter;
+	lines[irq].priority  = (flags & IRQ_ZERO_LATENCY) ? -1 : (int)priority;
+
+	return irq;
+}
+
+void irq_enable(unsigned int irq)
+{
+	if (irq >= SIM_IRQ_LINES_COUNT)
+		return;
+
+	lines[irq].enabled = true;
+	_sim_irq_service();
+}
+
+void irq_disable(unsigned int irq)
+{
+	if (irq >= SIM_IRQ_LINES_COUNT)
+		return;
+
+	lines[irq].enabled = false;
+}
+
+int irq_is_enabled(unsigned int irq)
+{
+	if (irq >= SIM_IRQ_LINES_COUNT)
+		return 0;
+
+	return lines[irq].enabled ? 1 : 0;
+}
+
+unsigned int irq_lock()
+{
+	return lock_depth++;
+}
+
+void irq_unlock(unsigned int key)
+{
+	lock_depth = key;
+	_sim_irq_service();
+}
+
+
+/* CMSIS NVIC API */
+
+void NVIC_SetPendingIRQ(IRQn_Type irq)
+{
+	sim_irq_raise(irq);
+}
+
+
+/* Public API */
+
+void sim_irq_raise(unsigned int irq)
+{
+	if (irq >= SIM_IRQ_LINES_COUNT)
+		return;
+
+	lines[irq].pending = true;
+	_sim_irq_service();
+}
+
+bool sim_irq_is_pending(unsigned int irq)
+{
+	if (irq >= SIM_IRQ_LINES_COUNT)
+		return false;
+
+	return lines[irq].pending;
+}
+
+void sim_irq_clear_pending(unsigned int irq)
+{
+	if (irq >= SIM_IRQ_LINES_COUNT)
+		return;
+
+	lines[irq].pending = false;
+}
+
+void sim_irq_reset()
+{
+	for (int irq = 0 ; irq < SIM_IRQ_LINES_COUNT ; irq++)
+	{
+		lines[irq] = {};
+	}
+
+	lock_depth = 0;
+}
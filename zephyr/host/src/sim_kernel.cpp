@@ -0,0 +1,824 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Simulated kernel of the host build. Each thread runs on its own
+ *         host stack, and switches back to the simulation loop (ucontext)
+ *         when it blocks or yields.
+ */
+
+
+/* Stdlib */
+#include <ucontext.h>
+#include <vector>
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+
+/* Event trace */
+#include "event_trace.h"
+
+/* Simulator */
+#include "sim/sim_time.h"
+
+/* Current file header */
+#include "sim/sim_kernel.h"
+
+
+/**
+ *  Local variables and constants
+ */
+
+/* Host stack of a thread: target stack sizes are too small for host code */
+#define SIM_THREAD_STACK_SIZE (256 * 1024)
+
+#define SIM_TIME_NEVER UINT64_MAX
+
+/* 170MHz system clock */
+#define SIM_CYCLES_PER_US 170
+
+typedef enum
+{
+	sim_thread_ready,
+	sim_thread_yielded,   /* Ready after the next time step */
+	sim_thread_sleeping,
+	sim_thread_pending_semaphore,
+	sim_thread_pending_timer,
+	sim_thread_dead
+} sim_thread_state_t;
+
+typedef struct
+{
+	struct k_thread*   handle;
+	k_thread_entry_t   entry;
+	void*              p1;
+	void*              p2;
+	void*              p3;
+	int                priority;
+	sim_thread_state_t state;
+	bool               suspended;
+	uint64_t           ready_order; /* First in first out at a same priority */
+	uint64_t           wake_ns;     /* Sleep end or semaphore timeout */
+	struct k_sem*      semaphore;
+	struct k_timer*    timer;
+	int                wait_result;
+	ucontext_t         context;
+	std::vector<char>  stack;
+} sim_thread_t;
+
+static std::vector<sim_thread_t*>   threads;
+static std::vector<struct k_timer*> timers;
+static std::vector<sim_event_t*>    events;
+
+static ucontext_t simulation_context;
+static int        current_thread = -1;
+static uint64_t   ready_counter  = 0;
+static uint64_t   step_end_ns    = 0;
+
+#ifdef CONFIG_OWNTECH_TRACE
+/* Thread of the last switch event, not repeated while it keeps running */
+#define TRACE_THREAD_IDLE_INDEX -1
+static int traced_thread = TRACE_THREAD_IDLE_INDEX - 1;
+#endif
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Makes a thread ready, after the threads already
+ *        ready at its priority.
+ */
+static void _sim_kernel_make_ready(sim_thread_t* thread, int wait_result)
+{
+	thread->state       = sim_thread_ready;
+	thread->wait_result = wait_result;
+	thread->ready_order = ready_counter;
+	ready_counter++;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Switches from the current thread back to the
+ *        simulation loop. Returns when the thread is run again.
+ */
+static void _sim_kernel_switch_out()
+{
+	sim_thread_t* thread = threads[current_thread];
+
+	swapcontext(&thread->context, &simulation_context);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Entry point of all threads.
+ */
+static void _sim_kernel_thread_entry(int thread_id)
+{
+	sim_thread_t* thread = threads[thread_id];
+
+	thread->entry(thread->p1, thread->p2, thread->p3);
+
+	thread->state = sim_thread_dead;
+	_sim_kernel_switch_out();
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Runs ready threads, most urgent first, until
+ *        all of them block or yield.
+ */
+static void _sim_kernel_run_threads()
+{
+	while (true)
+	{
+		int next_thread = -1;
+
+		for (size_t i = 0 ; i < threads.size() ; i++)
+		{
+			sim_thread_t* thread = threads[i];
+
+			if ( (thread->state != sim_thread_ready) ||
+				 (thread->suspended == true) )
+				continue;
+
+			if ( (next_thread < 0) ||
+				 (thread->priority < threads[next_thread]->priority) ||
+				 ( (thread->priority == threads[next_thread]->priority) &&
+				   (thread->ready_order < threads[next_thread]->ready_order) ) )
+			{
+				next_thread = (int)i;
+			}
+		}
+
+		if (next_thread < 0)
+		{
+#ifdef CONFIG_OWNTECH_TRACE
+			/* The simulation loop stands for the idle thread */
+			if (traced_thread != TRACE_THREAD_IDLE_INDEX)
+			{
+				OWNTECH_TRACE(TRACE_EVENT_THREAD_SWITCH, TRACE_THREAD_IDLE);
+				traced_thread = TRACE_THREAD_IDLE_INDEX;
+			}
+#endif
+			return;
+		}
+
+#ifdef CONFIG_OWNTECH_TRACE
+		if (traced_thread != next_thread)
+		{
+			trace_thread_switched_in(threads[next_thread]->handle);
+			traced_thread = next_thread;
+		}
+#endif
+
+		current_thread = next_thread;
+		swapcontext(&simulation_context, &threads[next_thread]->context);
+		current_thread = -1;
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the simulated time of the next timer
+ *        expiry, thread wake-up or event.
+ */
+static uint64_t _sim_kernel_next_time()
+{
+	uint64_t next_ns = SIM_TIME_NEVER;
+
+	for (struct k_timer* timer : timers)
+	{
+		if ( (timer->running == true) && (timer->expiry_ns < next_ns) )
+		{
+			next_ns = timer->expiry_ns;
+		}
+	}
+
+	for (sim_thread_t* thread : threads)
+	{
+		if ( ( (thread->state == sim_thread_sleeping) ||
+			   (thread->state == sim_thread_pending_semaphore) ) &&
+			 (thread->wake_ns < next_ns) )
+		{
+			next_ns = thread->wake_ns;
+		}
+	}
+
+	for (sim_event_t* event : events)
+	{
+		if ( (event->scheduled == true) && (event->time_ns < next_ns) )
+		{
+			next_ns = event->time_ns;
+		}
+	}
+
+	return next_ns;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Wakes the threads waiting on a timer.
+ */
+static void _sim_kernel_wake_timer_threads(struct k_timer* timer)
+{
+	for (sim_thread_t* thread : threads)
+	{
+		if ( (thread->state == sim_thread_pending_timer) &&
+			 (thread->timer == timer) )
+		{
+			_sim_kernel_make_ready(thread, 0);
+		}
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Processes what is due at the current simulated
+ *        time: timers, thread wake-ups, then events by priority.
+ */
+static void _sim_kernel_process_due()
+{
+	uint64_t now_ns = sim_time_get_ns();
+
+	for (sim_thread_t* thread : threads)
+	{
+		if (thread->state == sim_thread_yielded)
+		{
+			_sim_kernel_make_ready(thread, 0);
+		}
+	}
+
+	for (struct k_timer* timer : timers)
+	{
+		if ( (timer->running == false) || (timer->expiry_ns > now_ns) )
+			continue;
+
+		timer->status++;
+
+		if (timer->period_ns != 0)
+		{
+			timer->expiry_ns += timer->period_ns;
+		}
+		else
+		{
+			timer->running = false;
+		}
+
+		if (timer->expiry_fn != NULL)
+		{
+			timer->expiry_fn(timer);
+		}
+
+		_sim_kernel_wake_timer_threads(timer);
+	}
+
+	for (sim_thread_t* thread : threads)
+	{
+		if ( (thread->state == sim_thread_sleeping) &&
+			 (thread->wake_ns <= now_ns) )
+		{
+			_sim_kernel_make_ready(thread, 0);
+		}
+		else if ( (thread->state == sim_thread_pending_semaphore) &&
+				  (thread->wake_ns <= now_ns) )
+		{
+			_sim_kernel_make_ready(thread, -EAGAIN);
+		}
+	}
+
+	/* Handlers may schedule other events due now */
+	while (true)
+	{
+		sim_event_t* next_event = nullptr;
+
+		for (sim_event_t* event : events)
+		{
+			if ( (event->scheduled == false) || (event->time_ns > now_ns) )
+				continue;
+
+			if ( (next_event == nullptr) ||
+				 (event->time_ns < next_event->time_ns) ||
+				 ( (event->time_ns == next_event->time_ns) &&
+				   (event->priority < next_event->priority) ) )
+			{
+				next_event = event;
+			}
+		}
+
+		if (next_event == nullptr)
+			break;
+
+		next_event->scheduled = false;
+		next_event->handler(next_event->arg);
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Runs the threads, then moves to the next due
+ *        time if it is not after a limit and processes it.
+ *
+ * @return false if nothing is due until the limit.
+ */
+static bool _sim_kernel_step(uint64_t end_ns)
+{
+	step_end_ns = end_ns;
+
+	_sim_kernel_run_threads();
+
+	uint64_t next_ns = _sim_kernel_next_time();
+	if ( (next_ns == SIM_TIME_NEVER) || (next_ns > end_ns) )
+		return false;
+
+	uint64_t now_ns = sim_time_get_ns();
+	if (next_ns > now_ns)
+	{
+		sim_time_advance_ns(next_ns - now_ns);
+	}
+
+	_sim_kernel_process_due();
+
+	return true;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the simulated time at the end of a
+ *        timeout, or SIM_TIME_NEVER for K_FOREVER.
+ */
+static uint64_t _sim_kernel_timeout_end(k_timeout_t timeout)
+{
+	if (timeout.ns < 0)
+		return SIM_TIME_NEVER;
+
+	return sim_time_get_ns() + (uint64_t)timeout.ns;
+}
+
+
+/* Public API */
+
+void sim_event_schedule(sim_event_t* event, uint64_t time_ns)
+{
+	bool registered = false;
+	for (sim_event_t* registered_event : events)
+	{
+		if (registered_event == event)
+		{
+			registered = true;
+			break;
+		}
+	}
+
+	if (registered == false)
+	{
+		events.push_back(event);
+	}
+
+	event->time_ns   = time_ns;
+	event->scheduled = true;
+}
+
+void sim_event_cancel(sim_event_t* event)
+{
+	event->scheduled = false;
+}
+
+bool sim_kernel_is_idle_until(uint64_t time_ns)
+{
+	if (time_ns > step_end_ns)
+		return false;
+
+	for (sim_thread_t* thread : threads)
+	{
+		if ( ( (thread->state == sim_thread_ready) ||
+			   (thread->state == sim_thread_yielded) ) &&
+			 (thread->suspended == false) )
+		{
+			return false;
+		}
+	}
+
+	return (_sim_kernel_next_time() > time_ns);
+}
+
+uint64_t sim_kernel_get_idle_end()
+{
+	for (sim_thread_t* thread : threads)
+	{
+		if ( ( (thread->state == sim_thread_ready) ||
+			   (thread->state == sim_thread_yielded) ) &&
+			 (thread->suspended == false) )
+		{
+			return sim_time_get_ns();
+		}
+	}
+
+	uint64_t next_ns = _sim_kernel_next_time();
+
+	return (next_ns < step_end_ns) ? next_ns : step_end_ns;
+}
+
+void sim_kernel_run_until(uint64_t end_ns)
+{
+	while (_sim_kernel_step(end_ns) == true)
+	{
+	}
+
+	uint64_t now_ns = sim_time_get_ns();
+	if (end_ns > now_ns)
+	{
+		sim_time_advance_ns(end_ns - now_ns);
+		_sim_kernel_process_due();
+	}
+}
+
+void sim_kernel_run_for(uint64_t duration_ns)
+{
+	sim_kernel_run_until(sim_time_get_ns() + duration_ns);
+}
+
+
+/* Zephyr threads */
+
+k_tid_t k_thread_create(struct k_thread* new_thread,
+						k_thread_stack_t* stack,
+						size_t stack_size,
+						k_thread_entry_t entry,
+						void* p1, void* p2, void* p3,
+						int prio,
+						uint32_t options,
+						k_timeout_t delay)
+{
+	ARG_UNUSED(stack);
+	ARG_UNUSED(stack_size);
+	ARG_UNUSED(options);
+
+	sim_thread_t* thread = new sim_thread_t();
+
+	thread->handle    = new_thread;
+	thread->entry     = entry;
+	thread->p1        = p1;
+	thread->p2        = p2;
+	thread->p3        = p3;
+	thread->priority  = prio;
+	thread->suspended = false;
+	thread->stack.resize(SIM_THREAD_STACK_SIZE);
+
+	int thread_id = (int)threads.size();
+	threads.push_back(thread);
+	new_thread->sim_id = thread_id;
+
+	getcontext(&thread->context);
+	thread->context.uc_stack.ss_sp   = thread->stack.data();
+	thread->context.uc_stack.ss_size = thread->stack.size();
+	thread->context.uc_link          = nullptr;
+	makecontext(&thread->context,
+				(void (*)())_sim_kernel_thread_entry,
+				1, thread_id);
+
+	if (delay.ns == 0)
+	{
+		_sim_kernel_make_ready(thread, 0);
+	}
+	else
+	{
+		/* Started by k_thread_resume() when the delay is K_FOREVER */
+		thread->state   = sim_thread_sleeping;
+		thread->wake_ns = _sim_kernel_timeout_end(delay);
+	}
+
+	return new_thread;
+}
+
+void k_thread_suspend(k_tid_t thread_id)
+{
+	sim_thread_t* thread = threads[thread_id->sim_id];
+
+	thread->suspended = true;
+
+	if (thread_id->sim_id == current_thread)
+	{
+		_sim_kernel_switch_out();
+	}
+}
+
+void k_thread_resume(k_tid_t thread_id)
+{
+	sim_thread_t* thread = threads[thread_id->sim_id];
+
+	if (thread->suspended == false)
+		return;
+
+	thread->suspended = false;
+
+	/* As on the target, resuming a sleeping thread ends its sleep */
+	if (thread->state == sim_thread_sleeping)
+	{
+		_sim_kernel_make_ready(thread, 0);
+	}
+}
+
+k_tid_t k_current_get()
+{
+	if (current_thread < 0)
+		return NULL;
+
+	return threads[current_thread]->handle;
+}
+
+void k_yield()
+{
+	if (current_thread < 0)
+		return;
+
+	threads[current_thread]->state = sim_thread_yielded;
+	_sim_kernel_switch_out();
+}
+
+int32_t k_sleep(k_timeout_t timeout)
+{
+	if (current_thread < 0)
+	{
+		/* Sleeping outside of a thread runs the simulation */
+		if (timeout.ns > 0)
+		{
+			sim_kernel_run_for((uint64_t)timeout.ns);
+		}
+
+		return 0;
+	}
+
+	sim_thread_t* thread = threads[current_thread];
+
+	thread->state   = sim_thread_sleeping;
+	thread->wake_ns = _sim_kernel_timeout_end(timeout);
+	_sim_kernel_switch_out();
+
+	return 0;
+}
+
+
+/* Zephyr timers */
+
+void k_timer_init(struct k_timer* timer,
+				  void (*expiry_fn)(struct k_timer* timer),
+				  void (*stop_fn)(struct k_timer* timer))
+{
+	timer->expiry_ns = 0;
+	timer->period_ns = 0;
+	timer->status    = 0;
+	timer->running   = false;
+	timer->expiry_fn = expiry_fn;
+	timer->stop_fn   = stop_fn;
+
+	for (struct k_timer* registered_timer : timers)
+	{
+		if (registered_timer == timer)
+			return;
+	}
+
+	timers.push_back(timer);
+}
+
+void k_timer_start(struct k_timer* timer,
+				   k_timeout_t duration,
+				   k_timeout_t period)
+{
+	if (duration.ns < 0)
+		return;
+
+	timer->expiry_ns = _sim_kernel_timeout_end(duration);
+	timer->period_ns = (period.ns > 0) ? (uint64_t)period.ns : 0;
+	timer->status    = 0;
+	timer->running   = true;
+}
+
+void k_timer_stop(struct k_timer* timer)
+{
+	if (timer->running == false)
+		return;
+
+	timer->running = false;
+
+	if (timer->stop_fn != NULL)
+	{
+		timer->stop_fn(timer);
+	}
+
+	_sim_kernel_wake_timer_threads(timer);
+}
+
+uint32_t k_timer_status_get(struct k_timer* timer)
+{
+	uint32_t status = timer->status;
+	timer->status = 0;
+
+	return status;
+}
+
+uint32_t k_timer_status_sync(struct k_timer* timer)
+{
+	if ( (timer->status == 0) && (timer->running == true) )
+	{
+		if (current_thread >= 0)
+		{
+			sim_thread_t* thread = threads[current_thread];
+
+			thread->state = sim_thread_pending_timer;
+			thread->timer = timer;
+			_sim_kernel_switch_out();
+		}
+		else
+		{
+			while ( (timer->status == 0) && (timer->running == true) )
+			{
+				if (_sim_kernel_step(SIM_TIME_NEVER) == false)
+					break;
+			}
+		}
+	}
+
+	return k_timer_status_get(timer);
+}
+
+
+/* Zephyr semaphores */
+
+int k_sem_init(struct k_sem* sem, unsigned int initial_count, unsigned int limit)
+{
+	if ( (limit == 0) || (initial_count > limit) )
+		return -EINVAL;
+
+	sem->count = initial_count;
+	sem->limit = limit;
+
+	return 0;
+}
+
+void k_sem_give(struct k_sem* sem)
+{
+	sim_thread_t* waiting_thread = nullptr;
+
+	for (sim_thread_t* thread : threads)
+	{
+		if ( (thread->state != sim_thread_pending_semaphore) ||
+			 (thread->semaphore != sem) )
+			continue;
+
+		if ( (waiting_thread == nullptr) ||
+			 (thread->priority < waiting_thread->priority) ||
+			 ( (thread->priority == waiting_thread->priority) &&
+			   (thread->ready_order < waiting_thread->ready_order) ) )
+		{
+			waiting_thread = thread;
+		}
+	}
+
+	if (waiting_thread != nullptr)
+	{
+		_sim_kernel_make_ready(waiting_thread, 0);
+	}
+	else if (sem->count < sem->limit)
+	{
+		sem->count++;
+	}
+}
+
+int k_sem_take(struct k_sem* sem, k_timeout_t timeout)
+{
+	if (sem->count > 0)
+	{
+		sem->count--;
+		return 0;
+	}
+
+	if (timeout.ns == 0)
+		return -EBUSY;
+
+	if (current_thread >= 0)
+	{
+		sim_thread_t* thread = threads[current_thread];
+
+		thread->state     = sim_thread_pending_semaphore;
+		thread->semaphore = sem;
+		thread->wake_ns   = _sim_kernel_timeout_end(timeout);
+
+		/* Keeps the first in first out order among waiting threads */
+		thread->ready_order = ready_counter;
+		ready_counter++;
+
+		_sim_kernel_switch_out();
+
+		return thread->wait_result;
+	}
+
+	uint64_t end_ns = _sim_kernel_timeout_end(timeout);
+	while (sem->count == 0)
+	{
+		if (_sim_kernel_step(end_ns) == false)
+			return -EAGAIN;
+	}
+
+	sem->count--;
+
+	return 0;
+}
+
+void k_sem_reset(struct k_sem* sem)
+{
+	sem->count = 0;
+
+	for (sim_thread_t* thread : threads)
+	{
+		if ( (thread->state == sim_thread_pending_semaphore) &&
+			 (thread->semaphore == sem) )
+		{
+			_sim_kernel_make_ready(thread, -EAGAIN);
+		}
+	}
+}
+
+unsigned int k_sem_count_get(struct k_sem* sem)
+{
+	return sem->count;
+}
+
+
+/* Zephyr mutexes */
+
+int k_mutex_init(struct k_mutex* mutex)
+{
+	k_sem_init(&mutex->sem, 1, 1);
+	mutex->owner      = nullptr;
+	mutex->lock_count = 0;
+
+	return 0;
+}
+
+int k_mutex_lock(struct k_mutex* mutex, k_timeout_t timeout)
+{
+	k_tid_t current = k_current_get();
+
+	if ( (mutex->lock_count > 0) && (mutex->owner == current) )
+	{
+		mutex->lock_count++;
+		return 0;
+	}
+
+	int result = k_sem_take(&mutex->sem, timeout);
+	if (result != 0)
+		return result;
+
+	mutex->owner      = current;
+	mutex->lock_count = 1;
+
+	return 0;
+}
+
+int k_mutex_unlock(struct k_mutex* mutex)
+{
+	if (mutex->lock_count == 0)
+		return -EINVAL;
+
+	if (mutex->owner != k_current_get())
+		return -EPERM;
+
+	mutex->lock_count--;
+	if (mutex->lock_count == 0)
+	{
+		mutex->owner = nullptr;
+		k_sem_give(&mutex->sem);
+	}
+
+	return 0;
+}
+
+
+/* Zephyr time */
+
+int64_t k_uptime_get()
+{
+	return (int64_t)(sim_time_get_ns() / 1000000);
+}
+
+uint32_t k_uptime_get_32()
+{
+	return (uint32_t)k_uptime_get();
+}
+
+uint32_t k_cycle_get_32()
+{
+	return (uint32_t)((sim_time_get_ns() * SIM_CYCLES_PER_US) / 1000);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  In-memory replacement of the NVS storage in the host build.
+ *         Data is lost when the program exits.
+ */
+
+
+/* Stdlib */
+#include <string.h>
+#include <map>
+#include <vector>
+
+/* Current file header */
+#include "nvs_storage.h"
+
+
+/**
+ *  Local variables
+ */
+
+static std::map<uint16_t, std::vector<uint8_t>> storage;
+
+static const uint16_t current_version = 0x0001;
+
+
+/* Public API */
+
+int8_t nvs_storage_store_data(uint16_t data_id,
+							  const void* data,
+							  uint8_t data_size)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+
+	if (storage.find(VERSION) == storage.end())
+	{
+		storage[VERSION] = { (uint8_t)(current_version & 0xFF),
+							 (uint8_t)(current_version >> 8) };
+	}
+
+	storage[data_id] = std::vector<uint8_t>(bytes, bytes + data_size);
+
+	return (int8_t)data_size;
+}
+
+int8_t nvs_storage_retrieve_data(uint16_t data_id,
+								 void* data_buffer,
+								 uint8_t data_buffer_size)
+{
+	auto entry = storage.find(data_id);
+
+	if (entry == storage.end())
+		return -1;
+
+	size_t size = entry->second.size();
+	if (size > data_buffer_size)
+	{
+		size = data_buffer_size;
+	}
+
+	memcpy(data_buffer, entry->second.data(), size);
+
+	return (int8_t)entry->second.size();
+}
+
+int8_t nvs_storage_clear_all_stored_data()
+{
+	storage.clear();
+
+	return 0;
+}
+
+uint16_t nvs_storage_get_current_version()
+{
+	return current_version;
+}
+
+uint16_t nvs_storage_get_version_in_nvs()
+{
+	uint16_t version = 0;
+
+	nvs_storage_retrieve_data(VERSION, &version, sizeof(version));
+
+	return version;
+}
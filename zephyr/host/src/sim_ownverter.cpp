@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Ownverter plant model.
+ *
+ *         States:  i1, i2, i3 (phase currents), vH (DC bus capacitor).
+ *         Inputs:  DC source, e1, e2, e3 (back-EMF).
+ *
+ *         The load is a balanced star with a floating neutral, whose
+ *         voltage is vN = (s1 + s2 + s3).vH/3 - (e1 + e2 + e3)/3:
+ *
+ *         dik/dt = (sk.vH - vN - ek - R.ik) / L
+ *         dvH/dt = (GS.(VS - vH) - s1.i1 - s2.i2 - s3.i3) / C
+ */
+
+
+/* Stdlib */
+#include <math.h>
+
+/* Current module private header */
+#include "sim_power_stage.h"
+
+/* Current file header */
+#include "sim/sim_power_models.h"
+
+
+/**
+ *  Local variables and constants
+ */
+
+enum
+{
+	OWNVERTER_I1_LOW,
+	OWNVERTER_I2_LOW,
+	OWNVERTER_I3_LOW,
+	OWNVERTER_V_HIGH,
+	OWNVERTER_STATES_COUNT
+};
+
+enum
+{
+	OWNVERTER_DC_SOURCE,
+	OWNVERTER_EMF1,
+	OWNVERTER_EMF2,
+	OWNVERTER_EMF3,
+	OWNVERTER_INPUTS_COUNT
+};
+
+/* Measured quantities that are not states */
+#define OWNVERTER_V1_LOW           (OWNVERTER_STATES_COUNT + 0)
+#define OWNVERTER_V2_LOW           (OWNVERTER_STATES_COUNT + 1)
+#define OWNVERTER_V3_LOW           (OWNVERTER_STATES_COUNT + 2)
+#define OWNVERTER_I_HIGH           (OWNVERTER_STATES_COUNT + 3)
+#define OWNVERTER_QUANTITIES_COUNT (OWNVERTER_STATES_COUNT + 4)
+
+#define OWNVERTER_LEGS_COUNT 3
+
+/* Gains and offsets from boards/shields/ownverter/ownverter_v1_1_0.overlay */
+#define OWNVERTER_V_LOW_GAIN    0x3d3851ec
+#define OWNVERTER_V_LOW_OFFSET  0xc2b867f0
+#define OWNVERTER_V_HIGH_GAIN   0x3cf57710
+#define OWNVERTER_V_HIGH_OFFSET 0x00000000
+#define OWNVERTER_I_GAIN        0x3ba3d70a
+#define OWNVERTER_I_OFFSET      0xc1200000
+/* The devicetree gives I3_LOW the calibration of the voltage sensors */
+#define OWNVERTER_I3_LOW_GAIN   0x3d3851ec
+#define OWNVERTER_I3_LOW_OFFSET 0xc2b867f0
+
+static const sim_power_stage_sensor_t ownverter_sensors[] =
+{
+	{ OWNVERTER_V1_LOW, 1,  6, OWNVERTER_V_LOW_GAIN,  OWNVERTER_V_LOW_OFFSET  },
+	{ OWNVERTER_V1_LOW, 2,  6, OWNVERTER_V_LOW_GAIN,  OWNVERTER_V_LOW_OFFSET  },
+	{ OWNVERTER_V2_LOW, 1,  1, OWNVERTER_V_LOW_GAIN,  OWNVERTER_V_LOW_OFFSET  },
+	{ OWNVERTER_V2_LOW, 2,  1, OWNVERTER_V_LOW_GAIN,  OWNVERTER_V_LOW_OFFSET  },
+	{ OWNVERTER_V3_LOW, 2,  4, OWNVERTER_V_LOW_GAIN,  OWNVERTER_V_LOW_OFFSET  },
+	{ OWNVERTER_V_HIGH, 1,  8, OWNVERTER_V_HIGH_GAIN, OWNVERTER_V_HIGH_OFFSET },
+	{ OWNVERTER_V_HIGH, 2,  8, OWNVERTER_V_HIGH_GAIN, OWNVERTER_V_HIGH_OFFSET },
+	{ OWNVERTER_I1_LOW, 1,  7, OWNVERTER_I_GAIN,      OWNVERTER_I_OFFSET      },
+	{ OWNVERTER_I1_LOW, 2,  7, OWNVERTER_I_GAIN,      OWNVERTER_I_OFFSET      },
+	{ OWNVERTER_I2_LOW, 1,  2, OWNVERTER_I_GAIN,      OWNVERTER_I_OFFSET      },
+	{ OWNVERTER_I2_LOW, 2,  2, OWNVERTER_I_GAIN,      OWNVERTER_I_OFFSET      },
+	{ OWNVERTER_I3_LOW, 1, 14, OWNVERTER_I3_LOW_GAIN, OWNVERTER_I3_LOW_OFFSET },
+	{ OWNVERTER_I3_LOW, 2, 14, OWNVERTER_I3_LOW_GAIN, OWNVERTER_I3_LOW_OFFSET },
+	{ OWNVERTER_I_HIGH, 1,  9, OWNVERTER_I_GAIN,      OWNVERTER_I_OFFSET      },
+	{ OWNVERTER_I_HIGH, 2,  9, OWNVERTER_I_GAIN,      OWNVERTER_I_OFFSET      }
+};
+
+static sim_ownverter_parameters_t ownverter_parameters;
+static sim_power_stage_t          ownverter_stage;
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Continuous-time matrices of a combination of
+ *        switch states.
+ */
+static void _sim_ownverter_matrices(void* context,
+									uint8_t switches,
+									double* a,
+									double* b)
+{
+	const sim_ownverter_parameters_t* p =
+		(const sim_ownverter_parameters_t*)context;
+
+	const size_t n = OWNVERTER_STATES_COUNT;
+	const size_t m = OWNVERTER_INPUTS_COUNT;
+
+	double source = (p->dc_source_resistance > 0) ?
+					(1.0 / p->dc_source_resistance) : 0.0;
+
+	double on[OWNVERTER_LEGS_COUNT];
+	double on_mean = 0;
+	for (uint8_t leg = 0 ; leg < OWNVERTER_LEGS_COUNT ; leg++)
+	{
+		on[leg]  = (switches & (1U << leg)) ? 1.0 : 0.0;
+		on_mean += on[leg] / OWNVERTER_LEGS_COUNT;
+	}
+
+	a[OWNVERTER_V_HIGH * n + OWNVERTER_V_HIGH] = -source / p->dc_capacitance;
+	b[OWNVERTER_V_HIGH * m + OWNVERTER_DC_SOURCE] = source / p->dc_capacitance;
+
+	for (uint8_t leg = 0 ; leg < OWNVERTER_LEGS_COUNT ; leg++)
+	{
+		size_t current = OWNVERTER_I1_LOW + leg;
+
+		a[current * n + current] = -p->phase_resistance / p->phase_inductance;
+		a[current * n + OWNVERTER_V_HIGH] = (on[leg] - on_mean)
+										  / p->phase_inductance;
+
+		for (uint8_t emf = 0 ; emf < OWNVERTER_LEGS_COUNT ; emf++)
+		{
+			double share = ((emf == leg) ? 1.0 : 0.0) - 1.0 / OWNVERTER_LEGS_COUNT;
+			b[current * m + OWNVERTER_EMF1 + emf] = -share / p->phase_inductance;
+		}
+
+		a[OWNVERTER_V_HIGH * n + current] = -on[leg] / p->dc_capacitance;
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Updates the back-EMF at the middle of a step.
+ */
+static void _sim_ownverter_inputs(void* context, uint64_t time_ns, double* u)
+{
+	const sim_ownverter_parameters_t* p =
+		(const sim_ownverter_parameters_t*)context;
+
+	if (p->emf_amplitude == 0)
+		return;
+
+	double angle = 2.0 * M_PI * p->emf_frequency * ((double)time_ns * 1e-9);
+
+	for (uint8_t phase = 0 ; phase < OWNVERTER_LEGS_COUNT ; phase++)
+	{
+		u[OWNVERTER_EMF1 + phase] = p->emf_amplitude *
+									cos(angle - phase * 2.0 * M_PI / 3.0);
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Computes all the measured quantities.
+ */
+static void _sim_ownverter_quantities(double* quantities)
+{
+	const double* x = ownverter_stage.x;
+
+	for (uint8_t i = 0 ; i < OWNVERTER_STATES_COUNT ; i++)
+	{
+		quantities[i] = x[i];
+	}
+
+	quantities[OWNVERTER_I_HIGH] = 0;
+	for (uint8_t leg = 0 ; leg < OWNVERTER_LEGS_COUNT ; leg++)
+	{
+		double state = ownverter_stage.leg_state[leg];
+
+		quantities[OWNVERTER_V1_LOW + leg] = state * x[OWNVERTER_V_HIGH];
+		quantities[OWNVERTER_I_HIGH]      += state * x[OWNVERTER_I1_LOW + leg];
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Plant step function.
+ */
+static void _sim_ownverter_step(void* context, uint64_t duration_ns)
+{
+	(void)context;
+
+	sim_power_stage_step(&ownverter_stage, duration_ns);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Plant sample function.
+ */
+static bool _sim_ownverter_sample(void* context,
+								  uint8_t adc_number,
+								  uint8_t channel,
+								  float* value)
+{
+	(void)context;
+
+	double quantities[OWNVERTER_QUANTITIES_COUNT];
+	_sim_ownverter_quantities(quantities);
+
+	return sim_power_stage_sample(ownverter_sensors,
+								  sizeof(ownverter_sensors) / sizeof(ownverter_sensors[0]),
+								  quantities,
+								  adc_number,
+								  channel,
+								  value);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Plant duty cycle function.
+ */
+static void _sim_ownverter_set_duty_cycle(void* context,
+										  uint8_t leg,
+										  float duty_cycle)
+{
+	(void)context;
+
+	sim_power_stage_set_duty_cycle(&ownverter_stage, leg, duty_cycle);
+}
+
+static const sim_plant_t ownverter_plant =
+{
+	_sim_ownverter_step,
+	_sim_ownverter_sample,
+	_sim_ownverter_set_duty_cycle,
+	nullptr
+};
+
+
+/* Public API */
+
+void sim_ownverter_get_default_parameters(sim_ownverter_parameters_t* parameters)
+{
+	*parameters = {};
+
+	parameters->model.type                = sim_power_model_averaged;
+	parameters->model.switching_period_ns = 5000;
+	parameters->model.steps_per_period    = 1;
+
+	parameters->dc_capacitance       = 100e-6f;
+	parameters->dc_source_voltage    = 48.0f;
+	parameters->dc_source_resistance = 50e-3f;
+
+	parameters->phase_inductance = 1e-3f;
+	parameters->phase_resistance = 1.0f;
+}
+
+const sim_plant_t* sim_ownverter_init(const sim_ownverter_parameters_t* parameters)
+{
+	if ( (parameters->dc_capacitance <= 0) ||
+		 (parameters->phase_inductance <= 0) ||
+		 (parameters->phase_resistance < 0) )
+		return nullptr;
+
+	ownverter_parameters = *parameters;
+
+	int8_t result = sim_power_stage_init(&ownverter_stage,
+										 OWNVERTER_STATES_COUNT,
+										 OWNVERTER_INPUTS_COUNT,
+										 OWNVERTER_LEGS_COUNT,
+										 _sim_ownverter_matrices,
+										 _sim_ownverter_inputs,
+										 &ownverter_parameters,
+										 &parameters->model);
+	if (result != 0)
+		return nullptr;
+
+	ownverter_stage.u[OWNVERTER_DC_SOURCE] = parameters->dc_source_voltage;
+
+	return &ownverter_plant;
+}
+
+void sim_ownverter_get_measures(sim_ownverter_measures_t* measures)
+{
+	double quantities[OWNVERTER_QUANTITIES_COUNT];
+	_sim_ownverter_quantities(quantities);
+
+	measures->v1_low = (float)quantities[OWNVERTER_V1_LOW];
+	measures->v2_low = (float)quantities[OWNVERTER_V2_LOW];
+	measures->v3_low = (float)quantities[OWNVERTER_V3_LOW];
+	measures->v_high = (float)quantities[OWNVERTER_V_HIGH];
+	measures->i1_low = (float)quantities[OWNVERTER_I1_LOW];
+	measures->i2_low = (float)quantities[OWNVERTER_I2_LOW];
+	measures->i3_low = (float)quantities[OWNVERTER_I3_LOW];
+	measures->i_high = (float)quantities[OWNVERTER_I_HIGH];
+}
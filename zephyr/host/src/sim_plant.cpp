@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+
+/* Current file header */
+#include "sim/sim_plant.h"
+
+
+/**
+ *  Local variables
+ */
+
+static const sim_plant_t* current_plant = nullptr;
+
+
+/* Public API */
+
+void sim_plant_set(const sim_plant_t* plant)
+{
+	current_plant = plant;
+}
+
+void sim_plant_step(uint64_t duration_ns)
+{
+	if ( (current_plant == nullptr) || (current_plant->step == nullptr) )
+		return;
+
+	current_plant->step(current_plant->context, duration_ns);
+}
+
+bool sim_plant_sample(uint8_t adc_number, uint8_t channel, float* value)
+{
+	if ( (current_plant == nullptr) || (current_plant->sample == nullptr) )
+		return false;
+
+	return current_plant->sample(current_plant->context,
+								 adc_number,
+								 channel,
+								 value);
+}
+
+void sim_plant_set_duty_cycle(uint8_t leg, float duty_cycle)
+{
+	if ( (current_plant == nullptr) ||
+		 (current_plant->set_duty_cycle == nullptr) )
+		return;
+
+	current_plant->set_duty_cycle(current_plant->context, leg, duty_cycle);
+}
@@ -0,0 +1,499 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+
+/* Stdlib */
+#include <math.h>
+#include <string.h>
+
+/* Simulator */
+#include "sim/sim_time.h"
+
+/* Current file header */
+#include "sim_power_stage.h"
+
+
+/**
+ *  Local constants
+ */
+
+#define SIM_POWER_STAGE_MAX_AUGMENTED \
+	(SIM_POWER_STAGE_MAX_STATES + SIM_POWER_STAGE_MAX_INPUTS)
+
+/* Order of the Taylor series of the scaled matrix exponential */
+#define SIM_POWER_STAGE_TAYLOR_ORDER 16
+
+/* States below this magnitude are set to 0 */
+#define SIM_POWER_STAGE_FLUSH_LIMIT 1e-30
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Product of two square matrices. The result
+ *        must not alias the operands.
+ */
+static void _sim_power_stage_multiply(const double* left,
+									  const double* right,
+									  size_t size,
+									  double* result)
+{
+	for (size_t row = 0 ; row < size ; row++)
+	{
+		for (size_t column = 0 ; column < size ; column++)
+		{
+			double sum = 0;
+			for (size_t k = 0 ; k < size ; k++)
+			{
+				sum += left[row * size + k] * right[k * size + column];
+			}
+			result[row * size + column] = sum;
+		}
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Matrix exponential, by scaling and squaring
+ *        of a Taylor series.
+ */
+static void _sim_power_stage_exponential(const double* matrix,
+										 size_t size,
+										 double* result)
+{
+	const size_t elements = size * size;
+
+	double norm = 0;
+	for (size_t row = 0 ; row < size ; row++)
+	{
+		double row_sum = 0;
+		for (size_t column = 0 ; column < size ; column++)
+		{
+			row_sum += fabs(matrix[row * size + column]);
+		}
+		norm = fmax(norm, row_sum);
+	}
+
+	int squarings = 0;
+	if (norm > 0.5)
+	{
+		squarings = (int)ceil(log2(norm / 0.5));
+	}
+	double scale = ldexp(1.0, -squarings);
+
+	double scaled[SIM_POWER_STAGE_MAX_AUGMENTED * SIM_POWER_STAGE_MAX_AUGMENTED];
+	double term[SIM_POWER_STAGE_MAX_AUGMENTED * SIM_POWER_STAGE_MAX_AUGMENTED];
+	double next[SIM_POWER_STAGE_MAX_AUGMENTED * SIM_POWER_STAGE_MAX_AUGMENTED];
+
+	for (size_t i = 0 ; i < elements ; i++)
+	{
+		scaled[i] = matrix[i] * scale;
+	}
+
+	/* result = I + M + M^2/2! + ... */
+	memset(result, 0, elements * sizeof(double));
+	memset(term, 0, elements * sizeof(double));
+	for (size_t i = 0 ; i < size ; i++)
+	{
+		result[i * size + i] = 1;
+		term[i * size + i]   = 1;
+	}
+
+	for (int order = 1 ; order <= SIM_POWER_STAGE_TAYLOR_ORDER ; order++)
+	{
+		_sim_power_stage_multiply(term, scaled, size, next);
+		for (size_t i = 0 ; i < elements ; i++)
+		{
+			term[i]    = next[i] / order;
+			result[i] += term[i];
+		}
+	}
+
+	for (int i = 0 ; i < squarings ; i++)
+	{
+		_sim_power_stage_multiply(result, result, size, next);
+		memcpy(result, next, elements * sizeof(double));
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Zero-order hold discretisation of a
+ *        continuous-time model: exponential of [[A, B], [0, 0]] * step.
+ */
+static void _sim_power_stage_discretise(const double* a,
+										const double* b,
+										size_t states_count,
+										size_t inputs_count,
+										double step_s,
+										double* phi,
+										double* gamma)
+{
+	const size_t size = states_count + inputs_count;
+
+	double augmented[SIM_POWER_STAGE_MAX_AUGMENTED * SIM_POWER_STAGE_MAX_AUGMENTED] = {};
+	double exponential[SIM_POWER_STAGE_MAX_AUGMENTED * SIM_POWER_STAGE_MAX_AUGMENTED];
+
+	for (size_t row = 0 ; row < states_count ; row++)
+	{
+		for (size_t column = 0 ; column < states_count ; column++)
+		{
+			augmented[row * size + column] =
+				a[row * states_count + column] * step_s;
+		}
+		for (size_t column = 0 ; column < inputs_count ; column++)
+		{
+			augmented[row * size + states_count + column] =
+				b[row * inputs_count + column] * step_s;
+		}
+	}
+
+	_sim_power_stage_exponential(augmented, size, exponential);
+
+	for (size_t row = 0 ; row < states_count ; row++)
+	{
+		for (size_t column = 0 ; column < states_count ; column++)
+		{
+			phi[row * SIM_POWER_STAGE_MAX_STATES + column] =
+				exponential[row * size + column];
+		}
+		for (size_t column = 0 ; column < inputs_count ; column++)
+		{
+			gamma[row * SIM_POWER_STAGE_MAX_INPUTS + column] =
+				exponential[row * size + states_count + column];
+		}
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Weights the matrices of all the combinations
+ *        by the share of the step each one lasts, given the share of the
+ *        step each leg is on.
+ */
+static void _sim_power_stage_weight(const sim_power_stage_t* stage,
+									const double* on_shares,
+									double* phi,
+									double* gamma)
+{
+	const size_t phi_size   = SIM_POWER_STAGE_MAX_STATES * SIM_POWER_STAGE_MAX_STATES;
+	const size_t gamma_size = SIM_POWER_STAGE_MAX_STATES * SIM_POWER_STAGE_MAX_INPUTS;
+
+	memset(phi, 0, phi_size * sizeof(double));
+	memset(gamma, 0, gamma_size * sizeof(double));
+
+	for (uint32_t switches = 0 ;
+		 switches < (1U << stage->legs_count) ;
+		 switches++)
+	{
+		double weight = 1;
+		for (uint8_t leg = 0 ; leg < stage->legs_count ; leg++)
+		{
+			double on_share = on_shares[leg];
+			weight *= (switches & (1U << leg)) ? on_share : (1 - on_share);
+		}
+
+		if (weight == 0)
+			continue;
+
+		for (size_t i = 0 ; i < phi_size ; i++)
+		{
+			phi[i] += weight * stage->phi[switches][i];
+		}
+		for (size_t i = 0 ; i < gamma_size ; i++)
+		{
+			gamma[i] += weight * stage->gamma[switches][i];
+		}
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Term of the inputs in the next state: the
+ *        input matrix times the inputs.
+ */
+static void _sim_power_stage_input_term(const double* gamma,
+										const double* u,
+										double* term)
+{
+	for (size_t row = 0 ; row < SIM_POWER_STAGE_MAX_STATES ; row++)
+	{
+		term[row] = 0;
+	}
+
+	for (size_t column = 0 ; column < SIM_POWER_STAGE_MAX_INPUTS ; column++)
+	{
+		for (size_t row = 0 ; row < SIM_POWER_STAGE_MAX_STATES ; row++)
+		{
+			term[row] += gamma[row * SIM_POWER_STAGE_MAX_INPUTS + column] * u[column];
+		}
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Share of the next step during which a leg is
+ *        on. With a centered carrier, the leg is on for duty * period
+ *        around the middle of each period.
+ */
+static double _sim_power_stage_on_share(const sim_power_stage_t* stage,
+										uint8_t leg)
+{
+	const double period = (double)stage->period_ns;
+	const double half_on = stage->duty_cycle[leg] * period / 2;
+
+	/* Times relative to the start of the current period */
+	double start = (double)(stage->time_ns % stage->period_ns);
+	double end   = start + (double)stage->step_ns;
+
+	double on = 0;
+	for (int i = 0 ; i < 2 ; i++)
+	{
+		double center = i * period + period / 2;
+		double low    = fmax(start, center - half_on);
+		double high   = fmin(end, center + half_on);
+
+		if (high > low)
+		{
+			on += high - low;
+		}
+	}
+
+	return on / (double)stage->step_ns;
+}
+
+/* Public API */
+
+int8_t sim_power_stage_init(sim_power_stage_t* stage,
+							uint8_t states_count,
+							uint8_t inputs_count,
+							uint8_t legs_count,
+							sim_power_stage_matrices_t get_matrices,
+							sim_power_stage_inputs_t update_inputs,
+							void* context,
+							const sim_power_model_config_t* config)
+{
+	if ( (states_count == 0) || (states_count > SIM_POWER_STAGE_MAX_STATES) ||
+		 (inputs_count > SIM_POWER_STAGE_MAX_INPUTS) ||
+		 (legs_count == 0) || (legs_count > SIM_POWER_STAGE_MAX_LEGS) )
+		return -1;
+
+	if (config->switching_period_ns == 0)
+		return -1;
+
+	if (config->steps_per_period == 0)
+		return -1;
+
+	uint64_t step_ns = config->switching_period_ns / config->steps_per_period;
+	if (step_ns == 0)
+		return -1;
+
+	memset(stage, 0, sizeof(sim_power_stage_t));
+
+	stage->states_count  = states_count;
+	stage->inputs_count  = inputs_count;
+	stage->legs_count    = legs_count;
+	stage->update_inputs = update_inputs;
+	stage->context       = context;
+	stage->type          = config->type;
+	stage->period_ns     = config->switching_period_ns;
+	stage->step_ns       = step_ns;
+	stage->time_ns       = sim_time_get_ns();
+
+	for (uint32_t switches = 0 ; switches < (1U << legs_count) ; switches++)
+	{
+		double a[SIM_POWER_STAGE_MAX_STATES * SIM_POWER_STAGE_MAX_STATES] = {};
+		double b[SIM_POWER_STAGE_MAX_STATES * SIM_POWER_STAGE_MAX_INPUTS] = {};
+
+		get_matrices(context, switches, a, b);
+
+		_sim_power_stage_discretise(a, b,
+									states_count, inputs_count,
+									(double)step_ns * 1e-9,
+									stage->phi[switches],
+									stage->gamma[switches]);
+	}
+
+	return 0;
+}
+
+void sim_power_stage_set_duty_cycle(sim_power_stage_t* stage,
+									uint8_t leg,
+									double duty_cycle)
+{
+	if ( (leg == 0) || (leg > stage->legs_count) )
+		return;
+
+	duty_cycle = fmin(fmax(duty_cycle, 0.0), 1.0);
+
+	if (stage->duty_cycle[leg - 1] != duty_cycle)
+	{
+		stage->duty_cycle[leg - 1] = duty_cycle;
+		stage->averaged_valid      = false;
+	}
+}
+
+void sim_power_stage_step(sim_power_stage_t* stage, uint64_t duration_ns)
+{
+	stage->pending_ns += duration_ns;
+
+	while (stage->pending_ns >= stage->step_ns)
+	{
+		const double* phi;
+		const double* gamma;
+		double input_term[SIM_POWER_STAGE_MAX_STATES];
+		const double* input = input_term;
+
+		if (stage->update_inputs != nullptr)
+		{
+			stage->update_inputs(stage->context,
+								 stage->time_ns + stage->step_ns / 2,
+								 stage->u);
+		}
+
+		if (stage->type == sim_power_model_averaged)
+		{
+			if (stage->averaged_valid == false)
+			{
+				_sim_power_stage_weight(stage,
+										stage->duty_cycle,
+										stage->averaged_phi,
+										stage->averaged_gamma);
+				_sim_power_stage_input_term(stage->averaged_gamma,
+											stage->u,
+											stage->averaged_input);
+				stage->averaged_valid = true;
+			}
+
+			phi   = stage->averaged_phi;
+			gamma = stage->averaged_gamma;
+
+			/* Constant inputs: their term only changes with the duty cycles */
+			if (stage->update_inputs == nullptr)
+			{
+				input = stage->averaged_input;
+			}
+
+			for (uint8_t leg = 0 ; leg < stage->legs_count ; leg++)
+			{
+				stage->leg_state[leg] = stage->duty_cycle[leg];
+			}
+		}
+		else
+		{
+			uint8_t switches = 0;
+			bool    partial  = false;
+
+			for (uint8_t leg = 0 ; leg < stage->legs_count ; leg++)
+			{
+				double on = _sim_power_stage_on_share(stage, leg);
+
+				stage->leg_state[leg] = on;
+				if (on == 1)
+				{
+					switches |= (1U << leg);
+				}
+				else if (on != 0)
+				{
+					partial = true;
+				}
+			}
+
+			if (partial == false)
+			{
+				phi   = stage->phi[switches];
+				gamma = stage->gamma[switches];
+			}
+			else
+			{
+				/* Steps in which a switch commutes */
+				_sim_power_stage_weight(stage,
+										stage->leg_state,
+										stage->switching_phi,
+										stage->switching_gamma);
+				phi   = stage->switching_phi;
+				gamma = stage->switching_gamma;
+			}
+		}
+
+		if (input == input_term)
+		{
+			_sim_power_stage_input_term(gamma, stage->u, input_term);
+		}
+
+		/* Column by column, so that the rows accumulate independently.
+		 * Sizes are the maximum ones, which the compiler unrolls: padding
+		 * rows and columns are 0. */
+		double next[SIM_POWER_STAGE_MAX_STATES];
+		for (size_t row = 0 ; row < SIM_POWER_STAGE_MAX_STATES ; row++)
+		{
+			next[row] = input[row];
+		}
+		for (size_t column = 0 ; column < SIM_POWER_STAGE_MAX_STATES ; column++)
+		{
+			const double x = stage->x[column];
+			for (size_t row = 0 ; row < SIM_POWER_STAGE_MAX_STATES ; row++)
+			{
+				next[row] += phi[row * SIM_POWER_STAGE_MAX_STATES + column] * x;
+			}
+		}
+
+		/* States decaying towards 0 would otherwise end up as subnormal
+		 * numbers, which are many times slower to compute with */
+		for (size_t row = 0 ; row < SIM_POWER_STAGE_MAX_STATES ; row++)
+		{
+			stage->x[row] = (fabs(next[row]) < SIM_POWER_STAGE_FLUSH_LIMIT) ?
+							0.0 : next[row];
+		}
+
+		stage->time_ns    += stage->step_ns;
+		stage->pending_ns -= stage->step_ns;
+	}
+}
+
+bool sim_power_stage_sample(const sim_power_stage_sensor_t* sensors,
+							size_t sensors_count,
+							const double* quantities,
+							uint8_t adc_number,
+							uint8_t channel,
+							float* value)
+{
+	for (size_t i = 0 ; i < sensors_count ; i++)
+	{
+		const sim_power_stage_sensor_t* sensor = &sensors[i];
+
+		if ( (sensor->adc_number != adc_number) || (sensor->channel != channel) )
+			continue;
+
+		float gain;
+		float offset;
+		memcpy(&gain, &sensor->gain_bits, sizeof(float));
+		memcpy(&offset, &sensor->offset_bits, sizeof(float));
+
+		if (gain == 0)
+			return false;
+
+		*value = ((float)quantities[sensor->quantity] - offset) / gain;
+
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  PRIVATE HEADER - Fixed-step state-space engine shared by the
+ *         power stage models.
+ *
+ *         A power stage is a linear circuit for each combination of the
+ *         switch states of its legs: dx/dt = A(s) x + B(s) u. The model is
+ *         discretised once, at initialization, for each combination
+ *         (exact zero-order hold), so that a step only costs a matrix
+ *         product. Steps are a fraction of the switching period.
+ *         - the switched model uses the matrices of the combination given
+ *           by a centered carrier at each step. In the steps where a
+ *           switch commutes,
+ *           the combinations are weighted by the time each one lasts, so
+ *           that duty cycles are not rounded to the step.
+ *         - the averaged model weights the combinations by the time each
+ *           one lasts in a period. Weighted matrices are only computed
+ *           again when a duty cycle changes. The error of the weighting
+ *           is second order in the step.
+ */
+
+#ifndef SIM_POWER_STAGE_H_
+#define SIM_POWER_STAGE_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Simulator */
+#include "sim/sim_power_models.h"
+
+
+#define SIM_POWER_STAGE_MAX_STATES 6
+#define SIM_POWER_STAGE_MAX_INPUTS 4
+#define SIM_POWER_STAGE_MAX_LEGS   3
+#define SIM_POWER_STAGE_MAX_COMBINATIONS (1U << SIM_POWER_STAGE_MAX_LEGS)
+
+
+/**
+ * @brief Fills the continuous-time matrices of a combination of switch
+ *        states, bit n being set when leg n+1 is on (high side switch
+ *        closed). Matrices are row-major and zeroed beforehand.
+ */
+typedef void (*sim_power_stage_matrices_t)(void* context,
+										   uint8_t switches,
+										   double* a,
+										   double* b);
+
+/**
+ * @brief Updates the inputs before a step, for inputs that vary in time.
+ */
+typedef void (*sim_power_stage_inputs_t)(void* context,
+										 uint64_t time_ns,
+										 double* u);
+
+typedef struct
+{
+	/* Topology */
+	uint8_t  states_count;
+	uint8_t  inputs_count;
+	uint8_t  legs_count;
+	sim_power_stage_inputs_t update_inputs;
+	void*    context;
+
+	/* Discretisation, matrices are row-major with the maximum sizes and
+	 * padded with 0 */
+	sim_power_model_type_t type;
+	uint64_t period_ns;
+	uint64_t step_ns;
+	double   phi[SIM_POWER_STAGE_MAX_COMBINATIONS]
+				[SIM_POWER_STAGE_MAX_STATES * SIM_POWER_STAGE_MAX_STATES];
+	double   gamma[SIM_POWER_STAGE_MAX_COMBINATIONS]
+				  [SIM_POWER_STAGE_MAX_STATES * SIM_POWER_STAGE_MAX_INPUTS];
+
+	/* Averaged model matrices for the current duty cycles, and term of the
+	 * inputs when they are constant */
+	double   averaged_phi[SIM_POWER_STAGE_MAX_STATES * SIM_POWER_STAGE_MAX_STATES];
+	double   averaged_gamma[SIM_POWER_STAGE_MAX_STATES * SIM_POWER_STAGE_MAX_INPUTS];
+	double   averaged_input[SIM_POWER_STAGE_MAX_STATES];
+	bool     averaged_valid;
+
+	/* Switched model matrices for a step in which a switch commutes */
+	double   switching_phi[SIM_POWER_STAGE_MAX_STATES * SIM_POWER_STAGE_MAX_STATES];
+	double   switching_gamma[SIM_POWER_STAGE_MAX_STATES * SIM_POWER_STAGE_MAX_INPUTS];
+
+	/* State */
+	double   duty_cycle[SIM_POWER_STAGE_MAX_LEGS];
+	double   x[SIM_POWER_STAGE_MAX_STATES];
+	double   u[SIM_POWER_STAGE_MAX_INPUTS];  /* Constant without update_inputs */
+	uint64_t time_ns;
+	uint64_t pending_ns;
+
+	/* Share of the last step each leg was on */
+	double   leg_state[SIM_POWER_STAGE_MAX_LEGS];
+} sim_power_stage_t;
+
+/**
+ * @brief Measurement channel of a shield, as described in its devicetree:
+ *        the raw value is (quantity - offset) / gain.
+ */
+typedef struct
+{
+	uint8_t  quantity;     /* Index in the quantities of the model */
+	uint8_t  adc_number;
+	uint8_t  channel;
+	uint32_t gain_bits;    /* IEEE 754, as in the devicetree */
+	uint32_t offset_bits;
+} sim_power_stage_sensor_t;
+
+
+/**
+ * @brief Discretises the model for all switch combinations and sets its
+ *        state to 0.
+ *
+ * @return 0 if OK, -1 if the topology or the step are invalid.
+ */
+int8_t sim_power_stage_init(sim_power_stage_t* stage,
+							uint8_t states_count,
+							uint8_t inputs_count,
+							uint8_t legs_count,
+							sim_power_stage_matrices_t get_matrices,
+							sim_power_stage_inputs_t update_inputs,
+							void* context,
+							const sim_power_model_config_t* config);
+
+/**
+ * @brief Sets the duty cycle of a leg, clamped between 0 and 1.
+ *
+ * @param leg Leg number, starting at 1.
+ */
+void sim_power_stage_set_duty_cycle(sim_power_stage_t* stage,
+									uint8_t leg,
+									double duty_cycle);
+
+/**
+ * @brief Runs the steps that fit in the elapsed time. The remainder is
+ *        kept for the next call.
+ */
+void sim_power_stage_step(sim_power_stage_t* stage, uint64_t duration_ns);
+
+/**
+ * @brief Gives the raw ADC value of a quantity of the model, if a sensor
+ *        of the table measures it on this ADC channel.
+ *
+ * @return true if a sensor matches.
+ */
+bool sim_power_stage_sample(const sim_power_stage_sensor_t* sensors,
+							size_t sensors_count,
+							const double* quantities,
+							uint8_t adc_number,
+							uint8_t channel,
+							float* value);
+
+
+#endif /* SIM_POWER_STAGE_H_ */
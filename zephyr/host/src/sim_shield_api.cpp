@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ *
+ * @brief  Shield API object of the host build, limited to the parts of the
+ *         Shield API built on the host.
+ */
+
+
+/* Current class header */
+#include "ShieldAPI.h"
+
+
+ShieldAPI shield;
+
+PowerAPI ShieldAPI::power;
+
+#ifdef CONFIG_OWNTECH_SHIELD_THREE_PHASE
+ThreePhaseAPI ShieldAPI::threephase;
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Spin API object of the host build, limited to the parts of the
+ *         Spin API built on the host.
+ *
+ *         Current mode is not simulated: the DAC and comparator functions
+ *         called by the Power API keep the analog peripherals unconfigured.
+ */
+
+
+/* Current class header */
+#include "SpinAPI.h"
+
+
+SpinAPI spin;
+
+GpioHAL SpinAPI::gpio;
+DacHAL  SpinAPI::dac;
+CompHAL SpinAPI::comp;
+PwmHAL  SpinAPI::pwm;
+DataAPI SpinAPI::data;
+
+#ifdef CONFIG_OWNTECH_CAPTURE_API
+CaptureAPI SpinAPI::capture;
+#endif
+
+
+/* Current mode DAC and comparator */
+
+void DacHAL::currentModeInit(uint8_t dac_number, hrtim_tu_t tu_src)
+{
+	(void)dac_number;
+	(void)tu_src;
+}
+
+void DacHAL::slopeCompensation(uint8_t dac_number,
+							   float32_t peak_voltage,
+							   float32_t low_voltage)
+{
+	(void)dac_number;
+	(void)peak_voltage;
+	(void)low_voltage;
+}
+
+void CompHAL::initialize(uint8_t comparator_number)
+{
+	(void)comparator_number;
+}
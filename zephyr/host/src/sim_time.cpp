@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+
+/* Simulated registers */
+#include <stm32g4xx.h>
+
+/* Simulator */
+#include "sim/sim_plant.h"
+
+/* Current file header */
+#include "sim/sim_time.h"
+
+
+/**
+ *  Local variables
+ */
+
+static uint64_t current_time_ns = 0;
+
+/* 170MHz system clock */
+#define SIM_CYCLES_PER_US 170
+
+CoreDebug_Type sim_core_debug_registers;
+
+static DWT_Type dwt_registers;
+
+
+/* Public API */
+
+uint64_t sim_time_get_ns()
+{
+	return current_time_ns;
+}
+
+void sim_time_advance_ns(uint64_t duration_ns)
+{
+	current_time_ns += duration_ns;
+
+	sim_plant_step(duration_ns);
+}
+
+void sim_time_reset()
+{
+	current_time_ns = 0;
+}
+
+DWT_Type* sim_dwt_get()
+{
+	dwt_registers.CYCCNT = (uint32_t)(current_time_ns * SIM_CYCLES_PER_US / 1000);
+
+	return &dwt_registers;
+}
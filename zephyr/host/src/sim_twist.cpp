@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Twist plant model.
+ *
+ *         States:  iL1, iL2 (inductor currents), vL1, vL2 (low side
+ *                  capacitors), vH (high side capacitor).
+ *         Inputs:  high side source, low side 1 and 2 sources.
+ *
+ *         diLk/dt = (sk.vH - vLk - rL.iLk) / L
+ *         dvLk/dt = (iLk - GLk.vLk + GSLk.(VSLk - vLk)) / CL
+ *         dvH/dt  = (GSH.(VSH - vH) - GH.vH - s1.iL1 - s2.iL2) / CH
+ */
+
+
+/* Current module private header */
+#include "sim_power_stage.h"
+
+/* Current file header */
+#include "sim/sim_power_models.h"
+
+
+/**
+ *  Local variables and constants
+ */
+
+enum
+{
+	TWIST_I1_LOW,
+	TWIST_I2_LOW,
+	TWIST_V1_LOW,
+	TWIST_V2_LOW,
+	TWIST_V_HIGH,
+	TWIST_STATES_COUNT
+};
+
+enum
+{
+	TWIST_HIGH_SOURCE,
+	TWIST_LOW1_SOURCE,
+	TWIST_LOW2_SOURCE,
+	TWIST_INPUTS_COUNT
+};
+
+/* Measured quantities that are not states */
+#define TWIST_I_HIGH            TWIST_STATES_COUNT
+#define TWIST_QUANTITIES_COUNT (TWIST_STATES_COUNT + 1)
+
+#define TWIST_LEGS_COUNT 2
+
+/* Gains and offsets from boards/shields/twist/twist_v1_4_1.overlay */
+#define TWIST_V_LOW_GAIN    0x3d3851ec
+#define TWIST_V_LOW_OFFSET  0xc2b867f0
+#define TWIST_V_HIGH_GAIN   0x3cf57710
+#define TWIST_V_HIGH_OFFSET 0x00000000
+#define TWIST_I_GAIN        0x3ba3d70a
+#define TWIST_I_OFFSET      0xc1200000
+
+static const sim_power_stage_sensor_t twist_sensors[] =
+{
+	{ TWIST_V1_LOW, 1, 1, TWIST_V_LOW_GAIN,  TWIST_V_LOW_OFFSET  },
+	{ TWIST_V1_LOW, 2, 1, TWIST_V_LOW_GAIN,  TWIST_V_LOW_OFFSET  },
+	{ TWIST_V2_LOW, 1, 6, TWIST_V_LOW_GAIN,  TWIST_V_LOW_OFFSET  },
+	{ TWIST_V2_LOW, 2, 6, TWIST_V_LOW_GAIN,  TWIST_V_LOW_OFFSET  },
+	{ TWIST_V_HIGH, 1, 9, TWIST_V_HIGH_GAIN, TWIST_V_HIGH_OFFSET },
+	{ TWIST_V_HIGH, 2, 9, TWIST_V_HIGH_GAIN, TWIST_V_HIGH_OFFSET },
+	{ TWIST_I1_LOW, 1, 2, TWIST_I_GAIN,      TWIST_I_OFFSET      },
+	{ TWIST_I1_LOW, 2, 2, TWIST_I_GAIN,      TWIST_I_OFFSET      },
+	{ TWIST_I2_LOW, 1, 7, TWIST_I_GAIN,      TWIST_I_OFFSET      },
+	{ TWIST_I2_LOW, 2, 7, TWIST_I_GAIN,      TWIST_I_OFFSET      },
+	{ TWIST_I_HIGH, 1, 8, TWIST_I_GAIN,      TWIST_I_OFFSET      },
+	{ TWIST_I_HIGH, 2, 8, TWIST_I_GAIN,      TWIST_I_OFFSET      }
+};
+
+static sim_twist_parameters_t twist_parameters;
+static sim_power_stage_t      twist_stage;
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Conductance of a resistance, 0 for none.
+ */
+static double _sim_twist_conductance(float resistance)
+{
+	return (resistance > 0) ? (1.0 / resistance) : 0.0;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Continuous-time matrices of a combination of
+ *        switch states.
+ */
+static void _sim_twist_matrices(void* context,
+								uint8_t switches,
+								double* a,
+								double* b)
+{
+	const sim_twist_parameters_t* p = (const sim_twist_parameters_t*)context;
+
+	const size_t n = TWIST_STATES_COUNT;
+	const size_t m = TWIST_INPUTS_COUNT;
+
+	double high_source = _sim_twist_conductance(p->high_source_resistance);
+	double high_load   = _sim_twist_conductance(p->high_load_resistance);
+
+	a[TWIST_V_HIGH * n + TWIST_V_HIGH] = -(high_source + high_load)
+									   / p->high_capacitance;
+	b[TWIST_V_HIGH * m + TWIST_HIGH_SOURCE] = high_source / p->high_capacitance;
+
+	for (uint8_t leg = 0 ; leg < TWIST_LEGS_COUNT ; leg++)
+	{
+		size_t current = TWIST_I1_LOW + leg;
+		size_t voltage = TWIST_V1_LOW + leg;
+		double on      = (switches & (1U << leg)) ? 1.0 : 0.0;
+
+		double low_source = _sim_twist_conductance(p->low_source_resistance[leg]);
+		double low_load   = _sim_twist_conductance(p->low_load_resistance[leg]);
+
+		a[current * n + current]      = -p->inductor_resistance / p->inductance;
+		a[current * n + voltage]      = -1.0 / p->inductance;
+		a[current * n + TWIST_V_HIGH] = on / p->inductance;
+
+		a[voltage * n + current] = 1.0 / p->low_capacitance;
+		a[voltage * n + voltage] = -(low_source + low_load) / p->low_capacitance;
+		b[voltage * m + TWIST_LOW1_SOURCE + leg] = low_source / p->low_capacitance;
+
+		a[TWIST_V_HIGH * n + current] = -on / p->high_capacitance;
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Computes all the measured quantities.
+ */
+static void _sim_twist_quantities(double* quantities)
+{
+	for (uint8_t i = 0 ; i < TWIST_STATES_COUNT ; i++)
+	{
+		quantities[i] = twist_stage.x[i];
+	}
+
+	quantities[TWIST_I_HIGH] =
+		twist_stage.leg_state[0] * twist_stage.x[TWIST_I1_LOW] +
+		twist_stage.leg_state[1] * twist_stage.x[TWIST_I2_LOW];
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Plant step function.
+ */
+static void _sim_twist_step(void* context, uint64_t duration_ns)
+{
+	(void)context;
+
+	sim_power_stage_step(&twist_stage, duration_ns);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Plant sample function.
+ */
+static bool _sim_twist_sample(void* context,
+							  uint8_t adc_number,
+							  uint8_t channel,
+							  float* value)
+{
+	(void)context;
+
+	double quantities[TWIST_QUANTITIES_COUNT];
+	_sim_twist_quantities(quantities);
+
+	return sim_power_stage_sample(twist_sensors,
+								  sizeof(twist_sensors) / sizeof(twist_sensors[0]),
+								  quantities,
+								  adc_number,
+								  channel,
+								  value);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Plant duty cycle function.
+ */
+static void _sim_twist_set_duty_cycle(void* context, uint8_t leg, float duty_cycle)
+{
+	(void)context;
+
+	sim_power_stage_set_duty_cycle(&twist_stage, leg, duty_cycle);
+}
+
+static const sim_plant_t twist_plant =
+{
+	_sim_twist_step,
+	_sim_twist_sample,
+	_sim_twist_set_duty_cycle,
+	nullptr
+};
+
+
+/* Public API */
+
+void sim_twist_get_default_parameters(sim_twist_parameters_t* parameters)
+{
+	*parameters = {};
+
+	parameters->model.type                = sim_power_model_averaged;
+	parameters->model.switching_period_ns = 5000;
+	parameters->model.steps_per_period    = 1;
+
+	parameters->inductance          = 33e-6f;
+	parameters->inductor_resistance = 50e-3f;
+	parameters->low_capacitance     = 40e-6f;
+
+	parameters->high_capacitance       = 20e-6f;
+	parameters->high_source_voltage    = 48.0f;
+	parameters->high_source_resistance = 50e-3f;
+
+	parameters->low_load_resistance[0] = 10.0f;
+	parameters->low_load_resistance[1] = 10.0f;
+}
+
+const sim_plant_t* sim_twist_init(const sim_twist_parameters_t* parameters)
+{
+	if ( (parameters->inductance <= 0) ||
+		 (parameters->inductor_resistance < 0) ||
+		 (parameters->low_capacitance <= 0) ||
+		 (parameters->high_capacitance <= 0) )
+		return nullptr;
+
+	twist_parameters = *parameters;
+
+	int8_t result = sim_power_stage_init(&twist_stage,
+										 TWIST_STATES_COUNT,
+										 TWIST_INPUTS_COUNT,
+										 TWIST_LEGS_COUNT,
+										 _sim_twist_matrices,
+										 nullptr,
+										 &twist_parameters,
+										 &parameters->model);
+	if (result != 0)
+		return nullptr;
+
+	twist_stage.u[TWIST_HIGH_SOURCE] = parameters->high_source_voltage;
+	twist_stage.u[TWIST_LOW1_SOURCE] = parameters->low_source_voltage[0];
+	twist_stage.u[TWIST_LOW2_SOURCE] = parameters->low_source_voltage[1];
+
+	return &twist_plant;
+}
+
+void sim_twist_get_measures(sim_twist_measures_t* measures)
+{
+	double quantities[TWIST_QUANTITIES_COUNT];
+	_sim_twist_quantities(quantities);
+
+	measures->v1_low = (float)quantities[TWIST_V1_LOW];
+	measures->v2_low = (float)quantities[TWIST_V2_LOW];
+	measures->v_high = (float)quantities[TWIST_V_HIGH];
+	measures->i1_low = (float)quantities[TWIST_I1_LOW];
+	measures->i2_low = (float)quantities[TWIST_I2_LOW];
+	measures->i_high = (float)quantities[TWIST_I_HIGH];
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Event-driven background task woken by the critical task, on the
+ *         host build: the critical task only signals the task, and the
+ *         software interrupt gives its event once the critical task
+ *         returned.
+ *
+ *         Usage: background_signal
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <vector>
+
+/* OwnTech Power API */
+#include "TaskAPI.h"
+
+/* Simulator */
+#include "sim/sim_kernel.h"
+#include "sim/sim_time.h"
+
+
+#define PERIOD_US        100
+#define PERIOD_NS        (PERIOD_US * 1000)
+#define SIGNAL_EVERY     4
+#define PERIODS          40
+
+static K_SEM_DEFINE(event, 0, 1);
+
+static int8_t event_task = -1;
+static int8_t other_task = -1;
+
+static uint32_t critical_runs = 0;
+static std::vector<uint64_t> signals;
+static std::vector<uint64_t> wakes;
+static bool signal_results = true;
+static uint32_t failures = 0;
+
+static void critical_task()
+{
+	critical_runs++;
+
+	if (critical_runs % SIGNAL_EVERY == 0)
+	{
+		signals.push_back(sim_time_get_ns());
+
+		/* Several signals in the same run wake the task once */
+		signal_results &= (task.signalBackground(event_task) == 0);
+		signal_results &= (task.signalBackground(event_task) == 0);
+	}
+}
+
+static void background_task()
+{
+	wakes.push_back(sim_time_get_ns());
+}
+
+static void other_background_task()
+{
+	task.suspendBackgroundMs(100);
+}
+
+static void check(bool condition, const char* name)
+{
+	printf("%-52s %s\n", name, condition ? "ok" : "FAILED");
+
+	if (condition == false)
+	{
+		failures++;
+	}
+}
+
+
+int main()
+{
+	/* Signal line already used by another driver */
+	irq_enable(CONFIG_OWNTECH_TASK_SIGNAL_IRQ);
+	bool refused = (task.createBackgroundOnEvent(background_task, &event) < 0);
+	irq_disable(CONFIG_OWNTECH_TASK_SIGNAL_IRQ);
+
+	event_task = task.createBackgroundOnEvent(background_task, &event);
+	other_task = task.createBackground(other_background_task);
+
+	if ( (event_task < 0) || (other_task < 0) ||
+		 (task.createCritical(critical_task, PERIOD_US) != 0) )
+	{
+		fprintf(stderr, "Cannot create the tasks\n");
+		return 1;
+	}
+
+	check(refused == true, "event task refused on an enabled signal line");
+	check(task.signalBackground(other_task) == -1,
+		  "only event-driven tasks can be signaled");
+
+	task.startBackground(event_task);
+	task.startCritical(false);
+
+	sim_kernel_run_for(PERIODS * PERIOD_NS);
+
+	check(signal_results == true, "signals accepted from the critical task");
+	check( (signals.size() == PERIODS / SIGNAL_EVERY) &&
+		   (wakes.size() == signals.size()),
+		   "one wake per critical task run signaling");
+	check(wakes == signals, "task woken in the period of the signal");
+
+	printf("%u checks failed\n", failures);
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ *
+ * @brief  Unit test of the software implementation of the CORDIC driver
+ *         and of the Clarke and Park transforms, on the host build.
+ *
+ *         Usage: cordic_transforms
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <math.h>
+
+/* CORDIC driver */
+#include "cordic.h"
+#include "cordic_transforms.h"
+
+
+/* Absolute error of the coprocessor with the default precision */
+#define CORDIC_TOLERANCE 1.9e-6f
+
+static uint32_t failures = 0;
+
+static void check(bool condition, const char* name)
+{
+	printf("%-52s %s\n", name, condition ? "ok" : "FAILED");
+
+	if (condition == false)
+	{
+		failures++;
+	}
+}
+
+static bool near(float value, float expected, float tolerance)
+{
+	return fabsf(value - expected) <= tolerance;
+}
+
+
+int main()
+{
+	const float pi = 3.14159265f;
+
+	/* Sine and cosine, with the wrapping of the angle */
+	float worst = 0;
+	for (int32_t i = -4000 ; i <= 4000 ; i++)
+	{
+		float theta = (float)i * (4.0f * pi / 4000.0f);
+		float s;
+		float c;
+
+		cordic_sin_cos(theta, &s, &c);
+		worst = fmaxf(worst, fabsf(s - sinf(theta)));
+		worst = fmaxf(worst, fabsf(c - cosf(theta)));
+	}
+	check(worst < CORDIC_TOLERANCE, "sin/cos within the coprocessor error, wrapped");
+
+	check( (cordic_angle_to_q31(-pi) == INT32_MIN) &&
+		   (cordic_angle_to_q31(0.0f) == 0) &&
+		   (cordic_angle_to_q31(0.5f * pi) == (1 << 30)),
+		   "angle to q1.31");
+
+	/* Polar coordinates */
+	float angle;
+	float magnitude;
+
+	cordic_polar(3.0f, 4.0f, &angle, &magnitude);
+	check( near(magnitude, 5.0f, 1e-5f) && near(angle, atan2f(4.0f, 3.0f), 1e-6f),
+		   "polar of (3, 4)");
+
+	cordic_polar(0.0f, 0.0f, &angle, &magnitude);
+	check( (angle == 0.0f) && (magnitude == 0.0f), "polar of the null vector");
+
+	check( near(cordic_atan2(-1.0f, -1.0f), -0.75f * pi, 1e-6f) &&
+		   (cordic_atan2(0.0f, 0.0f) == 0.0f),
+		   "atan2");
+	check( near(cordic_magnitude(1e-3f, -1e-3f), 1.41421356e-3f, 1e-9f) &&
+		   near(cordic_magnitude(3e4f, 4e4f), 5e4f, 1e-2f),
+		   "magnitude over several decades");
+	check(near(cordic_sqrt(2.0f), 1.41421356f, 1e-6f), "sqrt");
+
+	/* Batch, interleaved cosine and sine */
+	cordic_angle_q31_t angles[64];
+	int32_t results[128];
+	bool batch_ok = true;
+
+	for (uint16_t i = 0 ; i < 64 ; i++)
+	{
+		angles[i] = cordic_angle_to_q31((float)i * (2.0f * pi / 64.0f) - pi);
+	}
+
+	check(cordic_sin_cos_batch_start(angles, results, 64) == 0, "batch started");
+	cordic_batch_wait();
+	check(cordic_batch_is_done(), "batch done");
+
+	for (uint16_t i = 0 ; i < 64 ; i++)
+	{
+		float theta = (float)i * (2.0f * pi / 64.0f) - pi;
+		batch_ok &= near(cordic_q31_to_float(results[2 * i]), cosf(theta), CORDIC_TOLERANCE);
+		batch_ok &= near(cordic_q31_to_float(results[2 * i + 1]), sinf(theta), CORDIC_TOLERANCE);
+	}
+	check(batch_ok, "batch results");
+	check( (cordic_sin_cos_batch_start(nullptr, results, 1) == -1) &&
+		   (cordic_sin_cos_batch_start(angles, results, 0) == -1),
+		   "batch parameters checked");
+
+	/* Transforms of a balanced three-phase system rotating at theta */
+	bool clarke_ok = true;
+	bool park_ok = true;
+	bool round_trip_ok = true;
+
+	for (int32_t i = 0 ; i < 360 ; i++)
+	{
+		const float amplitude = 10.0f;
+		const float shift = 0.3f;
+		float theta = (float)i * (pi / 180.0f);
+
+		float a = amplitude * cosf(theta + shift);
+		float b = amplitude * cosf(theta + shift - 2.0f * pi / 3.0f);
+		float c = amplitude * cosf(theta + shift + 2.0f * pi / 3.0f);
+
+		/* Amplitude invariant */
+		float alpha;
+		float beta;
+		cordic_clarke(a, b, c, &alpha, &beta);
+		clarke_ok &= near(alpha, amplitude * cosf(theta + shift), 1e-4f) &&
+					 near(beta, amplitude * sinf(theta + shift), 1e-4f);
+
+		float alpha2;
+		float beta2;
+		cordic_clarke_balanced(a, b, &alpha2, &beta2);
+		clarke_ok &= near(alpha2, alpha, 1e-4f) && near(beta2, beta, 1e-4f);
+
+		/* Constant in the rotating frame */
+		float d;
+		float q;
+		cordic_abc_to_dq(a, b, c, theta, &d, &q);
+		park_ok &= near(d, amplitude * cosf(shift), 1e-4f) &&
+				   near(q, amplitude * sinf(shift), 1e-4f);
+
+		float a2;
+		float b2;
+		float c2;
+		cordic_dq_to_abc(d, q, theta, &a2, &b2, &c2);
+		round_trip_ok &= near(a2, a, 1e-4f) && near(b2, b, 1e-4f) &&
+						 near(c2, c, 1e-4f);
+	}
+
+	check(clarke_ok, "Clarke of a balanced system");
+	check(park_ok, "Park of a balanced system is constant");
+	check(round_trip_ok, "abc to dq to abc");
+
+	printf("%u checks failed\n", failures);
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Overrun policies of the critical task, on the host build.
+ *
+ *         The critical task is given a simulated execution time, longer
+ *         than its period on one run, and the start times of the user code
+ *         are checked against each policy: late run, dropped event,
+ *         degraded rate until cleared, and stop.
+ *
+ *         Usage: critical_overrun
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <vector>
+
+/* OwnTech Power API */
+#include "TaskAPI.h"
+
+/* Simulator */
+#include "sim/sim_kernel.h"
+#include "sim/sim_task.h"
+#include "sim/sim_time.h"
+
+
+#define PERIOD_US        100
+#define PERIOD_NS        (PERIOD_US * 1000)
+#define EXECUTION_NS     20000
+#define OVERRUN_RUN      5
+
+static std::vector<uint64_t> runs;
+static uint64_t overrun_ns = 0;
+static uint32_t failures = 0;
+
+static void critical_task()
+{
+	runs.push_back(sim_time_get_ns());
+
+	if (runs.size() == OVERRUN_RUN + 1)
+	{
+		sim_task_consume_ns(overrun_ns);
+	}
+	else
+	{
+		sim_task_consume_ns(EXECUTION_NS);
+	}
+}
+
+static void check(bool condition, const char* name)
+{
+	printf("%-52s %s\n", name, condition ? "ok" : "FAILED");
+
+	if (condition == false)
+	{
+		failures++;
+	}
+}
+
+/**
+ * Runs the task for a number of periods, overrunning on run OVERRUN_RUN.
+ */
+static void run(overrun_policy_t policy, uint64_t overrun_duration_ns,
+				uint32_t periods)
+{
+	task.stopCritical();
+
+	runs.clear();
+	overrun_ns = overrun_duration_ns;
+
+	task.setCriticalOverrunPolicy(policy);
+	task.startCritical(false);
+
+	sim_kernel_run_for((uint64_t)periods * PERIOD_NS);
+}
+
+/**
+ * Time between the start of two runs of the user code.
+ */
+static uint64_t interval(uint32_t run)
+{
+	if (run + 1 >= runs.size())
+		return 0;
+
+	return runs[run + 1] - runs[run];
+}
+
+
+int main()
+{
+	if (task.createCritical(critical_task, PERIOD_US) != 0)
+	{
+		fprintf(stderr, "Cannot create the critical task\n");
+		return 1;
+	}
+
+	/* No overrun */
+	run(overrun_log, EXECUTION_NS, 20);
+	check( (runs.size() == 20) && (task.getCriticalOverrunCount() == 0),
+		   "no overrun, one run per period");
+
+	/* Log: the pending event runs the task late, then on the periods */
+	run(overrun_log, 150000, 20);
+	check(task.getCriticalOverrunCount() == 1, "log: overrun counted");
+	check(interval(OVERRUN_RUN) == 150000, "log: next run at the end of the overrun");
+	check(interval(OVERRUN_RUN + 1) == 50000, "log: following run on the period");
+	check(task.isCriticalDegraded() == false, "log: not degraded");
+
+	/* Log over several periods: missed periods run the task once */
+	run(overrun_log, 250000, 20);
+	check( (interval(OVERRUN_RUN) == 250000) &&
+		   (interval(OVERRUN_RUN + 1) == 50000),
+		   "log: a single late run after several periods");
+
+	/* Skip: the pending event is dropped */
+	run(overrun_skip, 150000, 20);
+	check(task.getCriticalOverrunCount() == 1, "skip: overrun counted");
+	check(interval(OVERRUN_RUN) == 2 * PERIOD_NS, "skip: pending period dropped");
+	check(interval(OVERRUN_RUN + 1) == PERIOD_NS, "skip: nominal rate after");
+	check(runs.size() == 19, "skip: one run less");
+
+	/* Degrade: the user code runs once every divider periods */
+	run(overrun_degrade, 150000, 20);
+	check(task.isCriticalDegraded() == true, "degrade: degraded");
+
+	/* The pending period is dropped, then the divider applies */
+	bool divided = (interval(OVERRUN_RUN) ==
+					(CONFIG_OWNTECH_TASK_DEGRADED_DIVIDER + 1) * PERIOD_NS);
+	for (uint32_t i = OVERRUN_RUN + 1 ; i + 1 < runs.size() ; i++)
+	{
+		divided &= (interval(i) ==
+					CONFIG_OWNTECH_TASK_DEGRADED_DIVIDER * PERIOD_NS);
+	}
+	check(divided, "degrade: user code run at the divided rate");
+
+	task.clearCriticalOverrun();
+	check( (task.isCriticalDegraded() == false) &&
+		   (task.getCriticalOverrunCount() == 0),
+		   "degrade: read as cleared before the next run");
+
+	size_t degraded_runs = runs.size();
+	sim_kernel_run_for(10 * PERIOD_NS);
+	check( (task.isCriticalDegraded() == false) &&
+		   (interval(degraded_runs) == PERIOD_NS) &&
+		   (interval(runs.size() - 2) == PERIOD_NS),
+		   "degrade: nominal rate once cleared");
+
+	/* Safety: the task is stopped */
+	run(overrun_safety, 150000, 20);
+	check( (task.getCriticalOverrunCount() == 1) &&
+		   (runs.size() == OVERRUN_RUN + 1),
+		   "safety: task stopped");
+
+	printf("%u checks failed\n", failures);
+
+	return (failures == 0) ? 0 : 1;
+}
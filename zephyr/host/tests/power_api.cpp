@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ *
+ * @brief  Power API of the Twist on the host build: the duty cycles
+ *         written through the Power API reach the plant through the
+ *         simulated HRTIM, the legs start and stop their drivers, and the
+ *         ADC decimation of a leg sets the number of conversions, and the
+ *         tracking ADC trigger stays between the switching edges, with
+ *         the tick level or the averaged HRTIM model.
+ *
+ *         Usage: power_api [averaged]
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+/* OwnTech Power API */
+#include "ShieldAPI.h"
+#include "SpinAPI.h"
+#include "hrtim.h"
+
+/* Simulator */
+#include "sim/sim_adc.h"
+#include "sim/sim_hrtim.h"
+#include "sim/sim_kernel.h"
+#include "sim/sim_plant.h"
+
+
+/* 200kHz, the default frequency of the Twist devicetree */
+#define PERIOD_NS 5000
+
+/* Twist v1.4.1 leg 1: driver and V1_LOW pins */
+#define LEG1_DRIVER_PIN 19
+#define V1_LOW_PIN      29
+
+/* Dead time of the Twist devicetree, on the rising edge of output 1 */
+#define DEAD_TIME_NS 100
+
+static uint32_t failures = 0;
+
+static void check(bool condition, const char* name)
+{
+	printf("%-52s %s\n", name, condition ? "ok" : "FAILED");
+
+	if (condition == false)
+	{
+		failures++;
+	}
+}
+
+
+/**
+ *  Plant receiving the duty cycle of leg 1
+ */
+
+static float leg1_duty_cycle = -1;
+
+static void plant_set_duty_cycle(void* context, uint8_t leg, float duty_cycle)
+{
+	(void)context;
+
+	if (leg == 1)
+	{
+		leg1_duty_cycle = duty_cycle;
+	}
+}
+
+static const sim_plant_t plant = { nullptr, nullptr, plant_set_duty_cycle, nullptr };
+
+/**
+ *  Burst controller hook
+ */
+
+static uint32_t burst_entries = 0;
+static uint32_t burst_exits   = 0;
+
+static void burst_callback(bool active)
+{
+	if (active == true)
+	{
+		burst_entries++;
+	}
+	else
+	{
+		burst_exits++;
+	}
+}
+
+/**
+ * Returns true if the duty cycle of leg 1, dead time excluded, is the
+ * expected one.
+ */
+static bool leg1_duty_cycle_is(float expected)
+{
+	float measured = leg1_duty_cycle + (float)DEAD_TIME_NS / PERIOD_NS;
+
+	return fabsf(measured - expected) < 1e-3f;
+}
+
+/**
+ * Returns the number of ADC 1 conversions over a number of periods.
+ */
+static uint64_t adc1_conversions(uint32_t periods)
+{
+	uint64_t start = sim_adc_get_conversions_count(1);
+
+	sim_kernel_run_for((uint64_t)periods * PERIOD_NS);
+
+	return sim_adc_get_conversions_count(1) - start;
+}
+
+/**
+ * Returns a compare value of leg 1: CMP1 for the duty cycle, CMP3 for the
+ * ADC trigger.
+ */
+static int32_t compare_value(hrtim_burst_dma_reg_t compare)
+{
+	return hrtim_burst_dma_reg_get(TIMA, compare);
+}
+
+
+int main(int argc, char** argv)
+{
+	if ( (argc > 1) && (strcmp(argv[1], "averaged") == 0) )
+	{
+		sim_hrtim_set_averaged(true);
+	}
+
+	sim_plant_set(&plant);
+
+	shield.power.initBuck(LEG1);
+
+	/* 170MHz x 16 for a 50kHz minimum frequency, halved in up-down mode */
+	check(shield.power.getPeriod(LEG1) == 170 * 16 * 1000 / 200 / 2,
+		  "leg 1 up-down period from the devicetree");
+	check(sim_hrtim_is_triggering_adcs() == true,
+		  "leg 1 triggers its ADC");
+
+	spin.data.enableAcquisition(V1_LOW_PIN);
+	spin.data.start();
+
+	sim_hrtim_connect_leg(1, PWMA);
+
+	shield.power.setDutyCycle(LEG1, 0.5f);
+	shield.power.start(LEG1);
+	check(spin.gpio.readPin(LEG1_DRIVER_PIN) == 1, "driver enabled on start");
+
+	sim_kernel_run_for(10 * PERIOD_NS);
+	check(leg1_duty_cycle_is(0.5f), "plant leg 1 at 50%");
+
+	shield.power.setDutyCycle(LEG1, 0.3f);
+	sim_kernel_run_for(3 * PERIOD_NS);
+	check(leg1_duty_cycle_is(0.3f), "plant leg 1 at 30% from the next period");
+
+	/* One conversion per period, then one every four periods */
+	check(adc1_conversions(100) == 100, "one ADC 1 conversion per period");
+
+	shield.power.setAdcDecim(LEG1, 4);
+	adc1_conversions(4);
+	check(adc1_conversions(100) == 25, "one ADC 1 conversion every 4 periods");
+
+	/* Center aligned: the on-time is centred on the valley, below CMP1, and
+	 * the off-time on the crest, above it */
+	uint16_t period = shield.power.getPeriod(LEG1);
+
+	shield.power.setTriggerTracking(LEG1, ADC_TRIG_MID_ON, 0.05f);
+	shield.power.setDutyCycle(LEG1, 0.3f);
+	check(abs(compare_value(BDMA_CMP3) - period / 20) <= 1,
+		  "ADC trigger offset from the valley");
+
+	shield.power.setTriggerTracking(LEG1, ADC_TRIG_MID_ON, 0.2f);
+	shield.power.setDutyCycle(LEG1, 0.1f);
+	check(compare_value(BDMA_CMP3) < compare_value(BDMA_CMP1),
+		  "ADC trigger kept within a short on-time");
+
+	shield.power.setTriggerTracking(LEG1, ADC_TRIG_MID_OFF, 0.2f);
+	shield.power.setDutyCycle(LEG1, 0.9f);
+	check(compare_value(BDMA_CMP3) > compare_value(BDMA_CMP1),
+		  "ADC trigger kept within a short off-time");
+
+	shield.power.setTriggerTracking(LEG1, ADC_TRIG_FIXED);
+
+	/* Burst controller between 1A and 2A, hook called on transitions */
+	shield.power.setBurstCallback(burst_callback);
+	shield.power.initBurstController(1.0f, 2.0f);
+
+	bool burst = shield.power.updateBurstController(1.5f);
+	check( (burst == false) && (burst_entries == 0),
+		  "burst mode not entered above the enter current");
+
+	burst = shield.power.updateBurstController(0.5f);
+	burst = shield.power.updateBurstController(1.5f) && burst;
+	check( (burst == true) && (burst_entries == 1) && (burst_exits == 0),
+		  "burst hook called once on entry");
+	check(shield.power.isBurstActive() == true,
+		  "burst mode kept below the exit current");
+
+	burst = shield.power.updateBurstController(2.5f);
+	check( (burst == false) && (burst_exits == 1),
+		  "burst hook called once on exit");
+
+	shield.power.updateBurstController(0.5f);
+	shield.power.deInitBurstController();
+	check( (burst_entries == 2) && (burst_exits == 2) &&
+		   (shield.power.isBurstActive() == false),
+		  "burst hook called when disabled in burst mode");
+
+	shield.power.setBurstCallback(nullptr);
+
+	shield.power.stop(LEG1);
+	check(spin.gpio.readPin(LEG1_DRIVER_PIN) == 0, "driver disabled on stop");
+
+	sim_kernel_run_for(3 * PERIOD_NS);
+	check(leg1_duty_cycle == 0.0f, "plant leg 1 off once stopped");
+
+	printf("%u checks failed\n", failures);
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ *
+ * @brief  Stress test of Shared<T>, on the host build.
+ *
+ *         A writer thread publishes values as fast as it can while a
+ *         reader thread reads them. Each value is made of fields derived
+ *         from its number, so that a torn read is detected. Fails if a
+ *         torn value is read, or if values are read out of order.
+ *
+ *         Usage: shared_stress [values]
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <thread>
+
+/* Task API */
+#include "Shared.h"
+
+
+/* Larger than a register, copied in several accesses */
+typedef struct
+{
+	uint64_t number;
+	uint64_t inverted;
+	uint64_t square;
+	float    voltage;
+	float    current;
+} value_t;
+
+static Shared<value_t> shared;
+
+
+static value_t make_value(uint64_t number)
+{
+	value_t value = { number,
+					  ~number,
+					  number * number,
+					  (float)(number & 0xFFFF),
+					  -(float)(number & 0xFFFF) };
+	return value;
+}
+
+static bool value_is_valid(const value_t& value)
+{
+	value_t expected = make_value(value.number);
+
+	return (value.inverted == expected.inverted) &&
+		   (value.square == expected.square) &&
+		   (value.voltage == expected.voltage) &&
+		   (value.current == expected.current);
+}
+
+
+int main(int argc, char** argv)
+{
+	uint64_t count = 5000000;
+	if (argc > 1)
+	{
+		count = strtoull(argv[1], nullptr, 0);
+	}
+
+	shared.write(make_value(0));
+
+	std::atomic<bool> done(false);
+
+	std::thread writer([&]()
+	{
+		for (uint64_t i = 1 ; i <= count ; i++)
+		{
+			shared.write(make_value(i));
+
+			/* Interleaves the threads on a single core too */
+			if (i % 256 == 0)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		done.store(true);
+	});
+
+	uint64_t reads = 0;
+	uint64_t changes = 0;
+	uint64_t errors = 0;
+	uint64_t previous = 0;
+	uint32_t previous_version = shared.version();
+
+	while ( (done.load() == false) || (previous != count) )
+	{
+		value_t value = shared.read();
+		uint32_t version = shared.version();
+
+		reads++;
+
+		if (reads % 256 == 0)
+		{
+			std::this_thread::yield();
+		}
+
+		if (value_is_valid(value) == false)
+		{
+			if (errors < 10)
+			{
+				fprintf(stderr, "Torn value read after %llu\n",
+						(unsigned long long)previous);
+			}
+			errors++;
+		}
+		else if (value.number < previous)
+		{
+			if (errors < 10)
+			{
+				fprintf(stderr, "Value %llu read after %llu\n",
+						(unsigned long long)value.number,
+						(unsigned long long)previous);
+			}
+			errors++;
+		}
+		else
+		{
+			changes += (value.number != previous) ? 1 : 0;
+			previous = value.number;
+		}
+
+		if ((int32_t)(version - previous_version) < 0)
+		{
+			errors++;
+		}
+		previous_version = version;
+	}
+
+	writer.join();
+
+	printf("%llu values written, %llu reads, %llu changes seen, %llu errors\n",
+		   (unsigned long long)count,
+		   (unsigned long long)reads,
+		   (unsigned long long)changes,
+		   (unsigned long long)errors);
+
+	return (errors == 0) ? 0 : 1;
+}
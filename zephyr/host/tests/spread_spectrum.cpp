@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ *
+ * @brief  Spread-spectrum mode of the Power API on the host build: the
+ *         burst DMA of the simulated HRTIM streams the dithering table,
+ *         which lowers the peak of the switching frequency in the spectrum
+ *         of the leg 1 output, and keeps the duty cycle, including after
+ *         a duty cycle update swapping the tables, from a thread or from
+ *         the critical task.
+ *
+ *         The spectrum is the Fourier transform of the TA1 output over a
+ *         window, computed exactly from its edges. The duty cycle of each
+ *         switching period is the one the simulated HRTIM passes to the
+ *         plant leg.
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <math.h>
+#include <complex>
+#include <vector>
+
+/* OwnTech Power API */
+#include "ShieldAPI.h"
+#include "SpinAPI.h"
+#include "TaskAPI.h"
+
+/* Simulator */
+#include "sim/sim_hrtim.h"
+#include "sim/sim_kernel.h"
+#include "sim/sim_plant.h"
+
+
+/* 200kHz, the default frequency of the Twist devicetree */
+#define PERIOD_NS    5000
+#define FREQUENCY_HZ 200000.0
+
+/* Measurement window, many profile periods long */
+#define WINDOW_NS 2000000
+
+/* Critical task at 20kHz: a dithering step every 10 switching periods */
+#define TASK_REPETITION 10
+#define TASK_PERIOD_US  50
+
+/* Total frequency excursion and profile frequency */
+#define SPREAD            0.2F
+#define PROFILE_FREQUENCY 1000
+
+/* Output TA1 */
+#define OUTPUT_TA1 0
+
+/* Dead time of the Twist devicetree, on the rising edge of output 1, and
+ * change of its share of the period over the spread */
+#define DEAD_TIME_NS 100
+#define DEAD_TIME_SHARE_CHANGE ((double)DEAD_TIME_NS / PERIOD_NS * SPREAD)
+
+static uint32_t failures = 0;
+
+static void check(bool condition, const char* name)
+{
+	printf("%-52s %s\n", name, condition ? "ok" : "FAILED");
+
+	if (condition == false)
+	{
+		failures++;
+	}
+}
+
+
+/**
+ *  TA1 output over a window
+ */
+
+static std::vector<uint64_t> edge_ticks;
+static std::vector<bool>     edge_levels;
+
+static void record_edge(const sim_hrtim_edge_t* edge, void* arg)
+{
+	(void)arg;
+
+	if (edge->output == OUTPUT_TA1)
+	{
+		edge_ticks.push_back(edge->tick);
+		edge_levels.push_back(edge->level);
+	}
+}
+
+/**
+ *  Plant receiving the duty cycle of each period of leg 1
+ */
+
+static float duty_cycle_min;
+static float duty_cycle_max;
+
+static void plant_set_duty_cycle(void* context, uint8_t leg, float duty_cycle)
+{
+	(void)context;
+
+	if (leg == 1)
+	{
+		duty_cycle_min = fminf(duty_cycle_min, duty_cycle);
+		duty_cycle_max = fmaxf(duty_cycle_max, duty_cycle);
+	}
+}
+
+static const sim_plant_t plant = { nullptr, nullptr, plant_set_duty_cycle, nullptr };
+
+/**
+ *  Critical task applying a duty cycle on each run
+ */
+
+static float critical_duty_cycle;
+
+static void control_task()
+{
+	shield.power.setDutyCycle(LEG1, critical_duty_cycle);
+}
+
+typedef struct
+{
+	double peak;       /* Largest spectrum magnitude around the frequency */
+	double duty_cycle; /* Mean over the window */
+	double duty_error; /* Largest difference between two periods */
+	double period_min; /* Switching periods, in ticks */
+	double period_max;
+} measure_t;
+
+/**
+ * Records the output over the window, and measures its spectrum around the
+ * switching frequency, its duty cycle and its switching periods, from the
+ * first rising edge to the last one.
+ */
+static measure_t measure()
+{
+	edge_ticks.clear();
+	edge_levels.clear();
+	duty_cycle_min = INFINITY;
+	duty_cycle_max = -INFINITY;
+
+	sim_kernel_run_for(WINDOW_NS);
+
+	std::vector<uint64_t> rising;
+	std::vector<uint64_t> falling;
+
+	for (size_t i = 0 ; i < edge_ticks.size() ; i++)
+	{
+		if (edge_levels[i] == true)
+		{
+			rising.push_back(edge_ticks[i]);
+		}
+		else if (rising.empty() == false)
+		{
+			falling.push_back(edge_ticks[i]);
+		}
+	}
+
+	/* Whole periods: a high interval and the low interval after it */
+	size_t periods = rising.size() - 1;
+
+	measure_t result = {};
+	result.period_min = INFINITY;
+
+	double high   = 0;
+	double origin = (double)rising[0];
+	double window = (double)(rising[periods] - rising[0]);
+
+	for (size_t i = 0 ; i < periods ; i++)
+	{
+		double period = (double)(rising[i + 1] - rising[i]);
+
+		high += (double)(falling[i] - rising[i]);
+		result.period_min = fmin(result.period_min, period);
+		result.period_max = fmax(result.period_max, period);
+	}
+
+	result.duty_cycle = high / window;
+	result.duty_error = duty_cycle_max - duty_cycle_min;
+
+	/* Spectrum every half bin from -30% to +30% of the frequency */
+	double window_s = window / SIM_HRTIM_TICKS_PER_SECOND;
+	double step_hz  = 0.5 / window_s;
+
+	for (double f = 0.7 * FREQUENCY_HZ ; f < 1.3 * FREQUENCY_HZ ; f += step_hz)
+	{
+		double omega = 2 * M_PI * f / SIM_HRTIM_TICKS_PER_SECOND;
+		std::complex<double> sum = 0;
+
+		for (size_t i = 0 ; i < periods ; i++)
+		{
+			double a = (double)rising[i] - origin;
+			double b = (double)falling[i] - origin;
+
+			sum += std::polar(1.0, -omega * a) - std::polar(1.0, -omega * b);
+		}
+
+		/* Integral of the high intervals, over the window */
+		double magnitude = std::abs(sum) / (omega * window);
+		result.peak = fmax(result.peak, magnitude);
+	}
+
+	return result;
+}
+
+
+int main()
+{
+	sim_hrtim_set_edge_handler(record_edge, nullptr);
+	sim_plant_set(&plant);
+
+	shield.power.initBuck(LEG1);
+	spin.pwm.setPeriodEvntRep(MSTR, TASK_REPETITION);
+	shield.power.setDutyCycle(LEG1, 0.5f);
+	shield.power.start(LEG1);
+	sim_hrtim_connect_leg(1, PWMA);
+
+	sim_kernel_run_for(10 * PERIOD_NS);
+	measure_t nominal = measure();
+
+	check(nominal.period_max - nominal.period_min <= 1,
+		  "fixed switching period without spread spectrum");
+
+	int8_t started = shield.power.startSpreadSpectrum(dither_triangular,
+													  SPREAD,
+													  PROFILE_FREQUENCY);
+	check(started == 0, "spread spectrum started");
+
+	sim_kernel_run_for(10 * PERIOD_NS);
+	measure_t spread = measure();
+
+	double reduction_db = 20 * log10(nominal.peak / spread.peak);
+	double period_ratio = spread.period_max / spread.period_min;
+
+	printf("switching periods %.0f to %.0f ticks, nominal %.0f\n",
+		   spread.period_min, spread.period_max, nominal.period_max);
+	printf("fundamental peak reduced by %.1fdB\n", reduction_db);
+	printf("duty cycle %.4f, nominal %.4f\n",
+		   spread.duty_cycle, nominal.duty_cycle);
+
+	/* Ratio of the longest to the shortest period: 1.1 / 0.9 */
+	check(period_ratio > 1.2, "switching period spans the spread");
+	check(reduction_db > 10, "fundamental peak reduced by more than 10dB");
+
+	/* The dead time is constant: its share follows the period */
+	check(fabs(spread.duty_cycle - nominal.duty_cycle) < 2e-3,
+		  "duty cycle kept while dithering");
+	check(spread.duty_error < DEAD_TIME_SHARE_CHANGE + 1e-3,
+		  "duty cycle kept in every period");
+
+	/* Swaps the tables */
+	shield.power.setDutyCycle(LEG1, 0.3f);
+	sim_kernel_run_for(10 * PERIOD_NS);
+	measure_t updated = measure();
+
+	check(fabs(updated.duty_cycle - (nominal.duty_cycle - 0.2)) < 2e-3,
+		  "duty cycle update applied while dithering");
+	check(updated.duty_error < DEAD_TIME_SHARE_CHANGE + 1e-3,
+		  "updated duty cycle kept in every period");
+	check(updated.period_max / updated.period_min > 1.2,
+		  "still dithering after the update");
+
+	/* The critical task only swaps in the tables rebuilt in background,
+	 * the update applies on a following control period */
+	critical_duty_cycle = 0.4f;
+	task.createCritical(control_task, TASK_PERIOD_US, source_hrtim);
+	task.startCritical();
+	sim_kernel_run_for(4 * TASK_PERIOD_US * 1000);
+	measure_t critical = measure();
+	task.stopCritical();
+
+	check(fabs(critical.duty_cycle - (nominal.duty_cycle - 0.1)) < 2e-3,
+		  "duty cycle update applied from the critical task");
+	check(critical.duty_error < DEAD_TIME_SHARE_CHANGE + 1e-3,
+		  "critical task duty cycle kept in every period");
+
+	shield.power.stopSpreadSpectrum();
+	sim_kernel_run_for(10 * PERIOD_NS);
+	measure_t stopped = measure();
+
+	check( (stopped.period_max - stopped.period_min <= 1) &&
+		   (fabs(stopped.period_max - nominal.period_max) <= 1),
+		   "nominal switching period once stopped");
+	check(fabs(stopped.duty_cycle - (nominal.duty_cycle - 0.1)) < 1e-3,
+		  "updated duty cycle kept once stopped");
+
+	printf("%u checks failed\n", failures);
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ *
+ * @brief  Stress test of SpscQueue, on the host build.
+ *
+ *         A producer thread pushes numbered elements as fast as it can
+ *         while a consumer thread pops them. Fails if an element is lost,
+ *         duplicated, reordered or torn, or if the queue reports more
+ *         elements than its capacity.
+ *
+ *         Usage: spsc_queue_stress [elements]
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+/* Task API */
+#include "SpscQueue.h"
+
+
+typedef struct
+{
+	uint32_t number;
+	uint32_t inverted;
+	uint64_t payload;
+} element_t;
+
+/* Small, so that the queue is often full and often empty */
+static SpscQueue<element_t, 16> queue;
+
+
+int main(int argc, char** argv)
+{
+	uint32_t count = 5000000;
+	if (argc > 1)
+	{
+		count = strtoul(argv[1], nullptr, 0);
+	}
+
+	uint32_t full_count = 0;
+
+	std::thread producer([&]()
+	{
+		for (uint32_t i = 0 ; i < count ; i++)
+		{
+			element_t element = { i, ~i, (uint64_t)i * 0x9E3779B97F4A7C15ull };
+
+			while (queue.push(element) == false)
+			{
+				full_count++;
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	uint32_t errors = 0;
+	uint32_t expected = 0;
+
+	while (expected < count)
+	{
+		element_t element;
+
+		if (queue.size() > queue.capacity())
+		{
+			errors++;
+		}
+
+		if (queue.pop(element) == false)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		if ( (element.number != expected) ||
+			 (element.inverted != ~expected) ||
+			 (element.payload != (uint64_t)expected * 0x9E3779B97F4A7C15ull) )
+		{
+			if (errors < 10)
+			{
+				fprintf(stderr, "Element %u received instead of %u\n",
+						element.number, expected);
+			}
+			errors++;
+		}
+
+		expected++;
+	}
+
+	producer.join();
+
+	element_t element;
+	if (queue.pop(element) == true)
+	{
+		fprintf(stderr, "Element %u received after the last one\n",
+				element.number);
+		errors++;
+	}
+
+	printf("%u elements, queue full %u times, %u errors\n",
+		   count, full_count, errors);
+
+	return (errors == 0) ? 0 : 1;
+}
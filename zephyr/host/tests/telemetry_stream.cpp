@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Telemetry stream corrupted in transit, on the host build.
+ *
+ *         "write" streams SAMPLES samples of two channels, the sample
+ *         index and its square, then copies the stream with one byte
+ *         flipped in the payload of every CORRUPT_EVERY-th samples frame,
+ *         and a line of text inserted before every TEXT_EVERY-th one.
+ *
+ *         The copy is then decoded with telemetry_decode, and "check"
+ *         reads the CSV and text files it wrote: every sample of the
+ *         intact frames must be there with its values, the samples of the
+ *         corrupted frames must be missing, and the text must be kept.
+ *
+ *         Usage: telemetry_stream write <stream> <corrupted stream>
+ *                telemetry_stream check <decoded CSV> <decoded text>
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/* OwnTech telemetry */
+#include "telemetry.h"
+#include "telemetry_format.h"
+
+/* Simulator */
+#include "sim/sim_console.h"
+#include "sim/sim_kernel.h"
+
+
+#define SAMPLES       1000
+#define CORRUPT_EVERY 10
+#define TEXT_EVERY    7
+
+static float index_value  = 0;
+static float square_value = 0;
+
+static uint32_t failures = 0;
+
+static void check(bool condition, const char* name)
+{
+	printf("%-52s %s\n", name, condition ? "ok" : "FAILED");
+
+	if (condition == false)
+	{
+		failures++;
+	}
+}
+
+/**
+ * Returns true if the samples frame of this order is corrupted.
+ */
+static bool is_corrupted(uint32_t frame)
+{
+	return (frame % CORRUPT_EVERY) == CORRUPT_EVERY / 2;
+}
+
+/**
+ * Text inserted before a samples frame.
+ */
+static std::string text_line(uint32_t frame)
+{
+	return "Text before frame " + std::to_string(frame) + "\n";
+}
+
+static bool read_file(const char* path, std::vector<uint8_t>& data)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == nullptr)
+		return false;
+
+	uint8_t buffer[4096];
+	size_t  size;
+
+	while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		data.insert(data.end(), buffer, buffer + size);
+	}
+
+	fclose(file);
+
+	return true;
+}
+
+
+static int write_streams(const char* stream_path, const char* corrupted_path)
+{
+	FILE* stream = fopen(stream_path, "wb");
+	if (stream == nullptr)
+	{
+		fprintf(stderr, "Cannot write %s\n", stream_path);
+		return 1;
+	}
+
+	sim_console_set_output(stream);
+
+	telemetry_add_channel("index", &index_value);
+	telemetry_add_channel("square", &square_value);
+	telemetry_start();
+
+	/* Sampled faster than sent: the buffer holds them all */
+	for (uint32_t i = 0 ; i < SAMPLES ; i++)
+	{
+		index_value  = (float)i;
+		square_value = (float)(i * i);
+		telemetry_sample();
+	}
+
+	telemetry_stop();
+	sim_kernel_run_for(10 * 1000000);
+
+	sim_console_set_output(nullptr);
+	fclose(stream);
+
+	if (telemetry_get_dropped_samples() != 0)
+	{
+		fprintf(stderr, "%u samples dropped\n", telemetry_get_dropped_samples());
+		return 1;
+	}
+
+	std::vector<uint8_t> data;
+	read_file(stream_path, data);
+
+	FILE* corrupted = fopen(corrupted_path, "wb");
+	if (corrupted == nullptr)
+	{
+		fprintf(stderr, "Cannot write %s\n", corrupted_path);
+		return 1;
+	}
+
+	size_t   position = 0;
+	uint32_t frame    = 0;
+	uint32_t flipped  = 0;
+
+	while (position + sizeof(telemetry_frame_header_t) <= data.size())
+	{
+		telemetry_frame_header_t header;
+		memcpy(&header, &data[position], sizeof(header));
+
+		size_t frame_size = sizeof(header) + header.length
+						  + sizeof(telemetry_frame_crc_t);
+
+		if ( (header.sync[0] != TELEMETRY_SYNC_0) ||
+			 (header.sync[1] != TELEMETRY_SYNC_1) ||
+			 (position + frame_size > data.size()) )
+		{
+			fprintf(stderr, "Unexpected data at byte %zu\n", position);
+			fclose(corrupted);
+			return 1;
+		}
+
+		std::vector<uint8_t> bytes(data.begin() + position,
+								   data.begin() + position + frame_size);
+		position += frame_size;
+
+		if (header.type == TELEMETRY_FRAME_DESCRIPTOR)
+		{
+			fwrite(bytes.data(), 1, bytes.size(), corrupted);
+			continue;
+		}
+
+		if (frame % TEXT_EVERY == 0)
+		{
+			std::string text = text_line(frame);
+			fwrite(text.data(), 1, text.size(), corrupted);
+		}
+
+		if (is_corrupted(frame))
+		{
+			bytes[sizeof(header) + header.length / 2] ^= 0xFF;
+			flipped++;
+		}
+
+		fwrite(bytes.data(), 1, bytes.size(), corrupted);
+		frame++;
+	}
+
+	fclose(corrupted);
+
+	printf("%u samples frames, %u corrupted\n", frame, flipped);
+
+	return 0;
+}
+
+static int check_decoded(const char* csv_path, const char* text_path)
+{
+	std::vector<uint8_t> csv;
+	std::vector<uint8_t> text;
+
+	if ( (read_file(csv_path, csv) == false) ||
+		 (read_file(text_path, text) == false) )
+	{
+		fprintf(stderr, "Cannot read %s or %s\n", csv_path, text_path);
+		return 1;
+	}
+
+	csv.push_back(0);
+
+	/* Bytes of the corrupted frames are skipped as text too */
+	std::string skipped(text.begin(), text.end());
+
+	const char* line = (const char*)csv.data();
+	check(strncmp(line, "sample,index,square\n", 20) == 0,
+		  "channels named in the CSV header");
+
+	/* Samples of the intact frames, in order, with their values */
+	bool     values_ok   = true;
+	uint32_t expected    = 0;
+	uint32_t missing     = 0;
+	uint32_t unexpected  = 0;
+
+	for (line = strchr(line, '\n') ; (line != nullptr) && (line[1] != 0) ;
+		 line = strchr(line + 1, '\n'))
+	{
+		unsigned int sample;
+		float index;
+		float square;
+
+		if (sscanf(line + 1, "%u,%g,%g", &sample, &index, &square) != 3)
+		{
+			values_ok = false;
+			break;
+		}
+
+		while ( (expected < sample) && (expected < SAMPLES) )
+		{
+			if (is_corrupted(expected / CONFIG_OWNTECH_TELEMETRY_SAMPLES_PER_FRAME) == false)
+			{
+				missing++;
+			}
+			expected++;
+		}
+
+		if (is_corrupted(sample / CONFIG_OWNTECH_TELEMETRY_SAMPLES_PER_FRAME))
+		{
+			unexpected++;
+		}
+
+		values_ok &= (index == (float)sample) &&
+					 (square == (float)(sample * sample));
+		expected = sample + 1;
+	}
+
+	check(expected == SAMPLES, "samples decoded up to the last one");
+	check( (missing == 0) && (unexpected == 0),
+		   "samples of the corrupted frames only are missing");
+	check(values_ok, "values of the decoded samples kept");
+
+	bool text_kept = true;
+	uint32_t frames = (SAMPLES + CONFIG_OWNTECH_TELEMETRY_SAMPLES_PER_FRAME - 1)
+					/ CONFIG_OWNTECH_TELEMETRY_SAMPLES_PER_FRAME;
+
+	for (uint32_t frame = 0 ; frame < frames ; frame += TEXT_EVERY)
+	{
+		text_kept &= (skipped.find(text_line(frame)) != std::string::npos);
+	}
+	check(text_kept, "text between frames kept");
+
+	printf("%u checks failed\n", failures);
+
+	return (failures == 0) ? 0 : 1;
+}
+
+
+int main(int argc, char** argv)
+{
+	if ( (argc == 4) && (strcmp(argv[1], "write") == 0) )
+		return write_streams(argv[2], argv[3]);
+
+	if ( (argc == 4) && (strcmp(argv[1], "check") == 0) )
+		return check_decoded(argv[2], argv[3]);
+
+	fprintf(stderr, "Usage: %s write <stream> <corrupted stream>\n"
+					"       %s check <decoded CSV> <decoded text>\n",
+			argv[0], argv[0]);
+
+	return 1;
+}
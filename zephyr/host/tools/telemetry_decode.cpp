@@ -0,0 +1,601 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Decodes the telemetry stream to a CSV file, with one row per
+ *         sample: its index, then one column per channel.
+ *
+ *         An output name ending with ".rec" selects a binary record
+ *         instead, with the same rows at a fixed size, that analysis tools
+ *         map in memory rather than parse (see record_header_t). A record
+ *         holds a single channel layout: it stops at the first descriptor
+ *         changing it.
+ *
+ *         The input is a recording of the console, the standard input
+ *         ("-") or the console device itself, e.g. /dev/ttyACM0, which is
+ *         then read raw until Ctrl+C. The input is decoded as it is read:
+ *         a record can be as long as needed. Bytes outside of frames, such
+ *         as text printed by the board, are written to a text file when
+ *         one is given.
+ *
+ *         Captures of the Spin API are decoded the same way, the index of
+ *         their trigger sample being printed.
+ *
+ *         Usage: telemetry_decode [--text <file>] <input> <output.csv|.rec>
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+/* Zephyr */
+#include <zephyr/sys/crc.h>
+
+/* Telemetry format */
+#include "telemetry_codec.h"
+#include "telemetry_format.h"
+
+
+/* Bytes read at once */
+#define READ_SIZE (64 * 1024)
+
+/* Largest payload the target can send: 64 samples of 64 channels */
+#define MAX_PAYLOAD (sizeof(uint32_t) + \
+                     64 * TELEMETRY_MAX_CHANNELS * sizeof(float))
+
+#define FRAME_OVERHEAD (sizeof(telemetry_frame_header_t) + \
+                        sizeof(telemetry_frame_crc_t))
+
+
+/**
+ *  Binary record, little endian: this header, the channel names separated
+ *  with commas and ended with a 0, padding up to data_offset, then one row
+ *  per sample: its uint32_t index, then one float per channel. A row being
+ *  written may be incomplete: readers ignore it.
+ */
+
+#define RECORD_MAGIC     "OTRECORD"
+#define RECORD_VERSION   1
+#define RECORD_ALIGNMENT 8
+
+#define RECORD_TRIGGERED (1 << 0)
+
+typedef struct __attribute__((packed))
+{
+	char     magic[8];
+	uint32_t version;
+	uint32_t channels;
+	uint32_t data_offset;
+	uint32_t decimation;
+	uint32_t trigger_sample;
+	uint32_t flags;
+} record_header_t;
+
+/* Bytes written to the record at once */
+#define RECORD_BUFFER_SIZE (1024 * 1024)
+
+
+/**
+ *  Decoder state
+ */
+
+typedef struct
+{
+	FILE* csv;
+	FILE* record;
+	FILE* text;
+
+	/* Record header written, then stopped by a layout change */
+	bool            record_started;
+	bool            record_stopped;
+	record_header_t record_header;
+
+	/* From the last descriptor */
+	bool        described;
+	uint16_t    decimation;
+	uint8_t     channels;
+	std::string names;
+
+	bool     sequence_known;
+	uint16_t next_sequence;
+	uint32_t next_sample;
+
+	bool     triggered;
+	uint32_t trigger_sample;
+
+	uint64_t frames;
+	uint64_t samples;
+	uint64_t samples_lost;     /* Dropped on the target or in transit */
+	uint64_t frames_lost;
+	uint64_t frames_undescribed;
+	uint64_t frames_invalid;
+	uint64_t crc_errors;
+	uint64_t text_bytes;
+} decoder_t;
+
+static volatile sig_atomic_t interrupted = 0;
+
+
+static void on_interrupt(int signal)
+{
+	(void)signal;
+	interrupted = 1;
+}
+
+
+/**
+ *  Frame decoding
+ */
+
+static void write_record_header(decoder_t& decoder)
+{
+	record_header_t& header = decoder.record_header;
+
+	size_t names_size = decoder.names.size() + 1;
+	size_t data_offset = sizeof(header) + names_size;
+	data_offset = (data_offset + RECORD_ALIGNMENT - 1) &
+	              ~(size_t)(RECORD_ALIGNMENT - 1);
+
+	memcpy(header.magic, RECORD_MAGIC, sizeof(header.magic));
+	header.version     = RECORD_VERSION;
+	header.channels    = decoder.channels;
+	header.data_offset = data_offset;
+	header.decimation  = decoder.decimation;
+
+	uint8_t padding[RECORD_ALIGNMENT] = {};
+
+	fwrite(&header, sizeof(header), 1, decoder.record);
+	fwrite(decoder.names.c_str(), 1, names_size, decoder.record);
+	fwrite(padding, 1, data_offset - sizeof(header) - names_size,
+	       decoder.record);
+}
+
+static void decode_descriptor(decoder_t& decoder,
+                              const telemetry_frame_header_t& header,
+                              const uint8_t* payload)
+{
+	telemetry_descriptor_t descriptor;
+
+	if (header.length < sizeof(descriptor))
+		return;
+
+	memcpy(&descriptor, payload, sizeof(descriptor));
+
+	if (descriptor.version != TELEMETRY_VERSION)
+	{
+		fprintf(stderr, "Unsupported telemetry version %u\n",
+		        (unsigned int)descriptor.version);
+		return;
+	}
+
+	std::string names((const char*)payload + sizeof(descriptor),
+	                  header.length - sizeof(descriptor));
+
+	bool changed = (decoder.described == false) ||
+	               (decoder.channels != header.channels) ||
+	               (decoder.names != names);
+
+	decoder.described  = true;
+	decoder.decimation = descriptor.decimation;
+	decoder.channels   = header.channels;
+
+	if (changed)
+	{
+		decoder.names = names;
+
+		if (decoder.csv != nullptr)
+		{
+			fprintf(decoder.csv, "sample,%s\n", names.c_str());
+		}
+		else if (decoder.record_started == false)
+		{
+			write_record_header(decoder);
+			decoder.record_started = true;
+		}
+		else if (decoder.record_stopped == false)
+		{
+			fprintf(stderr, "Channels changed after sample %u: "
+			        "record stopped\n", decoder.next_sample);
+			decoder.record_stopped = true;
+		}
+	}
+}
+
+static void write_sample(decoder_t& decoder,
+                         uint32_t index,
+                         const float* values,
+                         uint8_t channels)
+{
+	if (decoder.record != nullptr)
+	{
+		if (decoder.record_stopped == false)
+		{
+			fwrite(&index, sizeof(index), 1, decoder.record);
+			fwrite(values, sizeof(float), channels, decoder.record);
+		}
+		return;
+	}
+
+	fprintf(decoder.csv, "%u", index);
+
+	for (uint8_t i = 0 ; i < channels ; i++)
+	{
+		fprintf(decoder.csv, ",%.7g", (double)values[i]);
+	}
+
+	fputc('\n', decoder.csv);
+}
+
+/**
+ * Decodes a samples frame, or a delta samples frame.
+ */
+static void decode_samples(decoder_t& decoder,
+                           const telemetry_frame_header_t& header,
+                           const uint8_t* payload)
+{
+	uint32_t first_sample;
+	size_t   sample_size = header.channels * sizeof(float);
+	bool     delta = (header.type == TELEMETRY_FRAME_DELTA);
+
+	if ( (decoder.described == false) ||
+	     (header.channels != decoder.channels) ||
+	     (header.channels == 0) ||
+	     (header.channels > TELEMETRY_MAX_CHANNELS) ||
+	     (header.length < sizeof(first_sample) + (delta ? sample_size : 0)) ||
+	     ( (delta == false) &&
+	       ((header.length - sizeof(first_sample)) % sample_size != 0) ) )
+	{
+		decoder.frames_undescribed++;
+		return;
+	}
+
+	const uint8_t* end = payload + header.length;
+
+	memcpy(&first_sample, payload, sizeof(first_sample));
+	payload += sizeof(first_sample);
+
+	if (first_sample > decoder.next_sample)
+	{
+		decoder.samples_lost += first_sample - decoder.next_sample;
+	}
+
+	float    values[TELEMETRY_MAX_CHANNELS];
+	uint32_t previous[TELEMETRY_MAX_CHANNELS];
+	uint32_t count = 0;
+
+	while (payload < end)
+	{
+		if ( (delta == false) || (count == 0) )
+		{
+			memcpy(values, payload, sample_size);
+			memcpy(previous, payload, sample_size);
+			payload += sample_size;
+		}
+		else
+		{
+			payload = telemetry_codec_decode(payload, end, values, previous,
+			                                 header.channels);
+			if (payload == nullptr)
+			{
+				decoder.frames_invalid++;
+				break;
+			}
+		}
+
+		write_sample(decoder, first_sample + count, values, header.channels);
+		count++;
+	}
+
+	decoder.samples    += count;
+	decoder.next_sample = first_sample + count;
+}
+
+static void decode_frame(decoder_t& decoder,
+                         const telemetry_frame_header_t& header,
+                         const uint8_t* payload)
+{
+	if ( (decoder.sequence_known) && (header.sequence != decoder.next_sequence) )
+	{
+		decoder.frames_lost += (uint16_t)(header.sequence - decoder.next_sequence);
+	}
+
+	decoder.sequence_known = true;
+	decoder.next_sequence  = header.sequence + 1;
+	decoder.frames++;
+
+	if (header.type == TELEMETRY_FRAME_DESCRIPTOR)
+	{
+		decode_descriptor(decoder, header, payload);
+	}
+	else if (header.type == TELEMETRY_FRAME_TRIGGER)
+	{
+		if (header.length == sizeof(decoder.trigger_sample))
+		{
+			memcpy(&decoder.trigger_sample, payload, header.length);
+			decoder.triggered = true;
+		}
+	}
+	else
+	{
+		decode_samples(decoder, header, payload);
+	}
+}
+
+static void skip_text(decoder_t& decoder, const uint8_t* data, size_t size)
+{
+	if (decoder.text != nullptr)
+	{
+		fwrite(data, 1, size, decoder.text);
+	}
+
+	decoder.text_bytes += size;
+}
+
+/**
+ * Decodes the complete frames of data, and returns the number of bytes
+ * used. The remaining ones start an incomplete frame.
+ */
+static size_t decode(decoder_t& decoder, const uint8_t* data, size_t size)
+{
+	size_t position = 0;
+
+	while (position < size)
+	{
+		const uint8_t* sync = (const uint8_t*)memchr(data + position,
+		                                             TELEMETRY_SYNC_0,
+		                                             size - position);
+
+		if (sync == nullptr)
+		{
+			skip_text(decoder, data + position, size - position);
+			return size;
+		}
+
+		skip_text(decoder, data + position, sync - (data + position));
+		position = sync - data;
+
+		telemetry_frame_header_t header;
+
+		if (size - position < sizeof(header))
+			return position;
+
+		memcpy(&header, data + position, sizeof(header));
+
+		bool valid = (header.sync[1] == TELEMETRY_SYNC_1) &&
+		             (header.type >= TELEMETRY_FRAME_DESCRIPTOR) &&
+		             (header.type <= TELEMETRY_FRAME_DELTA) &&
+		             (header.length <= MAX_PAYLOAD);
+
+		if (valid == false)
+		{
+			skip_text(decoder, data + position, 1);
+			position++;
+			continue;
+		}
+
+		size_t frame_size = FRAME_OVERHEAD + header.length;
+
+		if (size - position < frame_size)
+			return position;
+
+		const uint8_t* payload = data + position + sizeof(header);
+
+		uint16_t crc = crc16_itu_t(TELEMETRY_CRC_SEED,
+		                           data + position,
+		                           sizeof(header) + header.length);
+
+		telemetry_frame_crc_t frame_crc;
+		memcpy(&frame_crc, payload + header.length, sizeof(frame_crc));
+
+		if (crc != frame_crc)
+		{
+			decoder.crc_errors++;
+			skip_text(decoder, data + position, 1);
+			position++;
+			continue;
+		}
+
+		decode_frame(decoder, header, payload);
+		position += frame_size;
+	}
+
+	return position;
+}
+
+
+/**
+ *  Input
+ */
+
+static int open_input(const char* path)
+{
+	if (strcmp(path, "-") == 0)
+		return STDIN_FILENO;
+
+	int fd = open(path, O_RDONLY | O_NOCTTY);
+
+	if ( (fd >= 0) && (isatty(fd)) )
+	{
+		struct termios settings;
+
+		if (tcgetattr(fd, &settings) == 0)
+		{
+			cfmakeraw(&settings);
+			tcsetattr(fd, TCSANOW, &settings);
+		}
+	}
+
+	return fd;
+}
+
+
+int main(int argc, char** argv)
+{
+	const char* text_path = nullptr;
+	int first_argument = 1;
+
+	if ( (argc > 2) && (strcmp(argv[1], "--text") == 0) )
+	{
+		text_path = argv[2];
+		first_argument = 3;
+	}
+
+	if (argc - first_argument != 2)
+	{
+		fprintf(stderr, "Usage: %s [--text <file>] <input> <output.csv|.rec>\n",
+		        argv[0]);
+		return 2;
+	}
+
+	const char* input_path  = argv[first_argument];
+	const char* output_path = argv[first_argument + 1];
+
+	int input = open_input(input_path);
+
+	if (input < 0)
+	{
+		fprintf(stderr, "Cannot read %s\n", input_path);
+		return 1;
+	}
+
+	decoder_t decoder = {};
+
+	size_t output_length = strlen(output_path);
+	bool   record = (output_length > 4) &&
+	                (strcmp(output_path + output_length - 4, ".rec") == 0);
+
+	FILE* output = fopen(output_path, record ? "wb" : "w");
+
+	if (output == nullptr)
+	{
+		fprintf(stderr, "Cannot write %s\n", output_path);
+		return 1;
+	}
+
+	if (record)
+	{
+		decoder.record = output;
+		setvbuf(output, nullptr, _IOFBF, RECORD_BUFFER_SIZE);
+	}
+	else
+	{
+		decoder.csv = output;
+	}
+
+	if (text_path != nullptr)
+	{
+		decoder.text = fopen(text_path, "w");
+
+		if (decoder.text == nullptr)
+		{
+			fprintf(stderr, "Cannot write %s\n", text_path);
+			return 1;
+		}
+	}
+
+	/* Stop reading a console device cleanly */
+	struct sigaction action = {};
+	action.sa_handler = on_interrupt;
+	sigaction(SIGINT, &action, nullptr);
+
+	/* Holds an incomplete frame, then the bytes read after it */
+	std::vector<uint8_t> buffer(MAX_PAYLOAD + FRAME_OVERHEAD + READ_SIZE);
+	size_t pending = 0;
+
+	while (interrupted == 0)
+	{
+		ssize_t count = read(input, buffer.data() + pending, READ_SIZE);
+
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			fprintf(stderr, "Cannot read %s: %s\n", input_path, strerror(errno));
+			break;
+		}
+
+		if (count == 0)
+			break;
+
+		pending += count;
+
+		size_t used = decode(decoder, buffer.data(), pending);
+
+		memmove(buffer.data(), buffer.data() + used, pending - used);
+		pending -= used;
+	}
+
+	/* The trigger of a capture follows its descriptor */
+	if ( (decoder.record_started) && (decoder.triggered) )
+	{
+		decoder.record_header.trigger_sample = decoder.trigger_sample;
+		decoder.record_header.flags |= RECORD_TRIGGERED;
+
+		fseek(output, 0, SEEK_SET);
+		fwrite(&decoder.record_header, sizeof(decoder.record_header), 1,
+		       output);
+	}
+
+	fclose(output);
+
+	if (decoder.text != nullptr)
+	{
+		fclose(decoder.text);
+	}
+
+	if (input != STDIN_FILENO)
+	{
+		close(input);
+	}
+
+	printf("%llu frames, %llu samples of %u channels, decimation %u\n",
+	       (unsigned long long)decoder.frames,
+	       (unsigned long long)decoder.samples,
+	       (unsigned int)decoder.channels,
+	       (unsigned int)decoder.decimation);
+	printf("%llu samples lost, %llu frames lost, %llu CRC errors, "
+	       "%llu frames before a descriptor, %llu invalid frames, "
+	       "%llu bytes of text\n",
+	       (unsigned long long)decoder.samples_lost,
+	       (unsigned long long)decoder.frames_lost,
+	       (unsigned long long)decoder.crc_errors,
+	       (unsigned long long)decoder.frames_undescribed,
+	       (unsigned long long)decoder.frames_invalid,
+	       (unsigned long long)decoder.text_bytes);
+
+	if (decoder.triggered)
+	{
+		printf("Capture triggered at sample %u\n", decoder.trigger_sample);
+	}
+
+	return 0;
+}
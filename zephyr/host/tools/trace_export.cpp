@@ -0,0 +1,612 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Converts a dump of the event trace ring for timeline viewers:
+ *         - Chrome trace event JSON, opened by Perfetto UI and
+ *           chrome://tracing. Critical task executions and thread runs are
+ *           slices, the other events are instants on their own track,
+ *         - CTF 1.8, a directory with the metadata and one stream, read by
+ *           Babeltrace and Trace Compass.
+ *
+ *         The dump is either the binary image of trace_ring, as written by
+ *         the debugger or the host build, or the console output of
+ *         trace_dump().
+ *
+ *         Usage: trace_export [--ctf] <dump> <output>
+ */
+
+
+/* Stdlib */
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <sys/stat.h>
+
+/* Trace format */
+#include "event_trace_format.h"
+
+
+/**
+ *  Decoded trace
+ */
+
+typedef struct
+{
+	uint64_t cycles; /* Since the first event of the dump */
+	uint16_t id;
+	uint16_t arg;
+} decoded_event_t;
+
+typedef struct
+{
+	uint32_t frequency;
+	uint32_t lost; /* Events overwritten before the dump */
+	std::vector<decoded_event_t> events;
+} decoded_trace_t;
+
+/* Chrome trace tracks */
+#define TRACK_HRTIM         1
+#define TRACK_CRITICAL      2
+#define TRACK_DMA           3
+#define TRACK_COMMUNICATION 4
+#define TRACK_SAFETY        5
+#define TRACK_USER          6
+#define TRACK_THREAD_IDLE   7
+#define TRACK_THREAD_OTHER  8
+#define TRACK_THREAD_TASK   100
+
+
+/**
+ * Returns the name of an event, used in both output formats.
+ */
+static std::string event_name(uint16_t id)
+{
+	switch (id)
+	{
+		case TRACE_EVENT_HRTIM_REP:      return "hrtim_rep";
+		case TRACE_EVENT_DMA_HALF:       return "dma_half";
+		case TRACE_EVENT_DMA_FULL:       return "dma_full";
+		case TRACE_EVENT_CRITICAL_BEGIN: return "critical_begin";
+		case TRACE_EVENT_CRITICAL_END:   return "critical_end";
+		case TRACE_EVENT_THREAD_SWITCH:  return "thread_switch";
+		case TRACE_EVENT_CAN_RX:         return "can_rx";
+		case TRACE_EVENT_RS485_RX:       return "rs485_rx";
+		case TRACE_EVENT_SAFETY_ALERT:   return "safety_alert";
+		case TRACE_EVENT_SAFETY_TRIP:    return "safety_trip";
+		default:                         return "user_" + std::to_string(id);
+	}
+}
+
+
+/**
+ *  Dump reading
+ */
+
+static bool read_file(const char* path, std::vector<uint8_t>& content)
+{
+	FILE* file = fopen(path, "rb");
+
+	if (file == nullptr)
+		return false;
+
+	uint8_t buffer[4096];
+	size_t  count;
+
+	while ( (count = fread(buffer, 1, sizeof(buffer), file)) > 0 )
+	{
+		content.insert(content.end(), buffer, buffer + count);
+	}
+
+	fclose(file);
+
+	return true;
+}
+
+/**
+ * Extracts the words printed by trace_dump() from a console log, as the
+ * bytes of the ring. Returns false if no complete dump is found.
+ */
+static bool parse_console_dump(const std::vector<uint8_t>& text,
+                               std::vector<uint8_t>& image)
+{
+	std::string log(text.begin(), text.end());
+
+	size_t begin = log.find("trace begin");
+	if (begin == std::string::npos)
+		return false;
+
+	size_t end = log.find("trace end", begin);
+	if (end == std::string::npos)
+		return false;
+
+	size_t position = log.find('\n', begin);
+
+	while ( (position != std::string::npos) && (position < end) )
+	{
+		size_t token_start = log.find_first_of("0123456789abcdefABCDEF", position);
+		if ( (token_start == std::string::npos) || (token_start >= end) )
+			break;
+
+		size_t token_end = log.find_first_not_of("0123456789abcdefABCDEF", token_start);
+		std::string token = log.substr(token_start, token_end - token_start);
+
+		/* Console prefixes and line noise are not 8 digit words */
+		if (token.size() == 8)
+		{
+			uint32_t word = (uint32_t)strtoul(token.c_str(), nullptr, 16);
+
+			for (int i = 0 ; i < 4 ; i++)
+			{
+				image.push_back((uint8_t)(word >> (8 * i)));
+			}
+		}
+
+		position = token_end;
+	}
+
+	return true;
+}
+
+/**
+ * Decodes the ring image: events from the oldest to the newest, timestamps
+ * extended to 64 bits, then sorted.
+ */
+static bool decode(const std::vector<uint8_t>& image, decoded_trace_t& trace)
+{
+	trace_header_t header;
+
+	if (image.size() < sizeof(header))
+	{
+		fprintf(stderr, "Dump shorter than the trace header\n");
+		return false;
+	}
+
+	memcpy(&header, image.data(), sizeof(header));
+
+	if ( (header.magic != TRACE_MAGIC) || (header.version != TRACE_VERSION) )
+	{
+		fprintf(stderr, "Not a trace dump, or unsupported version\n");
+		return false;
+	}
+
+	if ( (header.event_size != sizeof(trace_event_t)) ||
+	     (header.size == 0) ||
+	     ((header.size & (header.size - 1)) != 0) ||
+	     (image.size() < sizeof(header) + (size_t)header.size * sizeof(trace_event_t)) )
+	{
+		fprintf(stderr, "Truncated or inconsistent trace dump\n");
+		return false;
+	}
+
+	const uint8_t* events = image.data() + sizeof(header);
+
+	uint32_t count = std::min(header.head, header.size);
+	uint32_t first = header.head - count;
+
+	trace.frequency = header.frequency;
+	trace.lost      = first;
+
+	uint64_t cycles    = 0;
+	uint32_t timestamp = 0;
+	bool     started   = false;
+
+	for (uint32_t i = 0 ; i < count ; i++)
+	{
+		trace_event_t event;
+		uint32_t slot = (first + i) & (header.size - 1);
+		memcpy(&event, events + slot * sizeof(trace_event_t), sizeof(event));
+
+		/* Slot reserved but not written yet when dumped */
+		if (event.id == TRACE_EVENT_NONE)
+			continue;
+
+		/* Consecutive events are close in time, both ways: preemption
+		 * between slot reservation and timestamp reorders them */
+		if (started == true)
+		{
+			cycles += (int64_t)(int32_t)(event.timestamp - timestamp);
+		}
+		timestamp = event.timestamp;
+		started   = true;
+
+		trace.events.push_back({ cycles, event.id, event.arg });
+	}
+
+	std::stable_sort(trace.events.begin(), trace.events.end(),
+	                 [](const decoded_event_t& a, const decoded_event_t& b)
+	                 {
+	                     return (int64_t)a.cycles < (int64_t)b.cycles;
+	                 });
+
+	if (trace.events.empty() == false)
+	{
+		uint64_t origin = trace.events.front().cycles;
+
+		for (decoded_event_t& event : trace.events)
+		{
+			event.cycles -= origin;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ *  Chrome trace event format
+ */
+
+static int thread_track(uint16_t thread_id)
+{
+	if (thread_id == TRACE_THREAD_IDLE)
+		return TRACK_THREAD_IDLE;
+
+	if (thread_id == TRACE_THREAD_OTHER)
+		return TRACK_THREAD_OTHER;
+
+	return TRACK_THREAD_TASK + thread_id;
+}
+
+static void write_track_name(FILE* file, int track, const std::string& name)
+{
+	fprintf(file,
+	        "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,"
+	        "\"args\":{\"name\":\"%s\"}},\n",
+	        track, name.c_str());
+
+	fprintf(file,
+	        "{\"ph\":\"M\",\"name\":\"thread_sort_index\",\"pid\":1,\"tid\":%d,"
+	        "\"args\":{\"sort_index\":%d}},\n",
+	        track, track);
+}
+
+static void write_event(FILE* file,
+                        const char* phase,
+                        const std::string& name,
+                        int track,
+                        double time_us,
+                        const char* args)
+{
+	fprintf(file,
+	        "{\"ph\":\"%s\",\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f",
+	        phase, name.c_str(), track, time_us);
+
+	if (phase[0] == 'i')
+	{
+		fprintf(file, ",\"s\":\"%s\"", (track == TRACK_SAFETY) ? "g" : "t");
+	}
+
+	if (args != nullptr)
+	{
+		fprintf(file, ",\"args\":{%s}", args);
+	}
+
+	fprintf(file, "},\n");
+}
+
+static bool export_chrome(const decoded_trace_t& trace, const char* path)
+{
+	FILE* file = fopen(path, "w");
+
+	if (file == nullptr)
+		return false;
+
+	fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	fprintf(file,
+	        "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,"
+	        "\"args\":{\"name\":\"Spin\"}},\n");
+
+	write_track_name(file, TRACK_HRTIM,         "HRTIM");
+	write_track_name(file, TRACK_CRITICAL,      "Critical task");
+	write_track_name(file, TRACK_DMA,           "ADC DMA");
+	write_track_name(file, TRACK_COMMUNICATION, "Communication");
+	write_track_name(file, TRACK_SAFETY,        "Safety");
+	write_track_name(file, TRACK_USER,          "User events");
+	write_track_name(file, TRACK_THREAD_IDLE,   "Idle");
+	write_track_name(file, TRACK_THREAD_OTHER,  "Other threads");
+
+	std::vector<bool> named_tasks(UINT16_MAX + 1, false);
+
+	double us_per_cycle = 1e6 / (double)trace.frequency;
+	bool   critical_open = false;
+	int    running_thread = -1;
+	double time_us = 0;
+	char   args[64];
+
+	for (const decoded_event_t& event : trace.events)
+	{
+		time_us = (double)event.cycles * us_per_cycle;
+
+		switch (event.id)
+		{
+			case TRACE_EVENT_HRTIM_REP:
+				write_event(file, "i", "repetition", TRACK_HRTIM, time_us, nullptr);
+				break;
+
+			case TRACE_EVENT_CRITICAL_BEGIN:
+				write_event(file, "B", "critical task", TRACK_CRITICAL, time_us, nullptr);
+				critical_open = true;
+				break;
+
+			case TRACE_EVENT_CRITICAL_END:
+				/* The beginning may have been overwritten */
+				if (critical_open == true)
+				{
+					write_event(file, "E", "critical task", TRACK_CRITICAL, time_us, nullptr);
+					critical_open = false;
+				}
+				break;
+
+			case TRACE_EVENT_DMA_HALF:
+			case TRACE_EVENT_DMA_FULL:
+				snprintf(args, sizeof(args), "\"channel\":%u", event.arg);
+				write_event(file, "i",
+				            (event.id == TRACE_EVENT_DMA_HALF) ? "half transfer"
+				                                               : "full transfer",
+				            TRACK_DMA, time_us, args);
+				break;
+
+			case TRACE_EVENT_THREAD_SWITCH:
+			{
+				int track = thread_track(event.arg);
+
+				if ( (track >= TRACK_THREAD_TASK) &&
+				     (named_tasks[event.arg] == false) )
+				{
+					write_track_name(file, track,
+					                 "Background task " + std::to_string(event.arg));
+					named_tasks[event.arg] = true;
+				}
+
+				if (running_thread >= 0)
+				{
+					write_event(file, "E", "running", running_thread, time_us, nullptr);
+				}
+				write_event(file, "B", "running", track, time_us, nullptr);
+				running_thread = track;
+				break;
+			}
+
+			case TRACE_EVENT_CAN_RX:
+				snprintf(args, sizeof(args), "\"item\":%u", event.arg);
+				write_event(file, "i", "CAN rx", TRACK_COMMUNICATION, time_us, args);
+				break;
+
+			case TRACE_EVENT_RS485_RX:
+				write_event(file, "i", "RS485 rx", TRACK_COMMUNICATION, time_us, nullptr);
+				break;
+
+			case TRACE_EVENT_SAFETY_ALERT:
+				snprintf(args, sizeof(args), "\"sensor\":%u", event.arg);
+				write_event(file, "i", "alert", TRACK_SAFETY, time_us, args);
+				break;
+
+			case TRACE_EVENT_SAFETY_TRIP:
+				snprintf(args, sizeof(args), "\"reaction\":%u", event.arg);
+				write_event(file, "i", "trip", TRACK_SAFETY, time_us, args);
+				break;
+
+			default:
+				snprintf(args, sizeof(args), "\"arg\":%u", event.arg);
+				write_event(file, "i", event_name(event.id), TRACK_USER, time_us, args);
+				break;
+		}
+	}
+
+	/* Close the slices still open at the end of the dump */
+	if (critical_open == true)
+	{
+		write_event(file, "E", "critical task", TRACK_CRITICAL, time_us, nullptr);
+	}
+
+	if (running_thread >= 0)
+	{
+		write_event(file, "E", "running", running_thread, time_us, nullptr);
+	}
+
+	/* Closing metadata event, so that no comma trails the last event */
+	fprintf(file,
+	        "{\"ph\":\"M\",\"name\":\"process_sort_index\",\"pid\":1,"
+	        "\"args\":{\"sort_index\":0}}\n");
+	fprintf(file, "]}\n");
+
+	fclose(file);
+
+	return true;
+}
+
+
+/**
+ *  Common Trace Format 1.8
+ */
+
+#define CTF_MAGIC 0xC1FC1FC1U
+
+static bool export_ctf(const decoded_trace_t& trace, const char* path)
+{
+	mkdir(path, 0755);
+
+	std::string directory(path);
+
+	FILE* metadata = fopen((directory + "/metadata").c_str(), "w");
+	if (metadata == nullptr)
+		return false;
+
+	fprintf(metadata,
+	        "/* CTF 1.8 */\n"
+	        "\n"
+	        "typealias integer { size = 16; align = 8; signed = false; } := uint16_t;\n"
+	        "typealias integer { size = 32; align = 8; signed = false; } := uint32_t;\n"
+	        "\n"
+	        "trace {\n"
+	        "\tmajor = 1;\n"
+	        "\tminor = 8;\n"
+	        "\tbyte_order = le;\n"
+	        "\tpacket.header := struct {\n"
+	        "\t\tuint32_t magic;\n"
+	        "\t\tuint32_t stream_id;\n"
+	        "\t};\n"
+	        "};\n"
+	        "\n"
+	        "clock {\n"
+	        "\tname = cycles;\n"
+	        "\tfreq = %u;\n"
+	        "\toffset = 0;\n"
+	        "};\n"
+	        "\n"
+	        "typealias integer {\n"
+	        "\tsize = 64; align = 8; signed = false;\n"
+	        "\tmap = clock.cycles.value;\n"
+	        "} := cycles_t;\n"
+	        "\n"
+	        "stream {\n"
+	        "\tid = 0;\n"
+	        "\tevent.header := struct {\n"
+	        "\t\tuint16_t id;\n"
+	        "\t\tcycles_t timestamp;\n"
+	        "\t};\n"
+	        "};\n",
+	        trace.frequency);
+
+	/* Only the user events present in the dump are declared */
+	std::vector<bool> declared(UINT16_MAX + 1, false);
+
+	for (const decoded_event_t& event : trace.events)
+	{
+		if (declared[event.id] == true)
+			continue;
+
+		fprintf(metadata,
+		        "\n"
+		        "event {\n"
+		        "\tname = \"%s\";\n"
+		        "\tid = %u;\n"
+		        "\tstream_id = 0;\n"
+		        "\tfields := struct {\n"
+		        "\t\tuint16_t arg;\n"
+		        "\t};\n"
+		        "};\n",
+		        event_name(event.id).c_str(), event.id);
+
+		declared[event.id] = true;
+	}
+
+	fclose(metadata);
+
+	FILE* stream = fopen((directory + "/stream_0").c_str(), "wb");
+	if (stream == nullptr)
+		return false;
+
+	/* A single packet, spanning the whole stream file */
+	uint32_t packet_header[2] = { CTF_MAGIC, 0 };
+	fwrite(packet_header, sizeof(packet_header), 1, stream);
+
+	for (const decoded_event_t& event : trace.events)
+	{
+		uint8_t record[12];
+
+		memcpy(&record[0], &event.id,     sizeof(event.id));
+		memcpy(&record[2], &event.cycles, sizeof(event.cycles));
+		memcpy(&record[10], &event.arg,   sizeof(event.arg));
+
+		fwrite(record, sizeof(record), 1, stream);
+	}
+
+	fclose(stream);
+
+	return true;
+}
+
+
+int main(int argc, char** argv)
+{
+	bool ctf = false;
+	int  first_argument = 1;
+
+	if ( (argc > 1) && (strcmp(argv[1], "--ctf") == 0) )
+	{
+		ctf = true;
+		first_argument = 2;
+	}
+
+	if (argc - first_argument != 2)
+	{
+		fprintf(stderr, "Usage: %s [--ctf] <dump> <output>\n", argv[0]);
+		return 2;
+	}
+
+	const char* dump_path   = argv[first_argument];
+	const char* output_path = argv[first_argument + 1];
+
+	std::vector<uint8_t> content;
+
+	if (read_file(dump_path, content) == false)
+	{
+		fprintf(stderr, "Cannot read %s\n", dump_path);
+		return 1;
+	}
+
+	/* Binary image, or console log of trace_dump() */
+	std::vector<uint8_t> image;
+	uint32_t magic = 0;
+
+	if (content.size() >= sizeof(magic))
+	{
+		memcpy(&magic, content.data(), sizeof(magic));
+	}
+
+	if (magic == TRACE_MAGIC)
+	{
+		image = content;
+	}
+	else if (parse_console_dump(content, image) == false)
+	{
+		fprintf(stderr, "No trace found in %s\n", dump_path);
+		return 1;
+	}
+
+	decoded_trace_t trace;
+
+	if (decode(image, trace) == false)
+		return 1;
+
+	bool written = ctf ? export_ctf(trace, output_path)
+	                   : export_chrome(trace, output_path);
+
+	if (written == false)
+	{
+		fprintf(stderr, "Cannot write %s\n", output_path);
+		return 1;
+	}
+
+	double duration_ms = trace.events.empty() ? 0 :
+	        (double)trace.events.back().cycles * 1e3 / (double)trace.frequency;
+
+	printf("%zu events over %.3f ms, %u older events overwritten\n",
+	       trace.events.size(), duration_ms, trace.lost);
+
+	return 0;
+}
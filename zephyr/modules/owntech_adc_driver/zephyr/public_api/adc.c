@@ -24,6 +24,10 @@
  */
 
 
+/* Zephyr */
+#include <zephyr/kernel.h>
+#include <zephyr/irq.h>
+
 /* STM32 LL */
 #include <stm32_ll_adc.h>
 
@@ -53,6 +57,44 @@ static bool         enable_dma[NUMBER_OF_ADCS]             = {0};
 static uint32_t
 		enabled_channels[NUMBER_OF_ADCS][NUMBER_OF_CHANNELS_PER_ADC] = {0};
 
+/* End of sequence event */
+static ADC_TypeDef* const adc_instances[NUMBER_OF_ADCS] =
+{
+	ADC1, ADC2, ADC3, ADC4, ADC5
+};
+
+static const uint8_t adc_irq_lines[NUMBER_OF_ADCS] =
+{
+	ADC1_2_IRQn, ADC1_2_IRQn, ADC3_IRQn, ADC4_IRQn, ADC5_IRQn
+};
+
+static ADC_TypeDef*   eos_adc      = NULL;
+static uint8_t        eos_irq_line = 0;
+static adc_callback_t eos_callback = NULL;
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - End of sequence interrupt handler. Disarms the
+ *        interrupt then calls the user function.
+ */
+static void _adc_eos_callback(const void* arg)
+{
+	ARG_UNUSED(arg);
+
+	if (LL_ADC_IsActiveFlag_EOS(eos_adc) == 0)
+		return;
+
+	LL_ADC_DisableIT_EOS(eos_adc);
+	LL_ADC_ClearFlag_EOS(eos_adc);
+
+	if (eos_callback != NULL)
+	{
+		eos_callback();
+	}
+}
+
 
 /* Public API */
 
@@ -272,3 +314,46 @@ void adc_trigger_software_conversion(uint8_t adc_number,
 {
 	adc_core_start(adc_number, number_of_acquisitions);
 }
+
+void adc_eos_event_configure(uint8_t adc_number, adc_callback_t callback)
+{
+	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
+		return;
+
+	eos_adc      = adc_instances[adc_number-1];
+	eos_irq_line = adc_irq_lines[adc_number-1];
+	eos_callback = callback;
+
+	irq_connect_dynamic(eos_irq_line,
+						0,
+						_adc_eos_callback,
+						NULL,
+						IRQ_ZERO_LATENCY);
+}
+
+void adc_eos_event_enable()
+{
+	if (eos_adc == NULL)
+		return;
+
+	LL_ADC_DisableIT_EOS(eos_adc);
+	LL_ADC_ClearFlag_EOS(eos_adc);
+
+	irq_enable(eos_irq_line);
+}
+
+void adc_eos_event_disable()
+{
+	if (eos_adc == NULL)
+		return;
+
+	irq_disable(eos_irq_line);
+
+	LL_ADC_DisableIT_EOS(eos_adc);
+}
+
+void adc_eos_event_arm()
+{
+	LL_ADC_ClearFlag_EOS(eos_adc);
+	LL_ADC_EnableIT_EOS(eos_adc);
+}
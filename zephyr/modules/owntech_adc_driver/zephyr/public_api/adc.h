@@ -74,6 +74,9 @@ typedef enum
 	hrtim_ev9 = 9
 } adc_ev_src_t;
 
+/** @brief Function called on ADC end of sequence */
+typedef void (*adc_callback_t)();
+
 
 /* Public API */
 
@@ -179,6 +182,43 @@ void adc_stop();
 void adc_trigger_software_conversion(uint8_t adc_number,
 									 uint8_t number_of_acquisitions);
 
+/**
+ * @brief Registers a function called from a zero-latency interrupt at the
+ *        end of a conversion sequence of an ADC.
+ *
+ *        The interrupt is one-shot: it must be armed with
+ *        adc_eos_event_arm() before each sequence that should call the
+ *        function. This allows calling it once every N sequences without
+ *        counting them in software, which would miss sequences ending
+ *        while the function runs.
+ *
+ *        The interrupt has priority 0, the one of the HRTIM and TIM6
+ *        interrupts of the critical task: they do not preempt each other.
+ *
+ *        Only one ADC at a time can be used.
+ *
+ * @param adc_number Number of the ADC.
+ * @param callback   Function to call.
+ */
+void adc_eos_event_configure(uint8_t adc_number, adc_callback_t callback);
+
+/**
+ * @brief Enables the end of sequence interrupt line of the configured ADC.
+ */
+void adc_eos_event_enable();
+
+/**
+ * @brief Disables the end of sequence interrupt line of the configured ADC.
+ */
+void adc_eos_event_disable();
+
+/**
+ * @brief Arms the end of sequence interrupt for the next end of sequence
+ *        of the configured ADC. A sequence ended before this call is
+ *        ignored.
+ */
+void adc_eos_event_arm();
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Placement of the critical path in CCM SRAM.
+ *
+ *         Functions marked with OWNTECH_CCM_FUNC and variables marked with
+ *         OWNTECH_CCM_DATA are copied from flash to CCM SRAM at boot when
+ *         CONFIG_OWNTECH_CCM_CRITICAL_PATH is enabled, and stay in flash
+ *         and SRAM otherwise.
+ *
+ *         E.g. for the user critical task:
+ *             OWNTECH_CCM_FUNC void loop_critical_task();
+ *
+ * @warning DMA cannot access CCM SRAM: never place DMA buffers there.
+ */
+
+#ifndef CCM_H_
+#define CCM_H_
+
+#ifdef CONFIG_OWNTECH_CCM_CRITICAL_PATH
+
+/* Calls between flash and CCM SRAM are out of range of a branch
+ * instruction, hence the long call. */
+#define OWNTECH_CCM_FUNC __attribute__((noinline, long_call, section(".ccm_text")))
+#define OWNTECH_CCM_DATA __attribute__((section(".ccm_data")))
+
+#else
+
+#define OWNTECH_CCM_FUNC
+#define OWNTECH_CCM_DATA
+
+#endif
+
+#endif /* CCM_H_ */
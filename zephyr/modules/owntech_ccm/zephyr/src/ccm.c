@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+/* Standard library */
+#include <string.h>
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <soc.h>
+
+/* Current file header */
+#include "ccm.h"
+
+
+/* Defined by the linker script */
+extern char __ccm_ram_start[];
+extern char __ccm_ram_end[];
+extern char __ccm_ram_load_start[];
+
+
+/**
+ * @brief PRIVATE FUNCTION - Copies the CCM code and data from flash.
+ *        Runs before any driver, the critical path is only called once
+ *        the application has started.
+ */
+static int _ccm_init(void)
+{
+    memcpy(__ccm_ram_start,
+           __ccm_ram_load_start,
+           (size_t)(__ccm_ram_end - __ccm_ram_start));
+
+    /* Make sure the copied code is visible to instruction fetches */
+    __DSB();
+    __ISB();
+
+    return 0;
+}
+
+SYS_INIT(_ccm_init, PRE_KERNEL_1, 0);
@@ -35,6 +35,9 @@
 /* Header */
 #include "Rs485.h"
 
+/* Event trace */
+#include "event_trace.h"
+
 #define DMA_USART DMA1 /* DMA used */
 
 /**
@@ -111,6 +114,8 @@ static void _dma_callback_tx(const struct device *dev,
  */
 static void _dma_callback_rx()
 {
+    OWNTECH_TRACE(TRACE_EVENT_RS485_RX, 0);
+
     /* Clear transmission complete flag */
     LL_DMA_ClearFlag_TC7(DMA_USART);
 
@@ -30,6 +30,8 @@
 #include <thingset/can.h>
 #include <thingset/sdk.h>
 
+#include "event_trace.h"
+
 LOG_MODULE_REGISTER(ts_can, CONFIG_THINGSET_SDK_LOG_LEVEL);
 
 extern struct thingset_context ts;
@@ -64,6 +66,8 @@ void can_control_rx_handler(uint16_t data_id,
                             size_t value_len,
                             uint8_t source_addr)
 {
+    OWNTECH_TRACE(TRACE_EVENT_CAN_RX, data_id);
+
     /* Control data items use IDs >= 0x8000 */
     if (data_id >= 0x8000) {
         /* CBOR: map with 1 element */
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Trigonometric and magnitude functions computed by the STM32G4
+ *         CORDIC coprocessor.
+ *
+ *         Blocking functions write the arguments and read the result right
+ *         away: the bus is stalled until the result is ready, which costs
+ *         a few cycles and no polling. Batch functions stream vectors of
+ *         angles through DMA while the CPU runs other code.
+ *
+ *         With CONFIG_OWNTECH_CORDIC_SOFTWARE, the same API is implemented
+ *         with libm and has no hardware dependency.
+ *
+ *         The coprocessor holds one calculation at a time. A blocking
+ *         function that finds it busy, running a batch or a call of a
+ *         context it preempted, computes its result with libm instead:
+ *         e.g. the critical task interrupting a thread in the middle of a
+ *         blocking call, or calling it while a batch runs. Such results
+ *         are more precise than the coprocessor ones, and take longer.
+ */
+
+#ifndef CORDIC_H_
+#define CORDIC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Angle in q1.31 format used by the batch functions:
+ *        `INT32_MIN` is -π and `INT32_MAX` is just below π.
+ */
+typedef int32_t cordic_angle_q31_t;
+
+/**
+ * @brief Converts an angle in radians to the q1.31 format of the batch
+ *        functions, wrapping it into [-π, π).
+ *
+ * @param[in] theta  Angle in radians, within ±6e9.
+ */
+static inline cordic_angle_q31_t cordic_angle_to_q31(float theta)
+{
+    /* Angle in turns of π, wrapped into [-1, 1) */
+    float x = theta * 0.318309886F;
+    x -= 2.0F * (float)(int32_t)(x * 0.5F);
+
+    if (x >= 1.0F)
+    {
+        x -= 2.0F;
+    }
+    else if (x < -1.0F)
+    {
+        x += 2.0F;
+    }
+
+    float scaled = x * 2147483648.0F;
+
+    /* Values just below 1 are rounded up to 2^31 */
+    if (scaled >= 2147483648.0F)
+    {
+        return INT32_MAX;
+    }
+    return (cordic_angle_q31_t)scaled;
+}
+
+/**
+ * @brief Converts a q1.31 result of the batch functions to a float.
+ *
+ * @param[in] value  Result in q1.31 format
+ */
+static inline float cordic_q31_to_float(int32_t value)
+{
+    return (float)value * (1.0F / 2147483648.0F);
+}
+
+/**
+ * @brief Enables the CORDIC clock. Called by the blocking functions when
+ *        needed, calling it at initialization avoids a test at run time.
+ */
+void cordic_init(void);
+
+/**
+ * @brief Computes the sine and cosine of an angle.
+ *
+ * @param[in]  theta      Angle in radians, within ±6e9.
+ * @param[out] sin_theta  Sine of the angle
+ * @param[out] cos_theta  Cosine of the angle
+ */
+void cordic_sin_cos(float theta, float* sin_theta, float* cos_theta);
+
+/**
+ * @brief Computes the angle of a vector.
+ *
+ * @param[in] y  Ordinate of the vector
+ * @param[in] x  Abscissa of the vector
+ *
+ * @return Angle in radians between -π and π, `0` for a null vector.
+ */
+float cordic_atan2(float y, float x);
+
+/**
+ * @brief Computes the magnitude of a vector, sqrt(x² + y²).
+ *
+ * @param[in] x  First component of the vector
+ * @param[in] y  Second component of the vector
+ */
+float cordic_magnitude(float x, float y);
+
+/**
+ * @brief Computes the angle and the magnitude of a vector in one
+ *        operation, e.g. to lock a PLL on an αβ vector.
+ *
+ * @param[in]  x          Abscissa of the vector
+ * @param[in]  y          Ordinate of the vector
+ * @param[out] angle      Angle in radians between -π and π
+ * @param[out] magnitude  Magnitude of the vector
+ */
+void cordic_polar(float x, float y, float* angle, float* magnitude);
+
+/**
+ * @brief Computes a square root.
+ *
+ *        The square root instruction of the FPU is faster than the
+ *        coprocessor once conversions are accounted for, so it is used
+ *        here. Provided for completeness of the API.
+ *
+ * @param[in] x  Positive value
+ */
+float cordic_sqrt(float x);
+
+/**
+ * @brief Starts computing the cosine and sine of a vector of angles.
+ *
+ *        The transfer runs on DMA2 channels 2 and 3. Results are
+ *        interleaved: `results[2*i]` is the cosine and `results[2*i+1]` the
+ *        sine of `angles[i]`, both in q1.31 format.
+ *
+ * @param[in]  angles   Angles in q1.31 format, see cordic_angle_to_q31()
+ * @param[out] results  Buffer of `2 * count` words
+ * @param[in]  count    Number of angles, between 1 and 32767
+ *
+ * @return `0` if the batch was started, `-1` if a batch is already running,
+ *         the coprocessor is used by a blocking call of a preempted
+ *         context, or the parameters are invalid.
+ *
+ * @warning Blocking functions compute in software until the batch is done,
+ *          and both buffers must remain valid until then.
+ */
+int8_t cordic_sin_cos_batch_start(const cordic_angle_q31_t* angles,
+                                  int32_t* results,
+                                  uint16_t count);
+
+/**
+ * @brief Returns `true` once the last batch is done, or if no batch was
+ *        started. The coprocessor is then free for blocking calls.
+ */
+bool cordic_batch_is_done(void);
+
+/**
+ * @brief Busy-waits until the last batch is done.
+ */
+void cordic_batch_wait(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORDIC_H_ */
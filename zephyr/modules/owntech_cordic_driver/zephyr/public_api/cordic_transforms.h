@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Clarke and Park transforms using the CORDIC driver for sine and
+ *         cosine. Clarke transforms are amplitude invariant.
+ */
+
+#ifndef CORDIC_TRANSFORMS_H_
+#define CORDIC_TRANSFORMS_H_
+
+#include "cordic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CORDIC_ONE_BY_SQRT3  0.57735027F
+#define CORDIC_SQRT3_BY_2    0.86602540F
+
+/**
+ * @brief Clarke transform of three phase quantities.
+ *
+ * @param[in]  a      Phase a
+ * @param[in]  b      Phase b
+ * @param[in]  c      Phase c
+ * @param[out] alpha  α component
+ * @param[out] beta   β component
+ */
+static inline void cordic_clarke(float a, float b, float c,
+                                 float* alpha, float* beta)
+{
+    *alpha = (2.0F * a - b - c) * (1.0F / 3.0F);
+    *beta = (b - c) * CORDIC_ONE_BY_SQRT3;
+}
+
+/**
+ * @brief Clarke transform of two phases of a balanced three-phase system,
+ *        e.g. when only two phase currents are measured.
+ *
+ * @param[in]  a      Phase a
+ * @param[in]  b      Phase b
+ * @param[out] alpha  α component
+ * @param[out] beta   β component
+ */
+static inline void cordic_clarke_balanced(float a, float b,
+                                          float* alpha, float* beta)
+{
+    *alpha = a;
+    *beta = (a + 2.0F * b) * CORDIC_ONE_BY_SQRT3;
+}
+
+/**
+ * @brief Inverse Clarke transform.
+ *
+ * @param[in]  alpha  α component
+ * @param[in]  beta   β component
+ * @param[out] a      Phase a
+ * @param[out] b      Phase b
+ * @param[out] c      Phase c
+ */
+static inline void cordic_clarke_inverse(float alpha, float beta,
+                                         float* a, float* b, float* c)
+{
+    *a = alpha;
+    *b = -0.5F * alpha + CORDIC_SQRT3_BY_2 * beta;
+    *c = -0.5F * alpha - CORDIC_SQRT3_BY_2 * beta;
+}
+
+/**
+ * @brief Park transform with precomputed sine and cosine, to share them
+ *        between several transforms of the same angle.
+ *
+ * @param[in]  alpha      α component
+ * @param[in]  beta       β component
+ * @param[in]  sin_theta  Sine of the rotating frame angle
+ * @param[in]  cos_theta  Cosine of the rotating frame angle
+ * @param[out] d          d component
+ * @param[out] q          q component
+ */
+static inline void cordic_park_sc(float alpha, float beta,
+                                  float sin_theta, float cos_theta,
+                                  float* d, float* q)
+{
+    *d = alpha * cos_theta + beta * sin_theta;
+    *q = beta * cos_theta - alpha * sin_theta;
+}
+
+/**
+ * @brief Inverse Park transform with precomputed sine and cosine.
+ *
+ * @param[in]  d          d component
+ * @param[in]  q          q component
+ * @param[in]  sin_theta  Sine of the rotating frame angle
+ * @param[in]  cos_theta  Cosine of the rotating frame angle
+ * @param[out] alpha      α component
+ * @param[out] beta       β component
+ */
+static inline void cordic_park_inverse_sc(float d, float q,
+                                          float sin_theta, float cos_theta,
+                                          float* alpha, float* beta)
+{
+    *alpha = d * cos_theta - q * sin_theta;
+    *beta = d * sin_theta + q * cos_theta;
+}
+
+/**
+ * @brief Park transform.
+ *
+ * @param[in]  alpha  α component
+ * @param[in]  beta   β component
+ * @param[in]  theta  Angle of the rotating frame in radians
+ * @param[out] d      d component
+ * @param[out] q      q component
+ */
+static inline void cordic_park(float alpha, float beta, float theta,
+                               float* d, float* q)
+{
+    float sin_theta;
+    float cos_theta;
+
+    cordic_sin_cos(theta, &sin_theta, &cos_theta);
+    cordic_park_sc(alpha, beta, sin_theta, cos_theta, d, q);
+}
+
+/**
+ * @brief Inverse Park transform.
+ *
+ * @param[in]  d      d component
+ * @param[in]  q      q component
+ * @param[in]  theta  Angle of the rotating frame in radians
+ * @param[out] alpha  α component
+ * @param[out] beta   β component
+ */
+static inline void cordic_park_inverse(float d, float q, float theta,
+                                       float* alpha, float* beta)
+{
+    float sin_theta;
+    float cos_theta;
+
+    cordic_sin_cos(theta, &sin_theta, &cos_theta);
+    cordic_park_inverse_sc(d, q, sin_theta, cos_theta, alpha, beta);
+}
+
+/**
+ * @brief Direct transform of three phase quantities to the rotating frame.
+ *
+ * @param[in]  a      Phase a
+ * @param[in]  b      Phase b
+ * @param[in]  c      Phase c
+ * @param[in]  theta  Angle of the rotating frame in radians
+ * @param[out] d      d component
+ * @param[out] q      q component
+ */
+static inline void cordic_abc_to_dq(float a, float b, float c, float theta,
+                                    float* d, float* q)
+{
+    float alpha;
+    float beta;
+
+    cordic_clarke(a, b, c, &alpha, &beta);
+    cordic_park(alpha, beta, theta, d, q);
+}
+
+/**
+ * @brief Inverse transform from the rotating frame to three phase
+ *        quantities.
+ *
+ * @param[in]  d      d component
+ * @param[in]  q      q component
+ * @param[in]  theta  Angle of the rotating frame in radians
+ * @param[out] a      Phase a
+ * @param[out] b      Phase b
+ * @param[out] c      Phase c
+ */
+static inline void cordic_dq_to_abc(float d, float q, float theta,
+                                    float* a, float* b, float* c)
+{
+    float alpha;
+    float beta;
+
+    cordic_park_inverse(d, q, theta, &alpha, &beta);
+    cordic_clarke_inverse(alpha, beta, a, b, c);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORDIC_TRANSFORMS_H_ */
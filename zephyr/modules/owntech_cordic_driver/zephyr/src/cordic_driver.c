@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+/* Standard library */
+#include <math.h>
+#include <string.h>
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+/* STM32 LL */
+#include <stm32_ll_bus.h>
+#include <stm32_ll_cordic.h>
+#include <stm32_ll_dma.h>
+
+/* Current file header */
+#include "cordic.h"
+#include "cordic_software.h"
+
+
+#define CORDIC_PRECISION \
+    ((uint32_t)CONFIG_OWNTECH_CORDIC_PRECISION << CORDIC_CSR_PRECISION_Pos)
+
+/** @brief Cosine and sine of an angle, modulus written as second argument */
+static const uint32_t CORDIC_CSR_SIN_COS = LL_CORDIC_FUNCTION_COSINE |
+                                           CORDIC_PRECISION          |
+                                           LL_CORDIC_SCALE_0         |
+                                           LL_CORDIC_NBWRITE_2       |
+                                           LL_CORDIC_NBREAD_2        |
+                                           LL_CORDIC_INSIZE_32BITS   |
+                                           LL_CORDIC_OUTSIZE_32BITS;
+
+/** @brief Angle and modulus of a vector */
+static const uint32_t CORDIC_CSR_PHASE = LL_CORDIC_FUNCTION_PHASE |
+                                         CORDIC_PRECISION         |
+                                         LL_CORDIC_SCALE_0        |
+                                         LL_CORDIC_NBWRITE_2      |
+                                         LL_CORDIC_NBREAD_2       |
+                                         LL_CORDIC_INSIZE_32BITS  |
+                                         LL_CORDIC_OUTSIZE_32BITS;
+
+/** @brief Cosine and sine of angles streamed by DMA, modulus kept at 1 */
+static const uint32_t CORDIC_CSR_SIN_COS_DMA = LL_CORDIC_FUNCTION_COSINE |
+                                               CORDIC_PRECISION          |
+                                               LL_CORDIC_SCALE_0         |
+                                               LL_CORDIC_NBWRITE_1       |
+                                               LL_CORDIC_NBREAD_2        |
+                                               LL_CORDIC_INSIZE_32BITS   |
+                                               LL_CORDIC_OUTSIZE_32BITS  |
+                                               CORDIC_CSR_DMAWEN         |
+                                               CORDIC_CSR_DMAREN;
+
+/** @brief DMA channels of the batches (DMA1 is used by the ADCs, DMA2
+ *         channel 1 by the HRTIM burst DMA) */
+static const uint32_t CORDIC_DMA_WRITE_CHANNEL = LL_DMA_CHANNEL_2;
+static const uint32_t CORDIC_DMA_READ_CHANNEL = LL_DMA_CHANNEL_3;
+
+static const int32_t Q31_ONE = INT32_MAX;
+static const float Q31_TO_FLOAT = 1.0F / 2147483648.0F;
+static const float FLOAT_TO_Q31 = 2147483648.0F;
+static const float PI_F = 3.14159265F;
+
+static bool cordic_initialized = false;
+static bool batch_running = false;
+/** @brief Last value written to CSR, to skip rewriting the same function */
+static uint32_t current_csr = 0;
+/** @brief Set while a blocking call or a batch uses the coprocessor */
+static atomic_t cordic_owned = ATOMIC_INIT(0);
+
+
+/**
+ * @brief PRIVATE FUNCTION - Takes the coprocessor. Fails while a batch
+ *        runs, or in a context that preempted a blocking call, e.g. the
+ *        critical task interrupting a thread. Uses no kernel service, so
+ *        that it can be called from a zero-latency interrupt.
+ *
+ * @return true if the coprocessor was taken.
+ */
+static inline bool _cordic_take(void)
+{
+    return atomic_cas(&cordic_owned, 0, 1);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Gives the coprocessor back.
+ */
+static inline void _cordic_give(void)
+{
+    atomic_clear(&cordic_owned);
+}
+
+
+/**
+ * @brief PRIVATE FUNCTION - Selects the CORDIC function if it is not the
+ *        current one.
+ *
+ * @param csr Value of the control and status register
+ */
+static inline void _cordic_configure(uint32_t csr)
+{
+    if (cordic_initialized == false)
+    {
+        cordic_init();
+    }
+
+    if (csr != current_csr)
+    {
+        WRITE_REG(CORDIC->CSR, csr);
+        current_csr = csr;
+    }
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Builds the float 2^exponent.
+ *
+ * @param exponent Power of two between -126 and 127
+ */
+static inline float _pow2(int32_t exponent)
+{
+    uint32_t bits = (uint32_t)(exponent + 127) << 23;
+    float value;
+
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Returns the exponent e such that
+ *        value / 2^e is below 0.5.
+ *
+ * @param value Strictly positive normal float
+ */
+static inline int32_t _scale_exponent(float value)
+{
+    uint32_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+    /* value = f.2^(biased - 126) with f in [0.5, 1) */
+    return (int32_t)((bits >> 23) & 0xFF) - 125;
+}
+
+void cordic_init(void)
+{
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_CORDIC);
+    cordic_initialized = true;
+}
+
+void cordic_sin_cos(float theta, float* sin_theta, float* cos_theta)
+{
+    if (_cordic_take() == false)
+    {
+        cordic_software_sin_cos(theta, sin_theta, cos_theta);
+        return;
+    }
+
+    _cordic_configure(CORDIC_CSR_SIN_COS);
+
+    LL_CORDIC_WriteData(CORDIC, (uint32_t)cordic_angle_to_q31(theta));
+    LL_CORDIC_WriteData(CORDIC, (uint32_t)Q31_ONE);
+
+    /* Reads are stalled until the calculation is done */
+    *cos_theta = (int32_t)LL_CORDIC_ReadData(CORDIC) * Q31_TO_FLOAT;
+    *sin_theta = (int32_t)LL_CORDIC_ReadData(CORDIC) * Q31_TO_FLOAT;
+
+    _cordic_give();
+}
+
+void cordic_polar(float x, float y, float* angle, float* magnitude)
+{
+    float largest = fmaxf(fabsf(x), fabsf(y));
+
+    if (largest == 0.0F)
+    {
+        *angle = 0.0F;
+        *magnitude = 0.0F;
+        return;
+    }
+
+    /* Scale both components below 0.5 so that the modulus stays below 1 */
+    int32_t exponent = _scale_exponent(largest);
+    float scale = _pow2(-exponent);
+
+    if (_cordic_take() == false)
+    {
+        cordic_software_polar(x, y, angle, magnitude);
+        return;
+    }
+
+    _cordic_configure(CORDIC_CSR_PHASE);
+
+    LL_CORDIC_WriteData(CORDIC, (uint32_t)(int32_t)(x * scale * FLOAT_TO_Q31));
+    LL_CORDIC_WriteData(CORDIC, (uint32_t)(int32_t)(y * scale * FLOAT_TO_Q31));
+
+    *angle = (int32_t)LL_CORDIC_ReadData(CORDIC) * (Q31_TO_FLOAT * PI_F);
+    *magnitude = (int32_t)LL_CORDIC_ReadData(CORDIC) * Q31_TO_FLOAT
+               * _pow2(exponent);
+
+    _cordic_give();
+}
+
+float cordic_atan2(float y, float x)
+{
+    float angle;
+    float magnitude;
+
+    cordic_polar(x, y, &angle, &magnitude);
+    return angle;
+}
+
+float cordic_magnitude(float x, float y)
+{
+    float angle;
+    float magnitude;
+
+    cordic_polar(x, y, &angle, &magnitude);
+    return magnitude;
+}
+
+float cordic_sqrt(float x)
+{
+    return sqrtf(x);
+}
+
+int8_t cordic_sin_cos_batch_start(const cordic_angle_q31_t* angles,
+                                  int32_t* results,
+                                  uint16_t count)
+{
+    if ( (angles == NULL) || (results == NULL) ||
+         (count == 0)     || (count > INT16_MAX) )
+    {
+        return -1;
+    }
+
+    /* Releases the coprocessor if the last batch is over */
+    (void)cordic_batch_is_done();
+
+    if (_cordic_take() == false)
+    {
+        return -1;
+    }
+
+    /* Only the angle is streamed: set the modulus argument to 1 with a
+       blocking calculation, it is kept by the following ones */
+    _cordic_configure(CORDIC_CSR_SIN_COS);
+    LL_CORDIC_WriteData(CORDIC, 0);
+    LL_CORDIC_WriteData(CORDIC, (uint32_t)Q31_ONE);
+    (void)LL_CORDIC_ReadData(CORDIC);
+    (void)LL_CORDIC_ReadData(CORDIC);
+
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMAMUX1);
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA2);
+
+    /* Results: two words per angle, from RDATA to memory */
+    LL_DMA_ConfigTransfer(DMA2,
+                          CORDIC_DMA_READ_CHANNEL,
+                          LL_DMA_DIRECTION_PERIPH_TO_MEMORY |
+                          LL_DMA_MODE_NORMAL                |
+                          LL_DMA_PERIPH_NOINCREMENT         |
+                          LL_DMA_MEMORY_INCREMENT           |
+                          LL_DMA_PDATAALIGN_WORD            |
+                          LL_DMA_MDATAALIGN_WORD            |
+                          LL_DMA_PRIORITY_HIGH);
+
+    LL_DMA_ConfigAddresses(DMA2,
+                           CORDIC_DMA_READ_CHANNEL,
+                           (uint32_t)&(CORDIC->RDATA),
+                           (uint32_t)results,
+                           LL_DMA_DIRECTION_PERIPH_TO_MEMORY);
+
+    LL_DMA_SetDataLength(DMA2, CORDIC_DMA_READ_CHANNEL, 2 * count);
+    LL_DMA_SetPeriphRequest(DMA2,
+                            CORDIC_DMA_READ_CHANNEL,
+                            LL_DMAMUX_REQ_CORDIC_READ);
+
+    /* Angles: one word per angle, from memory to WDATA */
+    LL_DMA_ConfigTransfer(DMA2,
+                          CORDIC_DMA_WRITE_CHANNEL,
+                          LL_DMA_DIRECTION_MEMORY_TO_PERIPH |
+                          LL_DMA_MODE_NORMAL                |
+                          LL_DMA_PERIPH_NOINCREMENT         |
+                          LL_DMA_MEMORY_INCREMENT           |
+                          LL_DMA_PDATAALIGN_WORD            |
+                          LL_DMA_MDATAALIGN_WORD            |
+                          LL_DMA_PRIORITY_MEDIUM);
+
+    LL_DMA_ConfigAddresses(DMA2,
+                           CORDIC_DMA_WRITE_CHANNEL,
+                           (uint32_t)angles,
+                           (uint32_t)&(CORDIC->WDATA),
+                           LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+
+    LL_DMA_SetDataLength(DMA2, CORDIC_DMA_WRITE_CHANNEL, count);
+    LL_DMA_SetPeriphRequest(DMA2,
+                            CORDIC_DMA_WRITE_CHANNEL,
+                            LL_DMAMUX_REQ_CORDIC_WRITE);
+
+    LL_DMA_ClearFlag_GI2(DMA2);
+    LL_DMA_ClearFlag_GI3(DMA2);
+
+    /* Read channel first so that no result is missed */
+    LL_DMA_EnableChannel(DMA2, CORDIC_DMA_READ_CHANNEL);
+    LL_DMA_EnableChannel(DMA2, CORDIC_DMA_WRITE_CHANNEL);
+
+    batch_running = true;
+    _cordic_configure(CORDIC_CSR_SIN_COS_DMA);
+
+    return 0;
+}
+
+bool cordic_batch_is_done(void)
+{
+    if (batch_running == false)
+    {
+        return true;
+    }
+
+    /* The batch ends when the last result is read, on read channel 3 */
+    if (LL_DMA_IsActiveFlag_TC3(DMA2) == 0)
+    {
+        return false;
+    }
+
+    LL_CORDIC_DisableDMAReq_WR(CORDIC);
+    LL_CORDIC_DisableDMAReq_RD(CORDIC);
+    LL_DMA_DisableChannel(DMA2, CORDIC_DMA_WRITE_CHANNEL);
+    LL_DMA_DisableChannel(DMA2, CORDIC_DMA_READ_CHANNEL);
+    LL_DMA_ClearFlag_GI2(DMA2);
+    LL_DMA_ClearFlag_GI3(DMA2);
+
+    /* Force the next blocking call to rewrite the function */
+    current_csr = 0;
+    batch_running = false;
+    _cordic_give();
+
+    return true;
+}
+
+void cordic_batch_wait(void)
+{
+    while (cordic_batch_is_done() == false)
+    {
+    }
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Software implementation of the CORDIC driver API. It only depends
+ *         on libm so that code using the driver can be built on a host.
+ *
+ *         The coprocessor driver also uses it when the coprocessor is busy.
+ */
+
+/* Standard library */
+#include <math.h>
+#include <stddef.h>
+
+/* Driver API */
+#include "cordic.h"
+
+/* Current file header */
+#include "cordic_software.h"
+
+
+static const float PI_F = 3.14159265F;
+
+
+void cordic_software_sin_cos(float theta, float* sin_theta, float* cos_theta)
+{
+    /* Same wrapping as the coprocessor */
+    float angle = cordic_q31_to_float(cordic_angle_to_q31(theta)) * PI_F;
+
+    *sin_theta = sinf(angle);
+    *cos_theta = cosf(angle);
+}
+
+void cordic_software_polar(float x, float y, float* angle, float* magnitude)
+{
+    if ((x == 0.0F) && (y == 0.0F))
+    {
+        *angle = 0.0F;
+        *magnitude = 0.0F;
+        return;
+    }
+
+    *angle = atan2f(y, x);
+    *magnitude = hypotf(x, y);
+}
+
+#ifdef CONFIG_OWNTECH_CORDIC_SOFTWARE
+
+/**
+ * @brief PRIVATE FUNCTION - Converts a float in [-1, 1] to q1.31 with
+ *        saturation, like the coprocessor output.
+ *
+ * @param value Value to convert
+ */
+static int32_t _float_to_q31(float value)
+{
+    float scaled = value * 2147483648.0F;
+
+    if (scaled >= 2147483648.0F)
+    {
+        return INT32_MAX;
+    }
+    else if (scaled <= -2147483648.0F)
+    {
+        return INT32_MIN;
+    }
+    return (int32_t)scaled;
+}
+
+void cordic_init(void)
+{
+}
+
+void cordic_sin_cos(float theta, float* sin_theta, float* cos_theta)
+{
+    cordic_software_sin_cos(theta, sin_theta, cos_theta);
+}
+
+void cordic_polar(float x, float y, float* angle, float* magnitude)
+{
+    cordic_software_polar(x, y, angle, magnitude);
+}
+
+float cordic_atan2(float y, float x)
+{
+    if ((x == 0.0F) && (y == 0.0F))
+    {
+        return 0.0F;
+    }
+    return atan2f(y, x);
+}
+
+float cordic_magnitude(float x, float y)
+{
+    return hypotf(x, y);
+}
+
+float cordic_sqrt(float x)
+{
+    return sqrtf(x);
+}
+
+int8_t cordic_sin_cos_batch_start(const cordic_angle_q31_t* angles,
+                                  int32_t* results,
+                                  uint16_t count)
+{
+    if ( (angles == NULL) || (results == NULL) ||
+         (count == 0)     || (count > INT16_MAX) )
+    {
+        return -1;
+    }
+
+    /* Computed right away, the batch is done when this function returns */
+    for (uint16_t i = 0; i < count; i++)
+    {
+        float angle = cordic_q31_to_float(angles[i]) * PI_F;
+
+        results[2 * i]     = _float_to_q31(cosf(angle));
+        results[2 * i + 1] = _float_to_q31(sinf(angle));
+    }
+
+    return 0;
+}
+
+bool cordic_batch_is_done(void)
+{
+    return true;
+}
+
+void cordic_batch_wait(void)
+{
+}
+
+#endif /* CONFIG_OWNTECH_CORDIC_SOFTWARE */
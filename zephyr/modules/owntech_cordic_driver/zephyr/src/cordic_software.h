@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2026-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2026
+ * @author agent <agent@local>
+ *
+ * @brief  Software computations of the CORDIC driver, used by the
+ *         coprocessor driver while the coprocessor is busy, and by the
+ *         software implementation of the API.
+ */
+
+#ifndef CORDIC_SOFTWARE_H_
+#define CORDIC_SOFTWARE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Computes the sine and cosine of an angle with libm, see
+ *        cordic_sin_cos().
+ */
+void cordic_software_sin_cos(float theta, float* sin_theta, float* cos_theta);
+
+/**
+ * @brief Computes the angle and the magnitude of a vector with libm, see
+ *        cordic_polar().
+ */
+void cordic_software_polar(float x, float y, float* angle, float* magnitude);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORDIC_SOFTWARE_H_ */
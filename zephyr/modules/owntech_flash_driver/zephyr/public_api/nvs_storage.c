@@ -39,6 +39,9 @@
 /* CMSIS */
 #include <arm_math.h>
 
+/* OwnTech deferred log */
+#include "deferred_log.h"
+
 /* Current file header */
 #include "nvs_storage.h"
 
@@ -137,7 +140,7 @@ static int8_t _nvs_storage_init()
 
 	if (!device_is_ready(fs.flash_device))
 	{
-		printk("Flash device %s is not ready\n", fs.flash_device->name);
+		OWNTECH_LOG("Flash device %s is not ready\n", fs.flash_device->name);
 		return -1;
 	}
 
@@ -153,7 +156,7 @@ static int8_t _nvs_storage_init()
 	int rc = flash_get_page_info_by_offs(fs.flash_device, fs.offset, &info);
 	if (rc != 0)
 	{
-		printk("Unable to get page info\n");
+		OWNTECH_LOG("Unable to get page info\n");
 		return -1;
 	}
 	fs.sector_size = info.size;
@@ -162,7 +165,7 @@ static int8_t _nvs_storage_init()
 	rc = nvs_mount(&fs);
 	if (rc != 0)
 	{
-		printk("Flash Init failed\n");
+		OWNTECH_LOG("Flash Init failed\n");
 		return -1;
 	}
 
@@ -179,7 +182,7 @@ static int8_t _nvs_storage_init()
 	}
 	else if (storage_version_in_nvs != current_storage_version)
 	{
-		printk("WARNING: stored version in NVS is different from \
+		OWNTECH_LOG("WARNING: stored version in NVS is different from \
 				current module version! \
 				Stored data may not have the expected format.\n");
 
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  FIR and IIR filters run by the STM32G4 filter math accelerator
+ *         (FMAC).
+ *
+ *         The accelerator computes one filter at a time, and reloading
+ *         another filter costs more than computing a short block of
+ *         samples. Only the resident filter, number
+ *         `FMAC_RESIDENT_FILTER`, runs on the accelerator: it is started
+ *         once with its coefficients and stays started with its history,
+ *         each run only streams the new samples. The other filters are
+ *         computed by the CPU, with the same fixed-point coefficients.
+ *
+ *         Every wait on the accelerator is bounded.
+ */
+
+#ifndef FMAC_H_
+#define FMAC_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of feedforward coefficients of a FIR filter */
+#define FMAC_FIR_MAX_TAPS 63
+/** @brief Maximum number of feedforward coefficients of an IIR filter */
+#define FMAC_IIR_MAX_B 31
+/** @brief Maximum number of feedback coefficients of an IIR filter,
+ *         a0 excluded */
+#define FMAC_IIR_MAX_A 31
+
+/** @brief Filter run on the accelerator, the others are run by the CPU */
+#define FMAC_RESIDENT_FILTER 0
+
+/**
+ * @brief Enables the FMAC clock. Called by fmac_filter_configure().
+ */
+void fmac_init(void);
+
+/**
+ * @brief Configures a filter. The coefficients of the resident filter
+ *        are loaded in the accelerator on its next run.
+ *
+ *        The filter is y[n] = (b0.x[n] + ... + bN.x[n-N]
+ *                             - a1.y[n-1] - ... - aM.y[n-M]) / a0,
+ *        so that coefficients computed by usual design tools can be used
+ *        directly. Coefficients are converted to q1.15 with a common
+ *        power of two gain, they must stay below 128 in absolute value
+ *        once divided by a0.
+ *
+ * @param[in] filter_number Filter number, between 0 and
+ *                          CONFIG_OWNTECH_FMAC_MAX_FILTERS - 1
+ * @param[in] b       Feedforward coefficients b0 to bN
+ * @param[in] b_count Number of feedforward coefficients, between 1 and
+ *                    `FMAC_FIR_MAX_TAPS` for a FIR filter, or
+ *                    `FMAC_IIR_MAX_B` for an IIR filter.
+ * @param[in] a       Feedback coefficients a0 to aM, `NULL` for a FIR filter
+ * @param[in] a_count Number of feedback coefficients including a0, `0` for
+ *                    a FIR filter, at most `FMAC_IIR_MAX_A + 1`.
+ *
+ * @return `0` if the filter was configured, `-1` if the parameters are
+ *         invalid.
+ *
+ * @note   The history of the filter is cleared.
+ */
+int8_t fmac_filter_configure(uint8_t filter_number,
+                             const float* b,
+                             uint8_t b_count,
+                             const float* a,
+                             uint8_t a_count);
+
+/**
+ * @brief Clears the history of a filter, as if all past inputs and
+ *        outputs were 0.
+ *
+ * @param[in] filter_number Filter number
+ */
+void fmac_filter_reset(uint8_t filter_number);
+
+/**
+ * @brief Filters a block of samples.
+ *
+ * @param[in]  filter_number Filter number
+ * @param[in]  input   Input samples in q1.15 format
+ * @param[out] output  Output samples in q1.15 format, saturated. Can be the
+ *                     same buffer as `input`.
+ * @param[in]  count   Number of samples
+ *
+ * @return `0` if the samples were filtered, `-1` if the filter is not
+ *         configured or if the accelerator stopped responding. In the
+ *         latter case, the outputs not returned keep their value, and
+ *         the next run restarts the resident filter from a cleared
+ *         history.
+ *
+ * @warning A filter must not be run from contexts that can preempt each
+ *          other.
+ */
+int8_t fmac_filter_run(uint8_t filter_number,
+                       const int16_t* input,
+                       int16_t* output,
+                       uint16_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FMAC_H_ */
@@ -0,0 +1,454 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+/* Standard library */
+#include <math.h>
+#include <string.h>
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+
+/* STM32 LL */
+#include <stm32_ll_bus.h>
+#include <stm32_ll_fmac.h>
+
+/* Current file header */
+#include "fmac.h"
+
+
+/**
+ * Accelerator memory layout (256 words): X1 input buffer, Y output buffer,
+ * and the coefficients of the resident filter.
+ */
+#define FMAC_X1_BASE     0
+#define FMAC_X1_SIZE     64
+#define FMAC_Y_BASE      64
+#define FMAC_Y_SIZE      32
+#define FMAC_X2_BASE     96
+
+#define FMAC_MAX_COEFFS  FMAC_FIR_MAX_TAPS
+
+/* Maximum gain applied to the accumulator, as a power of two */
+#define FMAC_MAX_GAIN    7
+
+/* Polls of a flag without progress before giving up on the accelerator */
+#define FMAC_WAIT_POLLS  1000
+
+typedef struct
+{
+    bool configured;
+    bool iir;
+    uint8_t b_count;
+    uint8_t a_count;              /* Feedback coefficients, a0 excluded */
+    uint8_t gain;                 /* Accumulator shift, R parameter */
+    int16_t coeffs[FMAC_MAX_COEFFS];
+    /* History of the filters computed by the CPU, the resident filter
+       keeps its own in the accelerator */
+    int16_t x_history[FMAC_MAX_COEFFS];
+    int16_t y_history[FMAC_IIR_MAX_A];
+    uint8_t x_position;           /* Oldest sample in x_history */
+    uint8_t y_position;           /* Oldest sample in y_history */
+} fmac_filter_t;
+
+static fmac_filter_t filters[CONFIG_OWNTECH_FMAC_MAX_FILTERS];
+static bool fmac_initialized = false;
+
+/* Whether the function of the resident filter is started */
+static bool fmac_started = false;
+
+static const int16_t fmac_zeros[FMAC_MAX_COEFFS] = {0};
+
+
+/**
+ * @brief PRIVATE FUNCTION - Waits for the accelerator to clear its START
+ *        bit, once all the values of a load function are written.
+ *
+ * @return 0 once cleared, -1 if it is still set after `FMAC_WAIT_POLLS`
+ *         polls.
+ */
+static int8_t _fmac_wait_start_cleared(void)
+{
+    for (uint32_t poll = 0; poll < FMAC_WAIT_POLLS; poll++)
+    {
+        if (LL_FMAC_IsEnabledStart(FMAC) == 0)
+        {
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Stops the function of the resident filter. Its
+ *        next run starts it again, from a cleared history.
+ */
+static void _fmac_stop(void)
+{
+    LL_FMAC_DisableStart(FMAC);
+    fmac_started = false;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Loads values in one of the accelerator buffers.
+ *
+ * @param function `LL_FMAC_FUNC_LOAD_X1`, `LL_FMAC_FUNC_LOAD_X2` or
+ *                 `LL_FMAC_FUNC_LOAD_Y`
+ * @param values   Values to load, oldest first for the X1 and Y buffers.
+ *                 For X2, the feedforward coefficients first.
+ * @param count    Number of values for X1 and Y, of feedforward
+ *                 coefficients for X2
+ * @param q_count  Number of feedback coefficients for X2, 0 otherwise
+ *
+ * @return 0 once the values are loaded, -1 if the accelerator did not
+ *         respond.
+ */
+static int8_t _fmac_load(uint32_t function,
+                         const int16_t* values,
+                         uint8_t count,
+                         uint8_t q_count)
+{
+    if (count + q_count == 0)
+    {
+        return 0;
+    }
+
+    LL_FMAC_ConfigFunc(FMAC, LL_FMAC_PROCESSING_START, function,
+                       count, q_count, 0);
+
+    for (uint8_t i = 0; i < count + q_count; i++)
+    {
+        LL_FMAC_WriteData(FMAC, (uint16_t)values[i]);
+    }
+
+    /* START is cleared by the accelerator once all values are loaded */
+    return _fmac_wait_start_cleared();
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Resets the accelerator, loads the coefficients
+ *        of the resident filter with a cleared history, and starts its
+ *        function. It then stays started from one run to the next.
+ *
+ * @return 0 once started, -1 if the accelerator did not respond.
+ */
+static int8_t _fmac_start(void)
+{
+    const fmac_filter_t* filter = &filters[FMAC_RESIDENT_FILTER];
+    uint32_t poll = 0;
+
+    LL_FMAC_EnableReset(FMAC);
+    while (LL_FMAC_IsEnabledReset(FMAC))
+    {
+        if (++poll >= FMAC_WAIT_POLLS)
+        {
+            return -1;
+        }
+    }
+
+    LL_FMAC_ConfigX1(FMAC, LL_FMAC_WM_0_THRESHOLD_1,
+                     FMAC_X1_BASE, FMAC_X1_SIZE);
+    LL_FMAC_ConfigX2(FMAC, FMAC_X2_BASE,
+                     filter->b_count + filter->a_count);
+    LL_FMAC_ConfigY(FMAC, LL_FMAC_WM_0_THRESHOLD_1,
+                    FMAC_Y_BASE, FMAC_Y_SIZE);
+    LL_FMAC_EnableClipping(FMAC);
+
+    if ( (_fmac_load(LL_FMAC_FUNC_LOAD_X2, filter->coeffs,
+                     filter->b_count, filter->a_count) != 0) ||
+         (_fmac_load(LL_FMAC_FUNC_LOAD_X1, fmac_zeros,
+                     filter->b_count - 1, 0) != 0) ||
+         (_fmac_load(LL_FMAC_FUNC_LOAD_Y, fmac_zeros,
+                     filter->a_count, 0) != 0) )
+    {
+        return -1;
+    }
+
+    if (filter->iir == true)
+    {
+        LL_FMAC_ConfigFunc(FMAC, LL_FMAC_PROCESSING_START,
+                           LL_FMAC_FUNC_IIR_DIRECT_FORM_1,
+                           filter->b_count, filter->a_count, filter->gain);
+    }
+    else
+    {
+        LL_FMAC_ConfigFunc(FMAC, LL_FMAC_PROCESSING_START,
+                           LL_FMAC_FUNC_CONVO_FIR,
+                           filter->b_count, 0, filter->gain);
+    }
+
+    fmac_started = true;
+
+    return 0;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Streams samples through the resident filter:
+ *        inputs are written ahead as long as the input buffer has room,
+ *        and results read behind them as they come.
+ *
+ * @return 0 if the samples were filtered, -1 if the accelerator stopped
+ *         responding.
+ */
+static int8_t _fmac_hardware_run(const int16_t* input,
+                                 int16_t* output,
+                                 uint16_t count)
+{
+    uint16_t written = 0;
+    uint16_t read = 0;
+    uint32_t idle_polls = 0;
+
+    if ( (fmac_started == false) && (_fmac_start() != 0) )
+    {
+        _fmac_stop();
+        return -1;
+    }
+
+    while (read < count)
+    {
+        bool progress = false;
+
+        if ( (written < count) && (LL_FMAC_IsActiveFlag_X1FULL(FMAC) == 0) )
+        {
+            LL_FMAC_WriteData(FMAC, (uint16_t)input[written]);
+            written++;
+            progress = true;
+        }
+
+        /* A result never overwrites an input not written yet */
+        if (LL_FMAC_IsActiveFlag_YEMPTY(FMAC) == 0)
+        {
+            output[read] = (int16_t)LL_FMAC_ReadData(FMAC);
+            read++;
+            progress = true;
+        }
+
+        if (progress == true)
+        {
+            idle_polls = 0;
+        }
+        else if (++idle_polls >= FMAC_WAIT_POLLS)
+        {
+            _fmac_stop();
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Computes a filter with the CPU, with the same
+ *        q1.15 coefficients, gain and saturation as the accelerator, and a
+ *        wider accumulator.
+ */
+static void _fmac_software_run(fmac_filter_t* filter,
+                               const int16_t* input,
+                               int16_t* output,
+                               uint16_t count)
+{
+    const int16_t* b = filter->coeffs;
+    const int16_t* a = &filter->coeffs[filter->b_count];
+    uint8_t shift = 15 - filter->gain;
+
+    for (uint16_t n = 0; n < count; n++)
+    {
+        int64_t accumulator = 0;
+        uint8_t position = filter->x_position;
+
+        /* The new sample replaces the oldest one, then the products go
+           back in time from it */
+        filter->x_history[position] = input[n];
+
+        for (uint8_t i = 0; i < filter->b_count; i++)
+        {
+            accumulator += (int32_t)b[i] * filter->x_history[position];
+            position = (position == 0) ? filter->b_count - 1 : position - 1;
+        }
+
+        filter->x_position = (filter->x_position + 1 < filter->b_count) ?
+                             filter->x_position + 1 : 0;
+
+        position = filter->y_position;
+
+        for (uint8_t i = 0; i < filter->a_count; i++)
+        {
+            position = (position == 0) ? filter->a_count - 1 : position - 1;
+            accumulator += (int32_t)a[i] * filter->y_history[position];
+        }
+
+        accumulator >>= shift;
+
+        if (accumulator > INT16_MAX)
+        {
+            accumulator = INT16_MAX;
+        }
+        else if (accumulator < INT16_MIN)
+        {
+            accumulator = INT16_MIN;
+        }
+
+        output[n] = (int16_t)accumulator;
+
+        if (filter->a_count > 0)
+        {
+            filter->y_history[filter->y_position] = output[n];
+            filter->y_position = (filter->y_position + 1 < filter->a_count) ?
+                                 filter->y_position + 1 : 0;
+        }
+    }
+}
+
+void fmac_init(void)
+{
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_FMAC);
+    fmac_initialized = true;
+}
+
+int8_t fmac_filter_configure(uint8_t filter_number,
+                             const float* b,
+                             uint8_t b_count,
+                             const float* a,
+                             uint8_t a_count)
+{
+    bool iir = (a != NULL) && (a_count > 1);
+
+    if ( (filter_number >= CONFIG_OWNTECH_FMAC_MAX_FILTERS) ||
+         (b == NULL) || (b_count == 0) )
+    {
+        return -1;
+    }
+
+    if ( ( iir && ((b_count > FMAC_IIR_MAX_B) ||
+                   (a_count > FMAC_IIR_MAX_A + 1) ||
+                   (a[0] == 0.0F)) ) ||
+         (!iir && (b_count > FMAC_FIR_MAX_TAPS)) )
+    {
+        return -1;
+    }
+
+    if ( (filter_number == FMAC_RESIDENT_FILTER) &&
+         (fmac_initialized == false) )
+    {
+        fmac_init();
+    }
+
+    /* Normalized coefficients, feedback ones negated as the accelerator
+       adds them to the accumulator */
+    float normalized[FMAC_MAX_COEFFS];
+    float largest = 0.0F;
+    float inverse_a0 = iir ? (1.0F / a[0]) : 1.0F;
+    uint8_t feedback_count = iir ? (a_count - 1) : 0;
+
+    for (uint8_t i = 0; i < b_count; i++)
+    {
+        normalized[i] = b[i] * inverse_a0;
+    }
+    for (uint8_t i = 0; i < feedback_count; i++)
+    {
+        normalized[b_count + i] = -a[i + 1] * inverse_a0;
+    }
+    for (uint8_t i = 0; i < b_count + feedback_count; i++)
+    {
+        largest = fmaxf(largest, fabsf(normalized[i]));
+    }
+
+    /* Smallest power of two bringing all the coefficients below 1 */
+    uint8_t gain = 0;
+    while ((largest >= (float)(1 << gain)) && (gain <= FMAC_MAX_GAIN))
+    {
+        gain++;
+    }
+    if (gain > FMAC_MAX_GAIN)
+    {
+        return -1;
+    }
+
+    fmac_filter_t* filter = &filters[filter_number];
+
+    filter->configured = true;
+    filter->iir = iir;
+    filter->b_count = b_count;
+    filter->a_count = feedback_count;
+    filter->gain = gain;
+
+    float scale = 32768.0F / (float)(1 << gain);
+    for (uint8_t i = 0; i < b_count + feedback_count; i++)
+    {
+        float value = roundf(normalized[i] * scale);
+        filter->coeffs[i] = (int16_t)fminf(fmaxf(value, -32768.0F), 32767.0F);
+    }
+
+    fmac_filter_reset(filter_number);
+
+    return 0;
+}
+
+void fmac_filter_reset(uint8_t filter_number)
+{
+    if (filter_number >= CONFIG_OWNTECH_FMAC_MAX_FILTERS)
+    {
+        return;
+    }
+
+    /* The resident filter loads its coefficients and a cleared history on
+       its next run */
+    if ( (filter_number == FMAC_RESIDENT_FILTER) && (fmac_started == true) )
+    {
+        _fmac_stop();
+    }
+
+    memset(filters[filter_number].x_history, 0,
+           sizeof(filters[filter_number].x_history));
+    memset(filters[filter_number].y_history, 0,
+           sizeof(filters[filter_number].y_history));
+    filters[filter_number].x_position = 0;
+    filters[filter_number].y_position = 0;
+}
+
+int8_t fmac_filter_run(uint8_t filter_number,
+                       const int16_t* input,
+                       int16_t* output,
+                       uint16_t count)
+{
+    if ( (filter_number >= CONFIG_OWNTECH_FMAC_MAX_FILTERS) ||
+         (filters[filter_number].configured == false) )
+    {
+        return -1;
+    }
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    if (filter_number == FMAC_RESIDENT_FILTER)
+    {
+        return _fmac_hardware_run(input, output, count);
+    }
+
+    _fmac_software_run(&filters[filter_number], input, output, count);
+
+    return 0;
+}
@@ -337,12 +337,42 @@ void hrtim_dt_set(hrtim_tu_number_t tu_number,
 /**
  * @brief   Updates the duty cycle of a timing unit
  *
+ *          If the ADC trigger placement of the timing unit is not
+ *          `ADC_TRIG_FIXED`, the ADC trigger compare is recomputed and written
+ *          along with the duty cycle, with the update of the timing unit
+ *          suspended so that both values are applied on the same period.
+ *
  * @param[in] tu_number        Timing unit number:
  *                  `MSTR`, `TIMA`, `TIMB`, `TIMC`, `TIMD`, `TIME`, `TIMF`
  * @param[in] value        The desired duty cycle value
  */
 void hrtim_duty_cycle_set(hrtim_tu_number_t tu_number, uint16_t value);
 
+/**
+ * @brief   Holds the transfer of the preload registers of several timing
+ *          units to their active registers.
+ *
+ *          Values written until hrtim_update_resume() are all applied on the
+ *          same update event. This is used to change the duty cycle of
+ *          several legs in the same switching period.
+ *
+ * @param[in] tu_mask  OR-ed combination of timing units:
+ *                  `TIMA`, `TIMB`, `TIMC`, `TIMD`, `TIME`, `TIMF`
+ *
+ * @warning Keep the suspended section short: an update event missed while
+ *          the update is held is delayed to the next one.
+ */
+void hrtim_update_suspend(uint32_t tu_mask);
+
+/**
+ * @brief   Releases the update of timing units held by
+ *          hrtim_update_suspend().
+ *
+ * @param[in] tu_mask  OR-ed combination of timing units:
+ *                  `TIMA`, `TIMB`, `TIMC`, `TIMD`, `TIME`, `TIMF`
+ */
+void hrtim_update_resume(uint32_t tu_mask);
+
 /**
  * @brief   Shifts the PWM of a timing unit
  *
@@ -392,6 +422,129 @@ void hrtim_burst_stop(void);
  */
 void hrtim_burst_dis(void);
 
+/**
+ * @brief   Selects the registers of a timing unit that will be reloaded
+ *          from memory on each burst DMA transfer.
+ *
+ *          Several timing units can be selected. On each burst, the
+ *          registers are written in the hardware order: master first, then
+ *          TIMA to TIMF, and inside a timing unit by increasing register
+ *          address (PER, REP, CMP1, CMP2, CMP3, CMP4).
+ *
+ * @param[in] tu         Timing unit:
+ *                  `MSTR`, `TIMA`, `TIMB`, `TIMC`, `TIMD`, `TIME`, `TIMF`
+ * @param[in] registers  OR-ed combination of `hrtim_burst_dma_reg_t` values,
+ *                       0 to remove the timing unit from the burst.
+ */
+void hrtim_burst_dma_regs_set(hrtim_tu_t tu, uint32_t registers);
+
+/**
+ * @brief   Reads a register that can be reloaded by burst DMA.
+ *
+ * @param[in] tu   Timing unit:
+ *                  `MSTR`, `TIMA`, `TIMB`, `TIMC`, `TIMD`, `TIME`, `TIMF`
+ * @param[in] reg  Register, a single `hrtim_burst_dma_reg_t` value
+ *
+ * @return  Value of the preload register
+ */
+uint16_t hrtim_burst_dma_reg_get(hrtim_tu_t tu, hrtim_burst_dma_reg_t reg);
+
+/**
+ * @brief   Writes a register that can be reloaded by burst DMA.
+ *
+ * @param[in] tu     Timing unit:
+ *                  `MSTR`, `TIMA`, `TIMB`, `TIMC`, `TIMD`, `TIME`, `TIMF`
+ * @param[in] reg    Register, a single `hrtim_burst_dma_reg_t` value
+ * @param[in] value  Value written to the preload register
+ */
+void hrtim_burst_dma_reg_set(hrtim_tu_t tu,
+                             hrtim_burst_dma_reg_t reg,
+                             uint16_t value);
+
+/**
+ * @brief   Selects the update event of a timing unit: its own repetition
+ *          event (default), or the master update, so that it takes its
+ *          preload registers in the same period as the master.
+ *
+ * @param[in] tu      Timing unit: `TIMA`, `TIMB`, `TIMC`, `TIMD`, `TIME`, `TIMF`
+ * @param[in] enable  true to update on the master update, false to update
+ *                    on repetition
+ */
+void hrtim_master_update_set(hrtim_tu_t tu, bool enable);
+
+/**
+ * @brief   Starts streaming a table into the registers selected with
+ *          hrtim_burst_dma_regs_set().
+ *
+ *          One burst is requested on each repetition event of the trigger
+ *          timing unit. The values are written to the preload registers and
+ *          thus take effect on the next update. The table is read
+ *          circularly by DMA2 channel 1, whose interrupt only runs at the
+ *          end of the table to undo a hrtim_burst_dma_swap().
+ *
+ * @param[in] trigger_tu Timing unit whose repetition event requests a burst:
+ *                  `MSTR`, `TIMA`, `TIMB`, `TIMC`, `TIMD`, `TIME`, `TIMF`
+ * @param[in] table      Table of register values. Its content is interleaved
+ *                       burst by burst, one word per selected register.
+ *                       It must remain valid until hrtim_burst_dma_stop().
+ * @param[in] length     Number of words in the table. Must be a non-zero
+ *                       multiple of the number of selected registers.
+ *
+ * @return  0 if the streaming was started, -1 otherwise.
+ *
+ * @warning The shadow values kept by the driver (duty cycle, compare usage)
+ *          are not updated by the DMA. While streaming, hrtim_duty_cycle_set()
+ *          and hrtim_tu_cmp_set() on CMP3 only update the shadow values of
+ *          the streamed registers. Do not write them through the other
+ *          functions of this driver.
+ */
+int8_t hrtim_burst_dma_start(hrtim_tu_t trigger_tu,
+                             const uint32_t* table,
+                             uint16_t length);
+
+/**
+ * @brief   Replaces the streamed table, from the next burst.
+ *
+ *          Between two bursts, the DMA channel is moved to the same position
+ *          in the new table, which is then read circularly, and the
+ *          registers it selects are given the values of the last burst in
+ *          the new table, overwriting direct writes. The swap is
+ *          attempted a few times while a burst is in progress.
+ *
+ * @param[in] table  Table of the same length and layout as the one given
+ *                   to hrtim_burst_dma_start(). It must remain valid until
+ *                   the next swap or hrtim_burst_dma_stop(). The previous
+ *                   table is no longer read once the function succeeds.
+ *
+ * @return  0 if the table was swapped, -1 if streaming is stopped or every
+ *          attempt fell in a burst, the previous table being kept.
+ *
+ * @warning Call from the critical task, or with the DMA2 channel 1
+ *          interrupt masked: it must not preempt this function.
+ */
+int8_t hrtim_burst_dma_swap(const uint32_t* table);
+
+/**
+ * @brief   Sets the function called by hrtim_burst_dma_notify().
+ *
+ * @param[in] callback  Function called from the DMA2 channel 1 interrupt,
+ *                      at a kernel-aware priority, NULL for none.
+ */
+void hrtim_burst_dma_set_notify(hrtim_callback_t callback);
+
+/**
+ * @brief   Pends the DMA2 channel 1 interrupt to call the notify callback
+ *          while streaming. Allowed from the critical task, which must not
+ *          call kernel functions: the callback can, once it returns.
+ */
+void hrtim_burst_dma_notify(void);
+
+/**
+ * @brief   Stops burst DMA streaming. Registers keep the last value written.
+ *          The register selection is cleared for all timing units.
+ */
+void hrtim_burst_dma_stop(void);
+
 /**
  * @brief   Enables a timing unit counter
  *
@@ -570,6 +723,32 @@ void hrtim_adc_trigger_set(hrtim_tu_number_t tu_number,
  */
 hrtim_adc_trigger_t hrtim_adc_trigger_get(hrtim_tu_number_t tu_number);
 
+/**
+ * @brief Sets the ADC trigger placement mode of a timing unit
+ *
+ *        The trigger is placed `offset` away from the centre of the
+ *        on-time or of the off-time, and kept between its edges, which
+ *        move with every duty cycle update. The on-time is `[0, CMP1]`, or
+ *        `[CMP1, PER]` when the outputs are hot swapped. In center aligned
+ *        modulation, the centres are the valley and the crest of the
+ *        counter, and the trigger is placed `|offset|` after them.
+ *
+ * @param[in] tu_number Timing unit number:
+ *                  `MSTR`, `TIMA`, `TIMB`, `TIMC`, `TIMD`, `TIME`, `TIMF`
+ * @param[in] mode      `ADC_TRIG_FIXED`, `ADC_TRIG_MID_ON`, `ADC_TRIG_MID_OFF`
+ * @param[in] offset    Offset from the centre in timer ticks, positive to
+ *                      trigger later.
+ */
+void hrtim_adc_auto_trigger_set(hrtim_tu_number_t tu_number,
+                                hrtim_adc_auto_trigger_t mode,
+                                int16_t offset);
+
+/**
+ * @brief Returns the ADC trigger placement mode of a timing unit
+ * @return `ADC_TRIG_FIXED`, `ADC_TRIG_MID_ON`, `ADC_TRIG_MID_OFF`
+ */
+hrtim_adc_auto_trigger_t hrtim_adc_auto_trigger_get(hrtim_tu_number_t tu_number);
+
 /**
  * @brief Sets the external event used in current mode for a timing unit
  *
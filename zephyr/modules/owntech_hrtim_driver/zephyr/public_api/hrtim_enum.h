@@ -235,6 +235,22 @@ extern "C"
         TIMF_CMP3 = LL_HRTIM_ADCTRIG_SRC13_TIMFCMP3
     } hrtim_adc_source_t;
 
+    /**
+     * @brief   ADC trigger placement mode
+     *
+     * - `ADC_TRIG_FIXED`: trigger stays where it was set by the user
+     *
+     * - `ADC_TRIG_MID_ON`: trigger follows the centre of the on-time
+     *
+     * - `ADC_TRIG_MID_OFF`: trigger follows the centre of the off-time
+     */
+    typedef enum
+    {
+        ADC_TRIG_FIXED = 0,
+        ADC_TRIG_MID_ON = 1,
+        ADC_TRIG_MID_OFF = 2
+    } hrtim_adc_auto_trigger_t;
+
     /**
      * @brief   HRTIM comparators definition
      */
@@ -408,6 +424,35 @@ extern "C"
         BURST_TIMF = LL_HRTIM_BM_CLKSRC_TIMER_F
     } hrtim_burst_clk_t;
 
+    /**
+     * @brief  HRTIM registers that can be reloaded by the burst DMA controller
+     *
+     * - `BDMA_PER`  = `LL_HRTIM_BURSTDMA_TIMPER`
+     *
+     * - `BDMA_REP`  = `LL_HRTIM_BURSTDMA_TIMREP`
+     *
+     * - `BDMA_CMP1` = `LL_HRTIM_BURSTDMA_TIMCMP1`
+     *
+     * - `BDMA_CMP2` = `LL_HRTIM_BURSTDMA_TIMCMP2`
+     *
+     * - `BDMA_CMP3` = `LL_HRTIM_BURSTDMA_TIMCMP3`
+     *
+     * - `BDMA_CMP4` = `LL_HRTIM_BURSTDMA_TIMCMP4`
+     *
+     * @note Master and slave timing units share the same bit layout for
+     *       these registers, so the values can be used for `MSTR` too.
+     *       Values can be OR-ed to reload several registers per burst.
+     */
+    typedef enum
+    {
+        BDMA_PER  = LL_HRTIM_BURSTDMA_TIMPER,
+        BDMA_REP  = LL_HRTIM_BURSTDMA_TIMREP,
+        BDMA_CMP1 = LL_HRTIM_BURSTDMA_TIMCMP1,
+        BDMA_CMP2 = LL_HRTIM_BURSTDMA_TIMCMP2,
+        BDMA_CMP3 = LL_HRTIM_BURSTDMA_TIMCMP3,
+        BDMA_CMP4 = LL_HRTIM_BURSTDMA_TIMCMP4
+    } hrtim_burst_dma_reg_t;
+
     /**
      *  Structs
      */
@@ -497,6 +542,8 @@ extern "C"
         hrtim_adc_source_t adc_source;     /* ADC time unit linked to this event */
         hrtim_adc_trigger_t adc_trigger;   /* ADC trigger between source and event */
         hrtim_adc_edgetrigger_t adc_rollover; /* ADC rollover only relevant in center aligned */
+        hrtim_adc_auto_trigger_t auto_trigger; /* ADC trigger placement tracking the duty cycle */
+        int16_t auto_offset;               /* Offset of the tracked trigger from the centre */
     } adc_hrtim_conf_t;
 
     /**
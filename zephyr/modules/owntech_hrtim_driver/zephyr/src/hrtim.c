@@ -30,8 +30,12 @@
 
 /* include */
 #include <stm32_ll_rcc.h>
+#include <stm32_ll_dma.h>
 #include "assert.h"
 #include "hrtim.h"
+#include "ccm.h"
+#include "event_trace.h"
+#include "deferred_log.h"
 
 
 /** @brief Defines the HRTIM IRQ Number */
@@ -48,6 +52,30 @@ static uint32_t HRTIM_MINIM_FREQUENCY = TU_DEFAULT_FREQ;
 /** @brief User callback for ISR */
 static hrtim_callback_t user_callback = NULL;
 
+/** @brief DMA channel used to stream burst DMA tables (DMA2 is free) */
+static const uint32_t HRTIM_BURST_DMA_CHANNEL = LL_DMA_CHANNEL_1;
+/** @brief Defines the DMA2 channel 1 IRQ Number */
+static const uint8_t HRTIM_BURST_DMA_IRQ_NUMBER = 56;
+/** @brief Defines the DMA2 channel 1 IRQ Priority, below the HRTIM */
+static const uint8_t HRTIM_BURST_DMA_IRQ_PRIO = 1;
+/** @brief Attempts of a table swap falling in a burst */
+static const uint8_t HRTIM_BURST_DMA_SWAP_ATTEMPTS = 4;
+/** @brief Registers selected for burst DMA, TIMA to TIMF then master */
+static uint32_t burst_dma_regs[HRTIM_STU_NUMOF + 1] = {0};
+/** @brief Timing unit currently requesting the bursts */
+static hrtim_tu_t burst_dma_trigger = MSTR;
+/** @brief Burst DMA streaming state */
+static bool burst_dma_running = false;
+/** @brief Streamed table, its length and the length of a burst, in words */
+static const uint32_t* burst_dma_table = NULL;
+static uint16_t burst_dma_length = 0;
+static uint16_t burst_dma_burst_length = 0;
+/** @brief Called from the DMA2 channel 1 interrupt after a notification */
+static hrtim_callback_t burst_dma_notify_callback = NULL;
+static atomic_t burst_dma_notified = ATOMIC_INIT(0);
+/** @brief Timing units whose update is held by hrtim_update_suspend() */
+static uint32_t update_suspended = 0;
+
 /* Default values to initialize all the timer */
 
 /** @brief Listing all timing units, TIMA to TIMF */
@@ -108,6 +136,12 @@ static hrtim_adc_event_t tu_adc_events[HRTIM_STU_NUMOF] =
 static hrtim_adc_source_t tu_adc_source[HRTIM_STU_NUMOF] =
     {TIMA_CMP3, TIMB_CMP3, TIMC_CMP3, TIMD_CMP3, TIME_CMP3, TIMF_CMP3};
 
+/** @brief Sets the DMAMUX request of each timing unit, TIMA to TIMF then master */
+static uint32_t burst_dma_request[HRTIM_STU_NUMOF + 1] =
+    {LL_DMAMUX_REQ_HRTIM1_A, LL_DMAMUX_REQ_HRTIM1_B, LL_DMAMUX_REQ_HRTIM1_C,
+     LL_DMAMUX_REQ_HRTIM1_D, LL_DMAMUX_REQ_HRTIM1_E, LL_DMAMUX_REQ_HRTIM1_F,
+     LL_DMAMUX_REQ_HRTIM1_M};
+
 /** @brief Sets the external event trigger for each timing unit*/
 static hrtim_external_trigger_t tu_external_trig[HRTIM_STU_NUMOF] =
     {EEV4, EEV1, EEV5, EEV1, EEV1, EEV1};
@@ -372,8 +406,10 @@ static inline uint32_t _period_ckpsc(uint32_t freq, timer_hrtim_t *tu)
  * - Executes the user-defined callback if it is not `NULL`.
  *
  */
-void _hrtim_callback()
+OWNTECH_CCM_FUNC void _hrtim_callback()
 {
+    OWNTECH_TRACE(TRACE_EVENT_HRTIM_REP, 0);
+
     if (LL_HRTIM_GetSyncInSrc(HRTIM1) == LL_HRTIM_SYNCIN_SRC_NONE)
     {
         LL_HRTIM_ClearFlag_REP(HRTIM1, LL_HRTIM_TIMER_MASTER);
@@ -936,6 +972,21 @@ uint32_t hrtim_period_get_us(hrtim_tu_number_t tu_number)
            (1<<timerMaster.pwm_conf.ckpsc);
 }
 
+/**
+ * @brief PRIVATE FUNCTION - Tells whether burst DMA streams a register of a
+ *        timing unit. Its streamed value must not be overwritten: direct
+ *        writes only update the driver shadow values.
+ *
+ * @param tu_number Timing unit number: `PWMA` to `PWMF`
+ * @param reg       Register, a single `hrtim_burst_dma_reg_t` value
+ */
+static inline bool _burst_dma_streams(hrtim_tu_number_t tu_number,
+                                      hrtim_burst_dma_reg_t reg)
+{
+    return (burst_dma_running == true) &&
+           ((burst_dma_regs[tu_number] & reg) != 0);
+}
+
 /* CMP1, CMP2 and CMP3 must not be changed in current mode since they are used */
 void hrtim_tu_cmp_set(hrtim_tu_number_t tu_number, hrtim_cmp_t cmp, uint16_t value)
 {
@@ -964,7 +1015,10 @@ void hrtim_tu_cmp_set(hrtim_tu_number_t tu_number, hrtim_cmp_t cmp, uint16_t val
         }
         break;
     case CMP3xR:
-        HRTIM1->sTimerxRegs[tu_number].CMP3xR = value;
+        if (_burst_dma_streams(tu_number, BDMA_CMP3) == false)
+        {
+            HRTIM1->sTimerxRegs[tu_number].CMP3xR = value;
+        }
         // LL_HRTIM_TIM_SetCompare3(HRTIM1,
         //                          tu_channel[tu_number]->pwm_conf.pwm_tu,
         //                          value);
@@ -1090,10 +1144,145 @@ void hrtim_dt_set(hrtim_tu_number_t tu_number, uint16_t rise_ns, uint16_t fall_n
                                rise_dt);
 }
 
-inline void hrtim_duty_cycle_set(hrtim_tu_number_t tu_number, uint16_t value)
+/**
+ * @brief PRIVATE FUNCTION - Computes the ADC trigger compare value tracking
+ *        the duty cycle of a timing unit.
+ *
+ * The switch driven by the duty cycle is on while the counter is below
+ * CMP1, and above it when the outputs are hot swapped to reach 100%. The
+ * trigger is placed from the edges of the sampled interval, on-time or
+ * off-time: at its centre in left aligned modulation, at the valley or the
+ * crest it is centred on in center aligned modulation, where the counter
+ * only reaches the half of the interval after the centre. The offset moves
+ * it from there, and the trigger is then kept between the edges.
+ *
+ * @param tu_number Timing unit number: `PWMA` to `PWMF`
+ * @param duty      Value written to CMP1
+ * @return          Value to write to CMP3
+ */
+static uint16_t _adc_auto_trigger_value(hrtim_tu_number_t tu_number,
+                                        uint16_t duty)
+{
+    timer_hrtim_t *tu = tu_channel[tu_number];
+    int32_t period = tu->pwm_conf.period;
+    int32_t offset = tu->adc_hrtim.auto_offset;
+    int32_t min_value = HRTIM_MIN_PER_and_CMP_REG_VALUES[tu->pwm_conf.ckpsc];
+    bool below_cmp1 = (tu->adc_hrtim.auto_trigger == ADC_TRIG_MID_ON) !=
+                      (tu->pwm_conf.duty_swap == true);
+    int32_t first_edge = (below_cmp1) ? 0 : duty;
+    int32_t last_edge = (below_cmp1) ? duty : period;
+    int32_t trigger;
+
+    if (tu->pwm_conf.modulation == UpDwn)
+    {
+        /* The counter value of an instant after the centre is also the one
+           of the instant as far before it */
+        if (offset < 0)
+        {
+            offset = -offset;
+        }
+
+        trigger = (below_cmp1) ? offset : (period - offset);
+    }
+    else
+    {
+        trigger = (first_edge + last_edge) / 2 + offset;
+    }
+
+    /* Away from the edges, or at the centre of a too short interval */
+    if (last_edge - first_edge < 2 * min_value)
+    {
+        trigger = (first_edge + last_edge) / 2;
+    }
+    else if (trigger < first_edge + min_value)
+    {
+        trigger = first_edge + min_value;
+    }
+    else if (trigger > last_edge - min_value)
+    {
+        trigger = last_edge - min_value;
+    }
+
+    if (trigger < min_value)
+    {
+        trigger = min_value;
+    }
+    else if (trigger > period - min_value)
+    {
+        trigger = period - min_value;
+    }
+
+    return (uint16_t)trigger;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Rewrites the tracking ADC trigger from the
+ *        current duty cycle of a timing unit.
+ *
+ * @param tu_number Timing unit number: `PWMA` to `PWMF`
+ */
+static void _adc_auto_trigger_update(hrtim_tu_number_t tu_number)
+{
+    if (tu_channel[tu_number]->adc_hrtim.auto_trigger == ADC_TRIG_FIXED)
+    {
+        return;
+    }
+
+    uint16_t trigger =
+        _adc_auto_trigger_value(tu_number,
+                                tu_channel[tu_number]->pwm_conf.duty_cycle);
+
+    if (_burst_dma_streams(tu_number, BDMA_CMP3) == false)
+    {
+        HRTIM1->sTimerxRegs[tu_number].CMP3xR = trigger;
+    }
+    tu_channel[tu_number]->comp_usage.cmp3 = USED;
+    tu_channel[tu_number]->comp_usage.cmp3_value = trigger;
+}
+
+OWNTECH_CCM_FUNC void hrtim_duty_cycle_set(hrtim_tu_number_t tu_number, uint16_t value)
 {
     tu_channel[tu_number]->pwm_conf.duty_cycle = value;
+
+    if (_burst_dma_streams(tu_number, BDMA_CMP1) == true)
+    {
+        _adc_auto_trigger_update(tu_number);
+        return;
+    }
+
+    if (tu_channel[tu_number]->adc_hrtim.auto_trigger == ADC_TRIG_FIXED)
+    {
+        HRTIM1->sTimerxRegs[tu_number].CMP1xR = value;
+        return;
+    }
+
+    hrtim_tu_t tu = tu_channel[tu_number]->pwm_conf.pwm_tu;
+
+    /* Update already held by the caller, do not release it here */
+    if (update_suspended & tu)
+    {
+        HRTIM1->sTimerxRegs[tu_number].CMP1xR = value;
+        _adc_auto_trigger_update(tu_number);
+        return;
+    }
+
+    /* Both compares must be transferred on the same update event */
+    LL_HRTIM_SuspendUpdate(HRTIM1, tu);
     HRTIM1->sTimerxRegs[tu_number].CMP1xR = value;
+    _adc_auto_trigger_update(tu_number);
+    LL_HRTIM_ResumeUpdate(HRTIM1, tu);
+}
+
+void hrtim_update_suspend(uint32_t tu_mask)
+{
+    update_suspended |= tu_mask;
+    LL_HRTIM_SuspendUpdate(HRTIM1, tu_mask);
+}
+
+void hrtim_update_resume(uint32_t tu_mask)
+{
+    update_suspended &= ~tu_mask;
+    LL_HRTIM_ResumeUpdate(HRTIM1, tu_mask);
 }
 
 
@@ -1342,6 +1531,324 @@ void hrtim_burst_dis(void){
     LL_HRTIM_BM_Disable(HRTIM1);
 }
 
+/**
+ * @brief PRIVATE FUNCTION - Returns the index of a timing unit in the
+ *        burst DMA tables.
+ *
+ * @param tu Timing unit: `MSTR`, `TIMA`, `TIMB`, `TIMC`, `TIMD`, `TIME`, `TIMF`
+ * @return 0 to 5 for `TIMA` to `TIMF`, `HRTIM_STU_NUMOF` for the master.
+ */
+static uint8_t _burst_dma_index(hrtim_tu_t tu)
+{
+    for (uint8_t tu_count = 0; tu_count < HRTIM_STU_NUMOF; tu_count++)
+    {
+        if (list_tu[tu_count] == tu)
+        {
+            return tu_count;
+        }
+    }
+
+    return HRTIM_STU_NUMOF;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Halts the burst DMA requests and the DMA channel
+ *        without touching the register selection.
+ */
+static void _burst_dma_halt(void)
+{
+    if (burst_dma_running == true)
+    {
+        LL_HRTIM_DisableDMAReq_REP(HRTIM1, burst_dma_trigger);
+        LL_DMA_DisableChannel(DMA2, HRTIM_BURST_DMA_CHANNEL);
+        irq_disable(HRTIM_BURST_DMA_IRQ_NUMBER);
+        burst_dma_running = false;
+    }
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Enables the disabled DMA channel on the current
+ *        table, a number of words before its end.
+ *
+ *        The channel restarts from its memory address register, and reloads
+ *        it with the count at the end of the table: after a restart in the
+ *        middle of the table, the transfer complete interrupt moves it back
+ *        to the start.
+ *
+ * @param remaining Number of words left before the end of the table
+ */
+static void _burst_dma_restart(uint32_t remaining)
+{
+    LL_DMA_SetMemoryAddress(DMA2,
+                            HRTIM_BURST_DMA_CHANNEL,
+                            (uintptr_t)&burst_dma_table[burst_dma_length -
+                                                        remaining]);
+    LL_DMA_SetDataLength(DMA2, HRTIM_BURST_DMA_CHANNEL, remaining);
+    LL_DMA_EnableChannel(DMA2, HRTIM_BURST_DMA_CHANNEL);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Writes the preload registers with the last burst
+ *        read before a position of the current table, as if the table had
+ *        been streamed all along: the master, then timers A to F, each in
+ *        increasing register order.
+ *
+ * @param remaining Number of words left before the end of the table
+ */
+static void _burst_dma_reload(uint32_t remaining)
+{
+    uint32_t position = burst_dma_length - remaining;
+
+    if (position == 0)
+    {
+        position = burst_dma_length;
+    }
+
+    const uint32_t* value = &burst_dma_table[position - burst_dma_burst_length];
+
+    for (uint8_t tu_count = 0; tu_count <= HRTIM_STU_NUMOF; tu_count++)
+    {
+        uint8_t index = (tu_count == 0) ? HRTIM_STU_NUMOF : tu_count - 1U;
+        hrtim_tu_t tu = (tu_count == 0) ? MSTR : list_tu[index];
+        uint32_t registers = burst_dma_regs[index];
+
+        while (registers != 0)
+        {
+            uint32_t reg = registers & -registers;
+
+            hrtim_burst_dma_reg_set(tu, (hrtim_burst_dma_reg_t)reg, *value++);
+            registers &= ~reg;
+        }
+    }
+}
+
+/**
+ * @brief PRIVATE FUNCTION - DMA2 channel 1 interrupt. Calls the notify
+ *        callback when pended by hrtim_burst_dma_notify(). On transfer
+ *        complete, at the end of the table, restarts the channel on the
+ *        whole table: runs before the next burst, a repetition period later.
+ */
+static void _burst_dma_callback(const void* arg)
+{
+    ARG_UNUSED(arg);
+
+    if ( (atomic_clear(&burst_dma_notified) != 0) &&
+         (burst_dma_notify_callback != NULL) )
+    {
+        burst_dma_notify_callback();
+    }
+
+    if (LL_DMA_IsActiveFlag_TC1(DMA2) == 0)
+    {
+        return;
+    }
+
+    LL_DMA_DisableChannel(DMA2, HRTIM_BURST_DMA_CHANNEL);
+    LL_DMA_ClearFlag_TC1(DMA2);
+    _burst_dma_restart(burst_dma_length);
+}
+
+void hrtim_burst_dma_regs_set(hrtim_tu_t tu, uint32_t registers)
+{
+    burst_dma_regs[_burst_dma_index(tu)] = registers;
+    LL_HRTIM_TIM_SetBurstDMARegs(HRTIM1, tu, registers);
+}
+
+uint16_t hrtim_burst_dma_reg_get(hrtim_tu_t tu, hrtim_burst_dma_reg_t reg)
+{
+    switch (reg)
+    {
+    case BDMA_PER:
+        return LL_HRTIM_TIM_GetPeriod(HRTIM1, tu);
+    case BDMA_REP:
+        return LL_HRTIM_TIM_GetRepetition(HRTIM1, tu);
+    case BDMA_CMP1:
+        return LL_HRTIM_TIM_GetCompare1(HRTIM1, tu);
+    case BDMA_CMP2:
+        return LL_HRTIM_TIM_GetCompare2(HRTIM1, tu);
+    case BDMA_CMP3:
+        return LL_HRTIM_TIM_GetCompare3(HRTIM1, tu);
+    default:
+        return LL_HRTIM_TIM_GetCompare4(HRTIM1, tu);
+    }
+}
+
+void hrtim_burst_dma_reg_set(hrtim_tu_t tu,
+                             hrtim_burst_dma_reg_t reg,
+                             uint16_t value)
+{
+    switch (reg)
+    {
+    case BDMA_PER:
+        LL_HRTIM_TIM_SetPeriod(HRTIM1, tu, value);
+        break;
+    case BDMA_REP:
+        LL_HRTIM_TIM_SetRepetition(HRTIM1, tu, value);
+        break;
+    case BDMA_CMP1:
+        LL_HRTIM_TIM_SetCompare1(HRTIM1, tu, value);
+        break;
+    case BDMA_CMP2:
+        LL_HRTIM_TIM_SetCompare2(HRTIM1, tu, value);
+        break;
+    case BDMA_CMP3:
+        LL_HRTIM_TIM_SetCompare3(HRTIM1, tu, value);
+        break;
+    default:
+        LL_HRTIM_TIM_SetCompare4(HRTIM1, tu, value);
+        break;
+    }
+}
+
+void hrtim_master_update_set(hrtim_tu_t tu, bool enable)
+{
+    LL_HRTIM_TIM_SetUpdateTrig(HRTIM1,
+                               tu,
+                               (enable == true) ?
+                               LL_HRTIM_UPDATETRIG_MASTER :
+                               LL_HRTIM_UPDATETRIG_REPETITION);
+}
+
+int8_t hrtim_burst_dma_start(hrtim_tu_t trigger_tu,
+                             const uint32_t* table,
+                             uint16_t length)
+{
+    uint16_t burst_length = 0;
+
+    for (uint8_t tu_count = 0; tu_count <= HRTIM_STU_NUMOF; tu_count++)
+    {
+        burst_length += __builtin_popcount(burst_dma_regs[tu_count]);
+    }
+
+    if ( (table == NULL) || (burst_length == 0) ||
+         (length == 0)   || (length % burst_length != 0) )
+    {
+        return -1;
+    }
+
+    _burst_dma_halt();
+
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMAMUX1);
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA2);
+
+    /* Circular memory to BDMADR transfer, one 32-bit word per register */
+    LL_DMA_ConfigTransfer(DMA2,
+                          HRTIM_BURST_DMA_CHANNEL,
+                          LL_DMA_DIRECTION_MEMORY_TO_PERIPH |
+                          LL_DMA_MODE_CIRCULAR              |
+                          LL_DMA_PERIPH_NOINCREMENT         |
+                          LL_DMA_MEMORY_INCREMENT           |
+                          LL_DMA_PDATAALIGN_WORD            |
+                          LL_DMA_MDATAALIGN_WORD            |
+                          LL_DMA_PRIORITY_VERYHIGH);
+
+    LL_DMA_ConfigAddresses(DMA2,
+                           HRTIM_BURST_DMA_CHANNEL,
+                           (uintptr_t)table,
+                           (uintptr_t)&(HRTIM1->sCommonRegs.BDMADR),
+                           LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+
+    LL_DMA_SetDataLength(DMA2, HRTIM_BURST_DMA_CHANNEL, length);
+
+    LL_DMA_SetPeriphRequest(DMA2,
+                            HRTIM_BURST_DMA_CHANNEL,
+                            burst_dma_request[_burst_dma_index(trigger_tu)]);
+
+    burst_dma_table = table;
+    burst_dma_length = length;
+    burst_dma_burst_length = burst_length;
+
+    LL_DMA_ClearFlag_TC1(DMA2);
+    LL_DMA_EnableIT_TC(DMA2, HRTIM_BURST_DMA_CHANNEL);
+
+    IRQ_CONNECT(HRTIM_BURST_DMA_IRQ_NUMBER,
+                HRTIM_BURST_DMA_IRQ_PRIO,
+                _burst_dma_callback,
+                NULL,
+                0);
+    irq_enable(HRTIM_BURST_DMA_IRQ_NUMBER);
+
+    LL_DMA_EnableChannel(DMA2, HRTIM_BURST_DMA_CHANNEL);
+
+    /* Values are loaded in preload registers and applied on next update,
+       which is itself triggered on repetition event */
+    LL_HRTIM_EnableDMAReq_REP(HRTIM1, trigger_tu);
+
+    burst_dma_trigger = trigger_tu;
+    burst_dma_running = true;
+
+    return 0;
+}
+
+int8_t hrtim_burst_dma_swap(const uint32_t* table)
+{
+    if ( (burst_dma_running == false) || (table == NULL) )
+    {
+        return -1;
+    }
+
+    for (uint8_t attempt = 0; attempt < HRTIM_BURST_DMA_SWAP_ATTEMPTS;
+         attempt++)
+    {
+        LL_DMA_DisableChannel(DMA2, HRTIM_BURST_DMA_CHANNEL);
+
+        uint32_t remaining = LL_DMA_GetDataLength(DMA2, HRTIM_BURST_DMA_CHANNEL);
+
+        /* End of the table not handled by the interrupt yet */
+        if (LL_DMA_IsActiveFlag_TC1(DMA2) != 0)
+        {
+            LL_DMA_ClearFlag_TC1(DMA2);
+            remaining = burst_dma_length;
+        }
+
+        /* A burst in progress resumes on the current table */
+        bool between_bursts = (remaining % burst_dma_burst_length) == 0;
+
+        /* The preload registers may have been written since the last
+           burst: gives them the values of the new table, before a burst
+           pending on the halted channel overwrites them */
+        if (between_bursts == true)
+        {
+            burst_dma_table = table;
+            _burst_dma_reload(remaining);
+        }
+
+        _burst_dma_restart(remaining);
+
+        if (between_bursts == true)
+        {
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+void hrtim_burst_dma_set_notify(hrtim_callback_t callback)
+{
+    burst_dma_notify_callback = callback;
+}
+
+void hrtim_burst_dma_notify(void)
+{
+    if (burst_dma_running == true)
+    {
+        atomic_or(&burst_dma_notified, 1);
+        NVIC_SetPendingIRQ((IRQn_Type)HRTIM_BURST_DMA_IRQ_NUMBER);
+    }
+}
+
+void hrtim_burst_dma_stop(void)
+{
+    _burst_dma_halt();
+
+    hrtim_burst_dma_regs_set(MSTR, 0);
+    for (uint8_t tu_count = 0; tu_count < HRTIM_STU_NUMOF; tu_count++)
+    {
+        hrtim_burst_dma_regs_set(list_tu[tu_count], 0);
+    }
+}
+
 void hrtim_cnt_en(hrtim_tu_number_t tu_number)
 {
     LL_HRTIM_TIM_CounterEnable(HRTIM1, tu_channel[tu_number]->pwm_conf.pwm_tu);
@@ -1410,6 +1917,21 @@ hrtim_adc_trigger_t hrtim_adc_trigger_get(hrtim_tu_number_t tu_number)
     return tu_channel[tu_number]->adc_hrtim.adc_trigger;
 }
 
+void hrtim_adc_auto_trigger_set(hrtim_tu_number_t tu_number,
+                                hrtim_adc_auto_trigger_t mode,
+                                int16_t offset)
+{
+    tu_channel[tu_number]->adc_hrtim.auto_trigger = mode;
+    tu_channel[tu_number]->adc_hrtim.auto_offset = offset;
+
+    _adc_auto_trigger_update(tu_number);
+}
+
+hrtim_adc_auto_trigger_t hrtim_adc_auto_trigger_get(hrtim_tu_number_t tu_number)
+{
+    return tu_channel[tu_number]->adc_hrtim.auto_trigger;
+}
+
 void hrtim_adc_rollover_set(hrtim_tu_number_t tu_number,
                             hrtim_adc_edgetrigger_t adc_rollover)
 {
@@ -1560,11 +2082,13 @@ void hrtim_change_frequency(uint32_t new_frequency)
                 tu_channel[channel]->pwm_conf.duty_cycle = new_duty;
                 tu_channel[channel]->phase_shift.value = new_shift;
                 tu_channel[channel]->pwm_conf.period = new_tu_period;
+
+                _adc_auto_trigger_update(channel);
             }
 
 
     }else{
-        printk("Minimum frequency = %d \n", timerMaster.pwm_conf.min_frequency);
+        OWNTECH_LOG("Minimum frequency = %d \n", timerMaster.pwm_conf.min_frequency);
     }
 }
 
@@ -1594,6 +2118,9 @@ void hrtim_output_hot_swap(hrtim_tu_number_t tu_number){
             tu_channel[tu_number]->pwm_conf.duty_swap = 0;        
         }
     }
+
+    /* On-time of the driven switch is inverted by the swap */
+    _adc_auto_trigger_update(tu_number);
 }
 
 uint32_t hrtim_get_resolution_ps(hrtim_tu_number_t tu_number)
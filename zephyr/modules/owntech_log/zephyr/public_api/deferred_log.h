@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Deferred logging for interrupts and hot paths.
+ *
+ *         OWNTECH_LOG(format, ...) stores the format string address and up
+ *         to 4 arguments in a ring buffer, and returns. A low priority
+ *         thread formats the stored messages on the console every
+ *         CONFIG_OWNTECH_DEFERRED_LOG_PERIOD_MS. Writers never wait, and
+ *         never take a lock: the ring can be written from any interrupt,
+ *         zero latency ones included. A message is dropped when the ring is
+ *         full, and the number of dropped messages is printed.
+ *
+ *         As formatting happens later, arguments are restricted to
+ *         integers, characters and pointers to strings that stay valid,
+ *         such as string literals or device names. Floating point values
+ *         are not supported.
+ *
+ *         Without CONFIG_OWNTECH_DEFERRED_LOG, OWNTECH_LOG() calls printk()
+ *         directly.
+ *
+ *         E.g.:
+ *             OWNTECH_LOG("Minimum frequency = %d\n", min_frequency);
+ */
+
+#ifndef DEFERRED_LOG_H_
+#define DEFERRED_LOG_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+#ifdef CONFIG_OWNTECH_DEFERRED_LOG
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Store a message. Use OWNTECH_LOG() instead, which takes a variable
+ *        number of arguments.
+ *
+ * @param format Format string, which must stay valid: a string literal.
+ * @param arg0   First argument of the format, 0 if none, and so on.
+ */
+void deferred_log_write(const char* format,
+                        uintptr_t arg0,
+                        uintptr_t arg1,
+                        uintptr_t arg2,
+                        uintptr_t arg3);
+
+/**
+ * @brief Print the stored messages now, from the calling thread, e.g.
+ *        before a reset.
+ */
+void deferred_log_flush(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#define _OWNTECH_LOG_ARG(x) ((uintptr_t)(x))
+
+#define _OWNTECH_LOG_0(format) \
+	deferred_log_write(format, 0, 0, 0, 0)
+#define _OWNTECH_LOG_1(format, a) \
+	deferred_log_write(format, _OWNTECH_LOG_ARG(a), 0, 0, 0)
+#define _OWNTECH_LOG_2(format, a, b) \
+	deferred_log_write(format, _OWNTECH_LOG_ARG(a), \
+	                   _OWNTECH_LOG_ARG(b), 0, 0)
+#define _OWNTECH_LOG_3(format, a, b, c) \
+	deferred_log_write(format, _OWNTECH_LOG_ARG(a), \
+	                   _OWNTECH_LOG_ARG(b), _OWNTECH_LOG_ARG(c), 0)
+#define _OWNTECH_LOG_4(format, a, b, c, d) \
+	deferred_log_write(format, _OWNTECH_LOG_ARG(a), \
+	                   _OWNTECH_LOG_ARG(b), _OWNTECH_LOG_ARG(c), \
+	                   _OWNTECH_LOG_ARG(d))
+
+#define _OWNTECH_LOG_SELECT(_0, _1, _2, _3, _4, name, ...) name
+
+#define OWNTECH_LOG(...) \
+	_OWNTECH_LOG_SELECT(__VA_ARGS__, _OWNTECH_LOG_4, _OWNTECH_LOG_3, \
+	                    _OWNTECH_LOG_2, _OWNTECH_LOG_1, \
+	                    _OWNTECH_LOG_0, unused)(__VA_ARGS__)
+
+#else
+
+#include <zephyr/kernel.h>
+
+#define OWNTECH_LOG(...) printk(__VA_ARGS__)
+
+#endif /* CONFIG_OWNTECH_DEFERRED_LOG */
+
+#endif /* DEFERRED_LOG_H_ */
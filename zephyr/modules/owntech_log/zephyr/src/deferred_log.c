@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Deferred log ring: bounded multiple producer, single consumer
+ *         queue. Each record holds a sequence number telling whether it is
+ *         free for a given write position, or written and ready to print.
+ *         Writers reserve a position with a compare and swap, fill the
+ *         record, then publish its sequence: a writer preempted between
+ *         both only delays printing, and never blocks another writer.
+ */
+
+
+/* Stdlib */
+#include <stdbool.h>
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+
+/* Current module header */
+#include "deferred_log.h"
+
+
+/* Positions are masked with the size */
+BUILD_ASSERT((CONFIG_OWNTECH_DEFERRED_LOG_BUFFER_SIZE &
+              (CONFIG_OWNTECH_DEFERRED_LOG_BUFFER_SIZE - 1)) == 0,
+             "CONFIG_OWNTECH_DEFERRED_LOG_BUFFER_SIZE must be a power of two");
+
+#define LOG_RING_MASK (CONFIG_OWNTECH_DEFERRED_LOG_BUFFER_SIZE - 1)
+
+#define LOG_THREAD_PRIORITY K_LOWEST_APPLICATION_THREAD_PRIO
+
+typedef struct
+{
+	/* Sequence minus the record index, so that a zeroed ring is free for
+	 * its first lap and needs no initialization: writers may log before
+	 * any init function ran. */
+	uint32_t    sequence;
+	const char* format;
+	uintptr_t   args[4];
+} log_record_t;
+
+
+/**
+ *  Local variables
+ */
+
+static log_record_t log_ring[CONFIG_OWNTECH_DEFERRED_LOG_BUFFER_SIZE];
+
+static uint32_t log_head = 0;
+static uint32_t log_tail = 0;
+static uint32_t log_dropped = 0;
+static uint32_t log_dropped_reported = 0;
+
+/* Serializes the log thread and deferred_log_flush() */
+K_MUTEX_DEFINE(log_print_mutex);
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Reads the sequence of the record of a position.
+ */
+static inline uint32_t _deferred_log_get_sequence(uint32_t position)
+{
+	return __atomic_load_n(&log_ring[position & LOG_RING_MASK].sequence,
+	                       __ATOMIC_ACQUIRE) + (position & LOG_RING_MASK);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Publishes the sequence of the record of a
+ *        position.
+ */
+static inline void _deferred_log_set_sequence(uint32_t position,
+                                              uint32_t sequence)
+{
+	__atomic_store_n(&log_ring[position & LOG_RING_MASK].sequence,
+	                 sequence - (position & LOG_RING_MASK),
+	                 __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Prints the ready records, frees each one before
+ *        printing it, then reports the messages dropped since last time.
+ */
+static void _deferred_log_print()
+{
+	k_mutex_lock(&log_print_mutex, K_FOREVER);
+
+	while (_deferred_log_get_sequence(log_tail) == log_tail + 1)
+	{
+		log_record_t record = log_ring[log_tail & LOG_RING_MASK];
+
+		_deferred_log_set_sequence(log_tail,
+		                           log_tail + CONFIG_OWNTECH_DEFERRED_LOG_BUFFER_SIZE);
+		log_tail++;
+
+		/* Arguments beyond those of the format are ignored */
+		printk(record.format, record.args[0], record.args[1],
+		       record.args[2], record.args[3]);
+	}
+
+	uint32_t dropped = __atomic_load_n(&log_dropped, __ATOMIC_RELAXED);
+
+	if (dropped != log_dropped_reported)
+	{
+		printk("%u log messages dropped\n",
+		       (unsigned int)(dropped - log_dropped_reported));
+		log_dropped_reported = dropped;
+	}
+
+	k_mutex_unlock(&log_print_mutex);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Log thread: prints the stored messages
+ *        periodically.
+ */
+static void _deferred_log_thread(void* p1, void* p2, void* p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1)
+	{
+		k_msleep(CONFIG_OWNTECH_DEFERRED_LOG_PERIOD_MS);
+		_deferred_log_print();
+	}
+}
+
+K_THREAD_DEFINE(deferred_log_thread_id,
+                CONFIG_OWNTECH_DEFERRED_LOG_STACK_SIZE,
+                _deferred_log_thread, NULL, NULL, NULL,
+                LOG_THREAD_PRIORITY, 0, 0);
+
+
+/* Public API */
+
+void deferred_log_write(const char* format,
+                        uintptr_t arg0,
+                        uintptr_t arg1,
+                        uintptr_t arg2,
+                        uintptr_t arg3)
+{
+	uint32_t position = __atomic_load_n(&log_head, __ATOMIC_RELAXED);
+
+	while (1)
+	{
+		int32_t difference = (int32_t)(_deferred_log_get_sequence(position) -
+		                               position);
+
+		if (difference == 0)
+		{
+			/* Record free for this position: reserve it. On failure,
+			 * position is updated with the current head. */
+			if (__atomic_compare_exchange_n(&log_head, &position, position + 1,
+			                                true,
+			                                __ATOMIC_RELAXED,
+			                                __ATOMIC_RELAXED))
+				break;
+		}
+		else if (difference < 0)
+		{
+			/* Record of the previous lap not printed yet: ring full */
+			__atomic_fetch_add(&log_dropped, 1, __ATOMIC_RELAXED);
+			return;
+		}
+		else
+		{
+			/* Another writer reserved this position */
+			position = __atomic_load_n(&log_head, __ATOMIC_RELAXED);
+		}
+	}
+
+	log_record_t* record = &log_ring[position & LOG_RING_MASK];
+
+	record->format  = format;
+	record->args[0] = arg0;
+	record->args[1] = arg1;
+	record->args[2] = arg2;
+	record->args[3] = arg3;
+
+	_deferred_log_set_sequence(position, position + 1);
+}
+
+void deferred_log_flush(void)
+{
+	_deferred_log_print();
+}
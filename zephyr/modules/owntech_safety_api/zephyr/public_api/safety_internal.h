@@ -44,4 +44,11 @@
 */
 int8_t safety_task();
 
+/**
+ * @brief Stops the power stage and applies the configured reaction
+ *        (open-circuit or short-circuit). Used by the uninterruptible
+ *        task when it overruns its period.
+ */
+void safety_action();
+
 #endif /* SAFETY_INTERNAL_H_ */
@@ -41,6 +41,13 @@
 /* Zephyr */
 #include "zephyr/kernel.h"
 
+/* Critical path placement */
+#include "ccm.h"
+
+/* Event trace and deferred log */
+#include "event_trace.h"
+#include "deferred_log.h"
+
 /* Defines */
 
 /**
@@ -156,7 +163,7 @@ int8_t safety_set_sensor_watch(sensor_t * safety_sensors,
 {
     if (sensors_number > DT_SENSORS_NUMBER)
     {
-        printk("ERROR: number of sensors superior to number of sensors defined \
+        OWNTECH_LOG("ERROR: number of sensors superior to number of sensors defined \
                 in device tree");
 
         return -1;
@@ -187,7 +194,7 @@ int8_t safety_unset_sensor_watch(sensor_t * safety_sensors,
 {
     if (sensors_number > DT_SENSORS_NUMBER)
     {
-        printk("ERROR: number of sensors superior to number of sensors defined \
+        OWNTECH_LOG("ERROR: number of sensors superior to number of sensors defined \
                 in device tree");
         return -1;
     }
@@ -227,7 +234,7 @@ int8_t safety_set_sensor_threshold_max(sensor_t *safety_sensors,
 {
     if (sensors_number > DT_SENSORS_NUMBER)
     {
-        printk("ERROR: number of sensors superior to number of sensors defined \
+        OWNTECH_LOG("ERROR: number of sensors superior to number of sensors defined \
                 in device tree");
 
         return -1;
@@ -250,7 +257,7 @@ int8_t safety_set_sensor_threshold_min(sensor_t *safety_sensors,
 {
     if (sensors_number > DT_SENSORS_NUMBER)
     {
-        printk("ERROR: number of sensors superior to number of sensors defined \
+        OWNTECH_LOG("ERROR: number of sensors superior to number of sensors defined \
                 in device tree");
 
         return -1;
@@ -291,7 +298,7 @@ bool safety_get_sensor_error(sensor_t safety_sensor)
 /**
  * @brief Monitors measures that needs to be watched for safety purpose
  */
-int8_t safety_watch()
+OWNTECH_CCM_FUNC int8_t safety_watch()
 {
     uint8_t status = 0;
 
@@ -303,11 +310,17 @@ int8_t safety_watch()
                     shield.sensors.peekLatestValue(static_cast<sensor_t>(i));
 
             if (measure != -10000){
-                sensor_errors[i] =
-                    (measure > sensor_threshold_max[i] ||
-                     measure < sensor_threshold_min[i])
-                     ? true
-                     : false;
+                bool error = (measure > sensor_threshold_max[i] ||
+                              measure < sensor_threshold_min[i])
+                              ? true
+                              : false;
+
+                if (error && !sensor_errors[i])
+                {
+                    OWNTECH_TRACE(TRACE_EVENT_SAFETY_ALERT, i);
+                }
+
+                sensor_errors[i] = error;
             }
             if (sensor_errors[i])
                 status = -1;
@@ -322,6 +335,8 @@ int8_t safety_watch()
  */
 void safety_action()
 {
+    OWNTECH_TRACE(TRACE_EVENT_SAFETY_TRIP, sensor_reaction);
+
     /* shield.power.stopAll(); */
     shield.power.stop(ALL);
     if (sensor_reaction == Open_Circuit)
@@ -356,7 +371,7 @@ void safety_disable_task()
  *        However, to avoid false triggering from transient phenomenon
  *        we wait for a delay with safety_alert_counter.
  */
-int8_t safety_task()
+OWNTECH_CCM_FUNC int8_t safety_task()
 {
     int8_t status = 0;
 
@@ -29,6 +29,9 @@
 /* Current Header */
 #include "safety_shield.h"
 
+/* OwnTech deferred log */
+#include "deferred_log.h"
+
 #define THRESHOLD_WRITE_PROP(node_id) \
         { \
             .sensor = DT_STRING_TOKEN(node_id, sensor_name),\
@@ -71,7 +74,7 @@ void safety_init_shield(bool watch_all)
 
         if(rc != 0)
         {
-            printk("%s value not found in static storage. \
+            OWNTECH_LOG("%s value not found in static storage. \
                     Default value will be used \n", dt_threshold_props[i].name);
 
             safety_set_sensor_threshold_max(
@@ -88,8 +91,8 @@ void safety_init_shield(bool watch_all)
         }
         else
         {
-            printk("%s value found in static storage.\n",
-                   dt_threshold_props[i].name);
+            OWNTECH_LOG("%s value found in static storage.\n",
+                        dt_threshold_props[i].name);
         }
 
         if(watch_all)
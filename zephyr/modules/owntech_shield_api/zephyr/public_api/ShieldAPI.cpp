@@ -34,6 +34,10 @@ ShieldAPI shield;
 PowerAPI ShieldAPI::power;
 SensorsAPI ShieldAPI::sensors;
 
+#ifdef CONFIG_OWNTECH_SHIELD_THREE_PHASE
+ThreePhaseAPI ShieldAPI::threephase;
+#endif
+
 #ifdef CONFIG_OWNTECH_NGND_DRIVER
 NgndHAL ShieldAPI::ngnd;
 #endif
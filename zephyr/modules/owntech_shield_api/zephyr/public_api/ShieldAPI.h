@@ -32,6 +32,10 @@
 #include "../src/Sensors.h"
 #include "../src/Power.h"
 
+#ifdef CONFIG_OWNTECH_SHIELD_THREE_PHASE
+#include "../src/ThreePhase.h"
+#endif
+
 
 /* Static class definition */
 
@@ -49,6 +53,14 @@ public:
 	 */
 	static PowerAPI power;
 
+#ifdef CONFIG_OWNTECH_SHIELD_THREE_PHASE
+	/**
+	 * @brief Contains all the functions to drive three legs as a
+	 * 		  three-phase inverter
+	 */
+	static ThreePhaseAPI threephase;
+#endif
+
 #ifdef CONFIG_OWNTECH_NGND_DRIVER
 	/**
 	 * @brief Contains all the function of the NGND switch compatible
@@ -29,6 +29,208 @@
 #include "Power.h"
 #include "SpinAPI.h"
 
+#ifdef CONFIG_OWNTECH_SHIELD_SPREAD_SPECTRUM
+
+/* Registers reloaded for each unit, in burst DMA order */
+#define DITHER_REGS_PER_UNIT 5
+/* Smallest burst: master period plus period, duty and trigger of one leg */
+#define DITHER_MAX_STEPS (CONFIG_OWNTECH_SHIELD_SPREAD_SPECTRUM_TABLE_SIZE / 4)
+#define DITHER_MIN_STEPS 4
+#define DITHER_MAX_SLOTS (DITHER_REGS_PER_UNIT * (HRTIM_STU_NUMOF + 1))
+
+static const hrtim_burst_dma_reg_t dither_regs[DITHER_REGS_PER_UNIT] =
+    {BDMA_PER, BDMA_CMP1, BDMA_CMP2, BDMA_CMP3, BDMA_CMP4};
+
+/* The DMA streams one table while the other one is rewritten */
+static uint32_t dither_tables[2][CONFIG_OWNTECH_SHIELD_SPREAD_SPECTRUM_TABLE_SIZE];
+static uint8_t dither_streamed = 0;
+
+/* Period ratio of each step, 16.16 fixed point */
+static uint32_t dither_ratio[DITHER_MAX_STEPS];
+
+/* Nominal value, timing unit and register of each slot of a burst */
+static uint16_t dither_nominal[DITHER_MAX_SLOTS];
+static hrtim_tu_t dither_slot_tu[DITHER_MAX_SLOTS];
+static uint8_t dither_slot_reg[DITHER_MAX_SLOTS];
+
+/**
+ * Rounding of each slot once scaled, added before the 16-bit shift. The
+ * master period is rounded down and leg periods up: legs reset by the
+ * master keep a period at least as long as its own, as with the nominal
+ * values, and do not roll over just before being reset.
+ */
+static uint16_t dither_rounding[DITHER_MAX_SLOTS];
+
+/* Nominal value of each slot in each table */
+static uint16_t dither_table_nominal[2][DITHER_MAX_SLOTS];
+
+/* Slot of the duty cycle and ADC trigger compares of each leg unit */
+static int8_t dither_cmp1_slot[HRTIM_STU_NUMOF];
+static int8_t dither_cmp3_slot[HRTIM_STU_NUMOF];
+
+static uint16_t dither_burst_length = 0;
+static uint16_t dither_steps = 0;
+static bool dither_active = false;
+
+/**
+ * Tables are rebuilt by a background thread, woken through the burst DMA
+ * interrupt as the critical task can not give a semaphore. The critical
+ * task only updates the nominal values, and swaps in a rebuilt table.
+ */
+#define DITHER_THREAD_STACK_SIZE 512
+static const int DITHER_THREAD_PRIORITY = 5;
+
+static K_THREAD_STACK_DEFINE(dither_thread_stack, DITHER_THREAD_STACK_SIZE);
+static struct k_thread dither_thread;
+static bool dither_thread_started = false;
+static K_SEM_DEFINE(dither_request, 0, 1);
+
+/* Set when a nominal value changed, cleared when a rebuild reads them */
+static atomic_t dither_outdated = ATOMIC_INIT(0);
+
+/* Table not streamed: being rebuilt, ready to stream, or being swapped in */
+#define DITHER_SPARE_IDLE     0
+#define DITHER_SPARE_READY    1
+#define DITHER_SPARE_SWAPPING 2
+static atomic_t dither_spare_state = ATOMIC_INIT(DITHER_SPARE_IDLE);
+
+/**
+ * @brief PRIVATE FUNCTION - Writes a slot in every step of a table, from
+ *        its nominal value scaled by the period ratio of the step.
+ *
+ * @param table   Table index, 0 or 1
+ * @param slot    Slot in the burst
+ * @param nominal Nominal value of the slot
+ */
+static void _ditherWriteSlot(uint8_t table, uint8_t slot, uint16_t nominal)
+{
+    uint32_t* value = &dither_tables[table][slot];
+
+    for (uint16_t step = 0; step < dither_steps; step++)
+    {
+        *value = (uint32_t)(((uint64_t)nominal * dither_ratio[step] +
+                             dither_rounding[slot]) >> 16);
+        value += dither_burst_length;
+    }
+
+    dither_table_nominal[table][slot] = nominal;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Updates the nominal value of a slot. The tables
+ *        are rebuilt in the background after _ditherCommit().
+ *
+ * @param slot  Slot in the burst, negative values are ignored
+ * @param value New nominal value
+ */
+static void _ditherUpdateSlot(int8_t slot, uint16_t value)
+{
+    if ( (slot < 0) || (dither_nominal[slot] == value) )
+    {
+        return;
+    }
+
+    dither_nominal[slot] = value;
+    atomic_set(&dither_outdated, 1);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Swaps in the table not streamed once it is
+ *        rebuilt. Called by the critical task and by the background thread,
+ *        the state tells which one swaps. If the DMA is busy, the swap is
+ *        retried on the next commit.
+ */
+static void _ditherSwap()
+{
+    if (atomic_cas(&dither_spare_state,
+                   DITHER_SPARE_READY,
+                   DITHER_SPARE_SWAPPING) == false)
+    {
+        return;
+    }
+
+    uint8_t spare = 1 - dither_streamed;
+
+    if (spin.pwm.swapWaveformTable(dither_tables[spare]) == 0)
+    {
+        dither_streamed = spare;
+        atomic_set(&dither_spare_state, DITHER_SPARE_IDLE);
+    }
+    else
+    {
+        atomic_set(&dither_spare_state, DITHER_SPARE_READY);
+    }
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Streams the nominal values updated since the
+ *        last call: swaps in a table rebuilt meanwhile, and requests the
+ *        rebuild of the outdated one. Bounded, for the critical task.
+ */
+static void _ditherCommit()
+{
+    _ditherSwap();
+
+    if (atomic_get(&dither_outdated) != 0)
+    {
+        hrtim_burst_dma_notify();
+    }
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Burst DMA interrupt notification: wakes the
+ *        background thread.
+ */
+static void _ditherNotify()
+{
+    k_sem_give(&dither_request);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Background thread: rewrites the outdated slots
+ *        of the table not streamed from the nominal values, then swaps it
+ *        in. Values updated meanwhile are rebuilt in another table.
+ */
+static void _ditherThread(void* p1, void* p2, void* p3)
+{
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (1)
+    {
+        k_sem_take(&dither_request, K_FOREVER);
+
+        /* The streamed table only changes on a swap, once this one is
+           ready */
+        while ( (dither_active == true) &&
+                (atomic_get(&dither_spare_state) == DITHER_SPARE_IDLE) &&
+                (atomic_clear(&dither_outdated) != 0) )
+        {
+            uint8_t spare = 1 - dither_streamed;
+
+            for (uint8_t slot = 0; slot < dither_burst_length; slot++)
+            {
+                uint16_t nominal = dither_nominal[slot];
+
+                if (dither_table_nominal[spare][slot] != nominal)
+                {
+                    _ditherWriteSlot(spare, slot, nominal);
+                }
+            }
+
+            atomic_set(&dither_spare_state, DITHER_SPARE_READY);
+
+            /* The swap must not be preempted by the burst DMA interrupt */
+            unsigned int key = irq_lock();
+            _ditherSwap();
+            irq_unlock(key);
+        }
+    }
+}
+
+#endif
+
 
 hrtim_tu_number_t PowerAPI::spinNumberToTu(uint16_t spin_number)
 {
@@ -276,9 +478,46 @@ void PowerAPI::setDutyCycleRaw(leg_t leg, uint16_t duty_value)
                 hrtim_duty_cycle_set(leg_tu, duty_value);
             }
         }
+
+#ifdef CONFIG_OWNTECH_SHIELD_SPREAD_SPECTRUM
+        if (dither_active == true)
+        {
+            _ditherUpdateSlot(dither_cmp1_slot[leg_tu], duty_value);
+
+            if (hrtim_adc_auto_trigger_get(leg_tu) != ADC_TRIG_FIXED)
+            {
+                _ditherUpdateSlot(dither_cmp3_slot[leg_tu],
+                                  tu_channel[leg_tu]->comp_usage.cmp3_value);
+            }
+
+            _ditherCommit();
+        }
+#endif
     }
 }
 
+void PowerAPI::setDutyCycleRawSync(const leg_t* legs,
+                                   const uint16_t* duty_values,
+                                   uint8_t leg_count)
+{
+    uint32_t tu_mask = 0;
+
+    for (uint8_t i = 0; i < leg_count; i++)
+    {
+        tu_mask |= tu_channel[spinNumberToTu(dt_pwm_pin[legs[i]])]
+                       ->pwm_conf.pwm_tu;
+    }
+
+    hrtim_update_suspend(tu_mask);
+
+    for (uint8_t i = 0; i < leg_count; i++)
+    {
+        setDutyCycleRaw(legs[i], duty_values[i]);
+    }
+
+    hrtim_update_resume(tu_mask);
+}
+
 void PowerAPI::start(leg_t leg)
 {
     int8_t startIndex = 0;
@@ -548,6 +787,52 @@ void PowerAPI::setTriggerValue(leg_t leg, float32_t trigger_value)
     {
         spin.pwm.setAdcTriggerInstant(spinNumberToTu(dt_pwm_pin[i]),
                                       trigger_value);
+
+#ifdef CONFIG_OWNTECH_SHIELD_SPREAD_SPECTRUM
+        if (dither_active == true)
+        {
+            hrtim_tu_number_t leg_tu = spinNumberToTu(dt_pwm_pin[i]);
+            _ditherUpdateSlot(dither_cmp3_slot[leg_tu],
+                              trigger_value * hrtim_period_get(leg_tu));
+        }
+#endif
+    }
+
+#ifdef CONFIG_OWNTECH_SHIELD_SPREAD_SPECTRUM
+    if (dither_active == true)
+    {
+        _ditherCommit();
+    }
+#endif
+}
+
+void PowerAPI::setTriggerTracking(leg_t leg,
+                                  hrtim_adc_auto_trigger_t mode,
+                                  float32_t offset)
+{
+    int8_t startIndex = 0;
+    int8_t endIndex = 0;
+
+    /*  If ALL is selected, loop through all legs */
+    if(leg == ALL)
+    {
+        startIndex = 0;
+        /* retrieves the total number of legs */
+        endIndex = dt_leg_count;
+    }
+    else
+    {
+        /* Treat `leg` as the specific leg index */
+        startIndex = leg;
+        /* Only iterate for this specific leg */
+        endIndex = leg + 1;
+    }
+
+    for (int8_t i = startIndex; i < endIndex; i++)
+    {
+        spin.pwm.setAdcTriggerTracking(spinNumberToTu(dt_pwm_pin[i]),
+                                       mode,
+                                       offset);
     }
 }
 
@@ -860,3 +1145,338 @@ void PowerAPI::initBoost(leg_t leg)
         }
     }
 }
+
+int8_t PowerAPI::initBurstController(float32_t enter_current,
+                                     float32_t exit_current,
+                                     uint16_t period)
+{
+    if ( (exit_current <= enter_current) || (period < 2) )
+    {
+        return -1;
+    }
+
+    burst_enter_current = enter_current;
+    burst_exit_current = exit_current;
+    burst_period = period;
+    burst_idle = 0;
+    burst_active = false;
+
+    spin.pwm.initBurstMode();
+    burst_initialized = true;
+
+    return 0;
+}
+
+bool PowerAPI::updateBurstController(float32_t load_current)
+{
+    if (burst_initialized == false)
+    {
+        return false;
+    }
+
+    /* Hysteresis between entering and leaving burst mode */
+    if ( (burst_active == true) && (load_current > burst_exit_current) )
+    {
+        spin.pwm.stopBurstMode();
+        burst_active = false;
+        burst_idle = 0;
+
+        if (burst_callback != nullptr)
+        {
+            burst_callback(false);
+        }
+
+        return false;
+    }
+
+    if ( (burst_active == false) && (load_current >= burst_enter_current) )
+    {
+        return false;
+    }
+
+    /**
+     * Active periods follow the load current, with at least one active
+     * and one idle period in each burst pattern.
+     */
+    float32_t load_ratio = load_current / burst_enter_current;
+
+    if (load_ratio < 0)
+    {
+        load_ratio = 0;
+    }
+    else if (load_ratio > 1)
+    {
+        load_ratio = 1;
+    }
+
+    uint16_t active = 1 + load_ratio * (burst_period - 2);
+    uint16_t idle = burst_period - active;
+
+    if (idle != burst_idle)
+    {
+        spin.pwm.setBurstMode(idle, burst_period);
+        burst_idle = idle;
+    }
+
+    if (burst_active == false)
+    {
+        spin.pwm.startBurstMode();
+        burst_active = true;
+
+        if (burst_callback != nullptr)
+        {
+            burst_callback(true);
+        }
+    }
+
+    return true;
+}
+
+bool PowerAPI::isBurstActive()
+{
+    return burst_active;
+}
+
+void PowerAPI::setBurstCallback(burst_callback_t callback)
+{
+    burst_callback = callback;
+}
+
+void PowerAPI::deInitBurstController()
+{
+    if (burst_initialized == true)
+    {
+        spin.pwm.deInitBurstMode();
+    }
+
+    if ( (burst_active == true) && (burst_callback != nullptr) )
+    {
+        burst_callback(false);
+    }
+
+    burst_active = false;
+    burst_initialized = false;
+    burst_idle = 0;
+}
+
+#ifdef CONFIG_OWNTECH_SHIELD_SPREAD_SPECTRUM
+
+int8_t PowerAPI::startSpreadSpectrum(dither_profile_t profile,
+                                     float32_t spread,
+                                     uint32_t modulation_frequency)
+{
+    bool is_leg_unit[HRTIM_STU_NUMOF] = {false};
+    hrtim_tu_number_t leg_tu;
+    hrtim_tu_t tu;
+    uint32_t registers;
+    uint16_t value;
+
+    if (dither_active == true)
+    {
+        stopSpreadSpectrum();
+    }
+
+    if ( (spread <= 0) || (spread > 0.5) || (modulation_frequency == 0) )
+    {
+        return -1;
+    }
+
+    leg_tu = spinNumberToTu(dt_pwm_pin[0]);
+    uint32_t frequency = tu_channel[leg_tu]->pwm_conf.frequency;
+
+    /* The lowest frequency must be reachable with the current prescaler */
+    if (frequency * (1 - spread / 2) < hrtim_get_min_frequency(leg_tu))
+    {
+        return -1;
+    }
+
+    for (uint8_t i = 0; i < dt_leg_count; i++)
+    {
+        is_leg_unit[spinNumberToTu(dt_pwm_pin[i])] = true;
+    }
+
+    /**
+     * Snapshot the registers in burst DMA order: master first, then leg
+     * units from TIMA to TIMF, PER then CMP1 to CMP4 inside each unit.
+     * Period, duty cycle and ADC trigger of legs are always reloaded,
+     * other compares only when they are in use (phase shift).
+     */
+    dither_burst_length = 0;
+
+    for (int8_t unit = -1; unit < (int8_t)HRTIM_STU_NUMOF; unit++)
+    {
+        if (unit < 0)
+        {
+            tu = MSTR;
+        }
+        else if (is_leg_unit[unit] == true)
+        {
+            tu = tu_channel[unit]->pwm_conf.pwm_tu;
+            dither_cmp1_slot[unit] = -1;
+            dither_cmp3_slot[unit] = -1;
+        }
+        else
+        {
+            continue;
+        }
+
+        registers = 0;
+
+        for (uint8_t reg = 0; reg < DITHER_REGS_PER_UNIT; reg++)
+        {
+            value = hrtim_burst_dma_reg_get(tu, dither_regs[reg]);
+
+            bool leg_register = (unit >= 0) && (reg == 1 || reg == 3);
+
+            if ( (reg == 0) || leg_register || (value != 0) )
+            {
+                if (unit >= 0 && reg == 1)
+                {
+                    dither_cmp1_slot[unit] = dither_burst_length;
+                }
+                else if (unit >= 0 && reg == 3)
+                {
+                    dither_cmp3_slot[unit] = dither_burst_length;
+                }
+
+                if (reg != 0)
+                {
+                    dither_rounding[dither_burst_length] = 0x8000;
+                }
+                else
+                {
+                    dither_rounding[dither_burst_length] = (unit < 0) ? 0
+                                                                      : 0xFFFF;
+                }
+
+                dither_nominal[dither_burst_length]  = value;
+                dither_slot_tu[dither_burst_length]  = tu;
+                dither_slot_reg[dither_burst_length] = reg;
+                dither_burst_length++;
+
+                registers |= dither_regs[reg];
+            }
+        }
+
+        spin.pwm.setWaveformRegisters(tu, registers);
+    }
+
+    /* One step per control task period */
+    uint32_t task_frequency = frequency / spin.pwm.getPeriodEvntRep(MSTR);
+    dither_steps = task_frequency / modulation_frequency;
+
+    if (dither_steps > DITHER_MAX_STEPS)
+    {
+        dither_steps = DITHER_MAX_STEPS;
+    }
+    if (dither_steps * dither_burst_length >
+        CONFIG_OWNTECH_SHIELD_SPREAD_SPECTRUM_TABLE_SIZE)
+    {
+        dither_steps =
+            CONFIG_OWNTECH_SHIELD_SPREAD_SPECTRUM_TABLE_SIZE /
+            dither_burst_length;
+    }
+    if (dither_steps < DITHER_MIN_STEPS)
+    {
+        spin.pwm.stopWaveformTable();
+        return -1;
+    }
+
+    /* Compute the period ratio of each step */
+    uint16_t lfsr = 0xACE1;
+    float32_t deviation;
+
+    for (uint16_t step = 0; step < dither_steps; step++)
+    {
+        if (profile == dither_triangular)
+        {
+            float32_t position = (float32_t)step / dither_steps;
+            deviation = (position < 0.5f) ? (4 * position - 1)
+                                          : (3 - 4 * position);
+        }
+        else
+        {
+            /* 16-bit Galois LFSR, maximal length */
+            lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+            deviation = 2 * ((float32_t)lfsr / 0xFFFF) - 1;
+        }
+
+        dither_ratio[step] =
+            (uint32_t)(65536 / (1 + deviation * spread / 2) + 0.5f);
+    }
+
+    for (uint8_t table = 0; table < 2; table++)
+    {
+        for (uint16_t slot = 0; slot < dither_burst_length; slot++)
+        {
+            _ditherWriteSlot(table, slot, dither_nominal[slot]);
+        }
+    }
+
+    if (dither_thread_started == false)
+    {
+        k_thread_create(&dither_thread,
+                        dither_thread_stack,
+                        K_THREAD_STACK_SIZEOF(dither_thread_stack),
+                        _ditherThread,
+                        NULL, NULL, NULL,
+                        DITHER_THREAD_PRIORITY,
+                        0,
+                        K_NO_WAIT);
+        hrtim_burst_dma_set_notify(_ditherNotify);
+        dither_thread_started = true;
+    }
+
+    /* Legs take the new values on master update, together with the master */
+    for (uint8_t unit = 0; unit < HRTIM_STU_NUMOF; unit++)
+    {
+        if (is_leg_unit[unit] == true)
+        {
+            hrtim_master_update_set(tu_channel[unit]->pwm_conf.pwm_tu, true);
+        }
+    }
+
+    dither_active = true;
+    dither_streamed = 0;
+    atomic_clear(&dither_outdated);
+    atomic_set(&dither_spare_state, DITHER_SPARE_IDLE);
+
+    if (spin.pwm.startWaveformTable(MSTR,
+                                    dither_tables[0],
+                                    dither_steps * dither_burst_length) != 0)
+    {
+        stopSpreadSpectrum();
+        return -1;
+    }
+
+    return 0;
+}
+
+void PowerAPI::stopSpreadSpectrum()
+{
+    if (dither_active == false)
+    {
+        return;
+    }
+
+    spin.pwm.stopWaveformTable();
+
+    /* Restore nominal values, including duty cycle updates done meanwhile */
+    for (uint16_t slot = 0; slot < dither_burst_length; slot++)
+    {
+        hrtim_burst_dma_reg_set(dither_slot_tu[slot],
+                                dither_regs[dither_slot_reg[slot]],
+                                dither_nominal[slot]);
+    }
+
+    for (uint8_t i = 0; i < dt_leg_count; i++)
+    {
+        hrtim_master_update_set(
+            tu_channel[spinNumberToTu(dt_pwm_pin[i])]->pwm_conf.pwm_tu,
+            false);
+    }
+
+    dither_active = false;
+}
+
+#endif
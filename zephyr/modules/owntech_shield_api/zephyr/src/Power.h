@@ -50,12 +50,43 @@ typedef enum
 	ALL
 } leg_t;
 
+/**
+ * @brief Function called by the light-load burst controller when burst mode
+ * 		  is entered (`active` is `true`) or left (`active` is `false`).
+ */
+typedef void (*burst_callback_t)(bool active);
+
+#ifdef CONFIG_OWNTECH_SHIELD_SPREAD_SPECTRUM
+/**
+ * @brief Frequency profile used by the spread-spectrum mode.
+ *
+ * 			- `dither_triangular` - frequency sweeps linearly up and down
+ *
+ * 			- `dither_pseudo_random` - frequency follows a fixed
+ * 			  pseudo-random sequence
+ */
+typedef enum
+{
+	dither_triangular,
+	dither_pseudo_random
+} dither_profile_t;
+#endif
+
 class PowerAPI
 {
 private:
 	/* return timing unit from spin pin number */
 	hrtim_tu_number_t spinNumberToTu(uint16_t spin_number);
 
+	/* Light-load burst controller state */
+	bool burst_active = false;
+	bool burst_initialized = false;
+	float32_t burst_enter_current = 0;
+	float32_t burst_exit_current = 0;
+	uint16_t burst_period = 0;
+	uint16_t burst_idle = 0;
+	burst_callback_t burst_callback = nullptr;
+
 
 public:
 	/**
@@ -103,6 +134,25 @@ public:
 	 */
 	void setDutyCycleRaw(leg_t leg, uint16_t duty_value);
 
+	/**
+	 * @brief Set the duty cycle of several legs in the same switching period.
+	 *
+	 * The update of the legs is held while the duty cycles are written, so
+	 * that they all take effect on the same update event. Use it for legs
+	 * that must not be updated separately, e.g. the three phases of an
+	 * inverter.
+	 *
+	 * @param legs        Array of legs to update: `LEG1` to `LEG5`.
+	 * @param duty_values Array of duty cycle values as unsigned integers,
+	 * 					  one per leg, clamped like in setDutyCycleRaw().
+	 * @param leg_count   Number of legs in the arrays.
+	 *
+	 * @warning `ALL` is NOT supported !
+	 */
+	void setDutyCycleRawSync(const leg_t* legs,
+							 const uint16_t* duty_values,
+							 uint8_t leg_count);
+
 
 	/**
 	 * @brief Start power output for a specific leg.
@@ -178,9 +228,37 @@ public:
 	 *
 	 * @param leg The leg for which to set the ADC trigger value: `LEG1` to `ALL`
 	 * @param trigger_value The trigger value to set between 0.05 and 0.95.
+	 *
+	 * @note This disables the trigger tracking set by setTriggerTracking().
 	 */
 	void setTriggerValue(leg_t leg, float32_t trigger_value);
 
+	/**
+	 * @brief Make the ADC trigger of a leg follow its duty cycle.
+	 *
+	 * On every duty cycle update, the trigger is moved to the centre of the
+	 * on-time or of the off-time, away from the switching edges and their
+	 * ringing. The trigger is written in the same register update as the
+	 * duty cycle, so there is no need to call setTriggerValue() in the
+	 * control task anymore.
+	 *
+	 * @param leg  The leg for which to track the duty cycle: `LEG1` to `ALL`
+	 * @param mode `ADC_TRIG_MID_ON` to sample at the centre of the on-time,
+	 * 			   `ADC_TRIG_MID_OFF` at the centre of the off-time,
+	 * 			   `ADC_TRIG_FIXED` to stop tracking.
+	 * @param offset Offset from the centre as a fraction of the period,
+	 * 				 positive to sample later. E.g. `0.02` compensates for a
+	 * 				 sensor delay of 2% of the period.
+	 *
+	 * @note The trigger is kept between the edges of the sampled interval.
+	 * 		 In center aligned modulation, the centres of the on and off
+	 * 		 times are the valley and the crest of the counter: the offset
+	 * 		 moves the trigger after them, up to the nearest edge.
+	 */
+	void setTriggerTracking(leg_t leg,
+							hrtim_adc_auto_trigger_t mode,
+							float32_t offset = 0);
+
 	/**
 	 * @brief Set the phase shift value for a specific leg's power control.
 	 *
@@ -324,6 +402,114 @@ public:
 	 */
 	void initBoost(leg_t leg);
 
+	/**
+	 * @brief Initializes the light-load burst controller.
+	 *
+	 * Under light load, the controller skips PWM periods using the HRTIM
+	 * burst mode to cut switching losses. It enters burst mode when the
+	 * load current falls below `enter_current` and leaves it when the
+	 * current rises above `exit_current`. While in burst mode, the ratio of
+	 * active periods follows the load current.
+	 *
+	 * @param enter_current Load current below which burst mode is entered.
+	 * @param exit_current  Load current above which burst mode is left,
+	 * 						must be greater than `enter_current`.
+	 * @param period        Number of PWM periods in a burst pattern
+	 * 						(active and idle), between `2` and `65535`.
+	 *
+	 * @return `0` if the controller was initialized, `-1` otherwise.
+	 *
+	 * @warning This function can only be called AFTER initializing the legs.
+	 */
+	int8_t initBurstController(float32_t enter_current,
+							   float32_t exit_current,
+							   uint16_t period = 32);
+
+	/**
+	 * @brief Updates the light-load burst controller with the measured
+	 * 		  load current. To be called from the critical task.
+	 *
+	 * @param load_current Measured load current, in the same unit as the
+	 * 					   thresholds given to initBurstController().
+	 *
+	 * While burst mode is active, the outputs are idle during part of the
+	 * periods, and the control loop must not integrate the error of those
+	 * periods. It must either skip its integrators while
+	 * isBurstActive() returns `true`, or hold and reset them from the
+	 * function given to setBurstCallback().
+	 *
+	 * @return `true` while burst mode is active.
+	 */
+	bool updateBurstController(float32_t load_current);
+
+	/**
+	 * @brief Sets the function called when burst mode is entered or left.
+	 *
+	 * The function runs in updateBurstController(), in the critical task,
+	 * before the control loop computes its next duty cycle. It is meant to
+	 * freeze the integrators of the control loop when burst mode is
+	 * entered, and to reset them to the last duty cycle when it is left,
+	 * so that the loop restarts without a bump.
+	 * It is also called by deInitBurstController() if burst mode was
+	 * active.
+	 *
+	 * @param callback Function to call, or `nullptr` to remove it.
+	 */
+	void setBurstCallback(burst_callback_t callback);
+
+	/**
+	 * @brief Returns the state of the light-load burst controller.
+	 *
+	 * @return `true` if burst mode is currently active.
+	 */
+	bool isBurstActive();
+
+	/**
+	 * @brief Leaves burst mode if active and disables the controller.
+	 */
+	void deInitBurstController();
+
+#ifdef CONFIG_OWNTECH_SHIELD_SPREAD_SPECTRUM
+	/**
+	 * @brief Starts the spread-spectrum mode on all the legs.
+	 *
+	 * The switching frequency is dithered around its current value.
+	 * Period, duty cycle, ADC trigger and phase shift registers are
+	 * scaled together on each step so that they stay proportional to the
+	 * period, dead time stays constant in nanoseconds. Registers are
+	 * reloaded by the HRTIM burst DMA on each control task period, from
+	 * one of two tables: duty cycle and trigger updates are written to
+	 * the other one by a background thread, which then swaps them. The
+	 * critical task only records the values, an update applies on a
+	 * following control period.
+	 *
+	 * @param profile Frequency profile: `dither_triangular` or
+	 * 				  `dither_pseudo_random`
+	 * @param spread  Total frequency excursion relative to the nominal
+	 * 				  frequency, between `0` and `0.5`. E.g. `0.1` dithers
+	 * 				  a 200kHz switching frequency from 190kHz to 210kHz.
+	 * @param modulation_frequency Repetition rate of the profile in Hz.
+	 *
+	 * @return `0` if the mode was started, `-1` if the parameters cannot
+	 * 		   be reached with the current frequency and table size.
+	 *
+	 * @warning Must be called AFTER the legs and the critical task are
+	 * 			initialized. Phase shift, dead time and frequency must not be
+	 * 			changed while the mode is active. Duty cycle and trigger
+	 * 			value can be updated with the usual functions, from the
+	 * 			critical task.
+	 */
+	int8_t startSpreadSpectrum(dither_profile_t profile,
+							   float32_t spread,
+							   uint32_t modulation_frequency);
+
+	/**
+	 * @brief Stops the spread-spectrum mode and restores the nominal
+	 * 		  frequency.
+	 */
+	void stopSpreadSpectrum();
+#endif
+
 };
 
 #endif /* POWER_H_ */
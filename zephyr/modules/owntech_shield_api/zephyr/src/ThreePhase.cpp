@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+#include "power_init.h"
+#include "ThreePhase.h"
+#include "ShieldAPI.h"
+#include "cordic_transforms.h"
+
+/* Number of points of the sine table over one turn */
+#define SIN_TABLE_SIZE 256
+#define SIN_TABLE_SCALE (SIN_TABLE_SIZE / (2.0F * PI))
+
+/* One turn of sine, plus the first point again to interpolate the last one */
+static const float32_t sin_table[SIN_TABLE_SIZE + 1] =
+{
+	+0.00000000f, +0.02454123f, +0.04906767f, +0.07356456f,
+	+0.09801714f, +0.12241068f, +0.14673047f, +0.17096189f,
+	+0.19509032f, +0.21910124f, +0.24298018f, +0.26671276f,
+	+0.29028468f, +0.31368174f, +0.33688985f, +0.35989504f,
+	+0.38268343f, +0.40524131f, +0.42755509f, +0.44961133f,
+	+0.47139674f, +0.49289819f, +0.51410274f, +0.53499762f,
+	+0.55557023f, +0.57580819f, +0.59569930f, +0.61523159f,
+	+0.63439328f, +0.65317284f, +0.67155895f, +0.68954054f,
+	+0.70710678f, +0.72424708f, +0.74095113f, +0.75720885f,
+	+0.77301045f, +0.78834643f, +0.80320753f, +0.81758481f,
+	+0.83146961f, +0.84485357f, +0.85772861f, +0.87008699f,
+	+0.88192126f, +0.89322430f, +0.90398929f, +0.91420976f,
+	+0.92387953f, +0.93299280f, +0.94154407f, +0.94952818f,
+	+0.95694034f, +0.96377607f, +0.97003125f, +0.97570213f,
+	+0.98078528f, +0.98527764f, +0.98917651f, +0.99247953f,
+	+0.99518473f, +0.99729046f, +0.99879546f, +0.99969882f,
+	+1.00000000f, +0.99969882f, +0.99879546f, +0.99729046f,
+	+0.99518473f, +0.99247953f, +0.98917651f, +0.98527764f,
+	+0.98078528f, +0.97570213f, +0.97003125f, +0.96377607f,
+	+0.95694034f, +0.94952818f, +0.94154407f, +0.93299280f,
+	+0.92387953f, +0.91420976f, +0.90398929f, +0.89322430f,
+	+0.88192126f, +0.87008699f, +0.85772861f, +0.84485357f,
+	+0.83146961f, +0.81758481f, +0.80320753f, +0.78834643f,
+	+0.77301045f, +0.75720885f, +0.74095113f, +0.72424708f,
+	+0.70710678f, +0.68954054f, +0.67155895f, +0.65317284f,
+	+0.63439328f, +0.61523159f, +0.59569930f, +0.57580819f,
+	+0.55557023f, +0.53499762f, +0.51410274f, +0.49289819f,
+	+0.47139674f, +0.44961133f, +0.42755509f, +0.40524131f,
+	+0.38268343f, +0.35989504f, +0.33688985f, +0.31368174f,
+	+0.29028468f, +0.26671276f, +0.24298018f, +0.21910124f,
+	+0.19509032f, +0.17096189f, +0.14673047f, +0.12241068f,
+	+0.09801714f, +0.07356456f, +0.04906767f, +0.02454123f,
+	+0.00000000f, -0.02454123f, -0.04906767f, -0.07356456f,
+	-0.09801714f, -0.12241068f, -0.14673047f, -0.17096189f,
+	-0.19509032f, -0.21910124f, -0.24298018f, -0.26671276f,
+	-0.29028468f, -0.31368174f, -0.33688985f, -0.35989504f,
+	-0.38268343f, -0.40524131f, -0.42755509f, -0.44961133f,
+	-0.47139674f, -0.49289819f, -0.51410274f, -0.53499762f,
+	-0.55557023f, -0.57580819f, -0.59569930f, -0.61523159f,
+	-0.63439328f, -0.65317284f, -0.67155895f, -0.68954054f,
+	-0.70710678f, -0.72424708f, -0.74095113f, -0.75720885f,
+	-0.77301045f, -0.78834643f, -0.80320753f, -0.81758481f,
+	-0.83146961f, -0.84485357f, -0.85772861f, -0.87008699f,
+	-0.88192126f, -0.89322430f, -0.90398929f, -0.91420976f,
+	-0.92387953f, -0.93299280f, -0.94154407f, -0.94952818f,
+	-0.95694034f, -0.96377607f, -0.97003125f, -0.97570213f,
+	-0.98078528f, -0.98527764f, -0.98917651f, -0.99247953f,
+	-0.99518473f, -0.99729046f, -0.99879546f, -0.99969882f,
+	-1.00000000f, -0.99969882f, -0.99879546f, -0.99729046f,
+	-0.99518473f, -0.99247953f, -0.98917651f, -0.98527764f,
+	-0.98078528f, -0.97570213f, -0.97003125f, -0.96377607f,
+	-0.95694034f, -0.94952818f, -0.94154407f, -0.93299280f,
+	-0.92387953f, -0.91420976f, -0.90398929f, -0.89322430f,
+	-0.88192126f, -0.87008699f, -0.85772861f, -0.84485357f,
+	-0.83146961f, -0.81758481f, -0.80320753f, -0.78834643f,
+	-0.77301045f, -0.75720885f, -0.74095113f, -0.72424708f,
+	-0.70710678f, -0.68954054f, -0.67155895f, -0.65317284f,
+	-0.63439328f, -0.61523159f, -0.59569930f, -0.57580819f,
+	-0.55557023f, -0.53499762f, -0.51410274f, -0.49289819f,
+	-0.47139674f, -0.44961133f, -0.42755509f, -0.40524131f,
+	-0.38268343f, -0.35989504f, -0.33688985f, -0.31368174f,
+	-0.29028468f, -0.26671276f, -0.24298018f, -0.21910124f,
+	-0.19509032f, -0.17096189f, -0.14673047f, -0.12241068f,
+	-0.09801714f, -0.07356456f, -0.04906767f, -0.02454123f,
+	-0.00000000f
+};
+
+
+void ThreePhaseAPI::sinCos(float32_t theta,
+						   float32_t* sin_theta,
+						   float32_t* cos_theta)
+{
+	float32_t position = theta * SIN_TABLE_SCALE;
+	int32_t index = (int32_t)position;
+
+	/* Round towards minus infinity for negative angles */
+	if (position < (float32_t)index)
+	{
+		index--;
+	}
+
+	float32_t fraction = position - (float32_t)index;
+	uint32_t sin_index = (uint32_t)index & (SIN_TABLE_SIZE - 1);
+	uint32_t cos_index = (sin_index + SIN_TABLE_SIZE / 4)
+						 & (SIN_TABLE_SIZE - 1);
+
+	*sin_theta = sin_table[sin_index]
+			   + fraction * (sin_table[sin_index + 1] - sin_table[sin_index]);
+	*cos_theta = sin_table[cos_index]
+			   + fraction * (sin_table[cos_index + 1] - sin_table[cos_index]);
+}
+
+int8_t ThreePhaseAPI::init(leg_t leg_a,
+						   leg_t leg_b,
+						   leg_t leg_c,
+						   three_phase_modulation_t modulation)
+{
+	bool legs_exist = (leg_a < dt_leg_count)
+				   && (leg_b < dt_leg_count)
+				   && (leg_c < dt_leg_count);
+	bool legs_distinct = (leg_a != leg_b)
+					  && (leg_b != leg_c)
+					  && (leg_a != leg_c);
+
+	if (!legs_exist || !legs_distinct)
+	{
+		return -1;
+	}
+
+	phase_leg[0] = leg_a;
+	phase_leg[1] = leg_b;
+	phase_leg[2] = leg_c;
+	this->modulation = modulation;
+	initialized = true;
+
+	return 0;
+}
+
+void ThreePhaseAPI::setModulation(three_phase_modulation_t modulation)
+{
+	this->modulation = modulation;
+}
+
+void ThreePhaseAPI::setDcBusVoltage(float32_t dc_bus_voltage)
+{
+	if (dc_bus_voltage > 0)
+	{
+		inverse_dc_bus = 1.0F / dc_bus_voltage;
+	}
+}
+
+void ThreePhaseAPI::setVoltageAlphaBeta(float32_t v_alpha, float32_t v_beta)
+{
+	modulate(v_alpha * inverse_dc_bus, v_beta * inverse_dc_bus);
+}
+
+void ThreePhaseAPI::setVoltageDq(float32_t v_d, float32_t v_q, float32_t theta)
+{
+	float32_t v_alpha;
+	float32_t v_beta;
+
+	cordic_park_inverse(v_d, v_q, theta, &v_alpha, &v_beta);
+
+	modulate(v_alpha * inverse_dc_bus, v_beta * inverse_dc_bus);
+}
+
+float32_t ThreePhaseAPI::getDutyCycle(uint8_t phase)
+{
+	if (phase > 2)
+	{
+		return 0;
+	}
+	return duty_cycle[phase];
+}
+
+void ThreePhaseAPI::computeDutyCycles(float32_t alpha,
+									  float32_t beta,
+									  three_phase_modulation_t modulation,
+									  float32_t* duty_cycles)
+{
+	/* Inverse Clarke transform, references relative to the DC bus */
+	float32_t v[3];
+	cordic_clarke_inverse(alpha, beta, &v[0], &v[1], &v[2]);
+
+	float32_t v_max = v[0];
+	float32_t v_min = v[0];
+	for (uint8_t i = 1; i < 3; i++)
+	{
+		if (v[i] > v_max) v_max = v[i];
+		if (v[i] < v_min) v_min = v[i];
+	}
+
+	/* Zero-sequence added to the three phases */
+	float32_t v_zero = 0;
+
+	switch (modulation)
+	{
+	case SPWM_THIRD_HARMONIC:
+	{
+		/**
+		 * For balanced references of amplitude m and angle θ,
+		 * va.vb.vc = m³.cos(3θ)/4, so the third harmonic of amplitude m/6
+		 * is obtained without computing the angle.
+		 */
+		float32_t square_amplitude = alpha * alpha + beta * beta;
+		if (square_amplitude > 1e-6F)
+		{
+			v_zero = -0.66666667F * v[0] * v[1] * v[2] / square_amplitude;
+		}
+		break;
+	}
+	case SVPWM:
+		v_zero = -0.5F * (v_max + v_min);
+		break;
+	case DPWM_MIN:
+		v_zero = -0.5F - v_min;
+		break;
+	case DPWM_MAX:
+		v_zero = 0.5F - v_max;
+		break;
+	case DPWM1:
+		v_zero = (v_max + v_min >= 0) ? (0.5F - v_max) : (-0.5F - v_min);
+		break;
+	case SPWM:
+	default:
+		break;
+	}
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		float32_t duty = 0.5F + v[i] + v_zero;
+
+		/* Saturate in overmodulation */
+		if (duty > 1.0F)
+		{
+			duty = 1.0F;
+		}
+		else if (duty < 0.0F)
+		{
+			duty = 0.0F;
+		}
+
+		duty_cycles[i] = duty;
+	}
+}
+
+void ThreePhaseAPI::modulate(float32_t alpha, float32_t beta)
+{
+	if (!initialized)
+	{
+		return;
+	}
+
+	computeDutyCycles(alpha, beta, modulation, duty_cycle);
+
+	uint16_t duty_raw[3];
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		duty_raw[i] = (uint16_t)(duty_cycle[i]
+								 * shield.power.getPeriod(phase_leg[i]));
+	}
+
+	shield.power.setDutyCycleRawSync(phase_leg, duty_raw, 3);
+}
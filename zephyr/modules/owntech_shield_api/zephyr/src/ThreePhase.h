@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date 2024
+ *
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief Three-phase modulation of three legs of a power shield, e.g. the
+ * 		  Ownverter.
+ */
+
+#ifndef THREEPHASE_H_
+#define THREEPHASE_H_
+
+#include <zephyr/kernel.h>
+#include "arm_math.h"
+#include "Power.h"
+
+/**
+ * @brief Zero-sequence added to the three phase references.
+ *
+ * 			- `SPWM` - sinusoidal modulation, no zero-sequence.
+ *
+ * 			- `SPWM_THIRD_HARMONIC` - one sixth of third harmonic injected,
+ * 			  linear up to a modulation index of 1.15.
+ *
+ * 			- `SVPWM` - space vector modulation, min-max zero-sequence,
+ * 			  linear up to a modulation index of 1.15.
+ *
+ * 			- `DPWM_MIN` - discontinuous modulation, the lowest phase is
+ * 			  clamped to the negative rail.
+ *
+ * 			- `DPWM_MAX` - discontinuous modulation, the highest phase is
+ * 			  clamped to the positive rail.
+ *
+ * 			- `DPWM1` - discontinuous modulation, the phase with the highest
+ * 			  absolute reference is clamped to its rail (60° sectors).
+ */
+typedef enum
+{
+	SPWM,
+	SPWM_THIRD_HARMONIC,
+	SVPWM,
+	DPWM_MIN,
+	DPWM_MAX,
+	DPWM1
+} three_phase_modulation_t;
+
+class ThreePhaseAPI
+{
+private:
+	leg_t phase_leg[3];
+	three_phase_modulation_t modulation = SVPWM;
+	float32_t inverse_dc_bus = 0;
+	float32_t duty_cycle[3] = {0.5, 0.5, 0.5};
+	bool initialized = false;
+
+	/* computes the duty cycles from per-unit αβ references and writes them */
+	void modulate(float32_t alpha, float32_t beta);
+
+public:
+	/**
+	 * @brief Initializes the three-phase modulation.
+	 *
+	 * @param leg_a Leg driving phase a: `LEG1` to `LEG5`
+	 * @param leg_b Leg driving phase b: `LEG1` to `LEG5`
+	 * @param leg_c Leg driving phase c: `LEG1` to `LEG5`
+	 * @param modulation Zero-sequence injected, `SVPWM` by default.
+	 *
+	 * @return `0` if the modulation was initialized, `-1` if the legs are
+	 * 		   not three distinct legs of the shield.
+	 *
+	 * @warning This function can only be called AFTER initializing the legs.
+	 * 			For the discontinuous modulations to actually stop switching
+	 * 			the clamped leg, the duty cycle limits of the legs must be
+	 * 			opened to the full period.
+	 */
+	int8_t init(leg_t leg_a,
+				leg_t leg_b,
+				leg_t leg_c,
+				three_phase_modulation_t modulation = SVPWM);
+
+	/**
+	 * @brief Changes the zero-sequence injected. Takes effect on the next
+	 * 		  voltage reference.
+	 *
+	 * @param modulation `SPWM`, `SPWM_THIRD_HARMONIC`, `SVPWM`, `DPWM_MIN`,
+	 * 					 `DPWM_MAX` or `DPWM1`
+	 */
+	void setModulation(three_phase_modulation_t modulation);
+
+	/**
+	 * @brief Sets the DC bus voltage used to normalize the voltage
+	 * 		  references. To be updated from the measurements in the
+	 * 		  critical task if the bus is not regulated.
+	 *
+	 * @param dc_bus_voltage DC bus voltage in volts, strictly positive.
+	 */
+	void setDcBusVoltage(float32_t dc_bus_voltage);
+
+	/**
+	 * @brief Sets the phase voltage reference in the stationary frame and
+	 * 		  writes the three legs in the same switching period.
+	 *
+	 * The reference uses the amplitude-invariant Clarke transform: the
+	 * amplitude of the αβ vector is the peak phase to neutral voltage.
+	 *
+	 * @param v_alpha α component of the voltage reference in volts
+	 * @param v_beta  β component of the voltage reference in volts
+	 */
+	void setVoltageAlphaBeta(float32_t v_alpha, float32_t v_beta);
+
+	/**
+	 * @brief Sets the phase voltage reference in the rotating frame and
+	 * 		  writes the three legs in the same switching period.
+	 *
+	 * @param v_d   d component of the voltage reference in volts
+	 * @param v_q   q component of the voltage reference in volts
+	 * @param theta Angle of the rotating frame in radians, any value.
+	 */
+	void setVoltageDq(float32_t v_d, float32_t v_q, float32_t theta);
+
+	/**
+	 * @brief Returns the last duty cycle computed for a phase.
+	 *
+	 * @param phase Phase index: `0` to `2` for phases a to c.
+	 */
+	float32_t getDutyCycle(uint8_t phase);
+
+	/**
+	 * @brief Computes the duty cycles of the three phases from per-unit αβ
+	 * 		  references, without writing the legs.
+	 *
+	 * @param alpha α component of the reference, relative to the DC bus
+	 * @param beta  β component of the reference, relative to the DC bus
+	 * @param modulation Zero-sequence injected
+	 * @param duty_cycles Array of 3 where to store the duty cycles of
+	 * 					  phases a to c, saturated between 0 and 1.
+	 */
+	static void computeDutyCycles(float32_t alpha,
+								  float32_t beta,
+								  three_phase_modulation_t modulation,
+								  float32_t* duty_cycles);
+
+	/**
+	 * @brief Table-based sine and cosine, about 1e-4 of absolute error.
+	 *
+	 * @param theta Angle in radians, any value.
+	 * @param sin_theta Pointer where to store the sine
+	 * @param cos_theta Pointer where to store the cosine
+	 */
+	static void sinCos(float32_t theta,
+					   float32_t* sin_theta,
+					   float32_t* cos_theta);
+};
+
+#endif /* THREEPHASE_H_ */
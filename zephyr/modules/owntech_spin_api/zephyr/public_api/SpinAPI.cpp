@@ -49,3 +49,7 @@ UartHAL SpinAPI::uart;
 #endif
 
 TimerHAL SpinAPI::timer;
+
+#ifdef CONFIG_OWNTECH_CAPTURE_API
+CaptureAPI SpinAPI::capture;
+#endif
@@ -45,6 +45,10 @@
 #include "../src/NgndHAL.h"
 #endif
 
+#ifdef CONFIG_OWNTECH_CAPTURE_API
+#include "../src/CaptureAPI.h"
+#endif
+
 
 
 /**
@@ -99,6 +103,13 @@ public:
 	 */
 	static DataAPI data;
 
+#ifdef CONFIG_OWNTECH_CAPTURE_API
+	/**
+	 * @brief Triggered captures of the critical task variables and pins
+	 */
+	static CaptureAPI capture;
+#endif
+
 };
 
 
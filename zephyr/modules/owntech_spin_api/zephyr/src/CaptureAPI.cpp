@@ -0,0 +1,469 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+#include <soc.h>
+
+/* Current class header */
+#include "CaptureAPI.h"
+
+/* OwnTech Power API */
+#include "SpinAPI.h"
+
+/* Current module private functions */
+#include "./data/data_conversion.h"
+#include "./data/data_dispatch.h"
+#include "ccm.h"
+
+/* OwnTech telemetry frames */
+#include "telemetry_frame.h"
+
+
+/* Samples converted at once when downloading */
+#define CAPTURE_FRAME_SAMPLES 16
+
+
+/**
+ *  Local variables
+ */
+
+/* Channels */
+static const char* channel_names[CONFIG_OWNTECH_CAPTURE_MAX_CHANNELS];
+static float32_t*  channel_variables[CONFIG_OWNTECH_CAPTURE_MAX_CHANNELS];
+static uint8_t     channel_pins[CONFIG_OWNTECH_CAPTURE_MAX_CHANNELS];
+static uint8_t     channel_count = 0;
+
+/* Pins, resolved when arming: variable channels have no ADC */
+static adc_t   channel_adcs[CONFIG_OWNTECH_CAPTURE_MAX_CHANNELS];
+static uint8_t channel_numbers[CONFIG_OWNTECH_CAPTURE_MAX_CHANNELS];
+static uint8_t channel_ranks[CONFIG_OWNTECH_CAPTURE_MAX_CHANNELS];
+
+/* Settings */
+static capture_trigger_t trigger_type = CAPTURE_TRIGGER_MANUAL;
+static uint8_t   trigger_channel = 0;
+static float32_t trigger_level = 0;
+static uint32_t  pre_trigger_length = 0;
+static uint32_t  post_trigger_length = 0;
+static uint16_t  decimation = 1;
+
+/* Samples, oldest at write_slot once the buffer has wrapped */
+static float32_t capture_buffer[CONFIG_OWNTECH_CAPTURE_BUFFER_SIZE];
+static uint32_t  capture_length = 0;
+static uint32_t  write_slot = 0;
+static uint32_t  stored_samples = 0;
+static uint32_t  remaining_samples = 0;
+static uint16_t  decimation_counter = 0;
+
+/* Trigger detection */
+static float32_t previous_value = 0;
+static bool      previous_valid = false;
+static volatile bool trigger_forced = false;
+static volatile bool safety_tripped = false;
+
+static volatile capture_state_t state = CAPTURE_IDLE;
+
+/* Download */
+static float32_t frame_values[CAPTURE_FRAME_SAMPLES *
+                              CONFIG_OWNTECH_CAPTURE_MAX_CHANNELS];
+static telemetry_frame_writer_t frame_writer;
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Indicates whether the capture is running.
+ */
+static bool _capture_running()
+{
+	return (state == CAPTURE_ARMED) || (state == CAPTURE_TRIGGERED);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Converts a stored value of a pin channel.
+ */
+static float32_t _capture_convert(uint8_t channel, float32_t raw_value)
+{
+	if (raw_value == (float32_t)PEEK_NO_VALUE)
+	{
+		return NO_VALUE;
+	}
+
+	return data_conversion_convert_raw_value(channel_adcs[channel],
+	                                         channel_numbers[channel],
+	                                         (uint32_t)raw_value);
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Checks the trigger condition on the sample
+ *        just stored.
+ */
+static inline bool _capture_check_trigger(const float32_t* slot)
+{
+	if (trigger_forced)
+	{
+		return true;
+	}
+
+	if (trigger_type == CAPTURE_TRIGGER_MANUAL)
+	{
+		return false;
+	}
+
+	/* Conditions are checked with a full pre-trigger history */
+	bool ready = (stored_samples > pre_trigger_length);
+
+	if (trigger_type == CAPTURE_TRIGGER_SAFETY)
+	{
+		return ready && safety_tripped;
+	}
+
+	float32_t value = slot[trigger_channel];
+
+	if (channel_variables[trigger_channel] == nullptr)
+	{
+		value = _capture_convert(trigger_channel, value);
+	}
+
+	bool was_valid = previous_valid;
+	float32_t previous = previous_value;
+
+	previous_value = value;
+	previous_valid = true;
+
+	if (ready == false)
+	{
+		return false;
+	}
+
+	switch (trigger_type)
+	{
+		case CAPTURE_TRIGGER_RISING_EDGE:
+			return was_valid && (previous < trigger_level) &&
+			       (value >= trigger_level);
+		case CAPTURE_TRIGGER_FALLING_EDGE:
+			return was_valid && (previous > trigger_level) &&
+			       (value <= trigger_level);
+		case CAPTURE_TRIGGER_ABOVE:
+			return value > trigger_level;
+		case CAPTURE_TRIGGER_BELOW:
+			return value < trigger_level;
+		default:
+			return false;
+	}
+}
+
+
+/* Public API */
+
+int8_t CaptureAPI::addVariable(const char* name, float32_t* variable)
+{
+	if ( (_capture_running()) ||
+	     (channel_count == CONFIG_OWNTECH_CAPTURE_MAX_CHANNELS) )
+	{
+		return -1;
+	}
+
+	channel_names[channel_count]     = name;
+	channel_variables[channel_count] = variable;
+	channel_pins[channel_count]      = 0;
+
+	return channel_count++;
+}
+
+int8_t CaptureAPI::addPin(const char* name, uint8_t pin_number)
+{
+	if ( (_capture_running()) ||
+	     (channel_count == CONFIG_OWNTECH_CAPTURE_MAX_CHANNELS) )
+	{
+		return -1;
+	}
+
+	channel_names[channel_count]     = name;
+	channel_variables[channel_count] = nullptr;
+	channel_pins[channel_count]      = pin_number;
+
+	return channel_count++;
+}
+
+int8_t CaptureAPI::clearChannels()
+{
+	if (_capture_running())
+	{
+		return -1;
+	}
+
+	channel_count = 0;
+	state = CAPTURE_IDLE;
+
+	return 0;
+}
+
+int8_t CaptureAPI::setTrigger(capture_trigger_t trigger,
+                              uint8_t channel,
+                              float32_t level)
+{
+	if (_capture_running())
+	{
+		return -1;
+	}
+
+	trigger_type    = trigger;
+	trigger_channel = channel;
+	trigger_level   = level;
+
+	return 0;
+}
+
+int8_t CaptureAPI::setLength(uint32_t pre_trigger_samples,
+                             uint32_t post_trigger_samples)
+{
+	if ( (_capture_running()) ||
+	     ( (post_trigger_samples == 0) && (pre_trigger_samples != 0) ) )
+	{
+		return -1;
+	}
+
+	pre_trigger_length  = pre_trigger_samples;
+	post_trigger_length = post_trigger_samples;
+
+	return 0;
+}
+
+int8_t CaptureAPI::setDecimation(uint16_t new_decimation)
+{
+	if ( (_capture_running()) || (new_decimation == 0) )
+	{
+		return -1;
+	}
+
+	decimation = new_decimation;
+
+	return 0;
+}
+
+uint32_t CaptureAPI::getCapacity()
+{
+	if (channel_count == 0)
+	{
+		return 0;
+	}
+
+	return CONFIG_OWNTECH_CAPTURE_BUFFER_SIZE / channel_count;
+}
+
+int8_t CaptureAPI::arm()
+{
+	if ( (_capture_running()) ||
+	     (channel_count == 0) ||
+	     ( (trigger_type != CAPTURE_TRIGGER_MANUAL) &&
+	       (trigger_type != CAPTURE_TRIGGER_SAFETY) &&
+	       (trigger_channel >= channel_count) ) )
+	{
+		return -1;
+	}
+
+	uint32_t capacity = this->getCapacity();
+
+	if ( (pre_trigger_length == 0) && (post_trigger_length == 0) )
+	{
+		pre_trigger_length  = capacity / 4;
+		post_trigger_length = capacity - pre_trigger_length;
+	}
+
+	if (pre_trigger_length + post_trigger_length > capacity)
+	{
+		return -1;
+	}
+
+	for (uint8_t i = 0 ; i < channel_count ; i++)
+	{
+		if (channel_variables[i] != nullptr)
+			continue;
+
+		adc_t adc_num = DataAPI::getCurrentAdcForPin(channel_pins[i]);
+		if (adc_num == UNKNOWN_ADC)
+		{
+			return -1;
+		}
+
+		uint8_t channel_num = DataAPI::getChannelNumber(adc_num,
+		                                                channel_pins[i]);
+		uint8_t channel_rank = DataAPI::getChannelRank(adc_num, channel_num);
+		if ( (channel_num == 0) || (channel_rank == 0) )
+		{
+			return -1;
+		}
+
+		channel_adcs[i]    = adc_num;
+		channel_numbers[i] = channel_num;
+		channel_ranks[i]   = channel_rank;
+	}
+
+	capture_length     = pre_trigger_length + post_trigger_length;
+	write_slot         = 0;
+	stored_samples     = 0;
+	remaining_samples  = post_trigger_length;
+	decimation_counter = decimation - 1;
+
+	previous_valid = false;
+	trigger_forced = false;
+	safety_tripped = false;
+
+	/* Sampling starts with the next critical task run, which must see
+	   the settings above once it sees the state */
+	__DMB();
+	state = CAPTURE_ARMED;
+
+	return 0;
+}
+
+void CaptureAPI::trigger()
+{
+	trigger_forced = true;
+}
+
+void CaptureAPI::stop()
+{
+	state = CAPTURE_IDLE;
+}
+
+capture_state_t CaptureAPI::getState()
+{
+	return state;
+}
+
+int8_t CaptureAPI::download()
+{
+	if (state != CAPTURE_DONE)
+	{
+		return -1;
+	}
+
+	uint32_t oldest_slot = (stored_samples == capture_length) ? write_slot : 0;
+	uint32_t trigger_sample = stored_samples - post_trigger_length;
+
+	telemetry_frame_send_descriptor(channel_names, channel_count, decimation);
+
+	uint16_t crc = telemetry_frame_begin(TELEMETRY_FRAME_TRIGGER,
+	                                     channel_count,
+	                                     sizeof(trigger_sample));
+	crc = telemetry_frame_write(&trigger_sample, sizeof(trigger_sample), crc);
+	telemetry_frame_end(crc);
+
+	for (uint32_t first = 0 ; first < stored_samples ;
+	     first += CAPTURE_FRAME_SAMPLES)
+	{
+		uint32_t count = stored_samples - first;
+		if (count > CAPTURE_FRAME_SAMPLES)
+		{
+			count = CAPTURE_FRAME_SAMPLES;
+		}
+
+		float32_t* value = frame_values;
+
+		for (uint32_t i = 0 ; i < count ; i++)
+		{
+			uint32_t slot = (oldest_slot + first + i) % capture_length;
+			const float32_t* stored = &capture_buffer[slot * channel_count];
+
+			for (uint8_t j = 0 ; j < channel_count ; j++)
+			{
+				*value++ = (channel_variables[j] != nullptr) ?
+				           stored[j] : _capture_convert(j, stored[j]);
+			}
+		}
+
+		telemetry_frame_send_samples(&frame_writer,
+		                             channel_count,
+		                             first,
+		                             frame_values,
+		                             count);
+	}
+
+	return 0;
+}
+
+
+/* Critical task API */
+
+OWNTECH_CCM_FUNC void CaptureAPI::sample()
+{
+	if ( (state != CAPTURE_ARMED) && (state != CAPTURE_TRIGGERED) )
+		return;
+
+	decimation_counter++;
+	if (decimation_counter < decimation)
+		return;
+
+	decimation_counter = 0;
+
+	float32_t* slot = &capture_buffer[write_slot * channel_count];
+
+	for (uint8_t i = 0 ; i < channel_count ; i++)
+	{
+		if (channel_variables[i] != nullptr)
+		{
+			slot[i] = *channel_variables[i];
+		}
+		else
+		{
+			slot[i] = data_dispatch_peek_acquired_value(channel_adcs[i],
+			                                            channel_ranks[i]);
+		}
+	}
+
+	write_slot++;
+	if (write_slot == capture_length)
+	{
+		write_slot = 0;
+	}
+
+	if (stored_samples < capture_length)
+	{
+		stored_samples++;
+	}
+
+	if (state == CAPTURE_ARMED)
+	{
+		if (_capture_check_trigger(slot) == false)
+			return;
+
+		state = CAPTURE_TRIGGERED;
+	}
+
+	/* The trigger sample is the first post-trigger one */
+	remaining_samples--;
+	if (remaining_samples == 0)
+	{
+		state = CAPTURE_DONE;
+	}
+}
+
+void CaptureAPI::notifySafetyTrip()
+{
+	safety_tripped = true;
+}
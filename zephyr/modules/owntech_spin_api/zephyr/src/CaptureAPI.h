@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+
+#ifndef CAPTUREAPI_H_
+#define CAPTUREAPI_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+/* ARM CMSIS library */
+#include <arm_math.h>
+
+
+/**
+ *  Type definitions
+ */
+
+typedef enum : uint8_t
+{
+	CAPTURE_TRIGGER_MANUAL,       /* Only trigger() */
+	CAPTURE_TRIGGER_RISING_EDGE,  /* Channel crossing the level upwards */
+	CAPTURE_TRIGGER_FALLING_EDGE, /* Channel crossing the level downwards */
+	CAPTURE_TRIGGER_ABOVE,        /* Channel above the level */
+	CAPTURE_TRIGGER_BELOW,        /* Channel below the level */
+	CAPTURE_TRIGGER_SAFETY        /* Safety API tripping */
+} capture_trigger_t;
+
+typedef enum : uint8_t
+{
+	CAPTURE_IDLE,
+	CAPTURE_ARMED,     /* Filling the pre-trigger history */
+	CAPTURE_TRIGGERED, /* Taking the post-trigger samples */
+	CAPTURE_DONE       /* Ready to download */
+} capture_state_t;
+
+
+/**
+ *  Static class definition
+ */
+
+/**
+ * @brief Triggered captures of channels at the critical task rate, with
+ *        pre-trigger history, as a scope does.
+ *
+ *        Once armed, the channels are sampled after each run of the
+ *        critical task into a circular buffer in static RAM. When the
+ *        trigger condition is met, a number of post-trigger samples is
+ *        taken, then the capture stops, keeping the samples preceding the
+ *        trigger. The capture is then downloaded on the console as
+ *        telemetry frames, decoded by the telemetry_decode tool of the host
+ *        build.
+ *
+ *        Channels are either variables, e.g. computed by the critical
+ *        task, or pins acquired by the Data API. Pins are read raw from the
+ *        dispatch buffers, and converted when the capture is downloaded.
+ *
+ * @note  Channels, trigger, length and decimation can only be changed
+ *        when the capture is not running.
+ */
+class CaptureAPI
+{
+	/* Allow specific external members to access private members of this class */
+	friend void user_task_proxy();
+
+public:
+
+	/**
+	 * @brief Add a variable to the capture channels.
+	 *
+	 * @param name     Channel name, which must stay valid: a string
+	 *                 literal. Must not contain commas.
+	 * @param variable Variable sampled.
+	 *
+	 * @return Channel index, -1 if the capture is running or if
+	 *         CONFIG_OWNTECH_CAPTURE_MAX_CHANNELS channels were added.
+	 */
+	int8_t addVariable(const char* name, float32_t* variable);
+
+	/**
+	 * @brief Add a pin acquired by the Data API to the capture channels.
+	 *
+	 * @param name       Channel name, which must stay valid: a string
+	 *                   literal. Must not contain commas.
+	 * @param pin_number Spin pin number, which acquisition must be enabled
+	 *                   when the capture is armed.
+	 *
+	 * @return Channel index, -1 if the capture is running or if
+	 *         CONFIG_OWNTECH_CAPTURE_MAX_CHANNELS channels were added.
+	 */
+	int8_t addPin(const char* name, uint8_t pin_number);
+
+	/**
+	 * @brief Remove all the channels.
+	 *
+	 * @return 0 on success, -1 if the capture is running.
+	 */
+	int8_t clearChannels();
+
+	/**
+	 * @brief Set the trigger condition. Default is CAPTURE_TRIGGER_MANUAL.
+	 *
+	 * @param trigger Trigger condition.
+	 * @param channel Index of the channel compared with the level.
+	 * @param level   Level, in the unit of the channel. Pin values are
+	 *                compared once converted.
+	 *
+	 * @return 0 on success, -1 if the capture is running.
+	 */
+	int8_t setTrigger(capture_trigger_t trigger,
+	                  uint8_t channel = 0,
+	                  float32_t level = 0);
+
+	/**
+	 * @brief Set the number of samples kept before the trigger, and taken
+	 *        from the trigger on. Their sum must not exceed getCapacity().
+	 *        Default, or when both are 0, is a quarter of the capacity
+	 *        before the trigger, and the rest after.
+	 *
+	 * @param pre_trigger_samples  Samples before the trigger sample.
+	 * @param post_trigger_samples Samples from the trigger sample on, at
+	 *                             least 1 unless both are 0.
+	 *
+	 * @return 0 on success, -1 if the capture is running.
+	 */
+	int8_t setLength(uint32_t pre_trigger_samples,
+	                 uint32_t post_trigger_samples);
+
+	/**
+	 * @brief Sample one run of the critical task out of decimation.
+	 *        Default is 1: every run.
+	 *
+	 * @return 0 on success, -1 if the capture is running or if decimation
+	 *         is 0.
+	 */
+	int8_t setDecimation(uint16_t decimation);
+
+	/**
+	 * @brief Get the number of samples the buffer holds with the current
+	 *        channels.
+	 */
+	uint32_t getCapacity();
+
+	/**
+	 * @brief Start a capture. Conditional triggers are ignored until the
+	 *        pre-trigger samples were taken.
+	 *
+	 * @return 0 on success, -1 if the capture is running, if there is no
+	 *         channel, if the length exceeds the capacity, if the trigger
+	 *         channel does not exist, or if a pin is not acquired.
+	 */
+	int8_t arm();
+
+	/**
+	 * @brief Trigger an armed capture on the next sample, whatever the
+	 *        trigger condition.
+	 */
+	void trigger();
+
+	/**
+	 * @brief Stop a running capture, discarding it.
+	 */
+	void stop();
+
+	/**
+	 * @brief Get the capture state.
+	 */
+	capture_state_t getState();
+
+	/**
+	 * @brief Write the capture on the console: a descriptor frame, a
+	 *        trigger frame with the index of the trigger sample, then the
+	 *        samples, oldest first. Waits for the console: call it from
+	 *        a background task or from the main thread, while no telemetry
+	 *        is streaming.
+	 *
+	 * @return 0 on success, -1 if no capture is done.
+	 */
+	int8_t download();
+
+private:
+	static void sample();
+	static void notifySafetyTrip();
+
+};
+
+
+#endif /* CAPTUREAPI_H_ */
@@ -38,6 +38,11 @@
 
 /* Current module private functions */
 #include "./data/data_dispatch.h"
+#include "ccm.h"
+
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+#include "fmac.h"
+#endif
 
 /**
  *  Static class members
@@ -50,6 +55,11 @@ uint8_t DataAPI::current_rank[ADC_COUNT] = {0};
 DispatchMethod_t DataAPI::dispatch_method = DispatchMethod_t::on_dma_interrupt;
 uint32_t DataAPI::repetition_count_between_dispatches = 0;
 float32_t*** DataAPI::converted_values_buffer = nullptr;
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+/* FMAC filter number plus one of each pin, 0 if not filtered */
+uint8_t DataAPI::pin_filter[PIN_COUNT] = {0};
+uint8_t DataAPI::filters_count = 0;
+#endif
 
 
 adc_t DataAPI::current_adc[PIN_COUNT] = {DEFAULT_ADC};
@@ -110,6 +120,26 @@ int8_t DataAPI::start()
 			data_dispatch_init(task, this->repetition_count_between_dispatches);
 	}
 
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+	/* Attach filters to their channels */
+	for (uint8_t pin_index = 0 ; pin_index < PIN_COUNT ; pin_index++)
+	{
+		if (DataAPI::pin_filter[pin_index] == 0)
+			continue;
+
+		adc_t adc_num = DataAPI::current_adc[pin_index];
+		uint8_t channel_num = this->getChannelNumber(adc_num, pin_index+1);
+		uint8_t channel_rank = DataAPI::getChannelRank(adc_num, channel_num);
+
+		if (channel_rank != 0)
+		{
+			data_dispatch_set_filter(adc_num,
+									 channel_rank,
+									 DataAPI::pin_filter[pin_index] - 1);
+		}
+	}
+#endif
+
 	/* Make sure module is initialized */
 	if (adcInitialized == false)
 	{
@@ -161,6 +191,54 @@ int8_t DataAPI::stop()
 	return 0;
 }
 
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+int8_t DataAPI::setFilter(uint8_t pin_num,
+						  const float32_t* b,
+						  uint8_t b_count,
+						  const float32_t* a,
+						  uint8_t a_count)
+{
+	if ( (DataAPI::is_started == true) || (pin_num == 0) ||
+		 (pin_num > PIN_COUNT) )
+	{
+		return -1;
+	}
+
+	if (DataAPI::getCurrentAdcForPin(pin_num) == UNKNOWN_ADC)
+	{
+		return -1;
+	}
+
+	uint8_t filter_number;
+	if (DataAPI::pin_filter[pin_num-1] != 0)
+	{
+		filter_number = DataAPI::pin_filter[pin_num-1] - 1;
+	}
+	else if (DataAPI::filters_count < CONFIG_OWNTECH_FMAC_MAX_FILTERS)
+	{
+		filter_number = DataAPI::filters_count;
+	}
+	else
+	{
+		return -1;
+	}
+
+	int8_t err = fmac_filter_configure(filter_number, b, b_count, a, a_count);
+	if (err != 0)
+	{
+		return -1;
+	}
+
+	if (DataAPI::pin_filter[pin_num-1] == 0)
+	{
+		DataAPI::pin_filter[pin_num-1] = filter_number + 1;
+		DataAPI::filters_count++;
+	}
+
+	return 0;
+}
+#endif
+
 void DataAPI::triggerAcquisition(adc_t adc_num)
 {
 	/*Make sure module is initialized */
@@ -947,7 +1025,7 @@ void DataAPI::setDispatchMethod(DispatchMethod_t dispatch_method)
 	DataAPI::dispatch_method = dispatch_method;
 }
 
-void DataAPI::doFullDispatch()
+OWNTECH_CCM_FUNC void DataAPI::doFullDispatch()
 {
 	data_dispatch_do_full_dispatch();
 }
@@ -103,6 +103,7 @@ class DataAPI
 {
 	/* Allow specific external members to access private members of this class */
 	friend class SensorsAPI;
+	friend class CaptureAPI;
 	friend void user_task_proxy();
 	friend void scheduling_start_uninterruptible_synchronous_task(bool);
 
@@ -550,6 +551,48 @@ public:
 	 */
 	void configureTriggerSource(adc_t adc_number, trigger_source_t trigger_source);
 
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+	/**
+	 * @brief Filter the acquired values of a pin with the FMAC hardware
+	 *        filter accelerator.
+	 *
+	 *        The filter runs on each dispatch, before values are made
+	 *        available: data.get*() and data.peek*() functions then return
+	 *        filtered values, and conversion applies to the filtered values.
+	 *        The accelerator holds a single filter: the products of the
+	 *        first pin filtered are computed by the accelerator, those of
+	 *        the other pins by the CPU, with the same coefficients.
+	 *
+	 *        The filter is y[n] = (b0.x[n] + ... + bN.x[n-N]
+	 *                             - a1.y[n-1] - ... - aM.y[n-M]) / a0,
+	 *        so that coefficients from usual design tools can be used as is.
+	 *        Its sampling frequency is the acquisition frequency of the pin.
+	 *
+	 * @note  This function must be called *after* acquisition has been
+	 *        enabled on the pin and *before* Data API is started. Calling it
+	 *        again for the same pin replaces its filter.
+	 *
+	 * @param[in] pin_number Number of the Spin pin to filter.
+	 * @param[in] b       Feedforward coefficients b0 to bN.
+	 * @param[in] b_count Number of feedforward coefficients, up to 63 for a
+	 *                    FIR filter or 31 for an IIR filter.
+	 * @param[in] a       Feedback coefficients a0 to aM, omitted for a FIR
+	 *                    filter.
+	 * @param[in] a_count Number of feedback coefficients including a0, up
+	 *                    to 32, omitted for a FIR filter.
+	 *
+	 * @return `0` if the filter was set, `-1` if the pin is not acquired,
+	 *         if Data API is already started, if all the filters are used
+	 *         (see CONFIG_OWNTECH_FMAC_MAX_FILTERS) or if the coefficients
+	 *         can not be loaded in the accelerator.
+	 */
+	int8_t setFilter(uint8_t pin_number,
+					 const float32_t* b,
+					 uint8_t b_count,
+					 const float32_t* a = nullptr,
+					 uint8_t a_count = 0);
+#endif
+
 private:
 	/**
 	 * @brief Initialize all available ADC peripherals if not already initialized.
@@ -727,6 +770,10 @@ private:
 	static uint32_t repetition_count_between_dispatches;
 	static adc_t current_adc[PIN_COUNT];
 	static float32_t*** converted_values_buffer;
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+	static uint8_t pin_filter[PIN_COUNT];
+	static uint8_t filters_count;
+#endif
 
 };
 
@@ -333,10 +333,23 @@ void PwmHAL::setAdcTriggerInstant(hrtim_tu_number_t pwmX, float32_t trig_val)
 		hrtim_init_default_all(); /* Initialize default parameters before */
 	}
 
+	if (hrtim_adc_auto_trigger_get(pwmX) != ADC_TRIG_FIXED)
+	{
+		hrtim_adc_auto_trigger_set(pwmX, ADC_TRIG_FIXED, 0);
+	}
+
 	uint16_t trigger_value_int = trig_val * hrtim_period_get(pwmX);
 	hrtim_tu_cmp_set(pwmX, CMP3xR, trigger_value_int);
 }
 
+void PwmHAL::setAdcTriggerTracking(hrtim_tu_number_t pwmX,
+								   hrtim_adc_auto_trigger_t mode,
+								   float32_t offset)
+{
+	int16_t offset_int = offset * hrtim_period_get(pwmX);
+	hrtim_adc_auto_trigger_set(pwmX, mode, offset_int);
+}
+
 void PwmHAL::disableAdcTrigger(hrtim_tu_number_t tu_number)
 {
 	hrtim_adc_trigger_dis(tu_number);
@@ -545,4 +558,26 @@ void PwmHAL::stopBurstMode()
 void PwmHAL::deInitBurstMode()
 {
 	hrtim_burst_dis();
-}
\ No newline at end of file
+}
+
+void PwmHAL::setWaveformRegisters(hrtim_tu_t PWM_tu, uint32_t registers)
+{
+	hrtim_burst_dma_regs_set(PWM_tu, registers);
+}
+
+int8_t PwmHAL::startWaveformTable(hrtim_tu_t PWM_tu,
+								  const uint32_t* table,
+								  uint16_t length)
+{
+	return hrtim_burst_dma_start(PWM_tu, table, length);
+}
+
+int8_t PwmHAL::swapWaveformTable(const uint32_t* table)
+{
+	return hrtim_burst_dma_swap(table);
+}
+
+void PwmHAL::stopWaveformTable()
+{
+	hrtim_burst_dma_stop();
+}
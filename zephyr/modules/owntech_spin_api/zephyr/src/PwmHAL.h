@@ -357,9 +357,29 @@ public:
       * @param[in] pwmX  PWM Unit: `PWMA`,`PWMB`,`PWMC`,`PWMD`,`PWME`,`PWMF`
       * 
       * @param[in] trig_val   a float value between 0 and 1
+      *
+      * @note    This disables the trigger tracking set by
+      *          setAdcTriggerTracking().
       */
      void setAdcTriggerInstant(hrtim_tu_number_t pwmX, float32_t trig_val);
 
+     /**
+      * @brief This function makes the ADC trigger follow the duty cycle.
+      *        The trigger is recomputed on every duty cycle update and
+      *        written together with it.
+      *
+      * @param[in] pwmX   PWM Unit: `PWMA`,`PWMB`,`PWMC`,`PWMD`,`PWME`,`PWMF`
+      * @param[in] mode   `ADC_TRIG_MID_ON` to sample at the centre of the
+      *                   on-time, `ADC_TRIG_MID_OFF` at the centre of the
+      *                   off-time, `ADC_TRIG_FIXED` to stop tracking.
+      * @param[in] offset Offset from the centre as a fraction of the period,
+      *                   positive to sample later. The trigger is kept
+      *                   between the edges of the sampled interval.
+      */
+     void setAdcTriggerTracking(hrtim_tu_number_t pwmX,
+                                hrtim_adc_auto_trigger_t mode,
+                                float32_t offset = 0);
+
      /**
       * @brief This function sets the adc trig rollover mode for the selected timer
       *
@@ -547,6 +567,65 @@ public:
       */
      void deInitBurstMode();
 
+     /**
+      * @brief   This function selects the registers of a timing unit that
+      *          are reloaded from a waveform table on each PWM period.
+      *
+      * @param[in] PWM_tu    PWM Unit:`MSTR`,`TIMA`,`TIMB`,`TIMC`,`TIMD`,`TIME`,`TIMF`
+      * @param[in] registers OR-ed combination of `BDMA_PER`, `BDMA_REP`,
+      *                      `BDMA_CMP1`, `BDMA_CMP2`, `BDMA_CMP3`, `BDMA_CMP4`
+      *
+      * @note    Call it for each timing unit taking part in the waveform
+      *          before calling startWaveformTable().
+      */
+     void setWaveformRegisters(hrtim_tu_t PWM_tu, uint32_t registers);
+
+     /**
+      * @brief   This function starts streaming a waveform table into the
+      *          selected registers using the HRTIM burst DMA. The table is
+      *          read circularly and costs no CPU time once started.
+      *
+      * @param[in] PWM_tu PWM Unit whose period paces the table:
+      *                   `MSTR`,`TIMA`,`TIMB`,`TIMC`,`TIMD`,`TIME`,`TIMF`
+      * @param[in] table  Raw register values, one word per selected register
+      *                   for each period. Registers are ordered master first,
+      *                   then TIMA to TIMF, and PER, REP, CMP1 to CMP4 inside
+      *                   each unit. The table must stay in memory while the
+      *                   waveform is running.
+      * @param[in] length Number of words in the table
+      *
+      * @return  0 if the waveform was started, -1 if the table length does
+      *          not match the selected registers.
+      *
+      * @warning Do not set the duty cycle, phase shift or trigger of the
+      *          streamed registers while the waveform is running.
+      */
+     int8_t startWaveformTable(hrtim_tu_t PWM_tu,
+                               const uint32_t* table,
+                               uint16_t length);
+
+     /**
+      * @brief   This function replaces the streamed waveform table from the
+      *          next period, at the same position in the new table. Use two
+      *          tables to change the waveform while it is running: write the
+      *          one not streamed, then swap.
+      *
+      * @param[in] table  Table of the same length and layout as the one
+      *                   given to startWaveformTable()
+      *
+      * @return  0 if the table was swapped, -1 if the waveform is not
+      *          running or the DMA was busy, the previous table being kept.
+      *
+      * @warning Call it from the critical task.
+      */
+     int8_t swapWaveformTable(const uint32_t* table);
+
+     /**
+      * @brief   This function stops the waveform table streaming and clears
+      *          the registers selection.
+      */
+     void stopWaveformTable();
+
 private:
 
      bool swap_state[HRTIM_CHANNELS] = {false};
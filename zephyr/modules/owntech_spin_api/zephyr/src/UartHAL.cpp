@@ -31,6 +31,9 @@
 #include <zephyr/drivers/uart.h>
 #include <zephyr/console/console.h>
 
+/* OwnTech deferred log */
+#include "deferred_log.h"
+
 /* Current file header */
 #include "UartHAL.h"
 
@@ -56,13 +59,13 @@ static void _uart_usart1_process_input(const struct device *dev,
 	uint8_t c;
 
 	if (!uart_irq_update(uart_dev)) {
-		printk("no data \n");
+		OWNTECH_LOG("no data \n");
 		return;
 	}
 
 	while (uart_irq_rx_ready(uart_dev) && command_flag == false) {
 		uart_fifo_read(uart_dev, &c, 1);
-		printk("received %c \n",c);
+		OWNTECH_LOG("received %c \n",c);
 		buf_req[0] = c;
 		command_flag = true;
 	}
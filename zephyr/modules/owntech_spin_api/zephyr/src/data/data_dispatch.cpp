@@ -34,10 +34,15 @@
 /* OwnTech API */
 #include "adc.h"
 #include "SpinAPI.h"
+#include "ccm.h"
 
 /* Current module header */
 #include "dma.h"
 
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+#include "fmac.h"
+#endif
+
 /* Current file header */
 #include "data_dispatch.h"
 
@@ -92,6 +97,17 @@ static size_t    dma_buffer_sizes[ADC_COUNT]      = {0};
 /* Dispatch method */
 static dispatch_t dispatch_type;
 
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+/**
+ * FMAC filter of each channel: channel_filter[x][y] is the filter
+ * number plus one of ADC x+1 Channel y, 0 if it is not filtered.
+ */
+static uint8_t channel_filter[ADC_COUNT][CHANNELS_PER_ADC] = {0};
+
+/* Number of filtered channels of each ADC */
+static uint8_t filtered_channels_count[ADC_COUNT] = {0};
+#endif
+
 /**
  * Private Functions
  */
@@ -128,6 +144,41 @@ __STATIC_INLINE void _data_dispatch_swap_buffers(uint8_t adc_index,
 	buffers_data_count[adc_index][channel_index] = 0;
 }
 
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+/**
+ * Filters in place the values appended to the active buffer of a channel.
+ * 12-bit raw values are shifted to positive q1.15 numbers for the FMAC.
+ */
+__STATIC_INLINE void _data_dispatch_filter(uint8_t adc_index,
+										   uint8_t channel_index,
+										   uint32_t first_value)
+{
+	uint8_t filter = channel_filter[adc_index][channel_index];
+	uint32_t count = _data_dispatch_get_count(adc_index, channel_index);
+
+	if ( (filter == 0) || (count <= first_value) )
+		return;
+
+	uint16_t* values = _data_dispatch_get_buffer(adc_index, channel_index)
+					 + first_value;
+	int16_t* samples = (int16_t*)values;
+	uint32_t samples_count = count - first_value;
+
+	for (uint32_t i = 0 ; i < samples_count ; i++)
+	{
+		samples[i] = (int16_t)(values[i] << 3);
+	}
+
+	/* Values not returned by a stalled accelerator stay unfiltered */
+	fmac_filter_run(filter - 1, samples, samples, samples_count);
+
+	for (uint32_t i = 0 ; i < samples_count ; i++)
+	{
+		values[i] = (samples[i] > 0) ? (uint16_t)(samples[i] >> 3) : 0;
+	}
+}
+#endif
+
 /**
  * Public API
  */
@@ -272,7 +323,7 @@ void data_dispatch_init(dispatch_t dispatch_method, uint32_t repetitions)
 	}
 }
 
-void data_dispatch_do_dispatch(uint8_t adc_num)
+OWNTECH_CCM_FUNC void data_dispatch_do_dispatch(uint8_t adc_num)
 {
 	uint8_t adc_index = adc_num - 1;
 
@@ -303,6 +354,21 @@ void data_dispatch_do_dispatch(uint8_t adc_num)
 		data_count_in_dma_buffer = dma_get_retrieved_data_count(adc_num);
 	}
 
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+	/* Remember where new values start for filtered channels */
+	uint32_t first_new_value[CHANNELS_PER_ADC];
+	if (filtered_channels_count[adc_index] > 0)
+	{
+		for (uint8_t channel_index = 0 ;
+			 channel_index < enabled_channels_count[adc_index] ;
+			 channel_index++)
+		{
+			first_new_value[channel_index] =
+						_data_dispatch_get_count(adc_index, channel_index);
+		}
+	}
+#endif
+
 	for (size_t dma_index = 0 ;
 		 dma_index < data_count_in_dma_buffer ;
 		 dma_index++)
@@ -339,14 +405,36 @@ void data_dispatch_do_dispatch(uint8_t adc_num)
 		uint32_t  current_count =
 					_data_dispatch_get_count(adc_index, channel_index);
 
-		active_buffer[current_count] = dma_buffer[dma_buffer_index];
+		/**
+		 * Values acquired while the buffer is full are dropped, so that
+		 * the values after first_new_value are all new, and are filtered
+		 * once each, in order.
+		 */
+		if (current_count < CHANNELS_BUFFERS_SIZE)
+		{
+			active_buffer[current_count] = dma_buffer[dma_buffer_index];
+
+			/* Increment count */
+			_data_dispatch_increment_count(adc_index, channel_index);
+		}
+	}
 
-		/* Increment count */
-		_data_dispatch_increment_count(adc_index, channel_index);
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+	if (filtered_channels_count[adc_index] > 0)
+	{
+		for (uint8_t channel_index = 0 ;
+			 channel_index < enabled_channels_count[adc_index] ;
+			 channel_index++)
+		{
+			_data_dispatch_filter(adc_index,
+								  channel_index,
+								  first_new_value[channel_index]);
+		}
 	}
+#endif
 }
 
-void data_dispatch_do_full_dispatch()
+OWNTECH_CCM_FUNC void data_dispatch_do_full_dispatch()
 {
 	for (uint8_t adc_num = 1 ; adc_num <= ADC_COUNT ; adc_num++)
 	{
@@ -424,3 +512,30 @@ uint16_t data_dispatch_peek_acquired_value(uint8_t adc_number,
 		return 0;
 	}
 }
+
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+void data_dispatch_set_filter(uint8_t adc_number,
+							  uint8_t channel_rank,
+							  int8_t filter_number)
+{
+	uint8_t adc_index = adc_number-1;
+	uint8_t channel_index = channel_rank-1;
+
+	if ( (adc_index >= ADC_COUNT) || (channel_index >= CHANNELS_PER_ADC) )
+		return;
+
+	uint8_t previous = channel_filter[adc_index][channel_index];
+	uint8_t next = (filter_number < 0) ? 0 : (uint8_t)(filter_number + 1);
+
+	if ( (previous == 0) && (next != 0) )
+	{
+		filtered_channels_count[adc_index]++;
+	}
+	else if ( (previous != 0) && (next == 0) )
+	{
+		filtered_channels_count[adc_index]--;
+	}
+
+	channel_filter[adc_index][channel_index] = next;
+}
+#endif
@@ -114,5 +114,20 @@ uint16_t* data_dispatch_get_acquired_values(uint8_t adc_number,
 uint16_t data_dispatch_peek_acquired_value(uint8_t adc_number,
                                            uint8_t channel_rank);
 
+#ifdef CONFIG_OWNTECH_FMAC_DRIVER
+/**
+ * @brief  Filter the values of a channel with the FMAC as they are
+ *         dispatched. Filtered values replace the acquired ones.
+ *
+ * @param  adc_number Number of the ADC of the channel.
+ * @param  channel_rank Rank of the channel.
+ * @param  filter_number FMAC filter number, or -1 to stop
+ *         filtering the channel.
+ */
+void data_dispatch_set_filter(uint8_t adc_number,
+                              uint8_t channel_rank,
+                              int8_t filter_number);
+#endif
+
 
 #endif /* DATA_DISPATCH_H_ */
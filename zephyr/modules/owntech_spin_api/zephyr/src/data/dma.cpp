@@ -37,6 +37,9 @@
 /* Current module private functions */
 #include "data_dispatch.h"
 
+/* Event trace */
+#include "event_trace.h"
+
 /**
  *  DT definition
  */
@@ -47,13 +50,13 @@ static const struct device* dma1 = DEVICE_DT_GET(DT_NODELABEL(dma1));
  *  Local variables
  */
 
-static const uint32_t source_registers[5] =
+static const uintptr_t source_registers[5] =
 {
-	(uint32_t)(&(ADC1->DR)),
-	(uint32_t)(&(ADC2->DR)),
-	(uint32_t)(&(ADC3->DR)),
-	(uint32_t)(&(ADC4->DR)),
-	(uint32_t)(&(ADC5->DR))
+	(uintptr_t)(&(ADC1->DR)),
+	(uintptr_t)(&(ADC2->DR)),
+	(uintptr_t)(&(ADC3->DR)),
+	(uintptr_t)(&(ADC4->DR)),
+	(uintptr_t)(&(ADC5->DR))
 };
 
 static const uint32_t source_triggers[5] =
@@ -69,11 +72,11 @@ static size_t buffers_sizes[5] = {0};
 
 typedef struct
 {
-	bool     has_interrupt;
-	uint32_t src;
-	uint32_t dst;
-	size_t   size;
-	uint32_t channel;
+	bool      has_interrupt;
+	uintptr_t src;
+	uintptr_t dst;
+	size_t    size;
+	uint32_t  channel;
 } dma_user_data_t;
 
 static dma_user_data_t user_data[5] = {0};
@@ -99,6 +102,10 @@ static void _dma_callback(const struct device* dev,
 	/* Get user data for current channel */
 	dma_user_data_t* my_user_data = (dma_user_data_t*) user_data;
 
+	OWNTECH_TRACE((status == DMA_STATUS_COMPLETE) ? TRACE_EVENT_DMA_FULL
+	                                              : TRACE_EVENT_DMA_HALF,
+	              my_user_data->channel);
+
 	/* Do dispatch */
 	data_dispatch_do_dispatch(my_user_data->channel);
 
@@ -134,7 +141,7 @@ void dma_configure_adc_acquisition(uint8_t adc_number,
 	/* Private data for DMA channel */
 	user_data[dma_index].has_interrupt = !disable_interrupts;
 	user_data[dma_index].src           = source_registers[dma_index];
-	user_data[dma_index].dst           = (uint32_t)buffer;
+	user_data[dma_index].dst           = (uintptr_t)buffer;
 	user_data[dma_index].size          = buffer_size_bytes;
 	user_data[dma_index].channel       = adc_number;
 
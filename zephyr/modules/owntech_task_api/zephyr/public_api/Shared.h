@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Latest-value variable shared between the critical task and a
+ *         background task, never read torn and without disabling
+ *         interrupts.
+ */
+
+#ifndef SHARED_H_
+#define SHARED_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+/**
+ * @brief Variable with one writer context and any number of reader
+ *        contexts, holding a multi-word value such as a set of
+ *        set-points or measurements.
+ *
+ *        The value is double-buffered: the writer fills the slot that is
+ *        not published, then publishes it by incrementing a sequence
+ *        number. A reader copies the published slot and checks that the
+ *        sequence did not move, retrying otherwise.
+ *
+ *        A reader preempting the writer, e.g. the critical task reading a
+ *        value written by a background task, always gets the previously
+ *        published slot at the first try, since the writer only touches
+ *        the other one. A reader preempted by the writer retries once the
+ *        writer is done.
+ *
+ * @tparam T Type of the value, must be trivially copyable.
+ */
+template <typename T>
+class Shared
+{
+	static_assert(__is_trivially_copyable(T),
+				  "Shared value must be trivially copyable");
+
+public:
+
+	Shared() = default;
+
+	explicit Shared(const T& initial_value)
+	{
+		this->slots[0] = initial_value;
+	}
+
+	/**
+	 * @brief Publishes a new value. Writer side only.
+	 *
+	 * @param value Value to publish.
+	 */
+	void write(const T& value)
+	{
+		uint32_t sequence = __atomic_load_n(&this->sequence, __ATOMIC_RELAXED);
+
+		this->slots[(sequence + 1) & 1] = value;
+
+		/* Publish the slot after it is written */
+		__atomic_store_n(&this->sequence, sequence + 1, __ATOMIC_RELEASE);
+	}
+
+	/**
+	 * @brief Returns the last published value.
+	 */
+	T read() const
+	{
+		T value;
+		uint32_t before;
+		uint32_t after;
+
+		do
+		{
+			before = __atomic_load_n(&this->sequence, __ATOMIC_ACQUIRE);
+			value = this->slots[before & 1];
+
+			/* Do not let the copy move after the check */
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			after = __atomic_load_n(&this->sequence, __ATOMIC_RELAXED);
+		} while (before != after);
+
+		return value;
+	}
+
+	/**
+	 * @brief Returns the number of values published so far, to detect a
+	 *        new value without copying it.
+	 */
+	uint32_t version() const
+	{
+		return __atomic_load_n(&this->sequence, __ATOMIC_ACQUIRE);
+	}
+
+private:
+	uint32_t sequence = 0;
+	T slots[2] = {};
+
+};
+
+
+#endif /* SHARED_H_ */
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Wait-free single-producer single-consumer ring queue, to pass a
+ *         stream of values between the critical task and a background task
+ *         without disabling interrupts.
+ */
+
+#ifndef SPSCQUEUE_H_
+#define SPSCQUEUE_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+/**
+ * @brief Ring queue with exactly one producer context and one consumer
+ *        context, e.g. a background task pushing set-points and the
+ *        critical task popping them, or the other way around for
+ *        measurements.
+ *
+ *        Each index is only written by one side, so push() and pop() never
+ *        wait nor retry, and can be called from zero-latency interrupts.
+ *
+ * @tparam T    Type of the elements, copied by value.
+ * @tparam SIZE Number of elements, must be a power of two.
+ */
+template <typename T, uint32_t SIZE>
+class SpscQueue
+{
+	static_assert( (SIZE != 0) && ((SIZE & (SIZE - 1)) == 0),
+				   "SpscQueue size must be a power of two");
+
+public:
+
+	/**
+	 * @brief Adds an element at the end of the queue. Producer side only.
+	 *
+	 * @param value Element to add.
+	 * @return `true` if the element was added, `false` if the queue is full.
+	 */
+	bool push(const T& value)
+	{
+		uint32_t head = __atomic_load_n(&this->head, __ATOMIC_RELAXED);
+		uint32_t tail = __atomic_load_n(&this->tail, __ATOMIC_ACQUIRE);
+
+		if (head - tail == SIZE)
+			return false;
+
+		this->buffer[head & (SIZE - 1)] = value;
+
+		/* Publish the element after it is written */
+		__atomic_store_n(&this->head, head + 1, __ATOMIC_RELEASE);
+
+		return true;
+	}
+
+	/**
+	 * @brief Removes the element at the front of the queue. Consumer side
+	 *        only.
+	 *
+	 * @param value Variable receiving the element.
+	 * @return `true` if an element was retrieved, `false` if the queue is
+	 *         empty.
+	 */
+	bool pop(T& value)
+	{
+		uint32_t tail = __atomic_load_n(&this->tail, __ATOMIC_RELAXED);
+		uint32_t head = __atomic_load_n(&this->head, __ATOMIC_ACQUIRE);
+
+		if (head == tail)
+			return false;
+
+		value = this->buffer[tail & (SIZE - 1)];
+
+		/* Release the slot after it is read */
+		__atomic_store_n(&this->tail, tail + 1, __ATOMIC_RELEASE);
+
+		return true;
+	}
+
+	/**
+	 * @brief Number of elements in the queue. Exact on either side, a
+	 *        lower or upper bound seen from the other one.
+	 */
+	uint32_t size() const
+	{
+		return __atomic_load_n(&this->head, __ATOMIC_ACQUIRE) -
+			   __atomic_load_n(&this->tail, __ATOMIC_ACQUIRE);
+	}
+
+	bool empty() const
+	{
+		return this->size() == 0;
+	}
+
+	bool full() const
+	{
+		return this->size() == SIZE;
+	}
+
+	static constexpr uint32_t capacity()
+	{
+		return SIZE;
+	}
+
+private:
+	/* Free-running indexes, wrapping modulo 2^32 */
+	uint32_t head = 0; /* Written by the producer */
+	uint32_t tail = 0; /* Written by the consumer */
+	T buffer[SIZE];
+
+};
+
+
+#endif /* SPSCQUEUE_H_ */
@@ -26,6 +26,12 @@
 /* OwnTech Power API */
 #include "../src/uninterruptible_synchronous_task.h"
 #include "../src/asynchronous_tasks.h"
+#ifdef CONFIG_OWNTECH_TASK_PROFILER
+#include "../src/task_profiler.h"
+#endif
+#ifdef CONFIG_OWNTECH_TASK_MONITOR
+#include "../src/task_monitor.h"
+#endif
 
 
 /* Current class header */
@@ -48,9 +54,11 @@ TaskAPI task;
 /* Non-interruptable control task */
 int8_t TaskAPI::createCritical(task_function_t periodic_task,
 							   uint32_t task_period_us,
-							   scheduling_interrupt_source_t int_source)
+							   scheduling_interrupt_source_t int_source,
+							   uint8_t adc_number)
 {
 	scheduling_set_uninterruptible_synchronous_task_interrupt_source(int_source);
+	scheduling_set_uninterruptible_synchronous_task_adc(adc_number);
 
 	return scheduling_define_uninterruptible_synchronous_task(periodic_task,
 															  task_period_us);
@@ -66,6 +74,88 @@ void TaskAPI::stopCritical()
 	scheduling_stop_uninterruptible_synchronous_task();
 }
 
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+
+void TaskAPI::setCriticalOverrunPolicy(overrun_policy_t policy)
+{
+	scheduling_set_overrun_policy(policy);
+}
+
+uint32_t TaskAPI::getCriticalOverrunCount()
+{
+	return scheduling_get_overrun_count();
+}
+
+bool TaskAPI::isCriticalDegraded()
+{
+	return scheduling_is_degraded();
+}
+
+void TaskAPI::clearCriticalOverrun()
+{
+	scheduling_clear_overrun();
+}
+
+#endif /* CONFIG_OWNTECH_TASK_OVERRUN_DETECTION */
+
+#ifdef CONFIG_OWNTECH_TASK_MONITOR
+
+void TaskAPI::getLoad(task_load_t* load)
+{
+	task_monitor_get(load);
+}
+
+void TaskAPI::printLoad()
+{
+	task_monitor_print();
+}
+
+#endif /* CONFIG_OWNTECH_TASK_MONITOR */
+
+#ifdef CONFIG_OWNTECH_TASK_PROFILER
+
+void TaskAPI::enableCriticalProfiling(bool enable)
+{
+	task_profiler_enable(enable);
+}
+
+void TaskAPI::getCriticalProfile(critical_task_profile_t* profile)
+{
+	task_profiler_get(profile);
+}
+
+void TaskAPI::resetCriticalProfile()
+{
+	task_profiler_reset();
+}
+
+void TaskAPI::printCriticalProfile()
+{
+	task_profiler_print();
+}
+
+#endif /* CONFIG_OWNTECH_TASK_PROFILER */
+
+#if CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS > 0
+
+int8_t TaskAPI::createCriticalSubtask(task_function_t routine,
+									  uint32_t period_us,
+									  uint32_t phase,
+									  uint32_t budget_us)
+{
+	return scheduling_define_critical_subtask(routine,
+											  period_us,
+											  phase,
+											  budget_us);
+}
+
+uint32_t TaskAPI::getCriticalSubtasksWorstBudget()
+{
+	return scheduling_get_critical_subtasks_worst_budget();
+}
+
+#endif /* CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS > 0 */
+
 
 /* Asynchronous tasks */
 
@@ -76,6 +166,22 @@ int8_t TaskAPI::createBackground(task_function_t routine)
 	return scheduling_define_asynchronous_task(routine);
 }
 
+int8_t TaskAPI::createBackgroundPeriodic(task_function_t routine,
+										 uint32_t period_us)
+{
+	return scheduling_define_asynchronous_periodic_task(routine, period_us);
+}
+
+int8_t TaskAPI::createBackgroundOnEvent(task_function_t routine, k_sem* event)
+{
+	return scheduling_define_asynchronous_event_task(routine, event);
+}
+
+int8_t TaskAPI::signalBackground(uint8_t task_number)
+{
+	return scheduling_signal_asynchronous_task(task_number);
+}
+
 void TaskAPI::startBackground(uint8_t task_number)
 {
 	scheduling_start_asynchronous_task(task_number);
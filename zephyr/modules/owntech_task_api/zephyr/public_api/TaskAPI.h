@@ -32,6 +32,10 @@
 /* Zephyr */
 #include <zephyr/kernel.h>
 
+/* Inter-task communication */
+#include "SpscQueue.h"
+#include "Shared.h"
+
 /**
  *  Public types
  */
@@ -40,9 +44,89 @@ typedef void (*task_function_t)();
 
 typedef enum { source_uninitialized,
 			   source_hrtim,
-			   source_tim6 }
+			   source_tim6,
+			   source_adc }
 			   scheduling_interrupt_source_t;
 
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+/**
+ * @brief Action taken when the critical task is still running when its next
+ *        period starts.
+ *
+ * - overrun_log: only count the overrun. The next execution starts late.
+ * - overrun_skip: drop the pending event, the next execution starts on the
+ *   following period, keeping its phase.
+ * - overrun_degrade: drop the pending event and run the critical task only
+ *   once every CONFIG_OWNTECH_TASK_DEGRADED_DIVIDER periods until
+ *   clearCriticalOverrun() is called.
+ * - overrun_safety: call the safety action, which stops the power stage.
+ *   Without the Safety API, the critical task is stopped.
+ */
+typedef enum { overrun_log,
+			   overrun_skip,
+			   overrun_degrade,
+			   overrun_safety }
+			   overrun_policy_t;
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_MONITOR
+/**
+ * @brief CPU load of the tasks over the last measurement window, in per
+ *        mille of the CPU time, and stack usage of background tasks.
+ *
+ *        The critical task time is measured and removed from the time of
+ *        the task it preempted.
+ */
+typedef struct
+{
+	uint32_t window_ms;
+	uint16_t critical_permille;
+	uint16_t idle_permille;
+	uint8_t  background_count;
+	uint16_t background_permille[CONFIG_OWNTECH_TASK_MAX_ASYNCHRONOUS_TASKS];
+	uint32_t background_stack_used[CONFIG_OWNTECH_TASK_MAX_ASYNCHRONOUS_TASKS];
+	uint32_t background_stack_size[CONFIG_OWNTECH_TASK_MAX_ASYNCHRONOUS_TASKS];
+} task_load_t;
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_PROFILER
+/**
+ * @brief Execution profile of the critical task, in CPU cycles.
+ *
+ *        Execution is split in three phases: safety checks, data
+ *        dispatch, and user code (critical task and its subtasks).
+ *        Latency is the time between the interrupt event and the start
+ *        of the task.
+ *
+ *        Total and latency figures cover all the runs. The phases and the
+ *        latency histogram cover the sampled runs, folded every
+ *        millisecond from the last CONFIG_OWNTECH_TASK_PROFILER_SAMPLES
+ *        runs: all of them unless the task runs more often than that.
+ *        `record_max_cycles` is the cost of the profiler in the task,
+ *        measured with the cycle counter.
+ */
+typedef struct
+{
+	uint32_t runs;
+	uint32_t sampled_runs;
+	uint32_t cpu_frequency;
+	uint32_t total_min_cycles;
+	uint32_t total_mean_cycles;
+	uint32_t total_max_cycles;
+	uint32_t safety_mean_cycles;
+	uint32_t safety_max_cycles;
+	uint32_t dispatch_mean_cycles;
+	uint32_t dispatch_max_cycles;
+	uint32_t user_mean_cycles;
+	uint32_t user_max_cycles;
+	uint32_t latency_mean_cycles;
+	uint32_t latency_max_cycles;
+	uint32_t latency_bin_cycles;
+	uint32_t latency_histogram[CONFIG_OWNTECH_TASK_PROFILER_JITTER_BINS];
+	uint32_t record_max_cycles;
+} critical_task_profile_t;
+#endif
+
 /**
  *  Static class definition
  */
@@ -84,7 +168,17 @@ public:
 	 *        parameter can be provided to set TIM6 as the source in
 	 *        case the `HRTIM` is not used or if the task can't be
 	 *        correlated to an `HRTIM` event.
-	 *        Allowed values are source_hrtim and source_tim6.
+	 *        With source_adc, the `HRTIM` still gives the period, but the
+	 *        task runs from the end of conversion sequence interrupt of
+	 *        the ADC given by `adc_number`, as soon as the measures of
+	 *        the period are available. The ADC must be triggered once per
+	 *        `HRTIM` period, without discontinuous mode. Its latency gain
+	 *        over source_hrtim is measured on the host build only, see
+	 *        critical_latency_bench, not on the board yet.
+	 *        Allowed values are source_hrtim, source_tim6 and source_adc.
+	 *
+	 * @param adc_number ADC that triggers the task with source_adc,
+	 *        between 1 and 5. Ignored for other sources.
 	 * 
 	 * @return `0` if everything went well,
 	 *         `-1` if there was an error defining the task.
@@ -95,7 +189,8 @@ public:
 	int8_t createCritical(
 				task_function_t periodic_task,
 				uint32_t task_period_us,
-				scheduling_interrupt_source_t int_source = source_hrtim
+				scheduling_interrupt_source_t int_source = source_hrtim,
+				uint8_t adc_number = 1
 			);
 
 	/**
@@ -127,6 +222,152 @@ public:
 	 */
 	void stopCritical();
 
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+
+	/**
+	 * @brief Sets the action taken when the critical task overruns its
+	 *        period, i.e. when the next interrupt event occurs before the
+	 *        current execution is over. Default is `overrun_log`.
+	 *
+	 * @param policy One of `overrun_log`, `overrun_skip`, `overrun_degrade`
+	 *        or `overrun_safety`.
+	 */
+	void setCriticalOverrunPolicy(overrun_policy_t policy);
+
+	/**
+	 * @brief Returns the number of overruns of the critical task since it
+	 *        was started or since the last call to clearCriticalOverrun().
+	 */
+	uint32_t getCriticalOverrunCount();
+
+	/**
+	 * @brief Returns `true` if the critical task runs in degraded mode
+	 *        after an overrun with the `overrun_degrade` policy.
+	 */
+	bool isCriticalDegraded();
+
+	/**
+	 * @brief Clears the overrun count and returns to the nominal rate if
+	 *        the critical task was in degraded mode, at its next
+	 *        execution. Count and mode read until then are cleared ones.
+	 */
+	void clearCriticalOverrun();
+
+#endif /* CONFIG_OWNTECH_TASK_OVERRUN_DETECTION */
+
+#ifdef CONFIG_OWNTECH_TASK_MONITOR
+
+	/**
+	 * @brief Copies the CPU load of the critical task, of each background
+	 *        task and of the idle thread measured over the last window of
+	 *        CONFIG_OWNTECH_TASK_MONITOR_PERIOD_MS, along with the stack
+	 *        high watermark of each background task.
+	 *
+	 * @param load Structure to fill.
+	 */
+	void getLoad(task_load_t* load);
+
+	/**
+	 * @brief Prints the CPU load and stack usage on the console.
+	 *
+	 *        DO NOT use this function in a critical task!
+	 */
+	void printLoad();
+
+#endif /* CONFIG_OWNTECH_TASK_MONITOR */
+
+#ifdef CONFIG_OWNTECH_TASK_PROFILER
+
+	/**
+	 * @brief Switches the critical task profiler on or off.
+	 *
+	 *        When on, each execution of the critical task reads the DWT
+	 *        cycle counter five times, updates 32-bit counters and stores
+	 *        its stamps, and a kernel timer folds them into the statistics
+	 *        every millisecond. When off, the cost is a single test. The
+	 *        profiler is only built with CONFIG_OWNTECH_TASK_PROFILER.
+	 *
+	 * @param enable `true` to profile, `false` to stop.
+	 */
+	void enableCriticalProfiling(bool enable = true);
+
+	/**
+	 * @brief Copies the critical task profile gathered since the last
+	 *        reset. Can be called from a background task.
+	 *
+	 * @param profile Structure to fill.
+	 */
+	void getCriticalProfile(critical_task_profile_t* profile);
+
+	/**
+	 * @brief Clears the critical task profile, at the next execution of
+	 *        the critical task. Profiles read until then are empty.
+	 */
+	void resetCriticalProfile();
+
+	/**
+	 * @brief Prints the critical task profile on the console.
+	 *
+	 *        DO NOT use this function in a critical task!
+	 */
+	void printCriticalProfile();
+
+#endif /* CONFIG_OWNTECH_TASK_PROFILER */
+
+#if CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS > 0
+
+	/**
+	 * @brief Creates a critical subtask.
+	 *
+	 *        A critical subtask runs in the critical task context, right
+	 *        after the critical task, once every `period_us` / critical task
+	 *        period executions. This allows several control loops at
+	 *        different rates without hand-written counters, e.g. a current
+	 *        loop in the critical task at 50 kHz, a voltage loop subtask at
+	 *        5 kHz and a supervisory subtask at 500 Hz.
+	 *
+	 *        Subtasks of different periods can be given different phases so
+	 *        that they do not run on the same critical task execution.
+	 *
+	 *        A static check is done on the budgets: the worst sum of subtask
+	 *        budgets on a single execution must stay below the critical task
+	 *        period. The critical task itself must fit in the remaining time.
+	 *
+	 * @note  The critical task must have been created, and not started,
+	 *        before calling this function.
+	 *
+	 * @param routine Pointer to the void(void) function to execute.
+	 *
+	 * @param period_us Period of the subtask in µs. Must be an integer
+	 *        multiple of the critical task period.
+	 *
+	 * @param phase Index of the critical task execution on which the
+	 *        subtask runs, between `0` and the period ratio minus 1.
+	 *        E.g. with a 20 µs critical task and a 200 µs subtask, a phase
+	 *        of `3` runs the subtask on executions 3, 13, 23...
+	 *
+	 * @param budget_us Worst case execution time of the subtask in µs,
+	 *        `0` to skip it in the budget check.
+	 *
+	 * @return Number assigned to the subtask, or `-1` if it could not be
+	 *         created: invalid parameters, budget exceeded, or maximum
+	 *         number of subtasks reached (increase it in prj.conf if
+	 *         required).
+	 */
+	int8_t createCriticalSubtask(task_function_t routine,
+								 uint32_t period_us,
+								 uint32_t phase = 0,
+								 uint32_t budget_us = 0);
+
+	/**
+	 * @brief Returns the worst sum of critical subtask budgets falling on
+	 *        a single execution of the critical task, in µs. The critical
+	 *        task itself must fit in the period minus this value.
+	 */
+	uint32_t getCriticalSubtasksWorstBudget();
+
+#endif /* CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS > 0 */
+
 
 #ifdef CONFIG_OWNTECH_TASK_ENABLE_ASYNCHRONOUS_TASKS
 
@@ -145,6 +386,61 @@ public:
 	 */
 	int8_t createBackground(task_function_t routine);
 
+	/**
+	 * @brief Creates a periodic background task.
+	 *
+	 *        Unlike a task created with createBackground(), the routine is
+	 *        called once per period and the task sleeps in between, leaving
+	 *        the CPU idle. Deadlines do not drift with the routine duration.
+	 *
+	 * @param routine Pointer to the void(void) function called on each
+	 *        period. It must return, and must not wait or loop.
+	 * @param period_us Period of the task in µs, rounded to the kernel
+	 *        tick.
+	 * @return Number assigned to the task, to be started with
+	 *         startBackground(). Will be -1 if the period is 0 or if max
+	 *         number of asynchronous task has been reached.
+	 */
+	int8_t createBackgroundPeriodic(task_function_t routine,
+									uint32_t period_us);
+
+	/**
+	 * @brief Creates an event-driven background task.
+	 *
+	 *        The routine is called each time the event semaphore is given,
+	 *        using k_sem_give() from a thread or an interrupt. The task
+	 *        sleeps in between. Events given while the routine runs are
+	 *        counted up to the semaphore limit.
+	 *
+	 *        The critical task must never call k_sem_give(): it is a zero
+	 *        latency interrupt, which the kernel does not expect. It wakes
+	 *        the task with signalBackground() instead.
+	 *
+	 * @param routine Pointer to the void(void) function called on each
+	 *        event. It must return, and must not loop.
+	 * @param event Semaphore used as event, e.g. defined with
+	 *        `K_SEM_DEFINE(my_event, 0, 1)`.
+	 * @return Number assigned to the task, to be started with
+	 *         startBackground(). Will be -1 if the event is `NULL` or if
+	 *         max number of asynchronous task has been reached.
+	 */
+	int8_t createBackgroundOnEvent(task_function_t routine, k_sem* event);
+
+	/**
+	 * @brief Wakes an event-driven background task from the critical task.
+	 *
+	 *        The task is marked as signaled, and a software interrupt of
+	 *        normal priority gives its event semaphore once the critical
+	 *        task returns. Signals sent before the task runs are counted
+	 *        up to the semaphore limit, several signals in the same
+	 *        critical task run counting once.
+	 *
+	 * @param task_number Number of the task, obtained with
+	 *        createBackgroundOnEvent().
+	 * @return 0 on success, -1 if the task is not event-driven.
+	 */
+	int8_t signalBackground(uint8_t task_number);
+
 	/**
 	 * @brief Use this function to start a previously defined
 	 *        background task using its task number.
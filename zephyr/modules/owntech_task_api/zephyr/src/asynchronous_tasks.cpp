@@ -27,6 +27,13 @@
 #include "asynchronous_tasks.h"
 #include "scheduling_common.h"
 
+/* Event trace */
+#include "event_trace.h"
+
+#ifdef CONFIG_OWNTECH_TASK_MONITOR
+#include "task_monitor.h"
+#endif
+
 
 static K_THREAD_STACK_ARRAY_DEFINE(
 			asynchronous_thread_stack,
@@ -40,6 +47,30 @@ static uint8_t task_count = 0;
 
 static const int ASYNCHRONOUS_THREADS_PRIORITY = 14;
 
+/* Software interrupt giving the events signaled by the critical task, on
+   a line no peripheral raises */
+#define SIGNAL_IRQ_NUMBER CONFIG_OWNTECH_TASK_SIGNAL_IRQ
+static const uint8_t SIGNAL_IRQ_PRIO = 3;
+
+/* Lines of the OwnTech drivers: RS485 DMA, ADC end of sequence, TIM6,
+   burst DMA, HRTIM, CORDIC and FMAC */
+BUILD_ASSERT( (SIGNAL_IRQ_NUMBER != DMA1_Channel7_IRQn) &&
+			  (SIGNAL_IRQ_NUMBER != ADC1_2_IRQn) &&
+			  (SIGNAL_IRQ_NUMBER != ADC3_IRQn) &&
+			  (SIGNAL_IRQ_NUMBER != ADC4_IRQn) &&
+			  (SIGNAL_IRQ_NUMBER != ADC5_IRQn) &&
+			  (SIGNAL_IRQ_NUMBER != TIM6_DAC_IRQn) &&
+			  (SIGNAL_IRQ_NUMBER != DMA2_Channel1_IRQn) &&
+			  ( (SIGNAL_IRQ_NUMBER < HRTIM1_Master_IRQn) ||
+				(SIGNAL_IRQ_NUMBER > HRTIM1_TIMF_IRQn) ) &&
+			  (SIGNAL_IRQ_NUMBER != CORDIC_IRQn) &&
+			  (SIGNAL_IRQ_NUMBER != FMAC_IRQn),
+			  "CONFIG_OWNTECH_TASK_SIGNAL_IRQ is used by a driver");
+
+/* Bit n set when task n was signaled and its event is not given yet */
+static atomic_t signaled_tasks = ATOMIC_INIT(0);
+static bool signal_irq_connected = false;
+
 
 void _scheduling_user_asynchronous_task_entry_point(void* thread_function_p,
 													void*,
@@ -52,8 +83,62 @@ void _scheduling_user_asynchronous_task_entry_point(void* thread_function_p,
 	}
 }
 
-int8_t scheduling_define_asynchronous_task(task_function_t routine)
+void _scheduling_user_periodic_task_entry_point(void* thread_function_p,
+												void* task_info_p,
+												void*)
+{
+	task_information_t* task_info = (task_information_t*)task_info_p;
+
+	while(1)
+	{
+		/* Deadlines are given by the periodic timer, not by the end of the
+		   previous run: a late run does not delay the following ones */
+		k_timer_status_sync(&task_info->timer);
+		((task_function_t)thread_function_p)();
+	}
+}
+
+void _scheduling_user_event_task_entry_point(void* thread_function_p,
+											 void* task_info_p,
+											 void*)
+{
+	task_information_t* task_info = (task_information_t*)task_info_p;
+
+	while(1)
+	{
+		k_sem_take(task_info->event, K_FOREVER);
+		((task_function_t)thread_function_p)();
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Software interrupt at a kernel-aware priority:
+ *        gives the events of the signaled tasks.
+ */
+static void _signal_callback(const void* arg)
 {
+	ARG_UNUSED(arg);
+
+	atomic_val_t signaled = atomic_clear(&signaled_tasks);
+
+	for (uint8_t task_number = 0 ; task_number < task_count ; task_number++)
+	{
+		if ((signaled & (1 << task_number)) != 0)
+		{
+			k_sem_give(tasks_information[task_number].event);
+		}
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Reserves a task slot and fills the fields
+ *        common to all kinds of asynchronous tasks.
+ */
+static int8_t _define_task(task_function_t routine)
+{
+	if (routine == NULL)
+		return -1;
+
 	if (task_count < CONFIG_OWNTECH_TASK_MAX_ASYNCHRONOUS_TASKS)
 	{
 		uint8_t task_number = task_count;
@@ -70,6 +155,9 @@ int8_t scheduling_define_asynchronous_task(task_function_t routine)
 		tasks_information[task_number].stack_size  =
 				K_THREAD_STACK_SIZEOF(asynchronous_thread_stack[task_number]);
 
+		tasks_information[task_number].period_us   = 0;
+		tasks_information[task_number].event       = NULL;
+
 		tasks_information[task_number].status      = task_status_t::defined;
 
 		return task_number;
@@ -80,23 +168,119 @@ int8_t scheduling_define_asynchronous_task(task_function_t routine)
 	}
 }
 
+int8_t scheduling_define_asynchronous_task(task_function_t routine)
+{
+	return _define_task(routine);
+}
+
+int8_t scheduling_define_asynchronous_periodic_task(task_function_t routine,
+													uint32_t period_us)
+{
+	if (period_us == 0)
+		return -1;
+
+	int8_t task_number = _define_task(routine);
+
+	if (task_number < 0)
+		return -1;
+
+	tasks_information[task_number].period_us = period_us;
+	k_timer_init(&tasks_information[task_number].timer, NULL, NULL);
+
+	return task_number;
+}
+
+int8_t scheduling_define_asynchronous_event_task(task_function_t routine,
+												 k_sem* event)
+{
+	if (event == NULL)
+		return -1;
+
+	/* Another driver enabled the signal line */
+	if ( (signal_irq_connected == false) &&
+		 (irq_is_enabled(SIGNAL_IRQ_NUMBER) != 0) )
+		return -1;
+
+	int8_t task_number = _define_task(routine);
+
+	if (task_number < 0)
+		return -1;
+
+	tasks_information[task_number].event = event;
+
+	if (signal_irq_connected == false)
+	{
+		IRQ_CONNECT(SIGNAL_IRQ_NUMBER,
+					SIGNAL_IRQ_PRIO,
+					_signal_callback,
+					NULL,
+					0);
+		irq_enable(SIGNAL_IRQ_NUMBER);
+		signal_irq_connected = true;
+	}
+
+	return task_number;
+}
+
+int8_t scheduling_signal_asynchronous_task(uint8_t task_number)
+{
+	if ( (task_number >= task_count) ||
+		 (tasks_information[task_number].event == NULL) )
+		return -1;
+
+	/* Atomic without masking interrupts, which does not hold off the
+	   critical task anyway */
+	atomic_or(&signaled_tasks, 1 << task_number);
+	NVIC_SetPendingIRQ((IRQn_Type)SIGNAL_IRQ_NUMBER);
+
+	return 0;
+}
+
 void scheduling_start_asynchronous_task(uint8_t task_number)
 {
 	if (task_number < task_count)
 	{
-		if (tasks_information[task_number].status == task_status_t::defined)
+		task_information_t& task_info = tasks_information[task_number];
+
+		if ( (task_info.status == task_status_t::defined) ||
+			 (task_info.status == task_status_t::suspended) )
 		{
-			scheduling_common_start_task(
-				tasks_information[task_number],
-				_scheduling_user_asynchronous_task_entry_point);
+			if (task_info.period_us != 0)
+			{
+				/* First run one period after start */
+				k_timer_start(&task_info.timer,
+							  K_USEC(task_info.period_us),
+							  K_USEC(task_info.period_us));
+			}
+		}
+
+		if (task_info.status == task_status_t::defined)
+		{
+			k_thread_entry_t entry_point =
+				_scheduling_user_asynchronous_task_entry_point;
+
+			if (task_info.period_us != 0)
+			{
+				entry_point = _scheduling_user_periodic_task_entry_point;
+			}
+			else if (task_info.event != NULL)
+			{
+				entry_point = _scheduling_user_event_task_entry_point;
+			}
 
-			tasks_information[task_number].status = task_status_t::running;
+			scheduling_common_start_task(task_info, entry_point);
+			OWNTECH_TRACE_THREAD(task_info.thread_id, task_number);
+
+#ifdef CONFIG_OWNTECH_TASK_MONITOR
+			task_monitor_register(task_number, task_info.thread_id);
+#endif
+
+			task_info.status = task_status_t::running;
 		}
-		else if (tasks_information[task_number].status ==
-				 task_status_t::suspended)
+		else if (task_info.status == task_status_t::suspended)
 		{
-			scheduling_common_resume_task(tasks_information[task_number]);
-			tasks_information[task_number].status = task_status_t::running;
+			scheduling_common_resume_task(task_info);
+			task_info.status = task_status_t::running;
 		}
 	}
 }
@@ -107,11 +291,30 @@ void scheduling_stop_asynchronous_task(uint8_t task_number)
 	{
 		if (tasks_information[task_number].status == task_status_t::running)
 		{
+			if (tasks_information[task_number].period_us != 0)
+			{
+				k_timer_stop(&tasks_information[task_number].timer);
+			}
+
 			scheduling_common_suspend_task(tasks_information[task_number]);
 			tasks_information[task_number].status = task_status_t::suspended;
 		}
 	}
 }
 
+uint8_t scheduling_get_asynchronous_task_count()
+{
+	return task_count;
+}
+
+const task_information_t* scheduling_get_asynchronous_task_information(
+													uint8_t task_number)
+{
+	if (task_number >= task_count)
+		return NULL;
+
+	return &tasks_information[task_number];
+}
+
 
 #endif /* CONFIG_OWNTECH_TASK_ENABLE_ASYNCHRONOUS_TASKS */
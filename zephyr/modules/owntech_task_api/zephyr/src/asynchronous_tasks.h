@@ -32,6 +32,7 @@
 
 /* OwnTech Power API */
 #include "TaskAPI.h"
+#include "scheduling_common.h"
 
 
 #ifdef CONFIG_OWNTECH_TASK_ENABLE_ASYNCHRONOUS_TASKS
@@ -54,6 +55,58 @@
  */
 int8_t scheduling_define_asynchronous_task(task_function_t routine);
 
+/**
+ * @brief Define a new periodic asynchronous task.
+ *
+ * The routine is called once per period by a thread that sleeps on a
+ * periodic kernel timer in between. Deadlines are multiples of the period
+ * from the task start, so that they do not drift with the routine
+ * execution time.
+ *
+ * @param routine Pointer to the function called on each period. It must
+ *                return, and not loop.
+ * @param period_us Period in microseconds, rounded to the kernel tick.
+ *
+ * @return The task number (`>= 0`) on success,
+ *         or `-1` if the period is 0 or the task limit has been reached.
+ */
+int8_t scheduling_define_asynchronous_periodic_task(task_function_t routine,
+                                                    uint32_t period_us);
+
+/**
+ * @brief Define a new event-driven asynchronous task.
+ *
+ * The routine is called each time the semaphore is given, e.g. from a DMA
+ * or CAN interrupt, and the thread sleeps in between. The critical task
+ * must not give the semaphore: it signals the task with
+ * `scheduling_signal_asynchronous_task()`.
+ *
+ * @param routine Pointer to the function called on each event. It must
+ *                return, and not loop.
+ * @param event Semaphore given to wake the task.
+ *
+ * @return The task number (`>= 0`) on success,
+ *         or `-1` if the semaphore is `NULL` or the task limit has been
+ *         reached.
+ */
+int8_t scheduling_define_asynchronous_event_task(task_function_t routine,
+                                                 k_sem* event);
+
+/**
+ * @brief Signal an event-driven asynchronous task from the critical task.
+ *
+ * The critical task is a zero-latency interrupt, from which kernel calls
+ * such as k_sem_give() are not allowed. The task is marked as signaled and
+ * a software interrupt of normal priority is pended, which gives its
+ * semaphore once the critical task returns.
+ *
+ * @param task_number Index of the task, as returned by
+ *        `scheduling_define_asynchronous_event_task()`.
+ *
+ * @return `0` on success, or `-1` if the task is not event-driven.
+ */
+int8_t scheduling_signal_asynchronous_task(uint8_t task_number);
+
 /**
  * @brief Start or resume an asynchronous task.
  *
@@ -76,6 +129,22 @@ void scheduling_start_asynchronous_task(uint8_t task_number);
  */
 void scheduling_stop_asynchronous_task(uint8_t task_number);
 
+/**
+ * @brief Get the number of defined asynchronous tasks.
+ */
+uint8_t scheduling_get_asynchronous_task_count();
+
+/**
+ * @brief Get the information of an asynchronous task, e.g. its thread.
+ *
+ * @param task_number Index of the task.
+ *
+ * @return Pointer to the task information, or `NULL` if the task does not
+ *         exist.
+ */
+const task_information_t* scheduling_get_asynchronous_task_information(
+                                                    uint8_t task_number);
+
 
 #endif /* CONFIG_OWNTECH_TASK_ENABLE_ASYNCHRONOUS_TASKS */
 
@@ -33,7 +33,7 @@ void scheduling_common_start_task(task_information_t& task_info,
 	                              task_info.stack,
 	                              task_info.stack_size,
 	                              entry_point,
-	                              (void*)task_info.routine, NULL, NULL,
+	                              (void*)task_info.routine, (void*)&task_info, NULL,
 	                              task_info.priority,
 	                              K_FP_REGS,
 	                              K_NO_WAIT);
@@ -55,6 +55,9 @@ typedef struct
 	k_tid_t thread_id;
 	k_thread thread_data;
 	task_status_t status;
+	uint32_t period_us;  /* Non-zero for a periodic task */
+	k_timer timer;
+	k_sem* event;        /* Non-null for an event-driven task */
 } task_information_t;
 
 /**
@@ -62,7 +65,7 @@ typedef struct
  *
  * This function creates a thread for the given task using its stack,
  * priority, and entry point. The entry point will receive the task routine
- * as its first argument.
+ * as its first argument, and the task information as its second argument.
  *
  * @param task_info   Reference to the task information structure.
  *                    Must contain valid stack, size, priority, and routine.
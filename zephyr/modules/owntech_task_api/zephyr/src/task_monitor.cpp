@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+
+/* Stdlib */
+#include <string.h>
+
+/* Zephyr */
+#include <zephyr/init.h>
+#ifdef CONFIG_STATS
+#include <zephyr/stats/stats.h>
+#endif
+
+/* Current module */
+#include "asynchronous_tasks.h"
+
+/* Current file header */
+#include "task_monitor.h"
+
+
+/**
+ *  Local variables
+ */
+
+uint32_t task_monitor_critical_cycles[TASK_MONITOR_SLOTS];
+k_tid_t task_monitor_threads[CONFIG_OWNTECH_TASK_MAX_ASYNCHRONOUS_TASKS];
+
+/* Counters at the beginning of the current window */
+static uint32_t window_start;
+static uint32_t critical_start[TASK_MONITOR_SLOTS];
+static uint64_t thread_start[CONFIG_OWNTECH_TASK_MAX_ASYNCHRONOUS_TASKS];
+static uint64_t idle_start;
+
+/* Result of the last complete window */
+static task_load_t last_load;
+static struct k_spinlock last_load_lock;
+
+static void _task_monitor_window(struct k_work* work);
+static K_WORK_DELAYABLE_DEFINE(window_work, _task_monitor_window);
+
+#ifdef CONFIG_STATS
+STATS_SECT_START(owntech_task)
+STATS_SECT_ENTRY32(critical_load)
+STATS_SECT_ENTRY32(idle_load)
+STATS_SECT_ENTRY32(background0_load)
+STATS_SECT_ENTRY32(background1_load)
+STATS_SECT_ENTRY32(background2_load)
+STATS_SECT_ENTRY32(background3_load)
+STATS_SECT_ENTRY32(background4_load)
+STATS_SECT_ENTRY32(background0_stack)
+STATS_SECT_ENTRY32(background1_stack)
+STATS_SECT_ENTRY32(background2_stack)
+STATS_SECT_ENTRY32(background3_stack)
+STATS_SECT_ENTRY32(background4_stack)
+STATS_SECT_END;
+
+STATS_NAME_START(owntech_task)
+STATS_NAME(owntech_task, critical_load)
+STATS_NAME(owntech_task, idle_load)
+STATS_NAME(owntech_task, background0_load)
+STATS_NAME(owntech_task, background1_load)
+STATS_NAME(owntech_task, background2_load)
+STATS_NAME(owntech_task, background3_load)
+STATS_NAME(owntech_task, background4_load)
+STATS_NAME(owntech_task, background0_stack)
+STATS_NAME(owntech_task, background1_stack)
+STATS_NAME(owntech_task, background2_stack)
+STATS_NAME(owntech_task, background3_stack)
+STATS_NAME(owntech_task, background4_stack)
+STATS_NAME_END(owntech_task);
+
+static STATS_SECT_DECL(owntech_task) task_stats;
+#endif
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Share of a number of cycles over the window,
+ *        in per mille.
+ */
+static uint16_t _permille(uint64_t cycles, uint32_t window)
+{
+	if (window == 0)
+		return 0;
+
+	uint64_t permille = (cycles * 1000) / window;
+
+	return (permille > 1000) ? 1000 : (uint16_t)permille;
+}
+
+#ifdef CONFIG_STATS
+/**
+ * @brief PRIVATE FUNCTION - Copies a load report to the stats group.
+ */
+static void _task_monitor_update_stats(const task_load_t& load)
+{
+	uint32_t* background_load = &task_stats.s_background0_load;
+	uint32_t* background_stack = &task_stats.s_background0_stack;
+
+	STATS_SET(task_stats, critical_load, load.critical_permille);
+	STATS_SET(task_stats, idle_load, load.idle_permille);
+
+	for (uint8_t i = 0 ; i < load.background_count ; i++)
+	{
+		background_load[i] = load.background_permille[i];
+		background_stack[i] = load.background_stack_used[i];
+	}
+}
+#endif
+
+/**
+ * @brief PRIVATE FUNCTION - Closes the current measurement window and
+ *        opens the next one.
+ */
+static void _task_monitor_window(struct k_work* work)
+{
+	task_load_t load;
+	uint32_t critical_now[TASK_MONITOR_SLOTS];
+	uint32_t critical_delta[TASK_MONITOR_SLOTS];
+	uint32_t critical_total = 0;
+
+	memset(&load, 0, sizeof(load));
+
+	uint32_t now = task_monitor_now();
+	uint32_t window = now - window_start;
+	window_start = now;
+
+	for (uint8_t slot = 0 ; slot < TASK_MONITOR_SLOTS ; slot++)
+	{
+		critical_now[slot] = task_monitor_critical_cycles[slot];
+		critical_delta[slot] = critical_now[slot] - critical_start[slot];
+		critical_start[slot] = critical_now[slot];
+		critical_total += critical_delta[slot];
+	}
+
+	load.window_ms = (uint32_t)(((uint64_t)window * 1000) /
+								CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC);
+	load.critical_permille = _permille(critical_total, window);
+
+	/* Zephyr charges interrupt time to the preempted thread */
+	k_thread_runtime_stats_t stats;
+	k_thread_runtime_stats_all_get(&stats);
+	uint64_t idle = stats.idle_cycles - idle_start;
+	idle_start = stats.idle_cycles;
+	idle -= MIN(idle, (uint64_t)critical_delta[TASK_MONITOR_SLOT_IDLE]);
+	load.idle_permille = _permille(idle, window);
+
+	load.background_count = scheduling_get_asynchronous_task_count();
+
+	for (uint8_t i = 0 ; i < load.background_count ; i++)
+	{
+		const task_information_t* task =
+				scheduling_get_asynchronous_task_information(i);
+
+		if ( (task == NULL) || (task->status == task_status_t::defined) )
+			continue;
+
+		k_thread_runtime_stats_get(task->thread_id, &stats);
+		uint64_t cycles = stats.execution_cycles - thread_start[i];
+		thread_start[i] = stats.execution_cycles;
+		cycles -= MIN(cycles, (uint64_t)critical_delta[i]);
+
+		load.background_permille[i] = _permille(cycles, window);
+
+		size_t unused = 0;
+		k_thread_stack_space_get(task->thread_id, &unused);
+		load.background_stack_size[i] = task->stack_size;
+		load.background_stack_used[i] = task->stack_size - unused;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&last_load_lock);
+	last_load = load;
+	k_spin_unlock(&last_load_lock, key);
+
+#ifdef CONFIG_STATS
+	_task_monitor_update_stats(load);
+#endif
+
+	k_work_schedule(&window_work, K_MSEC(CONFIG_OWNTECH_TASK_MONITOR_PERIOD_MS));
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Starts the cycle counter, registers the stats
+ *        group and opens the first window.
+ */
+static int _task_monitor_init()
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+#ifdef CONFIG_STATS
+	stats_init_and_reg(STATS_HDR(task_stats),
+					   STATS_SIZE_INIT_PARMS(task_stats, STATS_SIZE_32),
+					   STATS_NAME_INIT_PARMS(owntech_task),
+					   "owntech_task");
+#endif
+
+	window_start = task_monitor_now();
+
+	k_work_schedule(&window_work, K_MSEC(CONFIG_OWNTECH_TASK_MONITOR_PERIOD_MS));
+
+	return 0;
+}
+
+SYS_INIT(_task_monitor_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+
+/* Public API */
+
+void task_monitor_get(task_load_t* load)
+{
+	if (load == nullptr)
+		return;
+
+	k_spinlock_key_t key = k_spin_lock(&last_load_lock);
+	*load = last_load;
+	k_spin_unlock(&last_load_lock, key);
+}
+
+void task_monitor_print()
+{
+	task_load_t load;
+
+	task_monitor_get(&load);
+
+	printk("CPU load over %u ms (per mille)\n", load.window_ms);
+	printk("  critical %u\n", load.critical_permille);
+	printk("  idle     %u\n", load.idle_permille);
+
+	for (uint8_t i = 0 ; i < load.background_count ; i++)
+	{
+		printk("  background %u: load %u, stack %u/%u bytes\n",
+			   i,
+			   load.background_permille[i],
+			   load.background_stack_used[i],
+			   load.background_stack_size[i]);
+	}
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  CPU load and stack usage monitor of the OwnTech tasks.
+ *
+ *         The critical task runs in an interrupt that Zephyr does not
+ *         account for: its execution time is measured with the DWT cycle
+ *         counter and subtracted from the thread it preempted. Background
+ *         task and idle times come from Zephyr thread runtime statistics.
+ */
+
+#ifndef TASK_MONITOR_H_
+#define TASK_MONITOR_H_
+
+/* Stdlib */
+#include <stdint.h>
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+#include <zephyr/kernel_structs.h>
+#include <soc.h>
+
+/* OwnTech Task API */
+#include "TaskAPI.h"
+
+
+/* Critical task cycles, charged to the thread it preempted.
+ * Slots 0 to MAX-1 are the background tasks, then idle, then others. */
+#define TASK_MONITOR_SLOT_IDLE  CONFIG_OWNTECH_TASK_MAX_ASYNCHRONOUS_TASKS
+#define TASK_MONITOR_SLOT_OTHER (CONFIG_OWNTECH_TASK_MAX_ASYNCHRONOUS_TASKS + 1)
+#define TASK_MONITOR_SLOTS      (CONFIG_OWNTECH_TASK_MAX_ASYNCHRONOUS_TASKS + 2)
+
+extern uint32_t task_monitor_critical_cycles[TASK_MONITOR_SLOTS];
+extern k_tid_t task_monitor_threads[CONFIG_OWNTECH_TASK_MAX_ASYNCHRONOUS_TASKS];
+
+/**
+ * @brief Read the cycle counter.
+ */
+static inline uint32_t task_monitor_now()
+{
+	return DWT->CYCCNT;
+}
+
+/**
+ * @brief Register the thread of a background task, once created, so that
+ *        the critical task time is charged to it from its first run.
+ *
+ * @param task_number Number of the background task.
+ * @param thread      Thread running the task.
+ */
+static inline void task_monitor_register(uint8_t task_number, k_tid_t thread)
+{
+	if (task_number < CONFIG_OWNTECH_TASK_MAX_ASYNCHRONOUS_TASKS)
+	{
+		task_monitor_threads[task_number] = thread;
+	}
+}
+
+/**
+ * @brief Account one execution of the critical task.
+ *
+ * @param cycles Execution time of the critical task in CPU cycles.
+ */
+static inline void task_monitor_record(uint32_t cycles)
+{
+	k_tid_t preempted = k_current_get();
+	uint8_t slot = TASK_MONITOR_SLOT_OTHER;
+
+	if (preempted == _kernel.cpus[0].idle_thread)
+	{
+		slot = TASK_MONITOR_SLOT_IDLE;
+	}
+	else
+	{
+		for (uint8_t i = 0 ; i < CONFIG_OWNTECH_TASK_MAX_ASYNCHRONOUS_TASKS ; i++)
+		{
+			if (preempted == task_monitor_threads[i])
+			{
+				slot = i;
+				break;
+			}
+		}
+	}
+
+	task_monitor_critical_cycles[slot] += cycles;
+}
+
+/**
+ * @brief Copy the load measured on the last window.
+ */
+void task_monitor_get(task_load_t* load);
+
+/**
+ * @brief Print the load measured on the last window on the console.
+ */
+void task_monitor_print();
+
+
+#endif /* TASK_MONITOR_H_ */
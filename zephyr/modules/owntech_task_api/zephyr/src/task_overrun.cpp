@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+
+/* Current module */
+#include "uninterruptible_synchronous_task.h"
+
+/* Current file header */
+#include "task_overrun.h"
+
+
+/**
+ *  Local variables
+ */
+
+volatile bool task_overrun_degraded = false;
+uint32_t task_overrun_degraded_countdown = 0;
+volatile uint32_t task_overrun_count = 0;
+
+/* Set by a clear, cleared by the task context once done */
+volatile bool task_overrun_clear_requested = false;
+
+static overrun_policy_t overrun_policy = overrun_log;
+
+
+/* Public API */
+
+overrun_action_t task_overrun_record()
+{
+	task_overrun_consume_clear();
+
+	task_overrun_count = task_overrun_count + 1;
+
+	switch (overrun_policy)
+	{
+		case overrun_skip:
+			return overrun_action_drop_event;
+		case overrun_degrade:
+			if (task_overrun_degraded == false)
+			{
+				task_overrun_degraded = true;
+				task_overrun_degraded_countdown =
+					CONFIG_OWNTECH_TASK_DEGRADED_DIVIDER - 1;
+			}
+			return overrun_action_drop_event;
+		case overrun_safety:
+			return overrun_action_stop;
+		case overrun_log:
+		default:
+			return overrun_action_none;
+	}
+}
+
+void scheduling_set_overrun_policy(overrun_policy_t policy)
+{
+	overrun_policy = policy;
+}
+
+uint32_t scheduling_get_overrun_count()
+{
+	if (task_overrun_clear_requested == true)
+		return 0;
+
+	return task_overrun_count;
+}
+
+bool scheduling_is_degraded()
+{
+	if (task_overrun_clear_requested == true)
+		return false;
+
+	return task_overrun_degraded;
+}
+
+void scheduling_clear_overrun()
+{
+	task_overrun_clear_requested = true;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Overrun policy of the uninterruptible synchronous task, shared
+ *         by the interrupt sources of the target and of the host build.
+ *
+ *         The source detects the overrun, i.e. the next event occurring
+ *         while the task runs, and performs the action returned by
+ *         task_overrun_record() on its event.
+ */
+
+#ifndef TASK_OVERRUN_H_
+#define TASK_OVERRUN_H_
+
+/* Stdlib */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* OwnTech Task API */
+#include "TaskAPI.h"
+
+
+/* Action of the interrupt source on an overrun */
+typedef enum
+{
+	overrun_action_none,       /* The pending event runs the task late */
+	overrun_action_drop_event, /* The pending event is dropped */
+	overrun_action_stop        /* The power stage or the task is stopped */
+} overrun_action_t;
+
+/* Internal state, shared with the inline hot path */
+extern volatile bool task_overrun_degraded;
+extern uint32_t task_overrun_degraded_countdown;
+extern volatile uint32_t task_overrun_count;
+extern volatile bool task_overrun_clear_requested;
+
+/**
+ * @brief Clears the overrun count and leaves degraded mode if a clear was
+ *        requested. The task context owns them, and cannot be masked, so
+ *        other contexts only request the clear.
+ */
+static inline void task_overrun_consume_clear()
+{
+	if (task_overrun_clear_requested == false)
+		return;
+
+	task_overrun_count = 0;
+	task_overrun_degraded = false;
+	task_overrun_clear_requested = false;
+}
+
+/**
+ * @brief In degraded mode, tells if the user code must be skipped on this
+ *        period. Only the last period out of each group runs it, with the
+ *        most recent data.
+ */
+static inline bool task_overrun_degraded_skip()
+{
+	task_overrun_consume_clear();
+
+	if (task_overrun_degraded == false)
+		return false;
+
+	if (task_overrun_degraded_countdown != 0)
+	{
+		task_overrun_degraded_countdown--;
+		return true;
+	}
+
+	task_overrun_degraded_countdown = CONFIG_OWNTECH_TASK_DEGRADED_DIVIDER - 1;
+	return false;
+}
+
+/**
+ * @brief Counts an overrun and applies the policy, entering degraded mode
+ *        if needed. Called by the interrupt source from the task context.
+ *
+ * @return Action to perform on the pending event.
+ */
+overrun_action_t task_overrun_record();
+
+
+#endif /* TASK_OVERRUN_H_ */
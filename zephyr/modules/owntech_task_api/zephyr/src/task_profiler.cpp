@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+
+/* Stdlib */
+#include <string.h>
+
+/* STM32 LL */
+#include <stm32_ll_hrtim.h>
+
+/* Current file header */
+#include "task_profiler.h"
+
+
+/* Period of the folding timer */
+#define PROFILER_FOLD_PERIOD_MS 1
+
+
+/**
+ *  Local variables
+ */
+
+bool task_profiler_enabled = false;
+task_profiler_data_t task_profiler_data = { 0, 0, UINT32_MAX };
+
+/* Odd while the critical task writes the counters */
+volatile uint32_t task_profiler_sequence = 0;
+
+/* Set by a reset, cleared by the critical task once done */
+volatile bool task_profiler_reset_requested = false;
+
+/* Counter of the interrupt source, reset on the task event */
+volatile uint32_t* task_profiler_latency_counter = nullptr;
+
+/* Latency in cycles = (counter * mul) >> shift */
+static uint32_t latency_mul = 0;
+static uint32_t latency_shift = 0;
+
+/* Dummy counter used when no source is set */
+static volatile uint32_t no_counter = 0;
+
+/* Statistics folded from the counters of the critical task */
+typedef struct
+{
+	uint32_t epoch;
+	uint32_t runs;
+	uint32_t total_sum;
+	uint32_t latency_ticks_sum;
+	uint64_t total;
+	uint64_t latency;
+	uint32_t samples;
+	uint32_t phase_max[PROFILER_STAMP_COUNT - 1];
+	uint64_t phase_sum[PROFILER_STAMP_COUNT - 1];
+	uint32_t latency_histogram[CONFIG_OWNTECH_TASK_PROFILER_JITTER_BINS];
+} task_profiler_folded_t;
+
+static task_profiler_folded_t folded = {};
+
+/* Copy of the counters being folded */
+static task_profiler_data_t snapshot;
+
+static struct k_timer fold_timer;
+static bool fold_timer_initialized = false;
+
+
+/* Private functions */
+
+/**
+ * @brief PRIVATE FUNCTION - Converts a counter of the interrupt source to
+ *        CPU cycles.
+ */
+static uint64_t _latency_cycles(uint32_t latency_ticks)
+{
+	return ((uint64_t)latency_ticks * latency_mul) >> latency_shift;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Folds the counters of the critical task into
+ *        the statistics: adds the sums since the previous fold, and the
+ *        samples of the runs since then that are still in the ring.
+ *        Must be called with interrupts locked.
+ */
+static void _fold()
+{
+	uint32_t sequence;
+
+	do
+	{
+		sequence = task_profiler_sequence;
+		__DMB();
+		snapshot = task_profiler_data;
+		__DMB();
+	} while ( ((sequence & 1) != 0) || (sequence != task_profiler_sequence) );
+
+	if (snapshot.epoch != folded.epoch)
+	{
+		memset(&folded, 0, sizeof(folded));
+		folded.epoch = snapshot.epoch;
+	}
+
+	folded.total   += snapshot.total_sum - folded.total_sum;
+	folded.latency += _latency_cycles(snapshot.latency_ticks_sum
+									  - folded.latency_ticks_sum);
+	folded.total_sum         = snapshot.total_sum;
+	folded.latency_ticks_sum = snapshot.latency_ticks_sum;
+
+	uint32_t first = folded.runs;
+	if ((snapshot.runs - first) > CONFIG_OWNTECH_TASK_PROFILER_SAMPLES)
+	{
+		first = snapshot.runs - CONFIG_OWNTECH_TASK_PROFILER_SAMPLES;
+	}
+
+	for (uint32_t run = first ; run != snapshot.runs ; run++)
+	{
+		const task_profiler_sample_t* sample =
+			&snapshot.samples[run & (CONFIG_OWNTECH_TASK_PROFILER_SAMPLES - 1)];
+
+		for (uint8_t i = 0 ; i < PROFILER_STAMP_COUNT - 1 ; i++)
+		{
+			uint32_t phase = sample->stamps[i + 1] - sample->stamps[i];
+			folded.phase_sum[i] += phase;
+			if (phase > folded.phase_max[i]) folded.phase_max[i] = phase;
+		}
+
+		uint64_t bin = _latency_cycles(sample->latency_ticks)
+					   / CONFIG_OWNTECH_TASK_PROFILER_JITTER_BIN_CYCLES;
+		if (bin >= CONFIG_OWNTECH_TASK_PROFILER_JITTER_BINS)
+		{
+			bin = CONFIG_OWNTECH_TASK_PROFILER_JITTER_BINS - 1;
+		}
+
+		folded.latency_histogram[bin]++;
+		folded.samples++;
+	}
+
+	folded.runs = snapshot.runs;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Folding timer expiry, keeps the 32-bit sums
+ *        from wrapping twice between folds.
+ */
+static void _fold_expiry(struct k_timer* timer)
+{
+	ARG_UNUSED(timer);
+
+	unsigned int key = irq_lock();
+	_fold();
+	irq_unlock(key);
+}
+
+
+/* Public API */
+
+void task_profiler_set_source(scheduling_interrupt_source_t int_source)
+{
+	if ( (int_source == source_hrtim) || (int_source == source_adc) )
+	{
+		/* HRTIM and CPU share the same 170MHz clock. The master counter
+		   runs at 32 times this clock divided by 2^CKPSC. With the ADC
+		   source, latency then includes the conversion time. */
+		task_profiler_latency_counter = &(HRTIM1->sMasterRegs.MCNTR);
+		latency_mul = 1 << LL_HRTIM_TIM_GetPrescaler(HRTIM1, LL_HRTIM_TIMER_MASTER);
+		latency_shift = 5;
+	}
+	else if (int_source == source_tim6)
+	{
+		/* TIM6 ticks every 0.1µs */
+		task_profiler_latency_counter = &(TIM6->CNT);
+		latency_mul = CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC / 10000000;
+		latency_shift = 0;
+	}
+	else
+	{
+		task_profiler_latency_counter = &no_counter;
+		latency_mul = 0;
+		latency_shift = 0;
+	}
+}
+
+void task_profiler_enable(bool enable)
+{
+	if (fold_timer_initialized == false)
+	{
+		k_timer_init(&fold_timer, _fold_expiry, NULL);
+		fold_timer_initialized = true;
+	}
+
+	if (enable == true)
+	{
+		if (task_profiler_latency_counter == nullptr)
+		{
+			task_profiler_latency_counter = &no_counter;
+		}
+
+		/* Start the cycle counter if nobody did */
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+		k_timer_start(&fold_timer,
+					  K_MSEC(PROFILER_FOLD_PERIOD_MS),
+					  K_MSEC(PROFILER_FOLD_PERIOD_MS));
+	}
+	else
+	{
+		k_timer_stop(&fold_timer);
+	}
+
+	task_profiler_enabled = enable;
+}
+
+void task_profiler_reset()
+{
+	task_profiler_reset_requested = true;
+}
+
+void task_profiler_get(critical_task_profile_t* profile)
+{
+	if (profile == nullptr)
+		return;
+
+	memset(profile, 0, sizeof(critical_task_profile_t));
+
+	profile->cpu_frequency = CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC;
+	profile->latency_bin_cycles = CONFIG_OWNTECH_TASK_PROFILER_JITTER_BIN_CYCLES;
+
+	if (task_profiler_reset_requested == true)
+		return;
+
+	/* Fold, then compute outside of the critical task counters */
+	unsigned int key = irq_lock();
+
+	_fold();
+
+	uint32_t runs = folded.runs;
+	uint32_t samples = folded.samples;
+
+	profile->runs = runs;
+	profile->sampled_runs = samples;
+	profile->record_max_cycles = snapshot.record_max;
+
+	for (uint8_t i = 0 ; i < CONFIG_OWNTECH_TASK_PROFILER_JITTER_BINS ; i++)
+	{
+		profile->latency_histogram[i] = folded.latency_histogram[i];
+	}
+
+	if (runs != 0)
+	{
+		profile->total_min_cycles  = snapshot.total_min;
+		profile->total_max_cycles  = snapshot.total_max;
+		profile->total_mean_cycles = folded.total / runs;
+
+		profile->latency_max_cycles  =
+			(uint32_t)_latency_cycles(snapshot.latency_ticks_max);
+		profile->latency_mean_cycles = folded.latency / runs;
+	}
+
+	if (samples != 0)
+	{
+		profile->safety_max_cycles    = folded.phase_max[0];
+		profile->safety_mean_cycles   = folded.phase_sum[0] / samples;
+		profile->dispatch_max_cycles  = folded.phase_max[1];
+		profile->dispatch_mean_cycles = folded.phase_sum[1] / samples;
+		profile->user_max_cycles      = folded.phase_max[2];
+		profile->user_mean_cycles     = folded.phase_sum[2] / samples;
+	}
+
+	irq_unlock(key);
+}
+
+void task_profiler_print()
+{
+	critical_task_profile_t profile;
+
+	task_profiler_get(&profile);
+
+	printk("Critical task profile over %u runs, %u sampled (cycles at %u Hz)\n",
+		   profile.runs, profile.sampled_runs, profile.cpu_frequency);
+	printk("  total    min %u mean %u max %u\n",
+		   profile.total_min_cycles,
+		   profile.total_mean_cycles,
+		   profile.total_max_cycles);
+	printk("  safety   mean %u max %u\n",
+		   profile.safety_mean_cycles, profile.safety_max_cycles);
+	printk("  dispatch mean %u max %u\n",
+		   profile.dispatch_mean_cycles, profile.dispatch_max_cycles);
+	printk("  user     mean %u max %u\n",
+		   profile.user_mean_cycles, profile.user_max_cycles);
+	printk("  latency  mean %u max %u\n",
+		   profile.latency_mean_cycles, profile.latency_max_cycles);
+	printk("  profiler max %u\n", profile.record_max_cycles);
+
+	for (uint8_t i = 0 ; i < CONFIG_OWNTECH_TASK_PROFILER_JITTER_BINS - 1 ; i++)
+	{
+		printk("  latency < %u: %u\n",
+			   (i + 1) * profile.latency_bin_cycles,
+			   profile.latency_histogram[i]);
+	}
+	printk("  latency >= %u: %u\n",
+		   (CONFIG_OWNTECH_TASK_PROFILER_JITTER_BINS - 1) *
+		   profile.latency_bin_cycles,
+		   profile.latency_histogram[CONFIG_OWNTECH_TASK_PROFILER_JITTER_BINS - 1]);
+}
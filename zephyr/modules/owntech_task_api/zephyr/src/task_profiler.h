@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Execution time and start latency profiling of the uninterruptible
+ *         synchronous task, based on the DWT cycle counter.
+ *
+ *         The hot path only keeps 32-bit counters: the proxy stamps the
+ *         start of each phase, and task_profiler_record() adds the total
+ *         execution time and start latency to wrapping sums, updates their
+ *         extremes, and stores the stamps of the run in a ring of samples.
+ *         Sums are folded into 64-bit totals, and the samples into the
+ *         per-phase statistics and the latency histogram, by the reader:
+ *         a kernel timer every millisecond while profiling, and
+ *         task_profiler_get().
+ *
+ *         The critical task cannot be masked, so the counters are
+ *         published with a sequence counter: the critical task makes it odd
+ *         while writing them, and readers copy them again until it was even
+ *         and unchanged around their copy. Readers run on the same core, so
+ *         the writes only need to stay ordered for the compiler. A reset is
+ *         a request that the critical task consumes before its next record.
+ */
+
+#ifndef TASK_PROFILER_H_
+#define TASK_PROFILER_H_
+
+/* Stdlib */
+#include <stdint.h>
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+#include <soc.h>
+
+/* OwnTech Task API */
+#include "TaskAPI.h"
+
+
+/* Phases stamped by the proxy, in execution order */
+typedef enum
+{
+	PROFILER_STAMP_START,
+	PROFILER_STAMP_DISPATCH,
+	PROFILER_STAMP_USER,
+	PROFILER_STAMP_END,
+	PROFILER_STAMP_COUNT
+} task_profiler_stamp_t;
+
+/* Stamps of one run, the last one is the end of the run */
+typedef struct
+{
+	uint32_t stamps[PROFILER_STAMP_COUNT];
+	uint32_t latency_ticks;
+} task_profiler_sample_t;
+
+typedef struct
+{
+	uint32_t epoch;
+	uint32_t runs;
+	uint32_t total_min;
+	uint32_t total_max;
+	uint32_t total_sum;
+	uint32_t latency_ticks_max;
+	uint32_t latency_ticks_sum;
+	uint32_t record_max;
+	task_profiler_sample_t samples[CONFIG_OWNTECH_TASK_PROFILER_SAMPLES];
+} task_profiler_data_t;
+
+BUILD_ASSERT((CONFIG_OWNTECH_TASK_PROFILER_SAMPLES &
+			  (CONFIG_OWNTECH_TASK_PROFILER_SAMPLES - 1)) == 0,
+			 "Number of profiler samples must be a power of 2");
+
+/* Internal state, shared with the inline hot path */
+extern bool task_profiler_enabled;
+extern task_profiler_data_t task_profiler_data;
+extern volatile uint32_t task_profiler_sequence;
+extern volatile bool task_profiler_reset_requested;
+extern volatile uint32_t* task_profiler_latency_counter;
+
+/**
+ * @brief Read the cycle counter.
+ */
+static inline uint32_t task_profiler_now()
+{
+	return DWT->CYCCNT;
+}
+
+/**
+ * @brief Clear the counters of the critical task, and start a new epoch
+ *        so that readers clear their totals.
+ *
+ * @param data Counters to clear.
+ */
+static inline void task_profiler_clear(task_profiler_data_t* data)
+{
+	data->epoch++;
+	data->runs = 0;
+	data->total_min = UINT32_MAX;
+	data->total_max = 0;
+	data->total_sum = 0;
+	data->latency_ticks_max = 0;
+	data->latency_ticks_sum = 0;
+	data->record_max = 0;
+}
+
+/**
+ * @brief Add the stamps of one execution to the counters.
+ *
+ * @param stamps Cycle counter at the start of each phase and at the end.
+ * @param latency_ticks Counter of the interrupt source read at the start
+ *        of the execution, i.e. time elapsed since the event.
+ */
+static inline void task_profiler_record(const uint32_t* stamps,
+										uint32_t latency_ticks)
+{
+	task_profiler_data_t* data = &task_profiler_data;
+
+	uint32_t total = stamps[PROFILER_STAMP_END] - stamps[PROFILER_STAMP_START];
+
+	/* Odd while the counters are written */
+	task_profiler_sequence++;
+	compiler_barrier();
+
+	if (task_profiler_reset_requested == true)
+	{
+		task_profiler_clear(data);
+		task_profiler_reset_requested = false;
+	}
+
+	task_profiler_sample_t* sample =
+		&data->samples[data->runs & (CONFIG_OWNTECH_TASK_PROFILER_SAMPLES - 1)];
+
+	for (uint8_t i = 0 ; i < PROFILER_STAMP_COUNT ; i++)
+	{
+		sample->stamps[i] = stamps[i];
+	}
+	sample->latency_ticks = latency_ticks;
+
+	data->runs++;
+	data->total_sum += total;
+	if (total > data->total_max) data->total_max = total;
+	if (total < data->total_min) data->total_min = total;
+
+	data->latency_ticks_sum += latency_ticks;
+	if (latency_ticks > data->latency_ticks_max)
+	{
+		data->latency_ticks_max = latency_ticks;
+	}
+
+	/* Cost of the record itself, up to here */
+	uint32_t record = task_profiler_now() - stamps[PROFILER_STAMP_END];
+	if (record > data->record_max) data->record_max = record;
+
+	compiler_barrier();
+	task_profiler_sequence++;
+}
+
+/**
+ * @brief Select the counter used to measure the start latency, depending on
+ *        the interrupt source of the task.
+ *
+ * @param int_source Interrupt source of the task.
+ */
+void task_profiler_set_source(scheduling_interrupt_source_t int_source);
+
+/**
+ * @brief Enable or disable profiling. The DWT cycle counter is started on
+ *        first enable, the folding timer runs while profiling is enabled.
+ */
+void task_profiler_enable(bool enable);
+
+/**
+ * @brief Request the statistics to be cleared before the next record.
+ *        Statistics read until then are empty.
+ */
+void task_profiler_reset();
+
+/**
+ * @brief Copy the statistics in a user structure. Must not be called from
+ *        the critical task.
+ */
+void task_profiler_get(critical_task_profile_t* profile);
+
+/**
+ * @brief Print the statistics on the console.
+ */
+void task_profiler_print();
+
+
+#endif /* TASK_PROFILER_H_ */
@@ -26,11 +26,31 @@
 
 /* Current module */
 #include "scheduling_common.h"
+#include "uninterruptible_synchronous_task.h"
 
 /* OwnTech Power API */
 #include "timer.h"
 #include "hrtim.h"
+#include "adc.h"
 #include "SpinAPI.h"
+#include "ccm.h"
+#include "event_trace.h"
+
+#ifdef CONFIG_OWNTECH_TASK_PROFILER
+#include "task_profiler.h"
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_MONITOR
+#include "task_monitor.h"
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+#include "task_overrun.h"
+
+/* STM32 LL */
+#include <stm32_ll_hrtim.h>
+#include <stm32_ll_tim.h>
+#endif
 
 #ifdef CONFIG_OWNTECH_SAFETY_API
 #include "safety_internal.h"
@@ -59,6 +79,7 @@ static task_status_t uninterruptibleTaskStatus = task_status_t::inexistent;
 
 /* Interrupt source */
 static scheduling_interrupt_source_t interrupt_source = source_uninitialized;
+static uint8_t trigger_adc_number = 1;
 
 /* For HRTIM interrupts */
 static task_function_t user_periodic_task = NULL;
@@ -70,8 +91,201 @@ static uint32_t task_period = 0;
 /* Safety */
 static bool safety_alert = false;
 
+#if CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS > 0
+/* Rate groups: subtasks run every `divider` critical task periods */
+typedef struct
+{
+	task_function_t routine;
+	uint32_t divider;
+	uint32_t phase;
+	uint32_t budget_us;
+	uint32_t countdown;
+} subtask_information_t;
+
+static subtask_information_t subtasks[CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS];
+static uint8_t subtasks_count = 0;
+
+/* Hyperperiods longer than this are checked pessimistically */
+static const uint32_t MAX_CHECKED_HYPERPERIOD = 10000;
+#endif
+
 /* Private API */
 
+#if CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS > 0
+static uint32_t _gcd(uint32_t a, uint32_t b)
+{
+	while (b != 0)
+	{
+		uint32_t r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Worst sum of the subtasks budgets over all the
+ *        ticks of the hyperperiod, including a candidate subtask.
+ */
+static uint32_t _subtasks_worst_tick_budget(const subtask_information_t& candidate)
+{
+	uint32_t hyperperiod = candidate.divider;
+	bool exact = true;
+
+	for (uint8_t i = 0 ; i < subtasks_count ; i++)
+	{
+		uint32_t divider = subtasks[i].divider;
+		hyperperiod = hyperperiod / _gcd(hyperperiod, divider) * divider;
+
+		if (hyperperiod > MAX_CHECKED_HYPERPERIOD)
+		{
+			exact = false;
+			break;
+		}
+	}
+
+	uint32_t worst = 0;
+
+	if (exact == false)
+	{
+		/* Assume all subtasks may fall on the same tick */
+		worst = candidate.budget_us;
+		for (uint8_t i = 0 ; i < subtasks_count ; i++)
+		{
+			worst += subtasks[i].budget_us;
+		}
+		return worst;
+	}
+
+	for (uint32_t tick = 0 ; tick < hyperperiod ; tick++)
+	{
+		uint32_t sum = 0;
+
+		if (tick % candidate.divider == candidate.phase)
+		{
+			sum += candidate.budget_us;
+		}
+		for (uint8_t i = 0 ; i < subtasks_count ; i++)
+		{
+			if (tick % subtasks[i].divider == subtasks[i].phase)
+			{
+				sum += subtasks[i].budget_us;
+			}
+		}
+
+		if (sum > worst)
+		{
+			worst = sum;
+		}
+	}
+
+	return worst;
+}
+
+static inline void _subtasks_reset()
+{
+	for (uint8_t i = 0 ; i < subtasks_count ; i++)
+	{
+		subtasks[i].countdown = subtasks[i].phase;
+	}
+}
+
+static inline void _subtasks_run()
+{
+	for (uint8_t i = 0 ; i < subtasks_count ; i++)
+	{
+		if (subtasks[i].countdown == 0)
+		{
+			subtasks[i].countdown = subtasks[i].divider - 1;
+			subtasks[i].routine();
+		}
+		else
+		{
+			subtasks[i].countdown--;
+		}
+	}
+}
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+/**
+ * @brief PRIVATE FUNCTION - Checks if the next interrupt event already
+ *        occurred, i.e. if its flag is set again while the task runs.
+ *        Interrupt handlers clear the flag on entry.
+ */
+static inline bool _overrun_pending()
+{
+	/* With the ADC source, periods are still given by the HRTIM. Its
+	   interrupt has the same priority as the end of sequence one running
+	   the task: it cannot preempt the task, and its flag stays set */
+	if ( (interrupt_source == source_hrtim) ||
+		 (interrupt_source == source_adc) )
+	{
+		if (LL_HRTIM_GetSyncInSrc(HRTIM1) == LL_HRTIM_SYNCIN_SRC_EXTERNAL_EVENT)
+		{
+			return LL_HRTIM_IsActiveFlag_SYNC(HRTIM1) != 0;
+		}
+		return LL_HRTIM_IsActiveFlag_REP(HRTIM1, LL_HRTIM_TIMER_MASTER) != 0;
+	}
+	else if (interrupt_source == source_tim6)
+	{
+		return LL_TIM_IsActiveFlag_UPDATE(TIM6) != 0;
+	}
+
+	return false;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Drops the pending interrupt event so that the
+ *        task does not run again until the next one.
+ */
+static void _overrun_drop_event()
+{
+	if ( (interrupt_source == source_hrtim) ||
+		 (interrupt_source == source_adc) )
+	{
+		if (LL_HRTIM_GetSyncInSrc(HRTIM1) == LL_HRTIM_SYNCIN_SRC_EXTERNAL_EVENT)
+		{
+			LL_HRTIM_ClearFlag_SYNC(HRTIM1);
+		}
+		else
+		{
+			LL_HRTIM_ClearFlag_REP(HRTIM1, LL_HRTIM_TIMER_MASTER);
+		}
+		NVIC_ClearPendingIRQ(HRTIM1_Master_IRQn);
+	}
+	else if (interrupt_source == source_tim6)
+	{
+		LL_TIM_ClearFlag_UPDATE(TIM6);
+		NVIC_ClearPendingIRQ(TIM6_DAC_IRQn);
+	}
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Applies the overrun policy.
+ */
+static void _overrun_handle()
+{
+	switch (task_overrun_record())
+	{
+		case overrun_action_drop_event:
+			_overrun_drop_event();
+			break;
+		case overrun_action_stop:
+#ifdef CONFIG_OWNTECH_SAFETY_API
+			safety_action();
+			safety_alert = true;
+#else
+			scheduling_stop_uninterruptible_synchronous_task();
+#endif
+			break;
+		case overrun_action_none:
+		default:
+			break;
+	}
+}
+#endif
+
 #ifdef CONFIG_OWNTECH_SAFETY_API
 void thread_error(void *, void *, void *)
 {
@@ -104,22 +318,100 @@ void thread_error(void *, void *, void *)
 }
 #endif
 
-void user_task_proxy()
+OWNTECH_CCM_FUNC void user_task_proxy()
 {
+	OWNTECH_TRACE(TRACE_EVENT_CRITICAL_BEGIN, 0);
+
+#ifdef CONFIG_OWNTECH_TASK_MONITOR
+	uint32_t monitor_start = task_monitor_now();
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_PROFILER
+	bool profiling = task_profiler_enabled;
+	uint32_t stamps[PROFILER_STAMP_COUNT];
+	uint32_t latency_ticks = 0;
+
+	if (profiling)
+	{
+		latency_ticks = *task_profiler_latency_counter;
+		stamps[PROFILER_STAMP_START] = task_profiler_now();
+	}
+#endif
+
 #ifdef CONFIG_OWNTECH_SAFETY_API
 
-	if (safety_task() != 0) safety_alert = true;
+	if (safety_task() != 0)
+	{
+		safety_alert = true;
+
+#ifdef CONFIG_OWNTECH_CAPTURE_API
+		spin.capture.notifySafetyTrip();
+#endif
+	}
+
+#endif
 
+	if (user_periodic_task == NULL)
+	{
+#ifdef CONFIG_OWNTECH_TASK_MONITOR
+		task_monitor_record(task_monitor_now() - monitor_start);
 #endif
+		OWNTECH_TRACE(TRACE_EVENT_CRITICAL_END, 0);
+		return;
+	}
 
-	if (user_periodic_task == NULL) return;
+#ifdef CONFIG_OWNTECH_TASK_PROFILER
+	if (profiling) stamps[PROFILER_STAMP_DISPATCH] = task_profiler_now();
+#endif
 
 	if (do_data_dispatch == true)
 	{
 		spin.data.doFullDispatch();
 	}
 
-	user_periodic_task();
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+	bool run_user_code = (task_overrun_degraded_skip() == false);
+#else
+	bool run_user_code = true;
+#endif
+
+	if (run_user_code == true)
+	{
+#ifdef CONFIG_OWNTECH_TASK_PROFILER
+		if (profiling) stamps[PROFILER_STAMP_USER] = task_profiler_now();
+#endif
+
+		user_periodic_task();
+
+#if CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS > 0
+		_subtasks_run();
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_PROFILER
+		if (profiling)
+		{
+			stamps[PROFILER_STAMP_END] = task_profiler_now();
+			task_profiler_record(stamps, latency_ticks);
+		}
+#endif
+	}
+
+#ifdef CONFIG_OWNTECH_CAPTURE_API
+	spin.capture.sample();
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_MONITOR
+	task_monitor_record(task_monitor_now() - monitor_start);
+#endif
+
+	OWNTECH_TRACE(TRACE_EVENT_CRITICAL_END, 0);
+
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+	if (_overrun_pending() == true)
+	{
+		_overrun_handle();
+	}
+#endif
 }
 
 /* Public API */
@@ -130,6 +422,11 @@ void scheduling_set_uninterruptible_synchronous_task_interrupt_source(
 	interrupt_source = int_source;
 }
 
+void scheduling_set_uninterruptible_synchronous_task_adc(uint8_t adc_number)
+{
+	trigger_adc_number = adc_number;
+}
+
 int8_t scheduling_define_uninterruptible_synchronous_task(
 									task_function_t periodic_task,
 									uint32_t task_period_us)
@@ -162,7 +459,8 @@ int8_t scheduling_define_uninterruptible_synchronous_task(
 
 		return 0;
 	}
-	else if (interrupt_source == source_hrtim)
+	else if ( (interrupt_source == source_hrtim) ||
+			  (interrupt_source == source_adc) )
 	{
 		uint32_t hrtim_period_us = hrtim_period_Master_get_us();
 
@@ -179,7 +477,19 @@ int8_t scheduling_define_uninterruptible_synchronous_task(
 
 		task_period = task_period_us;
 		user_periodic_task = periodic_task;
-		hrtim_PeriodicEvent_configure(MSTR, repetition, user_task_proxy);
+
+		if (interrupt_source == source_hrtim)
+		{
+			hrtim_PeriodicEvent_configure(MSTR, repetition, user_task_proxy);
+		}
+		else
+		{
+			/* The HRTIM period event only arms the ADC end of sequence
+			   interrupt, which runs the task as soon as the conversions
+			   of this period are done */
+			hrtim_PeriodicEvent_configure(MSTR, repetition, adc_eos_event_arm);
+			adc_eos_event_configure(trigger_adc_number, user_task_proxy);
+		}
 
 		uninterruptibleTaskStatus = task_status_t::defined;
 
@@ -211,7 +521,8 @@ void scheduling_start_uninterruptible_synchronous_task(
 		spin.data.setDispatchMethod(DispatchMethod_t::externally_triggered);
 
 		uint32_t repetition;
-		if (interrupt_source == scheduling_interrupt_source_t::source_hrtim)
+		if ( (interrupt_source == scheduling_interrupt_source_t::source_hrtim) ||
+			 (interrupt_source == scheduling_interrupt_source_t::source_adc) )
 		{
 			repetition = hrtim_PeriodicEvent_GetRep(MSTR);
 		}
@@ -231,6 +542,19 @@ void scheduling_start_uninterruptible_synchronous_task(
 		spin.data.start();
 	}
 
+#if CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS > 0
+	_subtasks_reset();
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+	scheduling_clear_overrun();
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_PROFILER
+	/* HRTIM prescaler is settled by now */
+	task_profiler_set_source(interrupt_source);
+#endif
+
 	if (interrupt_source == source_tim6)
 	{
 		if (device_is_ready(timer6) == false)
@@ -247,6 +571,16 @@ void scheduling_start_uninterruptible_synchronous_task(
 
 		hrtim_PeriodicEvent_en(MSTR);
 
+		uninterruptibleTaskStatus = task_status_t::running;
+	}
+	else if (interrupt_source == source_adc)
+	{
+		if (user_periodic_task == NULL)
+			return;
+
+		adc_eos_event_enable();
+		hrtim_PeriodicEvent_en(MSTR);
+
 		uninterruptibleTaskStatus = task_status_t::running;
 	}
 }
@@ -271,4 +605,63 @@ void scheduling_stop_uninterruptible_synchronous_task()
 
 		uninterruptibleTaskStatus = task_status_t::suspended;
 	}
+	else if (interrupt_source == source_adc)
+	{
+		hrtim_PeriodicEvent_dis(MSTR);
+		adc_eos_event_disable();
+
+		uninterruptibleTaskStatus = task_status_t::suspended;
+	}
+}
+
+#if CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS > 0
+int8_t scheduling_define_critical_subtask(task_function_t routine,
+										  uint32_t period_us,
+										  uint32_t phase,
+										  uint32_t budget_us)
+{
+	if (routine == NULL)
+		return -1;
+
+	if (subtasks_count >= CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS)
+		return -1;
+
+	/* The critical task gives the base period */
+	if ( (uninterruptibleTaskStatus == task_status_t::inexistent) ||
+		 (uninterruptibleTaskStatus == task_status_t::running) )
+		return -1;
+
+	if ( (task_period == 0) || (period_us % task_period != 0) )
+		return -1;
+
+	subtask_information_t subtask;
+	subtask.routine   = routine;
+	subtask.divider   = period_us / task_period;
+	subtask.phase     = phase;
+	subtask.budget_us = budget_us;
+	subtask.countdown = phase;
+
+	if ( (subtask.divider == 0) || (phase >= subtask.divider) )
+		return -1;
+
+	/* Static check: no tick may hold more subtask work than a period */
+	if (_subtasks_worst_tick_budget(subtask) >= task_period)
+		return -1;
+
+	subtasks[subtasks_count] = subtask;
+	subtasks_count++;
+
+	return subtasks_count - 1;
 }
+
+uint32_t scheduling_get_critical_subtasks_worst_budget()
+{
+	if (subtasks_count == 0)
+		return 0;
+
+	/* Reuse the check with an empty candidate */
+	subtask_information_t none = {NULL, 1, 0, 0, 0};
+	return _subtasks_worst_tick_budget(none);
+}
+#endif
+
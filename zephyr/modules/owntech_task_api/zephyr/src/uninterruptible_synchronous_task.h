@@ -44,6 +44,15 @@
 void scheduling_set_uninterruptible_synchronous_task_interrupt_source(
                                     scheduling_interrupt_source_t int_source);
 
+/**
+ * @brief Set the ADC whose end of sequence triggers the uninterruptible
+ *        synchronous task when the interrupt source is `source_adc`.
+ *        Must be called before defining the task.
+ *
+ * @param adc_number Number of the ADC, between 1 and 5.
+ */
+void scheduling_set_uninterruptible_synchronous_task_adc(uint8_t adc_number);
+
                                     /**
  * @brief Define a periodic task to be run in an uninterruptible synchronous 
  *        context.
@@ -86,5 +95,68 @@ void scheduling_start_uninterruptible_synchronous_task(
  */
 void scheduling_stop_uninterruptible_synchronous_task();
 
+#if CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS > 0
+/**
+ * @brief Define a subtask run in the uninterruptible synchronous task
+ *        context, every `period_us / task_period_us` executions of the task.
+ *
+ * @param routine Pointer to the subtask function (must not be `NULL`).
+ * @param period_us Subtask period in microseconds, integer multiple of the
+ *                  uninterruptible task period.
+ * @param phase Index of the task execution, between 0 and the period ratio
+ *              minus 1, on which the subtask runs.
+ * @param budget_us Worst case execution time of the subtask in
+ *                  microseconds, used for the static check.
+ *
+ * @return Subtask number on success,
+ *         `-1` on failure (no task defined, task running, invalid period or
+ *         phase, no more subtasks available, or budget exceeded).
+ */
+int8_t scheduling_define_critical_subtask(task_function_t routine,
+                                          uint32_t period_us,
+                                          uint32_t phase,
+                                          uint32_t budget_us);
+
+/**
+ * @brief Get the worst sum of subtask budgets falling on the same
+ *        execution of the uninterruptible synchronous task.
+ *
+ * @return Worst case subtask time in microseconds.
+ */
+uint32_t scheduling_get_critical_subtasks_worst_budget();
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_OVERRUN_DETECTION
+/**
+ * @brief Set the action taken when the uninterruptible synchronous task
+ *        overruns its period.
+ *
+ * @param policy Overrun policy.
+ */
+void scheduling_set_overrun_policy(overrun_policy_t policy);
+
+/**
+ * @brief Get the number of overruns since the task was started or since
+ *        the last call to `scheduling_clear_overrun()`.
+ *
+ * @return Overrun count.
+ */
+uint32_t scheduling_get_overrun_count();
+
+/**
+ * @brief Check if the task runs at a reduced rate after an overrun.
+ *
+ * @return `true` in degraded mode, `false` otherwise.
+ */
+bool scheduling_is_degraded();
+
+/**
+ * @brief Clear the overrun count and leave degraded mode, at the next
+ *        execution of the task. Count and mode read until then are
+ *        cleared ones.
+ */
+void scheduling_clear_overrun();
+#endif
+
 
 #endif /* UNINTERRUPTIBLESYNCHRONOUSTASK_H_ */
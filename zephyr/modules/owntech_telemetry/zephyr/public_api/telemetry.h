@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Binary telemetry stream of float variables on the console.
+ *
+ *         The variables given to telemetry_add_channel() are sampled by
+ *         telemetry_sample(), called from the critical task, once every
+ *         decimation calls. Samples are grouped in frames of
+ *         CONFIG_OWNTECH_TELEMETRY_SAMPLES_PER_FRAME samples and written
+ *         by a thread on the console, see telemetry_format.h. Sampling
+ *         never waits and takes no lock: a sample taken while the buffer
+ *         is full is dropped and counted.
+ *
+ *         Text printed while streaming can corrupt frames, which the host
+ *         decoder then skips.
+ *
+ *         E.g.:
+ *             telemetry_add_channel("V1_LOW", &v1_low);
+ *             telemetry_add_channel("I1_LOW", &i1_low);
+ *             telemetry_set_decimation(10);
+ *             telemetry_start();
+ *
+ *             In the critical task: telemetry_sample();
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+/* Current module frame format */
+#include "telemetry_format.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Add a variable to the stream. Channels are sent in the order they
+ *        were added.
+ *
+ * @param name     Channel name, which must stay valid: a string literal.
+ *                 Must not contain commas.
+ * @param variable Variable sampled.
+ *
+ * @return 0 on success, -1 when the stream is running or when
+ *         CONFIG_OWNTECH_TELEMETRY_MAX_CHANNELS channels were added.
+ */
+int8_t telemetry_add_channel(const char* name, const float* variable);
+
+/**
+ * @brief Remove all the channels.
+ *
+ * @return 0 on success, -1 when the stream is running.
+ */
+int8_t telemetry_clear_channels(void);
+
+/**
+ * @brief Sample one call of telemetry_sample() out of decimation. Default
+ *        is 1.
+ *
+ * @param decimation Decimation, at least 1.
+ *
+ * @return 0 on success, -1 when the stream is running or when decimation
+ *         is 0.
+ */
+int8_t telemetry_set_decimation(uint16_t decimation);
+
+/**
+ * @brief Start the stream, from the first sample. Starts the telemetry
+ *        thread on first call.
+ *
+ * @return 0 on success, -1 when no channel was added.
+ */
+int8_t telemetry_start(void);
+
+/**
+ * @brief Stop the stream. The frames complete at that time are still
+ *        sent, the samples of the incomplete one are discarded.
+ */
+void telemetry_stop(void);
+
+/**
+ * @brief Sample the channels, to be called from the critical task.
+ *        Returns immediately when the stream is stopped.
+ */
+void telemetry_sample(void);
+
+/**
+ * @brief Get the number of samples dropped since the stream started.
+ */
+uint32_t telemetry_get_dropped_samples(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Lossless delta coding of float samples, shared by the target and
+ *         by the host decoder. Allocation free: the caller keeps the
+ *         previous sample.
+ *
+ *         Each value is coded as the difference between its bits and the
+ *         bits of the previous value of its channel, zigzag mapped so that
+ *         small negative differences are small too, then written as a
+ *         varint: 7 bits per byte, the high bit telling that another byte
+ *         follows. Slowly changing values, whose sign and exponent rarely
+ *         change, take 1 to 3 bytes instead of 4, the worst case being 5.
+ *
+ *         E.g. encoding a sample of 3 channels:
+ *             uint8_t* end = telemetry_codec_encode(output, values,
+ *                                                   previous, 3);
+ */
+
+#ifndef TELEMETRY_CODEC_H_
+#define TELEMETRY_CODEC_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+
+/* Largest coded sample */
+#define TELEMETRY_CODEC_MAX_BYTES(channels) ((channels) * 5)
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+static inline uint32_t telemetry_codec_zigzag(int32_t value)
+{
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t telemetry_codec_unzigzag(uint32_t value)
+{
+	return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+/**
+ * @brief Code a sample.
+ *
+ * @param output   Output, with room for TELEMETRY_CODEC_MAX_BYTES(channels).
+ * @param values   Sample: one value per channel.
+ * @param previous Bits of the previous sample, updated. Zeroed, or set to
+ *                 the bits of a first sample sent raw, when starting.
+ * @param channels Number of channels.
+ *
+ * @return End of the coded sample.
+ */
+static inline uint8_t* telemetry_codec_encode(uint8_t* output,
+                                              const float* values,
+                                              uint32_t* previous,
+                                              uint8_t channels)
+{
+	for (uint8_t i = 0 ; i < channels ; i++)
+	{
+		uint32_t bits;
+		memcpy(&bits, &values[i], sizeof(bits));
+
+		uint32_t coded = telemetry_codec_zigzag((int32_t)(bits - previous[i]));
+		previous[i] = bits;
+
+		while (coded >= 0x80)
+		{
+			*output++ = (uint8_t)(coded | 0x80);
+			coded >>= 7;
+		}
+		*output++ = (uint8_t)coded;
+	}
+
+	return output;
+}
+
+/**
+ * @brief Decode a sample.
+ *
+ * @param input    Coded sample.
+ * @param end      End of the input.
+ * @param values   Decoded sample: one value per channel.
+ * @param previous Bits of the previous sample, updated, as when encoding.
+ * @param channels Number of channels.
+ *
+ * @return End of the coded sample, NULL if the input is truncated or
+ *         invalid.
+ */
+static inline const uint8_t* telemetry_codec_decode(const uint8_t* input,
+                                                    const uint8_t* end,
+                                                    float* values,
+                                                    uint32_t* previous,
+                                                    uint8_t channels)
+{
+	for (uint8_t i = 0 ; i < channels ; i++)
+	{
+		uint32_t coded = 0;
+		uint8_t  shift = 0;
+		uint8_t  byte;
+
+		do
+		{
+			if ( (input == end) || (shift > 28) )
+				return NULL;
+
+			byte   = *input++;
+			coded |= (uint32_t)(byte & 0x7F) << shift;
+			shift += 7;
+		} while (byte & 0x80);
+
+		uint32_t bits = previous[i] + (uint32_t)telemetry_codec_unzigzag(coded);
+		previous[i] = bits;
+
+		memcpy(&values[i], &bits, sizeof(bits));
+	}
+
+	return input;
+}
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_CODEC_H_ */
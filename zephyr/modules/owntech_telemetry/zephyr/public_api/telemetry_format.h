@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Frames of the telemetry stream, shared by the target and by the
+ *         host decoder.
+ *
+ *         A frame is a header, a payload and the CRC-16/CCITT-FALSE
+ *         (polynomial 0x1021, seed 0xFFFF) of the header and payload, all
+ *         little endian. The stream shares the console with text: readers
+ *         search the sync bytes, and skip frames whose CRC is wrong.
+ *
+ *         The descriptor payload is the format version, the decimation,
+ *         then the channel names separated by commas. It is sent when the
+ *         stream starts, then every TELEMETRY_DESCRIPTOR_PERIOD frames, so
+ *         that a reader can join a running stream.
+ *
+ *         The samples payload is the index of its first sample, then its
+ *         samples, each made of one float per channel. Indexes count the
+ *         samples taken since the stream started, dropped ones included:
+ *         a gap tells how many were dropped.
+ *
+ *         The delta samples payload is the index of its first sample, its
+ *         first sample, then as many following samples as the frame holds,
+ *         each coded from the previous one as described in
+ *         telemetry_codec.h. Frames are decoded independently of each other.
+ *
+ *         The trigger payload is the index of the trigger sample of a
+ *         capture, see the capture API of the Spin API.
+ */
+
+#ifndef TELEMETRY_FORMAT_H_
+#define TELEMETRY_FORMAT_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+#define TELEMETRY_SYNC_0  0xA5
+#define TELEMETRY_SYNC_1  0x5A
+#define TELEMETRY_VERSION 1
+
+#define TELEMETRY_CRC_SEED 0xFFFF
+
+#define TELEMETRY_DESCRIPTOR_PERIOD 256
+
+/* Largest number of channels of a frame, given by the decoders */
+#define TELEMETRY_MAX_CHANNELS 64
+
+typedef enum
+{
+	TELEMETRY_FRAME_DESCRIPTOR = 1,
+	TELEMETRY_FRAME_SAMPLES    = 2,
+	TELEMETRY_FRAME_TRIGGER    = 3,
+	TELEMETRY_FRAME_DELTA      = 4
+} telemetry_frame_type_t;
+
+typedef struct __attribute__((packed))
+{
+	uint8_t  sync[2];
+	uint8_t  type;     /* telemetry_frame_type_t */
+	uint8_t  channels;
+	uint16_t sequence; /* Frame counter, descriptors included */
+	uint16_t length;   /* Payload bytes */
+} telemetry_frame_header_t;
+
+typedef struct __attribute__((packed))
+{
+	uint16_t version;
+	uint16_t decimation;
+} telemetry_descriptor_t;
+
+typedef uint16_t telemetry_frame_crc_t;
+
+
+#endif /* TELEMETRY_FORMAT_H_ */
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Frame writer of the telemetry format, see telemetry_format.h,
+ *         used by the telemetry stream and by the Spin API captures.
+ *         Frames are written on the console, from a thread: writing waits
+ *         for room in the console output buffer.
+ *
+ *         A frame is written with telemetry_frame_begin(), then its
+ *         payload with telemetry_frame_write(), then telemetry_frame_end().
+ *         The frame lock is held from telemetry_frame_begin() to
+ *         telemetry_frame_end(), so that frames written by two threads,
+ *         e.g. the telemetry stream and a capture download, do not mix.
+ *
+ *         Samples are encoded by each writer in its own state, see
+ *         telemetry_frame_writer_t.
+ */
+
+#ifndef TELEMETRY_FRAME_H_
+#define TELEMETRY_FRAME_H_
+
+
+/* Stdlib */
+#include <stddef.h>
+#include <stdint.h>
+
+/* Current module frame format */
+#include "telemetry_format.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Payload of a delta samples frame */
+#define TELEMETRY_DELTA_PAYLOAD_SIZE 1024
+
+/**
+ * @brief Encoding state of a samples writer, owned by the caller: each
+ *        thread writing samples has its own.
+ */
+typedef struct
+{
+#ifdef CONFIG_OWNTECH_TELEMETRY_COMPRESSION
+	uint8_t  payload[TELEMETRY_DELTA_PAYLOAD_SIZE];
+	uint32_t previous[TELEMETRY_MAX_CHANNELS];
+#else
+	uint8_t  unused;
+#endif
+} telemetry_frame_writer_t;
+
+
+/**
+ * @brief Take the frame lock, waiting for a frame of another thread to
+ *        end, then write a frame header.
+ *
+ * @param type     Frame type.
+ * @param channels Number of channels.
+ * @param length   Payload bytes that will follow.
+ *
+ * @return CRC of the header, to give to the next call.
+ */
+uint16_t telemetry_frame_begin(telemetry_frame_type_t type,
+                               uint8_t channels,
+                               uint16_t length);
+
+/**
+ * @brief Write a part of the frame payload.
+ *
+ * @param data Data to write.
+ * @param size Bytes to write.
+ * @param crc  CRC returned by the previous call.
+ *
+ * @return Updated CRC.
+ */
+uint16_t telemetry_frame_write(const void* data, size_t size, uint16_t crc);
+
+/**
+ * @brief Write the frame CRC, ending the frame, and give the frame lock.
+ *
+ * @param crc CRC returned by the previous call.
+ */
+void telemetry_frame_end(uint16_t crc);
+
+/**
+ * @brief Write samples, in one samples frame, or with
+ *        CONFIG_OWNTECH_TELEMETRY_COMPRESSION in as many delta samples
+ *        frames as needed.
+ *
+ * @param writer       Encoding state of the calling writer.
+ * @param channels     Number of channels.
+ * @param first_sample Index of the first sample.
+ * @param values       Samples, each made of one value per channel.
+ * @param count        Number of samples.
+ */
+void telemetry_frame_send_samples(telemetry_frame_writer_t* writer,
+                                  uint8_t channels,
+                                  uint32_t first_sample,
+                                  const float* values,
+                                  uint32_t count);
+
+/**
+ * @brief Write a descriptor frame.
+ *
+ * @param names      Channel names, without commas.
+ * @param channels   Number of channels.
+ * @param decimation Decimation of the samples.
+ */
+void telemetry_frame_send_descriptor(const char* const* names,
+                                     uint8_t channels,
+                                     uint16_t decimation);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_FRAME_H_ */
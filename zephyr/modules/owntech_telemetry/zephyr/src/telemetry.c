@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Telemetry buffer: single producer, single consumer ring of
+ *         blocks, each holding the samples of one frame. The critical
+ *         task fills the block at the head and publishes it when complete,
+ *         the telemetry thread sends the block at the tail and frees it.
+ *         Blocks are sized when the stream starts, from the number of
+ *         channels.
+ */
+
+
+/* Stdlib */
+#include <stdbool.h>
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+#include <soc.h>
+
+/* Current module headers */
+#include "telemetry.h"
+#include "telemetry_frame.h"
+
+
+BUILD_ASSERT(CONFIG_OWNTECH_TELEMETRY_BUFFER_SIZE >=
+             2 * CONFIG_OWNTECH_TELEMETRY_SAMPLES_PER_FRAME *
+             CONFIG_OWNTECH_TELEMETRY_MAX_CHANNELS,
+             "CONFIG_OWNTECH_TELEMETRY_BUFFER_SIZE must hold two frames");
+
+#define TELEMETRY_MAX_BLOCKS (CONFIG_OWNTECH_TELEMETRY_BUFFER_SIZE / \
+                              CONFIG_OWNTECH_TELEMETRY_SAMPLES_PER_FRAME)
+
+/* Above background tasks, so that the stream keeps up with sampling */
+#define TELEMETRY_THREAD_PRIORITY 13
+
+
+/**
+ *  Local variables
+ */
+
+/* Channels */
+static const char*  channel_names[CONFIG_OWNTECH_TELEMETRY_MAX_CHANNELS];
+static const float* channel_variables[CONFIG_OWNTECH_TELEMETRY_MAX_CHANNELS];
+static uint8_t      channel_count = 0;
+static uint16_t     decimation = 1;
+
+/* Blocks */
+static float    sample_buffer[CONFIG_OWNTECH_TELEMETRY_BUFFER_SIZE];
+static uint32_t block_first_sample[TELEMETRY_MAX_BLOCKS];
+static uint32_t block_size = 0;  /* Values */
+static uint32_t block_count = 0;
+static uint32_t blocks_written = 0;
+static uint32_t blocks_sent = 0;
+
+/* Sampling, from the critical task */
+static volatile bool running = false;
+static uint16_t decimation_counter = 0;
+static uint32_t sample_index = 0;
+static uint32_t sample_in_block = 0;
+static float*   sample_write = NULL;
+static atomic_t dropped_samples = ATOMIC_INIT(0);
+
+/* Sending, from the telemetry thread */
+static uint32_t frames_since_descriptor = 0;
+static bool     descriptor_pending = false;
+static telemetry_frame_writer_t frame_writer;
+
+/* Held by the thread while sending, and by start to reset the blocks */
+K_SEM_DEFINE(telemetry_lock, 1, 1);
+
+static K_THREAD_STACK_DEFINE(telemetry_thread_stack,
+                             CONFIG_OWNTECH_TELEMETRY_STACK_SIZE);
+static struct k_thread telemetry_thread;
+static k_tid_t telemetry_thread_id = NULL;
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Sends the samples of a block.
+ */
+static void _telemetry_send_block(uint32_t block)
+{
+	telemetry_frame_send_samples(&frame_writer,
+	                             channel_count,
+	                             block_first_sample[block],
+	                             &sample_buffer[block * block_size],
+	                             CONFIG_OWNTECH_TELEMETRY_SAMPLES_PER_FRAME);
+
+	frames_since_descriptor++;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Sends the descriptor frame: decimation and
+ *        channel names.
+ */
+static void _telemetry_send_descriptor()
+{
+	telemetry_frame_send_descriptor(channel_names, channel_count, decimation);
+
+	frames_since_descriptor = 0;
+}
+
+/**
+ * @brief PRIVATE FUNCTION - Telemetry thread: sends the complete blocks
+ *        periodically.
+ */
+static void _telemetry_thread(void* p1, void* p2, void* p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1)
+	{
+		k_sem_take(&telemetry_lock, K_FOREVER);
+
+		if (descriptor_pending)
+		{
+			_telemetry_send_descriptor();
+			descriptor_pending = false;
+		}
+
+		while (blocks_sent != __atomic_load_n(&blocks_written,
+		                                      __ATOMIC_ACQUIRE))
+		{
+			if (frames_since_descriptor >= TELEMETRY_DESCRIPTOR_PERIOD)
+			{
+				_telemetry_send_descriptor();
+			}
+
+			_telemetry_send_block(blocks_sent % block_count);
+
+			__atomic_store_n(&blocks_sent, blocks_sent + 1, __ATOMIC_RELEASE);
+		}
+
+		k_sem_give(&telemetry_lock);
+
+		k_msleep(CONFIG_OWNTECH_TELEMETRY_PERIOD_MS);
+	}
+}
+
+
+/* Public API */
+
+int8_t telemetry_add_channel(const char* name, const float* variable)
+{
+	if ( (running) || (channel_count == CONFIG_OWNTECH_TELEMETRY_MAX_CHANNELS) )
+		return -1;
+
+	channel_names[channel_count]     = name;
+	channel_variables[channel_count] = variable;
+	channel_count++;
+
+	return 0;
+}
+
+int8_t telemetry_clear_channels(void)
+{
+	if (running)
+		return -1;
+
+	channel_count = 0;
+
+	return 0;
+}
+
+int8_t telemetry_set_decimation(uint16_t new_decimation)
+{
+	if ( (running) || (new_decimation == 0) )
+		return -1;
+
+	decimation = new_decimation;
+
+	return 0;
+}
+
+int8_t telemetry_start(void)
+{
+	if (channel_count == 0)
+		return -1;
+
+	if (running)
+		return 0;
+
+	/* Frames of the previous run not sent yet are discarded */
+	k_sem_take(&telemetry_lock, K_FOREVER);
+
+	block_size  = CONFIG_OWNTECH_TELEMETRY_SAMPLES_PER_FRAME * channel_count;
+	block_count = CONFIG_OWNTECH_TELEMETRY_BUFFER_SIZE / block_size;
+
+	blocks_written = 0;
+	blocks_sent    = 0;
+
+	decimation_counter = decimation - 1;
+	sample_index       = 0;
+	sample_in_block    = 0;
+	atomic_set(&dropped_samples, 0);
+
+	descriptor_pending = true;
+
+	k_sem_give(&telemetry_lock);
+
+	if (telemetry_thread_id == NULL)
+	{
+		telemetry_thread_id = k_thread_create(&telemetry_thread,
+		                                      telemetry_thread_stack,
+		                                      K_THREAD_STACK_SIZEOF(telemetry_thread_stack),
+		                                      _telemetry_thread,
+		                                      NULL, NULL, NULL,
+		                                      TELEMETRY_THREAD_PRIORITY,
+		                                      0,
+		                                      K_NO_WAIT);
+	}
+
+	/* The critical task samples once everything above is visible */
+	__DMB();
+	running = true;
+
+	return 0;
+}
+
+void telemetry_stop(void)
+{
+	running = false;
+}
+
+void telemetry_sample(void)
+{
+	if (!running)
+		return;
+
+	decimation_counter++;
+	if (decimation_counter < decimation)
+		return;
+
+	decimation_counter = 0;
+
+	if (sample_in_block == 0)
+	{
+		uint32_t sent = __atomic_load_n(&blocks_sent, __ATOMIC_ACQUIRE);
+
+		if ( (blocks_written - sent) >= block_count )
+		{
+			/* No free block */
+			atomic_inc(&dropped_samples);
+			sample_index++;
+			return;
+		}
+
+		uint32_t block = blocks_written % block_count;
+
+		block_first_sample[block] = sample_index;
+		sample_write = &sample_buffer[block * block_size];
+	}
+
+	for (uint8_t i = 0 ; i < channel_count ; i++)
+	{
+		sample_write[i] = *channel_variables[i];
+	}
+
+	sample_write += channel_count;
+	sample_index++;
+	sample_in_block++;
+
+	if (sample_in_block == CONFIG_OWNTECH_TELEMETRY_SAMPLES_PER_FRAME)
+	{
+		sample_in_block = 0;
+		__atomic_store_n(&blocks_written, blocks_written + 1, __ATOMIC_RELEASE);
+	}
+}
+
+uint32_t telemetry_get_dropped_samples(void)
+{
+	return (uint32_t)atomic_get(&dropped_samples);
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+
+/* Stdlib */
+#include <string.h>
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+#include <zephyr/console/console.h>
+#include <zephyr/sys/crc.h>
+
+/* Current module headers */
+#include "telemetry_frame.h"
+#include "telemetry_codec.h"
+
+
+#ifdef CONFIG_OWNTECH_TELEMETRY_COMPRESSION
+
+BUILD_ASSERT(TELEMETRY_DELTA_PAYLOAD_SIZE >=
+             sizeof(uint32_t) + TELEMETRY_MAX_CHANNELS * sizeof(float) +
+             TELEMETRY_CODEC_MAX_BYTES(TELEMETRY_MAX_CHANNELS),
+             "A delta samples frame must hold two samples");
+
+#endif
+
+
+/**
+ *  Local variables
+ */
+
+/* Shared by all the writers, so that readers detect lost frames */
+static uint16_t frame_sequence = 0;
+
+/* Held from the beginning to the end of a frame */
+K_MUTEX_DEFINE(telemetry_frame_lock);
+
+
+/* Public API */
+
+uint16_t telemetry_frame_begin(telemetry_frame_type_t type,
+                               uint8_t channels,
+                               uint16_t length)
+{
+	telemetry_frame_header_t header;
+
+	k_mutex_lock(&telemetry_frame_lock, K_FOREVER);
+
+	header.sync[0]  = TELEMETRY_SYNC_0;
+	header.sync[1]  = TELEMETRY_SYNC_1;
+	header.type     = type;
+	header.channels = channels;
+	header.sequence = frame_sequence++;
+	header.length   = length;
+
+	return telemetry_frame_write(&header, sizeof(header), TELEMETRY_CRC_SEED);
+}
+
+uint16_t telemetry_frame_write(const void* data, size_t size, uint16_t crc)
+{
+	console_write(NULL, data, size);
+
+	return crc16_itu_t(crc, (const uint8_t*)data, size);
+}
+
+void telemetry_frame_end(uint16_t crc)
+{
+	telemetry_frame_crc_t frame_crc = crc;
+
+	console_write(NULL, &frame_crc, sizeof(frame_crc));
+
+	k_mutex_unlock(&telemetry_frame_lock);
+}
+
+void telemetry_frame_send_samples(telemetry_frame_writer_t* writer,
+                                  uint8_t channels,
+                                  uint32_t first_sample,
+                                  const float* values,
+                                  uint32_t count)
+{
+#ifdef CONFIG_OWNTECH_TELEMETRY_COMPRESSION
+	size_t   sample_size = channels * sizeof(float);
+	uint32_t sent = 0;
+
+	while (sent < count)
+	{
+		uint8_t*       output = writer->payload;
+		const uint8_t* end    = writer->payload + sizeof(writer->payload);
+		uint32_t       index  = first_sample + sent;
+
+		/* First sample raw, so that frames decode independently */
+		memcpy(output, &index, sizeof(index));
+		output += sizeof(index);
+		memcpy(output, &values[sent * channels], sample_size);
+		output += sample_size;
+		memcpy(writer->previous, &values[sent * channels], sample_size);
+		sent++;
+
+		while ( (sent < count) &&
+		        (end - output >= TELEMETRY_CODEC_MAX_BYTES(channels)) )
+		{
+			output = telemetry_codec_encode(output,
+			                                &values[sent * channels],
+			                                writer->previous,
+			                                channels);
+			sent++;
+		}
+
+		uint16_t length = output - writer->payload;
+		uint16_t crc = telemetry_frame_begin(TELEMETRY_FRAME_DELTA,
+		                                     channels,
+		                                     length);
+		crc = telemetry_frame_write(writer->payload, length, crc);
+		telemetry_frame_end(crc);
+	}
+#else
+	ARG_UNUSED(writer);
+
+	uint16_t length = sizeof(first_sample) + count * channels * sizeof(float);
+
+	uint16_t crc = telemetry_frame_begin(TELEMETRY_FRAME_SAMPLES,
+	                                     channels,
+	                                     length);
+	crc = telemetry_frame_write(&first_sample, sizeof(first_sample), crc);
+	crc = telemetry_frame_write(values, count * channels * sizeof(float), crc);
+	telemetry_frame_end(crc);
+#endif
+}
+
+void telemetry_frame_send_descriptor(const char* const* names,
+                                     uint8_t channels,
+                                     uint16_t decimation)
+{
+	telemetry_descriptor_t descriptor;
+	uint16_t length = sizeof(descriptor) + channels - 1;
+
+	for (uint8_t i = 0 ; i < channels ; i++)
+	{
+		length += strlen(names[i]);
+	}
+
+	descriptor.version    = TELEMETRY_VERSION;
+	descriptor.decimation = decimation;
+
+	uint16_t crc = telemetry_frame_begin(TELEMETRY_FRAME_DESCRIPTOR,
+	                                     channels,
+	                                     length);
+	crc = telemetry_frame_write(&descriptor, sizeof(descriptor), crc);
+
+	for (uint8_t i = 0 ; i < channels ; i++)
+	{
+		if (i > 0)
+		{
+			crc = telemetry_frame_write(",", 1, crc);
+		}
+		crc = telemetry_frame_write(names[i], strlen(names[i]), crc);
+	}
+
+	telemetry_frame_end(crc);
+}
@@ -30,6 +30,7 @@
 
 /* Current file header */
 #include "stm32_timer_driver.h"
+#include "ccm.h"
 
 
 static int timer_stm32_init(const struct device* dev)
@@ -67,7 +68,7 @@ static int timer_stm32_init(const struct device* dev)
  * @param arg Pointer to the timer device (cast from a generic void pointer).
  *
  */
-static void timer_stm32_callback(const void* arg)
+OWNTECH_CCM_FUNC static void timer_stm32_callback(const void* arg)
 {
 	const struct device* timer_dev = (const struct device*)arg;
 	struct stm32_timer_driver_data* data =
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Binary event trace.
+ *
+ *         OWNTECH_TRACE(id, arg) writes an event stamped with the DWT cycle
+ *         counter into a ring of CONFIG_OWNTECH_TRACE_BUFFER_SIZE events,
+ *         which always holds the latest events. A slot is reserved with an
+ *         atomic increment, so that interrupts of any priority, zero
+ *         latency ones included, trace without locking. Recording an event
+ *         takes about ten cycles.
+ *
+ *         The macros expand to nothing when CONFIG_OWNTECH_TRACE is
+ *         disabled.
+ *
+ *         The ring is read with trace_dump() on the console, or from the
+ *         debugger:
+ *             dump binary value trace.bin trace_ring
+ *         then converted for a timeline viewer with the trace_export tool
+ *         of the host build.
+ *
+ *         E.g. for the user critical task:
+ *             OWNTECH_TRACE(TRACE_EVENT_USER, step);
+ */
+
+#ifndef EVENT_TRACE_H_
+#define EVENT_TRACE_H_
+
+
+#include "event_trace_format.h"
+
+
+#ifdef CONFIG_OWNTECH_TRACE
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+#include <soc.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct
+{
+	trace_header_t header;
+	trace_event_t  events[CONFIG_OWNTECH_TRACE_BUFFER_SIZE];
+} trace_ring_t;
+
+extern trace_ring_t trace_ring;
+
+
+/**
+ * @brief Record an event. Use OWNTECH_TRACE() instead, which expands to
+ *        nothing when the trace is disabled.
+ *
+ *        Two events recorded from contexts preempting each other can land
+ *        in the ring out of timestamp order: readers sort them.
+ */
+static inline __attribute__((always_inline))
+void trace_record(uint16_t id, uint16_t arg)
+{
+	if (trace_ring.header.enabled == 0)
+		return;
+
+	uint32_t index = __atomic_fetch_add(&trace_ring.header.head,
+	                                    1,
+	                                    __ATOMIC_RELAXED);
+
+	trace_event_t* event =
+		&trace_ring.events[index & (CONFIG_OWNTECH_TRACE_BUFFER_SIZE - 1)];
+
+	event->timestamp = DWT->CYCCNT;
+	event->id        = id;
+	event->arg       = arg;
+}
+
+/**
+ * @brief Resume recording. Recording starts at boot.
+ */
+void trace_start(void);
+
+/**
+ * @brief Stop recording, e.g. to keep the events preceding a fault in the
+ *        ring until it is dumped.
+ */
+void trace_stop(void);
+
+/**
+ * @brief Empty the ring.
+ */
+void trace_clear(void);
+
+/**
+ * @brief Print the ring on the console in hexadecimal, between
+ *        "trace begin" and "trace end" lines, for trace_export. Recording
+ *        is stopped during the dump.
+ */
+void trace_dump(void);
+
+/**
+ * @brief Give a thread the id reported by its switch events. Threads
+ *        without an id are reported as TRACE_THREAD_OTHER. Use
+ *        OWNTECH_TRACE_THREAD() instead.
+ *
+ * @param thread Thread.
+ * @param id     Thread id, e.g. a background task number.
+ */
+void trace_set_thread_id(k_tid_t thread, uint16_t id);
+
+/**
+ * @brief Record the switch to a thread. Called by the kernel on each
+ *        context switch when CONFIG_TRACING_USER is enabled.
+ */
+void trace_thread_switched_in(k_tid_t thread);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#define OWNTECH_TRACE(id, arg) trace_record((id), (arg))
+#define OWNTECH_TRACE_THREAD(thread, id) trace_set_thread_id((thread), (id))
+
+#else
+
+#define OWNTECH_TRACE(id, arg)
+#define OWNTECH_TRACE_THREAD(thread, id)
+
+#endif /* CONFIG_OWNTECH_TRACE */
+
+#endif /* EVENT_TRACE_H_ */
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ *
+ * @brief  Memory layout of the event trace ring, shared by the target and
+ *         by the host tools reading its dumps.
+ *
+ *         A dump is the trace header followed by the events of the ring,
+ *         little endian, as they are in the target memory.
+ */
+
+#ifndef EVENT_TRACE_FORMAT_H_
+#define EVENT_TRACE_FORMAT_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+/* "OTTR" read as a little endian word */
+#define TRACE_MAGIC   0x5254544FU
+#define TRACE_VERSION 1
+
+/**
+ * Event identifiers. The argument of each event is given in its comment.
+ * Identifiers from TRACE_EVENT_USER are free for the application.
+ */
+typedef enum
+{
+	TRACE_EVENT_NONE           = 0,  /* Slot never written */
+	TRACE_EVENT_HRTIM_REP      = 1,  /* HRTIM master repetition, 0 */
+	TRACE_EVENT_DMA_HALF       = 2,  /* ADC DMA half transfer, DMA channel */
+	TRACE_EVENT_DMA_FULL       = 3,  /* ADC DMA full transfer, DMA channel */
+	TRACE_EVENT_CRITICAL_BEGIN = 4,  /* Critical task start, 0 */
+	TRACE_EVENT_CRITICAL_END   = 5,  /* Critical task end, 0 */
+	TRACE_EVENT_THREAD_SWITCH  = 6,  /* Thread switched in, thread id */
+	TRACE_EVENT_CAN_RX         = 7,  /* CAN control item received, item id */
+	TRACE_EVENT_RS485_RX       = 8,  /* RS485 frame received, 0 */
+	TRACE_EVENT_SAFETY_ALERT   = 9,  /* Sensor out of its limits, sensor */
+	TRACE_EVENT_SAFETY_TRIP    = 10, /* Safety action taken, reaction */
+	TRACE_EVENT_USER           = 64
+} trace_event_id_t;
+
+/* Thread ids of TRACE_EVENT_THREAD_SWITCH. Background tasks use their
+ * task number. */
+#define TRACE_THREAD_IDLE  0xFFFE
+#define TRACE_THREAD_OTHER 0xFFFF
+
+typedef struct
+{
+	uint32_t timestamp; /* Cycle counter */
+	uint16_t id;        /* trace_event_id_t */
+	uint16_t arg;
+} trace_event_t;
+
+typedef struct
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t event_size;
+	uint32_t size;      /* Events of the ring, a power of two */
+	uint32_t frequency; /* Cycle counter frequency in Hz */
+	uint32_t head;      /* Events written since the last clear */
+	volatile uint32_t enabled;
+} trace_header_t;
+
+
+#endif /* EVENT_TRACE_FORMAT_H_ */
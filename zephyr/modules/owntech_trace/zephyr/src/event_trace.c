@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ * @author Jean Alinei <jean.alinei@owntech.org>
+ */
+
+
+/* Stdlib */
+#include <string.h>
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+
+#ifdef CONFIG_TRACING_USER
+#include <zephyr/kernel_structs.h>
+#endif
+
+/* Current module header */
+#include "event_trace.h"
+
+
+/* Slot index is masked with the size */
+BUILD_ASSERT((CONFIG_OWNTECH_TRACE_BUFFER_SIZE &
+              (CONFIG_OWNTECH_TRACE_BUFFER_SIZE - 1)) == 0,
+             "CONFIG_OWNTECH_TRACE_BUFFER_SIZE must be a power of two");
+
+/* Words of the console dump per line */
+#define TRACE_DUMP_WORDS_PER_LINE 8
+
+/* Threads that can be given an id */
+#define TRACE_THREADS_MAX 8
+
+
+/**
+ *  Local variables
+ */
+
+trace_ring_t trace_ring;
+
+static k_tid_t  trace_threads[TRACE_THREADS_MAX];
+static uint16_t trace_thread_ids[TRACE_THREADS_MAX];
+
+
+/* Public API */
+
+void trace_start(void)
+{
+	trace_ring.header.enabled = 1;
+}
+
+void trace_stop(void)
+{
+	trace_ring.header.enabled = 0;
+}
+
+void trace_clear(void)
+{
+	uint32_t enabled = trace_ring.header.enabled;
+
+	trace_ring.header.enabled = 0;
+
+	memset(trace_ring.events, 0, sizeof(trace_ring.events));
+	__atomic_store_n(&trace_ring.header.head, 0, __ATOMIC_RELAXED);
+
+	trace_ring.header.enabled = enabled;
+}
+
+void trace_dump(void)
+{
+	uint32_t enabled = trace_ring.header.enabled;
+
+	trace_ring.header.enabled = 0;
+
+	const uint32_t* words = (const uint32_t*)&trace_ring;
+	size_t words_count    = sizeof(trace_ring) / sizeof(uint32_t);
+
+	printk("trace begin\n");
+
+	for (size_t i = 0 ; i < words_count ; i += TRACE_DUMP_WORDS_PER_LINE)
+	{
+		for (size_t j = i ;
+		     (j < i + TRACE_DUMP_WORDS_PER_LINE) && (j < words_count) ;
+		     j++)
+		{
+			printk("%08x ", (unsigned int)words[j]);
+		}
+		printk("\n");
+	}
+
+	printk("trace end\n");
+
+	trace_ring.header.enabled = enabled;
+}
+
+void trace_set_thread_id(k_tid_t thread, uint16_t id)
+{
+	for (uint8_t i = 0 ; i < TRACE_THREADS_MAX ; i++)
+	{
+		if ( (trace_threads[i] == NULL) || (trace_threads[i] == thread) )
+		{
+			trace_thread_ids[i] = id;
+			trace_threads[i]    = thread;
+			return;
+		}
+	}
+}
+
+void trace_thread_switched_in(k_tid_t thread)
+{
+	uint16_t id = TRACE_THREAD_OTHER;
+
+#ifdef CONFIG_TRACING_USER
+	if (thread == _kernel.cpus[0].idle_thread)
+	{
+		id = TRACE_THREAD_IDLE;
+	}
+#endif
+
+	for (uint8_t i = 0 ; i < TRACE_THREADS_MAX ; i++)
+	{
+		if (trace_threads[i] == thread)
+		{
+			id = trace_thread_ids[i];
+			break;
+		}
+	}
+
+	trace_record(TRACE_EVENT_THREAD_SWITCH, id);
+}
+
+
+/* Kernel tracing hooks */
+
+#ifdef CONFIG_TRACING_USER
+
+void sys_trace_thread_switched_in_user(void)
+{
+	trace_thread_switched_in(k_current_get());
+}
+
+#endif
+
+
+/* Private API */
+
+/**
+ * @brief PRIVATE FUNCTION - Starts the cycle counter, fills the trace
+ *        header and starts recording.
+ */
+static int _trace_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	trace_ring.header.magic      = TRACE_MAGIC;
+	trace_ring.header.version    = TRACE_VERSION;
+	trace_ring.header.event_size = sizeof(trace_event_t);
+	trace_ring.header.size       = CONFIG_OWNTECH_TRACE_BUFFER_SIZE;
+	trace_ring.header.frequency  = CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC;
+	trace_ring.header.head       = 0;
+	trace_ring.header.enabled    = 1;
+
+	return 0;
+}
+
+SYS_INIT(_trace_init, PRE_KERNEL_1, 0);